@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+# Precompile the .9.png resources before they are packed into the pak:
+# the 1 pixel ticks border is stripped and the stretch regions/paddings are
+# stored in a npTc chunk (serialized Res_png_9patch,see src/gui/drawable/ninepatch.cc),
+# the layout bounds in npLb and the outline in npOl,as aapt does.
+# NinePatchRenderer loads these chunks instead of scanning the border at runtime.
+# Images this script can't handle(16bit,interlaced...) are copied unchanged.
+import os
+import sys
+import struct
+import zlib
+import shutil
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+NO_COLOR = 0x00000001
+TRANSPARENT_COLOR = 0x00000000
+COLOR_WHITE = 0xffffffff
+COLOR_TICK  = 0xff000000
+COLOR_LAYOUT_BOUNDS = 0xffff0000
+
+class NotSupported(Exception):
+    pass
+
+def read_chunks(data):
+    if data[:8] != PNG_SIGNATURE:
+        raise NotSupported("not a png")
+    pos = 8
+    chunks = []
+    while pos < len(data):
+        length, = struct.unpack('>I', data[pos:pos+4])
+        ctype = data[pos+4:pos+8]
+        chunks.append((ctype, data[pos+8:pos+8+length]))
+        pos += 12 + length
+    return chunks
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+def unfilter(raw, width, height, bpp):
+    stride = width * bpp
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for y in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos+1:pos+1+stride])
+        pos += 1 + stride
+        if ftype == 1:
+            for i in range(bpp, stride):
+                line[i] = (line[i] + line[i-bpp]) & 0xff
+        elif ftype == 2:
+            for i in range(stride):
+                line[i] = (line[i] + prev[i]) & 0xff
+        elif ftype == 3:
+            for i in range(stride):
+                left = line[i-bpp] if i >= bpp else 0
+                line[i] = (line[i] + ((left + prev[i]) >> 1)) & 0xff
+        elif ftype == 4:
+            for i in range(stride):
+                left = line[i-bpp] if i >= bpp else 0
+                upleft = prev[i-bpp] if i >= bpp else 0
+                line[i] = (line[i] + paeth(left, prev[i], upleft)) & 0xff
+        rows.append(line)
+        prev = line
+    return rows
+
+def decode_rgba(chunks):
+    """decode png to rows of RGBA bytes(8bit,non interlaced only)"""
+    ihdr = next(c for t, c in chunks if t == b'IHDR')
+    width, height, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', ihdr)
+    if depth != 8 or interlace != 0:
+        raise NotSupported("bitdepth %d interlace %d" % (depth, interlace))
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(ctype)
+    if channels is None:
+        raise NotSupported("colortype %d" % ctype)
+    raw = zlib.decompress(b''.join(c for t, c in chunks if t == b'IDAT'))
+    rows = unfilter(raw, width, height, channels)
+    palette = next((c for t, c in chunks if t == b'PLTE'), b'')
+    trns = next((c for t, c in chunks if t == b'tRNS'), b'')
+    out = []
+    for line in rows:
+        rgba = bytearray(width * 4)
+        for x in range(width):
+            if ctype == 6:
+                r, g, b, a = line[x*4:x*4+4]
+            elif ctype == 2:
+                r, g, b = line[x*3:x*3+3]
+                a = 255
+                if len(trns) == 6 and struct.pack('>HHH', r, g, b) == trns:
+                    a = 0
+            elif ctype == 3:
+                idx = line[x]
+                r, g, b = palette[idx*3:idx*3+3]
+                a = trns[idx] if idx < len(trns) else 255
+            elif ctype == 4:
+                r = g = b = line[x*2]
+                a = line[x*2+1]
+            else:
+                r = g = b = line[x]
+                a = 0 if len(trns) == 2 and struct.pack('>H', r) == trns else 255
+            rgba[x*4:x*4+4] = bytes((r, g, b, a))
+        out.append(rgba)
+    return width, height, out
+
+def pixel(rows, x, y):
+    r, g, b, a = rows[y][x*4:x*4+4]
+    return (a << 24) | (r << 16) | (g << 8) | b
+
+def fill_ranges(colors, neutral):
+    """returns (tick ranges,layout bounds ranges) without the border pixel"""
+    primary, secondary = [], []
+    last = None
+    length = len(colors)
+    for idx in range(1, length - 1):
+        color = colors[idx]
+        if color not in (COLOR_TICK, COLOR_LAYOUT_BOUNDS) and not neutral(color):
+            raise NotSupported("found an invalid color 0x%08x" % color)
+        if color != last:
+            if last == COLOR_TICK:
+                primary[-1][1] = idx - 1
+            elif last == COLOR_LAYOUT_BOUNDS:
+                secondary[-1][1] = idx - 1
+            if color == COLOR_TICK:
+                primary.append([idx - 1, length - 2])
+            elif color == COLOR_LAYOUT_BOUNDS:
+                secondary.append([idx - 1, length - 2])
+            last = color
+    return primary, secondary
+
+def populate_bounds(padding, layout, stretch, length):
+    if len(padding) > 1 or len(layout) > 2:
+        raise NotSupported("too many padding/layout bounds sections")
+    pstart = pend = 0
+    if padding:
+        pstart, pend = padding[0][0], length - padding[0][1]
+    elif stretch:
+        pstart, pend = stretch[0][0], length - stretch[-1][1]
+    lstart = lend = 0
+    if layout:
+        lstart = layout[0][1]
+        if len(layout) == 2:
+            lend = length - layout[1][0]
+    return pstart, pend, lstart, lend
+
+def segments(stretch, length):
+    """fixed and stretchy segments along one axis,as CalculateRegionColors walks them"""
+    result, nxt, it = [], 0, 0
+    while nxt != length:
+        if it < len(stretch):
+            if nxt != stretch[it][0]:
+                result.append((nxt, stretch[it][0]))
+                nxt = stretch[it][0]
+            else:
+                result.append((stretch[it][0], stretch[it][1]))
+                nxt = stretch[it][1]
+                it += 1
+        else:
+            result.append((nxt, length))
+            nxt = length
+    return result
+
+def region_color(rows, left, top, right, bottom):
+    expected = pixel(rows, left, top)
+    for y in range(top, bottom):
+        for x in range(left, right):
+            color = pixel(rows, x, y)
+            if (color >> 24) == 0:
+                if (expected >> 24) != 0:
+                    return NO_COLOR
+            elif color != expected:
+                return NO_COLOR
+    return TRANSPARENT_COLOR if (expected >> 24) == 0 else expected
+
+def outline_insets(alphas):
+    length = len(alphas)
+    start = end = 0
+    if length < 3:
+        return 0, 0
+    mid2 = length // 2
+    mid1 = mid2 + (length % 2)
+    maxa = 0
+    for i in range(0, mid1):
+        if maxa == 0xff:
+            break
+        if alphas[i] > maxa:
+            maxa, start = alphas[i], i
+    maxa = 0
+    for i in range(length - 1, mid2 - 1, -1):
+        if maxa == 0xff:
+            break
+        if alphas[i] > maxa:
+            maxa, end = alphas[i], length - (i + 1)
+    return start, end
+
+def analyze(width, height, rows):
+    if width < 3 or height < 3:
+        raise NotSupported("image must be at least 3x3")
+    corner = pixel(rows, 0, 0)
+    if (corner >> 24) == 0:
+        neutral = lambda c: (c >> 24) == 0
+    elif corner == COLOR_WHITE:
+        neutral = lambda c: c == COLOR_WHITE
+    else:
+        raise NotSupported("top-left corner pixel must be either opaque white or transparent")
+    top = [pixel(rows, x, 0) for x in range(width)]
+    left = [pixel(rows, 0, y) for y in range(height)]
+    bottom = [pixel(rows, x, height - 1) for x in range(width)]
+    right = [pixel(rows, width - 1, y) for y in range(height)]
+    xdivs, unexpected = fill_ranges(top, neutral)
+    if unexpected:
+        raise NotSupported("unexpected layout bounds on top border")
+    ydivs, unexpected = fill_ranges(left, neutral)
+    if unexpected:
+        raise NotSupported("unexpected layout bounds on left border")
+    if not xdivs or not ydivs:
+        raise NotSupported("no stretch region")
+    hpad, hlayout = fill_ranges(bottom, neutral)
+    vpad, vlayout = fill_ranges(right, neutral)
+    pl, pr, ll, lr = populate_bounds(hpad, hlayout, xdivs, width - 2)
+    pt, pb, lt, lb = populate_bounds(vpad, vlayout, ydivs, height - 2)
+
+    colors = []
+    for (y0, y1) in segments(ydivs, height - 2):
+        for (x0, x1) in segments(xdivs, width - 2):
+            colors.append(region_color(rows, x0 + 1, y0 + 1, x1 + 1, y1 + 1))
+    if len(colors) > 0x7f:
+        raise NotSupported("too many regions in 9-patch")
+
+    alpha = lambda x, y: rows[y][x*4+3]
+    ol, orr = outline_insets([alpha(x, height // 2) for x in range(1, width - 1)])
+    ot, ob = outline_insets([alpha(width // 2, y) for y in range(1, height - 1)])
+    ow = (width - 2) - ol - orr
+    oh = (height - 2) - ot - ob
+    diag = [alpha(1 + ol + i, 1 + ot + i) for i in range(max(0, min(ow, oh)))]
+    radius = 3.4142 * outline_insets(diag)[0]
+    return {
+        'xdivs': xdivs, 'ydivs': ydivs, 'colors': colors,
+        'padding': (pl, pr, pt, pb), 'layout': (ll, lt, lr, lb),
+        'outline': (ol, ot, orr, ob), 'radius': radius
+    }
+
+def serialize_nptc(info):
+    """Res_png_9patch in file(network) byte order"""
+    xdivs = [v for r in info['xdivs'] for v in r]
+    ydivs = [v for r in info['ydivs'] for v in r]
+    colors = info['colors']
+    data = struct.pack('>bBBBII', 0, len(xdivs), len(ydivs), len(colors), 0, 0)
+    data += struct.pack('>iiii', *info['padding'])
+    data += struct.pack('>I', 0)
+    data += struct.pack('>%di' % len(xdivs), *xdivs)
+    data += struct.pack('>%di' % len(ydivs), *ydivs)
+    data += struct.pack('>%dI' % len(colors), *colors)
+    return data
+
+def make_chunk(ctype, data):
+    crc = zlib.crc32(ctype + data) & 0xffffffff
+    return struct.pack('>I', len(data)) + ctype + data + struct.pack('>I', crc)
+
+def encode(width, height, rows, extra_chunks):
+    ihdr = struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)
+    raw = b''.join(b'\x00' + bytes(r) for r in rows)
+    out = PNG_SIGNATURE + make_chunk(b'IHDR', ihdr)
+    for ctype, data in extra_chunks:
+        out += make_chunk(ctype, data)
+    out += make_chunk(b'IDAT', zlib.compress(raw, 9))
+    out += make_chunk(b'IEND', b'')
+    return out
+
+def compile_ninepatch(src, dst):
+    with open(src, 'rb') as f:
+        data = f.read()
+    chunks = read_chunks(data)
+    if any(t == b'npTc' for t, _ in chunks):
+        return False # already compiled
+    width, height, rows = decode_rgba(chunks)
+    info = analyze(width, height, rows)
+    content = [r[4:(width - 1) * 4] for r in rows[1:height - 1]]
+    extra = [(b'npTc', serialize_nptc(info))]
+    if any(info['layout']):
+        extra.append((b'npLb', struct.pack('<iiii', *info['layout'])))
+    extra.append((b'npOl', struct.pack('<iiiifI', *info['outline'], info['radius'], 0xff)))
+    with open(dst, 'wb') as f:
+        f.write(encode(width - 2, height - 2, content, extra))
+    return True
+
+def process_directory(input_directory, output_directory):
+    compiled = skipped = 0
+    for root, dirs, files in os.walk(input_directory):
+        for file in files:
+            if not file.endswith('.9.png'):
+                continue
+            src = os.path.join(root, file)
+            dst = os.path.join(output_directory, os.path.relpath(src, input_directory))
+            os.makedirs(os.path.dirname(dst), exist_ok=True)
+            if os.path.exists(dst) and os.path.getmtime(dst) >= os.path.getmtime(src):
+                continue
+            try:
+                if compile_ninepatch(src, dst):
+                    compiled += 1
+                    continue
+            except (NotSupported, zlib.error, StopIteration, struct.error) as e:
+                print("%s keep the raw ninepatch:%s" % (src, e))
+            shutil.copyfile(src, dst)
+            skipped += 1
+    print("ninepatch: %d compiled,%d copied to %s" % (compiled, skipped, output_directory))
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: python ninepatch_compile.py <resource_directory> <output_directory>")
+        sys.exit(1)
+    process_directory(sys.argv[1], sys.argv[2])
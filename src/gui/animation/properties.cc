@@ -38,6 +38,30 @@ AnimateValue Property::get(void* t) const{
 void Property::set(void* object,const AnimateValue& value) const{
 }
 
+void Property::setFloat(void* object,float value)const{
+    if((mType == INT_TYPE) || (mType == COLOR_TYPE))
+        set(object,int(std::round(value)));
+    else
+        set(object,value);
+}
+
+float Property::getFloat(void* object)const{
+    const AnimateValue v = get(object);
+    return (v.index() == 0) ? float(GET_VARIANT(v,int)) : GET_VARIANT(v,float);
+}
+
+void Property::setInt(void* object,int value)const{
+    if(mType == FLOAT_TYPE)
+        set(object,float(value));
+    else
+        set(object,value);
+}
+
+int Property::getInt(void* object)const{
+    const AnimateValue v = get(object);
+    return (v.index() == 0) ? GET_VARIANT(v,int) : int(std::round(GET_VARIANT(v,float)));
+}
+
 int Property::getType()const{
     return mType;
 }
@@ -58,6 +82,12 @@ public:
     void set(void*object, const AnimateValue&v) const override{
         ((Drawable*)object)->setAlpha(GET_VARIANT(v,int));
     }
+    void setInt(void*object,int v)const override{
+        ((Drawable*)object)->setAlpha(v);
+    }
+    int getInt(void*object)const override{
+        return ((Drawable*)object)->getAlpha();
+    }
 };
 DrawableAlphaProperty DrawableAlphaProperty::DRAWABLE_ALPHA;
 
@@ -103,6 +133,10 @@ public:                                                     \
     }                                                       \
     AnimateValue get(void*obj)const override                \
             { return ((View*)obj)->get##METHOD(); }         \
+    void setFloat(void*obj,float v)const override           \
+            { ((View*)obj)->set##METHOD(v); }               \
+    float getFloat(void*obj)const override                  \
+            { return ((View*)obj)->get##METHOD(); }         \
 };                                                          \
 static const prop_##PROJ PROJ;        \
 }
@@ -117,6 +151,10 @@ public:                                                     \
     }                                                       \
     AnimateValue get(void*obj)const override                \
             { return ((View*)obj)->get##METHOD(); }         \
+    void setInt(void*obj,int v)const override               \
+            { ((View*)obj)->set##METHOD(v); }               \
+    int getInt(void*obj)const override                      \
+            { return ((View*)obj)->get##METHOD(); }         \
 };                                                          \
 static const prop_##PROJ PROJ;        \
 }
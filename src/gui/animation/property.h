@@ -50,6 +50,12 @@ public:
     Property(const std::string&name,int type);
     virtual AnimateValue get(void* t)const;
     virtual void set(void* object,const AnimateValue& value)const;
+    /*typed accessors for the per frame path,the builtin properties override them
+     *to call the target's setter without going through AnimateValue*/
+    virtual void setFloat(void* object,float value)const;
+    virtual float getFloat(void* object)const;
+    virtual void setInt(void* object,int value)const;
+    virtual int getInt(void* object)const;
     const std::string getName()const;
     int getType()const;
     static Property*fromName(const std::string&propertyName);
@@ -63,11 +69,11 @@ public:
     }
 
     virtual void setValue(void* object, float value)const{
-        set(object,value);
+        setFloat(object,value);
     }
 
     float getValue(void*object)const{
-        return GET_VARIANT(get(object),float);
+        return getFloat(object);
     };
 };
 
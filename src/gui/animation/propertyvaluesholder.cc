@@ -46,8 +46,9 @@ PropertyValuesHolder::PropertyValuesHolder(const Property*property){
 PropertyValuesHolder::PropertyValuesHolder(const std::string&name){
     mPropertyName = name;
     mValueType= Property::UNDEFINED;
-    mProperty = nullptr;
     mEvaluator= evaluator;
+    /*resolved once here,not by name on every start*/
+    mProperty = name.empty() ? nullptr : Property::fromName(name);
 }
 
 PropertyValuesHolder::~PropertyValuesHolder(){
@@ -55,7 +56,10 @@ PropertyValuesHolder::~PropertyValuesHolder(){
 }
 
 void PropertyValuesHolder::setPropertyName(const std::string& propertyName){
-    mPropertyName = propertyName;
+    if(mPropertyName != propertyName){
+        mPropertyName = propertyName;
+        mProperty = propertyName.empty() ? nullptr : Property::fromName(propertyName);
+    }
 }
 
 const std::string PropertyValuesHolder::getPropertyName()const{
@@ -80,11 +84,11 @@ void PropertyValuesHolder::setPropertyChangedListener(const OnPropertyChangedLis
 }
 
 void PropertyValuesHolder::setupSetterAndGetter(void*target){
-    if(mPropertyName.empty())return;
-    if(mProperty==nullptr){
-        mProperty = Property::fromName(mPropertyName);
-        mValueType= mProperty->getType();
-    }
+    if(mPropertyName.empty()||mProperty)return;
+    /*properties registered after this holder was created*/
+    mProperty = Property::fromName(mPropertyName);
+    if(mProperty && (mValueType == Property::UNDEFINED))
+        mValueType = mProperty->getType();
 }
 
 static int lerp(int startValue, int endValue, float fraction) {
@@ -192,7 +196,37 @@ void PropertyValuesHolder::setEvaluator(TypeEvaluator evaluator){
     mEvaluator = evaluator;
 }
 
+static inline float toFloat(const AnimateValue&v){
+#if VARIANT_AS_ANIMATEDVAUE
+    return (v.index() == 0) ? float(GET_VARIANT(v,int)) : GET_VARIANT(v,float);
+#else
+    return (v.type() == typeid(int)) ? float(GET_VARIANT(v,int)) : GET_VARIANT(v,float);
+#endif
+}
+
 void PropertyValuesHolder::calculateValue(float fraction){
+    if ((mEvaluator == evaluator) && ((mValueType == Property::INT_TYPE) || (mValueType == Property::FLOAT_TYPE))) {
+        /*plain numbers are interpolated in place,no keyframe is copied*/
+        const int last = int(mDataSource.size()) - 1;
+        int lowIndex = 0;
+        if ((fraction <= 0.0f) || (last == 0)) {
+            fraction = 0.f;
+        } else if (fraction >= 1.0f) {
+            lowIndex = last;
+            fraction = 0.f;
+        } else {
+            fraction *= last;
+            lowIndex = std::floor(fraction);
+            fraction -= lowIndex;
+        }
+        float value = toFloat(mDataSource[lowIndex]);
+        if (fraction != 0.f) {
+            value = value * (1.f - fraction) + toFloat(mDataSource[lowIndex + 1]) * fraction;
+        }
+        if (mValueType == Property::INT_TYPE) mAnimateValue = int(value);
+        else mAnimateValue = value;
+        return;
+    }
     if (fraction <= 0.0f) mAnimateValue = mDataSource.front();
     else if (fraction >= 1.0f) mAnimateValue = mDataSource.back();
     else {
@@ -248,7 +282,15 @@ void PropertyValuesHolder::getPropertyValues(PropertyValues& values){
 
 void PropertyValuesHolder::setAnimatedValue(void*target){
     if(mProperty!=nullptr){
+#if VARIANT_AS_ANIMATEDVAUE
+        switch(mAnimateValue.index()){
+        case 0 : mProperty->setInt(target,GET_VARIANT(mAnimateValue,int));     break;
+        case 1 : mProperty->setFloat(target,GET_VARIANT(mAnimateValue,float)); break;
+        default: mProperty->set(target,mAnimateValue); break;
+        }
+#else
         mProperty->set(target,getAnimatedValue());
+#endif
     }else if(mSetter!=0){
         AnimateValue value = getAnimatedValue();
         mSetter(target,mPropertyName,value);
@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <thread>
 #include <mutex>
+#include <sstream>
 #include <porting/cdlog.h>
 #include <porting/cdgraph.h>
 #include <utils/atexit.h>
@@ -29,8 +30,11 @@
 #include <core/build.h>
 #include <core/cxxopts.h>
 #include <core/inputeventsource.h>
+#include <core/inputlatencytracker.h>
+#include <core/trace.h>
 #include <core/windowmanager.h>
 #include <core/inputmethodmanager.h>
+#include <image-decoders/imagedecoder.h>
 
 #if defined(__linux__)||defined(__unix__)
 #include <sys/auxv.h>
@@ -45,8 +49,9 @@ namespace cdroid{
 
 App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
     int alpha = 255, rotation = 0, density = 0, frameDelay = 0;
-    bool debug= false,showFPS = false, help = false;
-    std::string logo, monkey, record, datapath;
+    float playSpeed = 1.f;
+    bool debug= false,showFPS = false, help = false, rgb565 = false, atlas = false, lazy = false, resample = false, latency = false;
+    std::string logo, monkey, record, trace, datapath;
     LogParseModules(argc,argv);
     mInst = this;
     cxxopts::Options options("cdroid","cdroid application");
@@ -54,6 +59,11 @@ App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
         ("d,debug","enable debuig mode",cxxopts::value<bool>(debug))
         ("h,help","print helps",cxxopts::value<bool>(help))
         ("fps", "show fps info",cxxopts::value<bool>(showFPS))
+        ("rgb565","use RGB565 for opaque bitmaps and windows",cxxopts::value<bool>(rgb565))
+        ("atlas","pack small bitmaps into shared atlas pages",cxxopts::value<bool>(atlas))
+        ("lazy","parse values of resource packages on demand",cxxopts::value<bool>(lazy))
+        ("resample","resample batched touch moves to the frame time",cxxopts::value<bool>(resample))
+        ("latency","track input to display latency,dumped with the fps info",cxxopts::value<bool>(latency))
         ("a,alpha","UI layer global alpha[0,255]",cxxopts::value<int>(alpha)->default_value("255"))
         ("f,framedelay","animation frame delay",cxxopts::value<int>(frameDelay))
         ("density","UI Density",cxxopts::value<int>(density))
@@ -61,6 +71,8 @@ App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
         ("l,logo","show logo",cxxopts::value<std::string>(logo))
         ("m,monkey","events playback path",cxxopts::value<std::string>(monkey))
         ("r,record","events record path",cxxopts::value<std::string>(record))
+        ("trace","record trace events and save them as chrome trace json at exit",cxxopts::value<std::string>(trace))
+        ("playspeed","speed of the events playback,0 for as fast as possible",cxxopts::value<float>(playSpeed)->default_value("1"))
         ("data","data directory",cxxopts::value<std::string>(datapath));
 
     Looper::prepareMainLooper();
@@ -91,6 +103,7 @@ App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
         return;
     }
     Typeface::setContext(this);
+    setLazyLoading(lazy);
     onInit();
     const size_t pos = mName.rfind(PATH_SEP);
     if(pos!=std::string::npos){
@@ -116,6 +129,11 @@ App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
         graph.setRotation(rotation);
     }
     if(!logo.empty()) graph.setLogo(logo);
+    if(rgb565){
+        graph.setOpaqueFormat(GPF_RGB565);
+        ImageDecoder::setPreferredConfig(ImageDecoder::RGB_565);
+    }
+    if(atlas) setImageAtlasEnabled(true);
     graph.showFPS(showFPS).init();
     View::VIEW_DEBUG = debug;
     DisplayMetrics::DENSITY_DEVICE = DisplayMetrics::getDeviceDensity();
@@ -125,15 +143,36 @@ App::App(int argc,const char*argv[]):mQuitFlag(false),mExitCode(0){
     Typeface::loadPreinstalledSystemFontMap();
     Typeface::loadFaceFromResource(this);
 
-    AtExit::registerCallback([this](){
+    if(!trace.empty()){
+        Trace::setThreadName("main");
+        Trace::setEnabled(true);
+    }
+    AtExit::registerCallback([this,trace](){
         LOGD("Exit...");
+        if(View::VIEW_DEBUG && getImageAtlas())
+            getImageAtlas()->dump(getDataPath());
+        if(InputLatencyTracker::getInstance().isEnabled()){
+            std::ostringstream oss;
+            InputLatencyTracker::getInstance().dump(oss);
+            LOGI("%s",oss.str().c_str());
+        }
+        if(!trace.empty()){
+            Trace::setEnabled(false);
+            Trace::dump(trace);
+        }
         mQuitFlag = true;
+        Looper::getMainLooper()->wake();
     });
 
     InputEventSource*inputsource=&InputEventSource::getInstance();//(getArg("record",""));
+    inputsource->setResampleTouch(resample);
+    InputLatencyTracker::getInstance().setEnabled(latency);
     addEventHandler(inputsource);
+    if(!record.empty()){
+        inputsource->record(record);
+    }
     if(!monkey.empty()){
-        inputsource->playback(monkey);
+        inputsource->playback(monkey,playSpeed);
     }
     AnimationHandler::getInstance();
 }
@@ -245,13 +284,15 @@ void App::removeEventHandler(const EventHandler*handler){
 
 int App::exec(){
     Looper*looper = Looper::getMainLooper();
-    while(!mQuitFlag)looper->pollAll(1);
+    /*block until woken when every EventHandler is readiness driven,otherwise keep polling them every ms*/
+    while(!mQuitFlag)looper->pollAll(looper->hasPolledEventHandlers()?1:-1);
     return mExitCode;
 }
 
 void App::exit(int code){
     mQuitFlag = true;
     mExitCode = code;
+    Looper::getMainLooper()->wake();
 }
 
 const std::string App::getName()const{
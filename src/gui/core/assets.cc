@@ -28,6 +28,7 @@
 #include <limits.h>
 #include <unistd.h>
 #include <core/systemclock.h>
+#include <core/trace.h>
 #include <drawable/drawables.h>
 #include <drawable/drawableinflater.h>
 #include <image-decoders/imagedecoder.h>
@@ -37,6 +38,7 @@ namespace cdroid {
 
 Assets::Assets() {
     mNextAutofillViewId=100000;
+    mLazyLoading = false;
 }
 
 Assets::Assets(const std::string&path):Assets() {
@@ -56,6 +58,7 @@ Assets::~Assets() {
         LOGV_IF(d.second.use_count(),"%s reference=%d",d.first.c_str(),d.second.use_count());
     }
     mDrawables.clear();
+    mImageAtlas = nullptr;
     mIDS.clear();
     mResources.clear();
     mStrings.clear();
@@ -76,11 +79,13 @@ const std::string Assets::getTheme()const {
 }
 
 void Assets::setTheme(const std::string&theme) {
+    loadDeferredValues(VALUES_STYLE,packageOf(theme));
     auto it = mStyles.find(theme);
     if(it!=mStyles.end()) {
         std::string pkg;
         mThemeName= theme;
         mTheme = it->second;
+        invalidateStyleCache();
         parseResource(theme,nullptr,&pkg);
         LOGD("set Theme to %s",theme.c_str());
     } else {
@@ -259,47 +264,145 @@ int Assets::addResource(const std::string&path,const std::string&name) {
     }
     mResources.insert({package,pak});
 
-    int count=0;
+    int count = 0,deferred = 0;
     PENDINGRESOURCE pending;
     auto sttm = SystemClock::uptimeMillis();
-    pak->forEachEntry([this,package,&count,&pending](const std::string&res) {
+    pak->forEachEntry([this,package,&count,&deferred,&pending](const std::string&res) {
         count++;
         if((res.size()>6)&&(TextUtils::startWith(res,"values")||TextUtils::startWith(res,"color"))) {
-            LOGV("LoadKeyValues from:%s",res.c_str());
-            std::string resid = AttributeSet::normalize(package,res);//package+":"+res;
-            resid = resid.substr(0,resid.find(".xml"));
-            loadKeyValues(package,package+":"+res,&pending);
+            const int category = mLazyLoading ? getValuesCategory(res) : -1;
+            if(category >= VALUES_COUNT){/*localized strings,loaded by loadStrings(lan)*/
+                if(!mLanguage.empty() && TextUtils::endWith(res,"/strings-"+mLanguage+".xml"))
+                    mDeferredValues[VALUES_STRING].push_back({package,res});
+                deferred++;
+            }else if(category >= 0){
+                mDeferredValues[category].push_back({package,res});
+                deferred++;
+            }else{
+                LOGV("LoadKeyValues from:%s",res.c_str());
+                loadKeyValues(package,package+":"+res,&pending);
+            }
         }
         return 0;
     });
     if(name.compare("cdroid")==0)
         setTheme("cdroid:style/Theme.Material");
-    for(auto& c:pending.colors){
+    if(mImageAtlas && pak->hasEntry("atlas.lst",false)){
+        std::unique_ptr<std::istream>stm(pak->getInputStream("atlas.lst"));
+        if(stm) mImageAtlas->loadList(*stm,package);
+    }
+    resolvePendingValues(&pending);
+    invalidateStyleCache();
+    const size_t preloadCount = mColors.size()+mDimensions.size()+mStateColors.size()+mArraies.size()+mStyles.size()+mStrings.size();
+    LOGI("[%s] load %d assets from %d files(%d values files deferred) [%d id,%d colors,%d stateColors, %d array,%d style,%d string,%d dimens] mTheme.size=%d used %dms",
+         package.c_str(),preloadCount,count,deferred, mIDS.size(),mColors.size(),mStateColors.size(),mArraies.size(), mStyles.size(),
+         mStrings.size(),mDimensions.size(),mTheme.getAttributeCount(),int(SystemClock::uptimeMillis()-sttm));
+    return pak?0:-1;
+}
+
+void Assets::resolvePendingValues(void*params){
+    PENDINGRESOURCE*pending = (PENDINGRESOURCE*)params;
+    /*references into the deferred values must be resolved now,only their packages are loaded*/
+    for(auto& d:pending->dimens)
+        loadDeferredValues(VALUES_DIMEN,packageOf(d.second));
+    for(auto& c:pending->colors)
+        loadDeferredValues(VALUES_COLOR,packageOf(c.second));
+    for(auto& cs:pending->colorStateList)
+        loadDeferredValues(VALUES_COLOR,packageOf(cs.first));
+    for(auto& c:pending->colors){
         auto it = mColors.find(c.second);
         LOGD_IF(it==mColors.end(),"%s-->%s [X]",c.first.c_str(),c.second.c_str());
         if( it != mColors.end() ){
             mColors.insert({c.first,it->second});
         }
     }
-    for(auto& d:pending.dimens){
+    for(auto& d:pending->dimens){
         auto it = mDimensions.find(d.second);
         LOGD_IF(it==mDimensions.end(),"dimen %s losting refto %s",d.first.c_str(),d.second.c_str());
         if(it != mDimensions.end()){
             mDimensions.insert({d.first,it->second});
         }
     }
-    for(auto& cs:pending.colorStateList){
+    for(auto& cs:pending->colorStateList){
         auto cls = std::make_shared<ColorStateList>();
         for(auto& attr:cs.second){
             cls->addStateColor(this,attr);
         }
         mStateColors.insert({cs.first,cls});
     }
-    const size_t preloadCount = mColors.size()+mDimensions.size()+mStateColors.size()+mArraies.size()+mStyles.size()+mStrings.size();
-    LOGI("[%s] load %d assets from %d files [%d id,%d colors,%d stateColors, %d array,%d style,%d string,%d dimens] mTheme.size=%d used %dms",
-         package.c_str(),preloadCount,count, mIDS.size(),mColors.size(),mStateColors.size(),mArraies.size(), mStyles.size(),
-         mStrings.size(),mDimensions.size(),mTheme.getAttributeCount(),int(SystemClock::uptimeMillis()-sttm));
-    return pak?0:-1;
+}
+
+/*values/strings-zh.xml is only loaded for its language,other files are grouped by their name,
+ *files whose name doesn't tell the type(ids,attrs,config...) are always loaded at once*/
+int Assets::getValuesCategory(const std::string&res){
+    if(TextUtils::startWith(res,"color/"))
+        return VALUES_COLOR;
+    const size_t pos = res.find('/');
+    const std::string name = (pos==std::string::npos) ? res : res.substr(pos+1);
+    if(TextUtils::startWith(name,"strings-")) return VALUES_COUNT;
+    if(TextUtils::startWith(name,"string")) return VALUES_STRING;
+    if(TextUtils::startWith(name,"array")) return VALUES_ARRAY;
+    if(TextUtils::startWith(name,"style")||TextUtils::startWith(name,"theme")) return VALUES_STYLE;
+    if(TextUtils::startWith(name,"color")) return VALUES_COLOR;
+    if(TextUtils::startWith(name,"dimen")) return VALUES_DIMEN;
+    return -1;
+}
+
+std::string Assets::packageOf(const std::string&resid)const{
+    std::string pkg;
+    parseResource(resid,nullptr,&pkg);
+    return pkg;
+}
+
+/*loads the deferred files of the category in package(all packages when it is empty)*/
+bool Assets::loadDeferredValues(int category,const std::string&package)const{
+    static const char*categoryNames[] = {"strings","arrays","styles","colors","dimens"};
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    if(mDeferredValues[category].empty())
+        return false;
+    /*lookups are const,the deferred values are part of their logical state(guarded by mCacheLock)*/
+    Assets*self = const_cast<Assets*>(this);
+    std::vector<std::pair<std::string,std::string>>files;
+    auto& deferred = self->mDeferredValues[category];
+    auto it = std::stable_partition(deferred.begin(),deferred.end(),[&package](const std::pair<std::string,std::string>&f){
+        return !package.empty() && (f.first!=package);
+    });
+    if(it == deferred.end())
+        return false;
+    files.assign(it,deferred.end());
+    deferred.erase(it,deferred.end());
+    PENDINGRESOURCE pending;
+    const auto sttm = SystemClock::uptimeMillis();
+    for(auto& f:files){
+        self->loadKeyValues(f.first,f.first+":"+f.second,&pending);
+    }
+    self->resolvePendingValues(&pending);
+    if(category == VALUES_STYLE)
+        self->invalidateStyleCache();
+    LOGI("lazy load %d %s files of [%s] used %dms",int(files.size()),categoryNames[category],package.c_str(),int(SystemClock::uptimeMillis()-sttm));
+    return true;
+}
+
+/*files are grouped by name only,a values file may hold other types(colors_material.xml has dimens),
+ *so a resource missing in its group loads the other deferred files of its own package before giving up*/
+bool Assets::loadMissingValues(const std::string&fullname)const{
+    const std::string package = packageOf(fullname);
+    bool loaded = false;
+    if(package.empty())
+        return false;
+    for(int category = 0; category < VALUES_COUNT; category++){
+        if(loadDeferredValues(category,package))
+            loaded = true;
+    }
+    return loaded;
+}
+
+void Assets::setLazyLoading(bool lazy){
+    mLazyLoading = lazy;
+}
+
+bool Assets::isLazyLoading()const{
+    return mLazyLoading;
 }
 
 static bool guessExtension(ZIPArchive*pak,std::string&ioname) {
@@ -372,6 +475,9 @@ std::unique_ptr<std::istream> Assets::getInputStream(const std::string&fullresid
 
 void Assets::loadStrings(const std::string&lan) {
     const std::string suffix = "/strings-"+lan+".xml";
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_STRING);
+    mLanguage = lan;
     for(auto& a:mResources) {
         std::vector<std::string>files;
         a.second->getEntries(files);
@@ -415,6 +521,7 @@ int Assets::getNextAutofillId(){
 }
 
 const std::string Assets::getString(const std::string& resid,const std::string&lan) {
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
     if((!lan.empty())&&(mLanguage!=lan)) {
         loadStrings(lan);
     }
@@ -422,7 +529,10 @@ const std::string Assets::getString(const std::string& resid,const std::string&l
     std::string pkg,name = resid;
     parseResource(resid,&name,&pkg);
     name = AttributeSet::normalize(pkg,resid);
+    loadDeferredValues(VALUES_STRING,packageOf(name));
     auto itr = mStrings.find(name);
+    if((itr == mStrings.end()) && (name.find("string/")!=std::string::npos) && loadMissingValues(name))
+        itr = mStrings.find(name);
     if(itr != mStrings.end()) {
         str = itr->second;
     }
@@ -433,7 +543,11 @@ const std::string Assets::getString(const std::string& resid,const std::string&l
 size_t Assets::getArray(const std::string&resid,std::vector<int>&out) {
     std::string pkg,name = resid;
     std::string fullname = parseResource(resid,&name,&pkg);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_ARRAY,packageOf(fullname));
     auto it = mArraies.find(fullname);
+    if((it == mArraies.end()) && (fullname.find("array/")!=std::string::npos) && loadMissingValues(fullname))
+        it = mArraies.find(fullname);
     if(it != mArraies.end()) {
         for(auto itm:it->second)
            out.emplace_back(std::stoi(itm));
@@ -445,7 +559,11 @@ size_t Assets::getArray(const std::string&resid,std::vector<int>&out) {
 size_t Assets::getArray(const std::string&resid,std::vector<std::string>&out) {
     std::string pkg,name = resid;
     std::string fullname = parseResource(resid,&name,&pkg);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_ARRAY,packageOf(fullname));
     auto it = mArraies.find(fullname);
+    if((it == mArraies.end()) && (fullname.find("array/")!=std::string::npos) && loadMissingValues(fullname))
+        it = mArraies.find(fullname);
     if(it != mArraies.end()) {
         for(auto itm:it->second){
             itm = AttributeSet::normalize(pkg,itm);
@@ -466,6 +584,7 @@ size_t Assets::getArray(const std::string&resid,std::vector<std::string>&out) {
 
 
 Drawable* Assets::getDrawable(const std::string&resid) {
+    ATRACE_NAME("Assets::getDrawable");
     Drawable* d = nullptr;
     std::string resname,package,ext,fullresid;
     if(resid.empty()||(resid.compare("null")==0)) {
@@ -496,8 +615,15 @@ Drawable* Assets::getDrawable(const std::string&resid) {
         return d;
     }
     if(resname.find("color/")!=std::string::npos){
+        std::unique_lock<std::recursive_mutex> lock(mCacheLock);
+        loadDeferredValues(VALUES_COLOR,packageOf(fullresid));
         auto itc = mColors.find(fullresid);
         auto its = mStateColors.find(fullresid);
+        if((itc == mColors.end()) && (its == mStateColors.end()) && loadMissingValues(fullresid)){
+            itc = mColors.find(fullresid);
+            its = mStateColors.find(fullresid);
+        }
+        lock.unlock();
         if( itc != mColors.end() ){
             const uint32_t cc = (uint32_t)getColor(fullresid);
             LOGV("%s use colors as drawable",fullresid.c_str());
@@ -540,7 +666,11 @@ int Assets::getDimension(const std::string&refid)const{
     parseResource(name,nullptr,&pkg);
     name = resolveAttrValue(refid);
     //name = AttributeSet::normalize(pkg,name);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_DIMEN,packageOf(name));
     auto it = mDimensions.find(name);
+    if((it == mDimensions.end()) && (name.find("dimen/")!=std::string::npos) && loadMissingValues(name))
+        it = mDimensions.find(name);
     if(it != mDimensions.end()) 
         return GET_VARIANT(it->second,int);
     LOGW("Resource not found:%s",refid.c_str());
@@ -551,7 +681,11 @@ int Assets::getDimensionPixelSize(const std::string&refid,int def)const{
     std::string pkg,name = refid;
     parseResource(name,nullptr,&pkg);
     name = AttributeSet::normalize(pkg,name);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_DIMEN,packageOf(name));
     auto it = mDimensions.find(name);
+    if((it == mDimensions.end()) && (name.find("dimen/")!=std::string::npos) && loadMissingValues(name))
+        it = mDimensions.find(name);
     if(it != mDimensions.end()){
         return GET_VARIANT(it->second,int);
     }
@@ -567,7 +701,11 @@ float Assets::getFloat(const std::string&refid,float def)const{
     std::string pkg,name = refid;
     parseResource(name,nullptr,&pkg);
     name = AttributeSet::normalize(pkg,name);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_DIMEN,packageOf(name));
     auto it = mDimensions.find(name);
+    if((it == mDimensions.end()) && (name.find("dimen/")!=std::string::npos) && loadMissingValues(name))
+        it = mDimensions.find(name);
     if(it != mDimensions.end()){
         return GET_VARIANT(it->second,float);
     }
@@ -581,7 +719,11 @@ int Assets::getColor(const std::string&refid) {
     std::string pkg,relname,name = refid;
     parseResource(name,&relname,&pkg);
     name = AttributeSet::normalize(pkg,name);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_COLOR,packageOf(name));
     auto it = mColors.find(name);
+    if((it == mColors.end()) && (name.find("color/")!=std::string::npos) && loadMissingValues(name))
+        it = mColors.find(name);
     if(it != mColors.end()) {
         return it->second;
     } if(relname.compare(0,4,"attr")==0){
@@ -611,8 +753,14 @@ cdroid::RefPtr<ColorStateList> Assets::getColorStateList(const std::string&fullr
     std::string pkg,name = fullresid,relname;
     parseResource(name,&relname,&pkg);
     name = AttributeSet::normalize(pkg,name);
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    loadDeferredValues(VALUES_COLOR,packageOf(name));
     auto itc = mColors.find(name);
     auto its = mStateColors.find(name);
+    if((itc == mColors.end()) && (its == mStateColors.end()) && (name.find("color/")!=std::string::npos) && loadMissingValues(name)){
+        itc = mColors.find(name);
+        its = mStateColors.find(name);
+    }
     if( its != mStateColors.end())
         return its->second;
     else if(itc != mColors.end()){
@@ -657,11 +805,39 @@ cdroid::RefPtr<ColorStateList> Assets::getColorStateList(const std::string&fullr
 
 void Assets::clearStyles() {
     mStyles.clear();
+    invalidateStyleCache();
+}
+
+void Assets::invalidateStyleCache(){
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    LOGV("%d styles %d attrs dropped",mFlattenedStyles.size(),mResolvedAttrs.size());
+    mFlattenedStyles.clear();
+    mResolvedAttrs.clear();
+}
+
+void Assets::setImageAtlasEnabled(bool enabled){
+    if(enabled && (mImageAtlas == nullptr)){
+        mImageAtlas = std::make_unique<ImageAtlas>();
+        for(auto& r:mResources){
+            if(!r.second->hasEntry("atlas.lst",false))continue;
+            std::unique_ptr<std::istream>stm(r.second->getInputStream("atlas.lst"));
+            if(stm) mImageAtlas->loadList(*stm,r.first);
+        }
+    }else if(!enabled){
+        mImageAtlas = nullptr;
+    }
+}
+
+ImageAtlas* Assets::getImageAtlas(){
+    return mImageAtlas.get();
 }
 
 std::string Assets::resolveAttrValue(const std::string&attrResId)const{
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    auto cached = mResolvedAttrs.find(attrResId);
+    if(cached != mResolvedAttrs.end())
+        return cached->second;
     std::string name = attrResId;
-    AttributeSet atts;
     size_t pos = name.find("attr/");
     if(pos!=std::string::npos){
         do {
@@ -672,7 +848,6 @@ std::string Assets::resolveAttrValue(const std::string&attrResId)const{
                 name=name.substr(pos+1);
             key = name;
             name= mTheme.getString(key);
-            atts.add(key,name);
             if((pos=name.find('@'))!=std::string::npos)
                 name.erase(pos,1);
             pos = name.find("attr");
@@ -681,10 +856,22 @@ std::string Assets::resolveAttrValue(const std::string&attrResId)const{
     }
     if((pos=name.find("@"))!=std::string::npos)
         name.erase(pos,1);
+    mResolvedAttrs.insert({attrResId,name});
     return name;
 }
 
+/*returned attributes are shared with the cache,they are copied only when the caller modifies them*/
 AttributeSet Assets::obtainStyledAttributes(const std::string&resname) {
+    std::lock_guard<std::recursive_mutex> lock(mCacheLock);
+    auto it = mFlattenedStyles.find(resname);
+    if(it == mFlattenedStyles.end()){
+        AttributeSet atts = flattenStyle(resname);
+        it = mFlattenedStyles.insert({resname,atts}).first;
+    }
+    return AttributeSet(it->second,true);
+}
+
+AttributeSet Assets::flattenStyle(const std::string&resname) {
     AttributeSet atts;
     std::string pkg,name = resname;
     size_t pos = name.find("attr/");
@@ -707,6 +894,7 @@ AttributeSet Assets::obtainStyledAttributes(const std::string&resname) {
             name.erase(pos,1);
     }
     name = parseResource(name,nullptr,&pkg);
+    loadDeferredValues(VALUES_STYLE,pkg);
     auto it = mStyles.find(name);
     if(it != mStyles.end()){
         atts = it->second;
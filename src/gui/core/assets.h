@@ -20,15 +20,26 @@
 #include <memory>
 #include <string>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 #include <core/variant.h>
 #include <drawable/drawable.h>
+#include <drawable/imageatlas.h>
 
 namespace cdroid{
 
 class Assets:public Context{
 private:
+    enum{/*values files deferred in lazy mode,grouped by the type of resources they hold*/
+        VALUES_STRING,
+        VALUES_ARRAY,
+        VALUES_STYLE,
+        VALUES_COLOR,
+        VALUES_DIMEN,
+        VALUES_COUNT
+    };
     int mNextAutofillViewId;
+    bool mLazyLoading;
     std::string mLanguage;
     std::string mThemeName;
     AttributeSet mTheme;
@@ -38,13 +49,28 @@ private:
     std::unordered_map<std::string,std::weak_ptr<Drawable::ConstantState>>mDrawables;
     std::unordered_map<std::string,class ZIPArchive*>mResources;
     std::unordered_map<std::string,AttributeSet>mStyles;
+    /*styles with their parent chain flattened,valid for the current theme*/
+    std::unordered_map<std::string,AttributeSet>mFlattenedStyles;
+    mutable std::unordered_map<std::string,std::string>mResolvedAttrs;
+    /*guards the caches filled by lookups,AsyncLayoutInflater reaches them from its own thread*/
+    mutable std::recursive_mutex mCacheLock;
+    /*(package,file) of the values not parsed yet*/
+    std::vector<std::pair<std::string,std::string>>mDeferredValues[VALUES_COUNT];
     std::unordered_map<std::string,uint32_t>mColors;
     std::unordered_map<std::string,nonstd::variant<int,float>>mDimensions;
     std::unordered_map<std::string,std::shared_ptr<ColorStateList>>mStateColors;
+    std::unique_ptr<ImageAtlas>mImageAtlas;
     const std::string parseResource(const std::string&fullresid,std::string*res,std::string*ns)const;
     void parseItem(const std::string&package,const std::string&resid,const std::vector<std::string>&tag,std::vector<AttributeSet>atts,const std::string&value,void*);
     ZIPArchive*getResource(const std::string & fullresid, std::string* relativeResid,std::string*package)const;
     std::string resolveAttrValue(const std::string&name)const;
+    AttributeSet flattenStyle(const std::string&resname);
+    void invalidateStyleCache();
+    static int getValuesCategory(const std::string&res);
+    void resolvePendingValues(void*pending);
+    std::string packageOf(const std::string&resid)const;
+    bool loadDeferredValues(int category,const std::string&package=std::string())const;
+    bool loadMissingValues(const std::string&fullname)const;
 protected:
     std::string mName;
     DisplayMetrics mDisplayMetrics;
@@ -57,6 +83,8 @@ public:
     ~Assets()override;
     int loadStyles(const std::string&resid);
     void clearStyles();
+    void setLazyLoading(bool);
+    bool isLazyLoading()const;
     const std::string getPackageName()const override;
     const std::string getTheme()const override;
     void setTheme(const std::string&theme)override;
@@ -78,6 +106,8 @@ public:
     size_t getArray(const std::string&resid,std::vector<std::string>&)override;
     RefPtr<ColorStateList> getColorStateList(const std::string&resid)override;
     AttributeSet obtainStyledAttributes(const std::string&)override;
+    void setImageAtlasEnabled(bool);
+    ImageAtlas* getImageAtlas()override;
 };
 
 }//namespace
@@ -51,7 +51,25 @@ AttributeSet::AttributeSet(const AttributeSet&other):AttributeSet(other.mContext
     }
 }
 
+AttributeSet::AttributeSet(const AttributeSet&other,bool shared)
+    :mContext(other.mContext),mPackage(other.mPackage){
+    if(shared){
+        mAttrs = other.mAttrs;
+        mShared = other.mShared = true;
+    }else{
+        mAttrs = std::make_shared<std::unordered_map<std::string,std::string>>(*other.mAttrs);
+    }
+}
+
+void AttributeSet::detach(){
+    if(mShared){
+        mAttrs = std::make_shared<std::unordered_map<std::string,std::string>>(*mAttrs);
+        mShared = false;
+    }
+}
+
 AttributeSet& AttributeSet::operator =(const AttributeSet&other){
+    detach();
     mContext = other.mContext;
     mPackage = other.mPackage;
     for(auto& a:*other.mAttrs){
@@ -101,6 +119,7 @@ std::string AttributeSet::normalize(const std::string&pkg,const std::string&prop
 
 int AttributeSet::set(const char*atts[],int size){
     int rc = 0;
+    detach();
     for(int i = 0;atts[i]&&(size==0||i<size);i+=2,rc+=1){
         const char* key = strrchr(atts[i],' ');
         if(key) key++;
@@ -112,6 +131,7 @@ int AttributeSet::set(const char*atts[],int size){
 
 int AttributeSet::inherit(const AttributeSet&other){
     int inheritedCount = 0;
+    detach();
     const bool isSamePackage = (mPackage.compare(other.mPackage)==0);
     for(auto it = other.mAttrs->begin(); it != other.mAttrs->end() ; it++){
         if(mAttrs->find(it->first)==mAttrs->end()){
@@ -128,6 +148,7 @@ int AttributeSet::inherit(const AttributeSet&other){
 
 int AttributeSet::Override(const AttributeSet&other){
     int overrideCount = 0;
+    detach();
     const bool isSamePackage = (mPackage.compare(other.mPackage)==0);
     for(auto it = other.mAttrs->begin(); it != other.mAttrs->end() ; it++){
         auto thisIter = mAttrs->find(it->first);
@@ -150,6 +171,7 @@ int AttributeSet::Override(const AttributeSet&other){
 }
 
 bool AttributeSet::add(const std::string&key,const std::string&value){
+    detach();
     auto itr = mAttrs->find(key);
     std::string ks = key;
     size_t pos = ks.find(' ');
@@ -35,9 +35,15 @@ protected:
     std::string mPackage;
     Context*mContext;
     std::shared_ptr<std::unordered_map<std::string,std::string>>mAttrs;
+    /*mAttrs may be shared with other sets(or threads),copy before writing.
+     *both sides of a sharing are marked,use_count() is only a hint across threads*/
+    mutable bool mShared = false;
+    void detach();
 public:
     AttributeSet();
     AttributeSet(const AttributeSet&);
+    /*shared=true:shares the attributes with other,they are copied on the first modification*/
+    AttributeSet(const AttributeSet&,bool shared);
     AttributeSet(Context*ctx,const std::string&package);
     virtual ~AttributeSet()=default;
     Context*getContext()const;
@@ -71,6 +71,11 @@ public:
         return mFunctor.get() == b.mFunctor.get();
     }
 
+    /*identity shared by all copies,the key operator== compares*/
+    const void*getId()const{
+        return mFunctor.get();
+    }
+
     operator bool() const {
         return mFunctor && static_cast<bool>(*mFunctor);
     }
@@ -37,15 +37,34 @@ Canvas::Canvas(const RefPtr<Surface>& target)
     //mInvalidRgn=Region::create();
 }
 
-Canvas::Canvas(unsigned int width,unsigned int height):Context(nullptr,true){
+Canvas::Canvas(unsigned int width,unsigned int height,int format):Context(nullptr,true){
     uint8_t*buffer;
-    uint32_t pitch;
-    GFXCreateSurface(0,&mHandle,width,height,GPF_ARGB,false);
+    uint32_t pitch,sw,sh;
+    int32_t realFormat = format;
+    Surface::Format cairoFormat = toCairoFormat(format);
+    GFXCreateSurface(0,&mHandle,width,height,format,false);
     GFXLockSurface(mHandle,(void**)&buffer,&pitch);
-    RefPtr<Surface>surf=ImageSurface::create(buffer,Surface::Format::ARGB32,width,height,pitch);
+    GFXGetSurfaceInfo(mHandle,&sw,&sh,&realFormat);
+    if(cairoFormat!=Surface::Format::ARGB32){
+        /*RGB565 rows are 4 bytes aligned,only a 1 pixel wide surface can't be told
+         *apart from a 32bit one by pitch,there the reported format decides*/
+        const uint32_t narrowPitch = (width*2+3)&~3;
+        if( (realFormat!=format) || (pitch!=narrowPitch) ){
+            LOGD("surface format %d is not supported by driver,fallback to ARGB",format);
+            cairoFormat = Surface::Format::ARGB32;
+        }
+    }
+    RefPtr<Surface>surf=ImageSurface::create(buffer,cairoFormat,width,height,pitch);
     m_cobject=cairo_create(surf->cobj());
 }
 
+Surface::Format Canvas::toCairoFormat(int gfxFormat){
+    switch(gfxFormat){
+    case GPF_RGB565: return Surface::Format::RGB16_565;
+    default: return Surface::Format::ARGB32;
+    }
+}
+
 Canvas::~Canvas(){
     if(mHandle)
         GFXDestroySurface(mHandle);
@@ -35,8 +35,9 @@ protected:
     friend class WindowManager;
 public:
     Canvas(const Cairo::RefPtr<Cairo::Surface>&target);
-    Canvas(unsigned int width,unsigned int height);
+    Canvas(unsigned int width,unsigned int height,int format=GPF_ARGB);
     ~Canvas();
+    static Cairo::Surface::Format toCairoFormat(int gfxFormat);
     void*getHandler()const;
     void get_text_size(const std::string&txt,int*w,int*h); 
     void draw_text(const Rect&rect,const std::string&text,int text_alignment=0);
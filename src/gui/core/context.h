@@ -32,6 +32,7 @@
 namespace cdroid{
 class Drawable;
 class ColorStateList;
+class ImageAtlas;
 class Context{
 public:
     virtual ~Context() = default;
@@ -63,6 +64,8 @@ public:
     virtual size_t getArray(const std::string&resname,std::vector<int>&) = 0;
     virtual RefPtr<ColorStateList> getColorStateList(const std::string&resid) = 0;
     virtual AttributeSet obtainStyledAttributes(const std::string&resid) = 0;
+    /*shared atlas for small bitmaps,nullptr if atlas is disabled*/
+    virtual ImageAtlas* getImageAtlas() { return nullptr; }
 };
 
 }
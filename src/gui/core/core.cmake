@@ -15,10 +15,12 @@ SET(CORE_SOURCES
     core/graphdevice.cc
     core/handler.cc
     core/inputdevice.cc
+    core/inputlatencytracker.cc
     #core/virtualinputdevice.cc
     core/inputeventsource.cc
     core/inputmethod.cc
     core/inputmethodmanager.cc
+    core/inputrecorder.cc
     core/insets.cc
     core/intent.cc
     core/uri.cc
@@ -39,6 +41,7 @@ SET(CORE_SOURCES
     core/scheduler.cc
     core/systemclock.cc
     core/tokenizer.cc
+    core/trace.cc
     core/xmlpullparser.cc
     core/typedvalue.cc
     core/typeface.cc
@@ -27,13 +27,16 @@
 #include <cairomm/fontface.h>
 #include <image-decoders/imagedecoder.h>
 #include <windowmanager.h>
+#include <inputlatencytracker.h>
 #include <systemclock.h>
+#include <trace.h>
 #include <thread>
 #if defined(__linux__)||defined(__unix__)
 #include <sys/resource.h>
 #endif
 #include <malloc.h>
 #include <fstream>
+#include <sstream>
 #include <mutex>
 using namespace Cairo;
 
@@ -50,6 +53,7 @@ GraphDevice&GraphDevice::getInstance(){
 
 GraphDevice::GraphDevice(){
     mFormat  = GPF_ARGB;
+    mOpaqueFormat = GPF_ARGB;
     mRotation= 0;
     mShowFPS = false;
     LOGD("GraphDevice %p",this);
@@ -60,6 +64,15 @@ GraphDevice& GraphDevice::setFormat(int format){
     return *this;
 }
 
+GraphDevice& GraphDevice::setOpaqueFormat(int format){
+    mOpaqueFormat = format<0?GPF_ARGB:format;
+    return *this;
+}
+
+int GraphDevice::getOpaqueFormat()const{
+    return mOpaqueFormat;
+}
+
 GraphDevice& GraphDevice::setLogo(const std::string&logo){
     mLogo = logo;
     return *this;
@@ -200,6 +213,12 @@ void GraphDevice::trackFPS(Canvas& canvas) {
             mFpsStartTime = nowTime;
             mFpsNumFrames = 0;
        	    mFPSText = buffer;
+            InputLatencyTracker& latency = InputLatencyTracker::getInstance();
+            if(latency.isEnabled()){
+                std::ostringstream oss;
+                latency.dump(oss);
+                LOGI("%s %s",buffer,oss.str().c_str());
+            }
         }
     }
     canvas.save();
@@ -320,6 +339,7 @@ void GraphDevice::rotateRectInWindow(const Rect&rcw,const Rect&rs,Rect&rd,int&dx
 }
 
 void GraphDevice::composeSurfaces(){
+    ATRACE_NAME("GraphDevice::composeSurfaces");
     const int rotation = WindowManager::getInstance().getDefaultDisplay().getRotation();
     std::vector<Rect> wBounds;
     std::vector<Window*> wins;
@@ -384,7 +404,13 @@ void GraphDevice::composeSurfaces(){
         }
         rgn->subtract(rgn);
     }/*endif for wSurfaces.size*/
-    if(commitedRects)GFXFlip(mPrimarySurface);
+    ATRACE_INT("composedRects",commitedRects);
+    if(commitedRects){
+        ATRACE_BEGIN("GFXFlip");
+        GFXFlip(mPrimarySurface);
+        ATRACE_END();
+        InputLatencyTracker::getInstance().onFrameFlipped();
+    }
     mLastComposeTime = SystemClock::uptimeMillis();
     mPendingCompose = 0;
 }
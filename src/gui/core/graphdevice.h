@@ -33,6 +33,7 @@ private:
     int mScreenWidth;
     int mScreenHeight;
     int mFormat;
+    int mOpaqueFormat;
     int mComposing;
     int mPendingCompose;
     int mRotation;
@@ -59,6 +60,9 @@ public:
     static GraphDevice&getInstance();
     ~GraphDevice();
     GraphDevice& setFormat(int format);
+    /*surface format used by opaque windows,GPF_RGB565 halves the memory and compose bandwidth*/
+    GraphDevice& setOpaqueFormat(int format);
+    int getOpaqueFormat()const;
     GraphDevice& setLogo(const std::string&);
     GraphDevice& setRotation(int rotation);
     GraphDevice& showFPS(bool);
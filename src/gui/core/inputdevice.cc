@@ -49,6 +49,16 @@
 
 namespace cdroid{
 
+/*kernel timestamp of the raw event,kept on the InputEvent for latency tracking*/
+static inline nsecs_t toHardwareTime(long sec,long usec){
+    return nsecs_t(sec)*1000000000LL + nsecs_t(usec)*1000LL;
+}
+
+/*event and down times are in ms on every device,as MotionEvents are*/
+static inline nsecs_t toEventTime(long sec,long usec){
+    return nsecs_t(sec)*1000LL + usec/1000;
+}
+
 InputDeviceSensorInfo::InputDeviceSensorInfo(const std::string& name,const std::string& vendor, int32_t version,
     InputDeviceSensorType type, InputDeviceSensorAccuracy accuracy, float maxRange, float resolution,
     float power, int32_t minDelay,int32_t fifoReservedEventCount, int32_t fifoMaxEventCount,
@@ -377,6 +387,7 @@ KeyDevice::KeyDevice(int32_t fd)
    msckey = 0;
    mLastDownKey = -1;
    mRepeatCount = 0;
+   mDownTime = 0;
    mDeviceInfo.addSource(SOURCE_KEYBOARD);
 }
 
@@ -385,9 +396,10 @@ int32_t KeyDevice::isValidEvent(int32_t type,int32_t code,int32_t value){
         (type==EV_REP)||(type==EV_SYN);
 }
 
-int32_t KeyDevice::putEvent(long sec,long nsec,int32_t type,int32_t code,int32_t value){
+int32_t KeyDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32_t value){
     int flags  = 0;
     int keyCode= code;
+    const nsecs_t eventTime = toEventTime(sec,usec);
     if(!isValidEvent(type,code,value)){
          LOGD("invalid event type %x source=%x",type,mDeviceInfo.getSources());
          return -1;
@@ -405,6 +417,8 @@ int32_t KeyDevice::putEvent(long sec,long nsec,int32_t type,int32_t code,int32_t
         case 1://key down
             if(mLastDownKey==keyCode)
                 mRepeatCount ++;
+            else
+                mDownTime = eventTime;
             mLastDownKey = keyCode;
             break;
         default://2:key repeat
@@ -412,7 +426,8 @@ int32_t KeyDevice::putEvent(long sec,long nsec,int32_t type,int32_t code,int32_t
         }
 
         mEvent.initialize(getId(),getSources(),mDisplayId,(value?KeyEvent::ACTION_DOWN:KeyEvent::ACTION_UP)/*action*/,flags,
-              keyCode,code/*scancode*/,0/*metaState*/,mRepeatCount, mDownTime,SystemClock::uptimeMicros()/*eventtime*/);
+              keyCode,code/*scancode*/,0/*metaState*/,mRepeatCount, mDownTime,eventTime);
+        mEvent.setHardwareTimeNanos(toHardwareTime(sec,usec));
         LOGV("fd[%d] keycode:%08x->%04x[%s] action=%d flags=%d",getId(),code,keyCode, KeyEvent::keyCodeToString(keyCode).c_str(),value,flags);
         mEvents.push_back(KeyEvent::obtain(mEvent));
         break;
@@ -768,6 +783,7 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
                     (value?KeyEvent::ACTION_DOWN:KeyEvent::ACTION_UP)/*action*/, code/*KeyCode*/,0/*repeat*/,
                     0/*metaState*/,getId()/*deviceId*/,code/*scancode*/,0/*flags*/,getSources(),0/*displayid*/);
                 LOGD("RECV KEY %d %s",code,(value?"down":"up"));
+                keyEvent->setHardwareTimeNanos(toHardwareTime(sec,usec));
                 mEvents.push_back(keyEvent);
             }
         }break;
@@ -804,11 +820,13 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
         if( code == SYN_MT_REPORT ) break;
         action = getActionByBits(pointerIndex);
         mMoveTime = (sec * 1000LL + usec/1000);
-        lastEvent = (mEvents.size() > 1) ? (MotionEvent*)mEvents.back() : nullptr;
+        lastEvent = mEvents.size() ? dynamic_cast<MotionEvent*>(mEvents.back()) : nullptr;
         pointerCount = (mCorrectedDeviceClasses&INPUT_DEVICE_CLASS_TOUCH_MT) ? std::max(mLastBits.count(),mCurrBits.count()) : 1;
         if(pointerCount==0)break;/*pointerCount==0 is KeyEvent!*/
-        if(lastEvent && (lastEvent->getActionMasked() == MotionEvent::ACTION_MOVE) && (action == MotionEvent::ACTION_MOVE) && (mMoveTime - lastEvent->getDownTime()<100)){
-            auto lastTime = lastEvent->getDownTime();
+        if(lastEvent && (lastEvent->getActionMasked() == MotionEvent::ACTION_MOVE) && (action == MotionEvent::ACTION_MOVE)
+                && (lastEvent->getPointerCount() == (size_t)pointerCount)){
+            /*moves not drained yet are batched as history of the pending event*/
+            auto lastTime = lastEvent->getEventTime();
             lastEvent->addSample(mMoveTime,mPointerCoords.data());
             LOGV("eventdur=%d %s",int(mMoveTime-lastTime),printEvent(lastEvent).c_str());
         }else {
@@ -820,6 +838,7 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
                 if(mVirtualScanCode){
                     KeyEvent*k = KeyEvent::obtain(mMoveTime,mMoveTime,KeyEvent::ACTION_UP,mVirtualKeyCode,0/*repeat*/,0/*metaState*/,
                         getId()/*deviceId*/,mVirtualScanCode,0/*flags*/,getSources(),mDisplayId);
+                    k->setHardwareTimeNanos(toHardwareTime(sec,usec));
                     mEvents.push_back(k);
                     k->recycle();
                     LOGD("mVirtualKey=%d/%d ACTION_UP",mVirtualScanCode,mVirtualKeyCode);
@@ -831,6 +850,7 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
                     }
                     KeyEvent*k = KeyEvent::obtain(mDownTime,mMoveTime,KeyEvent::ACTION_DOWN,mVirtualKeyCode,0/*repeat*/,0/*metaState*/,
                         getId()/*deviceId*/,mVirtualScanCode,0/*flags*/,getSources(),mDisplayId);
+                    k->setHardwareTimeNanos(toHardwareTime(sec,usec));
                     mEvents.push_back(k);
                     k->recycle();
                     LOGD("mVirtualKey=%d/%d ACTION_DOWN %p",mVirtualScanCode,mVirtualKeyCode,k);
@@ -843,6 +863,7 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
                      mCoord.getX(),mCoord.getY(),printEvent(mEvent).c_str());
                 mEvent->setActionButton(mActionButton);
                 mEvent->setAction(action|(pointerIndex<<MotionEvent::ACTION_POINTER_INDEX_SHIFT));
+                mEvent->setHardwareTimeNanos(toHardwareTime(sec,usec));
 
                 MotionEvent*e = MotionEvent::obtain(*mEvent);
                 mEvents.push_back(e);
@@ -851,6 +872,7 @@ int32_t TouchDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
             if((action==MotionEvent::ACTION_UP)&&mVirtualScanCode){
                 KeyEvent*k=KeyEvent::obtain(mDownTime,mMoveTime,KeyEvent::ACTION_UP,mVirtualKeyCode,0/*repeat*/,0/*metaState*/,
                         getId()/*deviceId*/,mVirtualScanCode,0/*flags*/,getSources(),mDisplayId);
+                k->setHardwareTimeNanos(toHardwareTime(sec,usec));
                 mEvents.push_back(k);
                 k->recycle();
                 LOGD("mVirtualKey=%d/%d ACTION_UP %p",mVirtualKeyCode,mVirtualKeyCode,k);
@@ -1144,6 +1166,7 @@ int32_t MouseDevice::putEvent(long sec,long usec,int32_t type,int32_t code,int32
                 LOGV_IF(mPendingAction != MotionEvent::ACTION_MOVE,"(%.f,%.f)\n%s", mPointerCoord.getX(),mPointerCoord.getY(),printEvent(mEvent).c_str());
                 mEvent->setActionButton(mActionButton);
                 mEvent->setAction(mPendingAction);
+                mEvent->setHardwareTimeNanos(toHardwareTime(sec,usec));
 
                 MotionEvent*e = MotionEvent::obtain(*mEvent);
                 mEvents.push_back(e);
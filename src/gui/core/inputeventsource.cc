@@ -18,6 +18,7 @@
 #include <core/inputeventsource.h>
 #include <core/windowmanager.h>
 #include <core/systemclock.h>
+#include <view/choreographer.h>
 #include <porting/cdlog.h>
 #include <unordered_map>
 #include <gui_features.h>
@@ -32,15 +33,37 @@
 #endif
 
 namespace cdroid{
-InputEventSource::InputEventSource(){
+InputEventSource::InputEventSource():mRawEvents(1024){
     LOGD("InputEventSource %p",this);
     mScreenSaveTimeOut = -1;
     mRunning = false;
     mInited = false;
-    mIsPlayback = false;
     mIsScreenSaveActived = false;
-    mLastPlaybackEventTime = SystemClock::uptimeMillis();
-    mLastInputEventTime = mLastPlaybackEventTime;
+    mLastInputEventTime = SystemClock::uptimeMillis();
+    mBatchScheduled = false;
+    mResampleTouch = false;
+    mConsumeBatchedInput = [this](){
+        consumeBatchedInput();
+    };
+    setReadinessDriven(true);
+}
+
+void InputEventSource::putRawEvents(const INPUTEVENT*es,int count){
+    std::lock_guard<std::recursive_mutex> lock(mtxEvents);
+    if(count)mLastInputEventTime = SystemClock::uptimeMillis();
+    for(int i = 0 ; i < count ; i ++){
+        const INPUTEVENT*e = es+i;
+        if(e->type >= EV_ADD){
+            onDeviceChanged(e);
+            continue;
+        }
+        auto it = mDevices.find(e->device);
+        if(it==mDevices.end()){
+            getDevice(e->device)->putEvent(e->tv_sec,e->tv_usec,e->type,e->code,e->value);
+            continue;
+        }
+        it->second->putEvent(e->tv_sec,e->tv_usec,e->type,e->code,e->value);
+    }
 }
 
 void InputEventSource::doEventsConsume(){
@@ -55,29 +78,54 @@ void InputEventSource::doEventsConsume(){
     InputInit();
     while(mRunning){
         const int count = InputGetEvents(es,sizeof(es)/sizeof(INPUTEVENT),20);
-        std::lock_guard<std::recursive_mutex> lock(mtxEvents);
-        if(count)mLastInputEventTime = SystemClock::uptimeMillis();
-        for(int i = 0 ; i < count ; i ++){
-            const INPUTEVENT*e = es+i;
-            auto it = mDevices.find(e->device);
-            if(es[i].type >= EV_ADD){
-                onDeviceChanged(es+i);
-                continue;
-            }
-            if(it==mDevices.end()){
-                getDevice(es->device)->putEvent(e->tv_sec,e->tv_usec,e->type,e->code,e->value);
-                continue;
-            }
-            it->second->putEvent(e->tv_sec,e->tv_usec,e->type,e->code,e->value);
+        /*devices are only touched by the main looper,which drains the queue in checkEvents*/
+        for(int i = 0;i < count;i++)
+            mRawEvents.put(es[i]);
+        if(count)signalReady();
+    }
+}
+
+void InputEventSource::drainRawEvents(){
+    INPUTEVENT es[64];
+    int count;
+    do{
+        for(count = 0;(count < int(sizeof(es)/sizeof(INPUTEVENT))) && mRawEvents.try_take(es[count]);count++);
+        if(count)putRawEvents(es,count);
+    }while(count == sizeof(es)/sizeof(INPUTEVENT));
+}
+
+int InputEventSource::inputFdCallback(int fd,int events,void*data){
+    InputEventSource*thiz = (InputEventSource*)data;
+    Looper*looper = Looper::getMainLooper();
+    INPUTEVENT es[64];
+    int count;
+    do{
+        count = InputReadEvents(fd,es,sizeof(es)/sizeof(INPUTEVENT));
+        for(int i = 0;i < count;i++){
+            if(es[i].type == EV_ADD)
+                looper->addFd(es[i].device,0,Looper::EVENT_INPUT,inputFdCallback,thiz);
+            else if(es[i].type == EV_REMOVE)
+                looper->removeFd(es[i].device);
         }
+        if(count > 0)thiz->putRawEvents(es,count);
+    }while(count == sizeof(es)/sizeof(INPUTEVENT));
+    /*dispatch on this loop iteration,no need to wait for the handler's turn*/
+    if(thiz->checkEvents() > 0)
+        thiz->handleEvents();
+    if( (count < 0) || (events & (Looper::EVENT_ERROR|Looper::EVENT_HANGUP)) ){
+        LOGI("input fd %d is gone,events=%x",fd,events);
+        return 0;/*unregistered by the looper*/
     }
+    return 1;
 }
 
 InputEventSource::~InputEventSource(){
     mRunning = false;
     Looper::getMainLooper()->removeEventHandler(this);
-    if(frecord.is_open())
-       frecord.close();
+    Choreographer::getInstance().removeCallbacks(Choreographer::CALLBACK_INPUT,&mConsumeBatchedInput,nullptr);
+    for(MotionEvent*m:mBatchedMotions)m->recycle();
+    mPlayer = nullptr;
+    mRecorder.close();
     LOGD("%p Destroied",this);
 }
 
@@ -114,6 +162,7 @@ void InputEventSource::setScreenSaver(ScreenSaver func,int timeout){
     if(mScreenSaver)mScreenSaver(false);
     mScreenSaver = func;
     mScreenSaveTimeOut = timeout;
+    signalReady();/*rearm the screensaver timeout*/
 }
 
 std::shared_ptr<InputDevice>InputEventSource::getDevice(int fd){
@@ -147,10 +196,15 @@ bool InputEventSource::needCancel(InputDevice*dev){
     dev->getLastEvent(action,etime,&pos);
     TouchDevice*tdev= dynamic_cast<TouchDevice*>(dev);
     const int edges = tdev ? tdev->checkPointEdges(pos):0;
-    if( (action == MotionEvent::ACTION_MOVE) && (now - etime>500) && (tdev != nullptr) && edges){
-        MotionEvent*e = MotionEvent::obtain(now, now, MotionEvent::ACTION_CANCEL, 0, 0, 0);
-        e->setSource(InputDevice::SOURCE_TOUCHSCREEN);
-        dev->pushEvent(e);
+    if( (action == MotionEvent::ACTION_MOVE) && (tdev != nullptr) && edges){
+        if(now - etime>500){
+            MotionEvent*e = MotionEvent::obtain(now, now, MotionEvent::ACTION_CANCEL, 0, 0, 0);
+            e->setSource(InputDevice::SOURCE_TOUCHSCREEN);
+            dev->pushEvent(e);
+            signalReady();
+            return true;
+        }
+        signalReadyAt(etime + 501);/*check again when the move is stale*/
     }
     return false;
 }
@@ -173,17 +227,28 @@ void setThreadAffinity(std::thread& t, int coreId) {
 
 int InputEventSource::checkEvents(){
     if(!mInited){
-        const auto numCore = std::thread::hardware_concurrency();
-        auto coreId= sched_getcpu();
-        auto func = std::bind(&InputEventSource::doEventsConsume,this);
-        std::thread th(func);
-        if(numCore>1){
-            setThreadAffinity(th,coreId-1>=0?coreId-1:coreId+1);
+        int fds[32];
+        InputInit();
+        const int numFds = InputGetDeviceFds(fds,sizeof(fds)/sizeof(fds[0]));
+        if(numFds > 0){
+            /*devices are read by the main looper directly*/
+            for(int i = 0;i < numFds;i++)
+                Looper::getMainLooper()->addFd(fds[i],0,Looper::EVENT_INPUT,inputFdCallback,this);
+            LOGI("%d input fds are polled by the main looper",numFds);
+        }else{
+            const auto numCore = std::thread::hardware_concurrency();
+            auto coreId= sched_getcpu();
+            auto func = std::bind(&InputEventSource::doEventsConsume,this);
+            std::thread th(func);
+            if(numCore>1){
+                setThreadAffinity(th,coreId-1>=0?coreId-1:coreId+1);
+            }
+            th.detach();
+            LOGI("MainLoop on %d/%d",coreId,numCore);
         }
-        th.detach();
-        LOGI("MainLoop on %d/%d",coreId,numCore);
         mInited = true;
     }
+    drainRawEvents();
     std::lock_guard<std::recursive_mutex> lock(mtxEvents);
     const nsecs_t now = SystemClock::uptimeMillis();
     int count = 0;
@@ -205,6 +270,9 @@ int InputEventSource::checkEvents(){
         mIsScreenSaveActived= false;
         mLastInputEventTime = now;
     }
+    if( (mScreenSaveTimeOut>0) && (mIsScreenSaveActived == false) && mScreenSaver){
+        signalReadyAt(mLastInputEventTime + mScreenSaveTimeOut + 1);
+    }
     return count;
 }
 
@@ -219,6 +287,7 @@ void InputEventSource::closeScreenSaver(){
         if(mScreenSaver)mScreenSaver(false);
     }
     mLastInputEventTime = SystemClock::uptimeMillis();
+    signalReady();
 }
 
 bool InputEventSource::isScreenSaverActived()const{
@@ -228,100 +297,122 @@ bool InputEventSource::isScreenSaverActived()const{
 int InputEventSource::handleEvents(){
     int ret = 0;
     std::vector<InputEvent*>events;
-    WindowManager& wm = WindowManager::getInstance();
     std::lock_guard<std::recursive_mutex> lock(mtxEvents);
     for(auto it:mDevices){
         const auto eventCount = it.second->drainEvents(events);
         if(eventCount==0) continue;
         ret += eventCount;
-        std::for_each(events.begin(),events.end(),[&wm](InputEvent*e){
-            wm.processEvent(*e);
+        for(InputEvent*e:events){
+            MotionEvent*m = dynamic_cast<MotionEvent*>(e);
+            if(m && (m->getActionMasked()==MotionEvent::ACTION_MOVE) && m->isFromSource(InputDevice::SOURCE_CLASS_POINTER)){
+                batchMotion(m);
+                continue;
+            }
+            flushBatchedMotions();/*keep the events in order*/
+            dispatchEvent(*e);
             e->recycle();
-        });
+        }
     }
     return ret;
 }
 
-void InputEventSource::sendEvent(InputEvent&event){
-    WindowManager::getInstance().processEvent(event);
+/*moves are dispatched once per frame from the choreographer's input phase,
+ *samples arriving in between are appended to the pending event as history*/
+void InputEventSource::batchMotion(MotionEvent*m){
+    for(auto it = mBatchedMotions.begin();it != mBatchedMotions.end();it++){
+        if((*it)->getDeviceId() != m->getDeviceId())continue;
+        if((*it)->addBatch(*m)){
+            m->recycle();
+            return;
+        }
+        dispatchEvent(**it);
+        (*it)->recycle();
+        *it = m;
+        return;
+    }
+    mBatchedMotions.push_back(m);
+    if(!mBatchScheduled){
+        mBatchScheduled = true;
+        Choreographer::getInstance().postCallback(Choreographer::CALLBACK_INPUT,mConsumeBatchedInput,nullptr);
+    }
 }
 
-void InputEventSource::recordEvent(InputEvent&inputEvent){
-    std::ostringstream oss;
-    const int type = inputEvent.getType();
-    //MotionEvent::ACTION_DOWN==KeyEvent::ACTION_DOWN,MotionEvent::ACTION_UP==KeyEvent::ACTION_UP,
-    //So MotionEvent::ACTION_DOWN/UP must be mapped from 0,1 ... -> 4,5 ... to make them diffrent
-    if(type==InputEvent::INPUT_EVENT_TYPE_MOTION){
-        MotionEvent& m = (MotionEvent&)inputEvent;
-        if(m.getPointerCount())
-            oss << m.getActionIndex()<<",";
-        oss<<(4 + m.getAction())<<","<<m.getX(0)<<","<<m.getY()<<","<<m.getEventTime()<<std::endl;
-    }else if(type==InputEvent::INPUT_EVENT_TYPE_KEY){
-        KeyEvent& k = (KeyEvent&)inputEvent;
-        oss<<k.getAction()<<","<<KeyEvent::keyCodeToString(k.getKeyCode())<<","<<k.getEventTime()<<std::endl;
+void InputEventSource::flushBatchedMotions(){
+    std::vector<MotionEvent*>motions;
+    motions.swap(mBatchedMotions);
+    for(MotionEvent*m:motions){
+        dispatchEvent(*m);
+        m->recycle();
     }
 }
 
-InputEvent*InputEventSource::parseEvent(const char*line){
-    const char*tokens[16]={0};
-    const char*p = line;
-    int tokenCount = 0;
-    while( p && ( tokenCount < sizeof(tokens)/sizeof(tokens[0]) )){
-        tokens[tokenCount++] = p;
-        p = strchr(p+1,',');
+void InputEventSource::consumeBatchedInput(){
+    std::lock_guard<std::recursive_mutex> lock(mtxEvents);
+    mBatchScheduled = false;
+    if(mResampleTouch){
+        const nsecs_t frameTime = Choreographer::getInstance().getFrameTime();
+        for(MotionEvent*m:mBatchedMotions)
+            resampleMotion(*m,frameTime - RESAMPLE_LATENCY);
     }
-    if(tokenCount<4){/*KeyEvent*/
-        const int keyCode = atoi(tokens[1]);
-        const nsecs_t etime = atoi(tokens[2]);
-        const int action = atoi(line);
-        KeyEvent* k = KeyEvent::obtain(etime,etime,action,keyCode,
-            0/*repeat*/, 0/*metaState*/, 0/*deviceId*/, keyCode/*scancode*/,
-            0/*flags*/, 0/*source*/,0/*displayid*/);
-        return k;
-    }else {/*(tokenCount>=4)MotionEvent*/
-        const int tkIdx = tokenCount>4?1:0;
-        const int pointer =(tokenCount>4) ? atoi(tokens[0]) : 0;
-        const int action = atoi(tokens[tkIdx]);
-        const int x = atoi(tokens[tkIdx+1]);
-        const int y = atoi(tokens[tkIdx+2]);
-        const nsecs_t etime = atoll(tokens[tkIdx+3]);
-        MotionEvent*m = MotionEvent::obtain(etime,etime,
-            action|(pointer<<MotionEvent::ACTION_POINTER_INDEX_SHIFT),
-            float(x),float(y), 0/*pressure*/, 0/*size*/, 0/*metaState*/,
-            0,0/*x/yPrecision*/,0/*deviceId*/,0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*displayId*/);
-        return m;
+    flushBatchedMotions();
+}
+
+/*extrapolates the two newest samples to sampleTime,the same limits as android's InputConsumer*/
+void InputEventSource::resampleMotion(MotionEvent&m,nsecs_t sampleTime){
+    const size_t historySize = m.getHistorySize();
+    if(historySize == 0)return;
+    const nsecs_t t1 = m.getEventTime();
+    const nsecs_t t0 = m.getHistoricalEventTime(historySize - 1);
+    const nsecs_t delta = t1 - t0;
+    if((delta < RESAMPLE_MIN_DELTA) || (delta > RESAMPLE_MAX_DELTA) || (sampleTime <= t1))
+        return;
+    sampleTime = std::min(sampleTime,t1 + std::min(delta/2,RESAMPLE_MAX_PREDICTION));
+    if(sampleTime <= t1)return;
+    const float alpha = float(sampleTime - t1)/delta;
+    const size_t pointerCount = m.getPointerCount();
+    std::vector<PointerCoords>coords(pointerCount);
+    for(size_t i = 0;i < pointerCount;i++){
+        PointerCoords c0;
+        m.getHistoricalPointerCoords(i,historySize - 1,c0);
+        m.getPointerCoords(i,coords[i]);
+        const float x = coords[i].getX(),y = coords[i].getY();
+        coords[i].setAxisValue(MotionEvent::AXIS_X,x + (x - c0.getX())*alpha);
+        coords[i].setAxisValue(MotionEvent::AXIS_Y,y + (y - c0.getY())*alpha);
     }
-    return nullptr;
+    m.addSample(sampleTime,coords.data());
+}
+
+void InputEventSource::setResampleTouch(bool resample){
+    mResampleTouch = resample;
+}
+
+void InputEventSource::sendEvent(InputEvent&event){
+    WindowManager::getInstance().processEvent(event);
+}
+
+void InputEventSource::dispatchEvent(InputEvent&event){
+    if(mRecorder.isOpen())
+        mRecorder.write(event);
+    WindowManager::getInstance().processEvent(event);
 }
 
 void InputEventSource::record(const std::string&fname){
-    frecord.open(fname);
+    mRecorder.open(fname);
 }
 
-void InputEventSource::playback(const std::string&fname){
-    auto func = [this](const std::string&fname){
-         std::fstream in(fname);
-         std::this_thread::sleep_for(std::chrono::milliseconds(10000));
-         LOGD_IF(in.good(),"play key from %s",fname.c_str());
-         if(!in.good())return ;
-         mIsPlayback = true;
-         while(1){
-             char line[256] = { 0 };
-             in.getline(line,255);
-             InputEvent*e = parseEvent(line);
-             if(e){
-                 e->recycle();
-             }
-             if(in.gcount() == 0){
-                 in.close();
-                 in.open(fname);
-             }
-         }
-    };
-    if(!fname.empty()){
-        std::thread th(func,fname);
-        th.detach();
+void InputEventSource::playback(const std::string&fname,float speed,int delay){
+    if(mPlayer == nullptr){
+        mPlayer.reset(new InputEventPlayer([this](InputEvent&e){
+            mLastInputEventTime = SystemClock::uptimeMillis();
+            WindowManager::getInstance().processEvent(e);
+        }));
     }
+    if(mPlayer->load(fname))
+        mPlayer->start(speed,delay);
+}
+
+void InputEventSource::stopPlayback(){
+    if(mPlayer)mPlayer->stop();
 }
 }//end namespace
 
@@ -19,10 +19,13 @@
 #define __INPUT_EVENT_SOURCE_H__
 #include <cdinput.h>
 #include <queue>
+#include <vector>
 #include <string>
-#include <fstream>
+#include <memory>
 #include <core/looper.h>
 #include <core/inputdevice.h>
+#include <core/inputrecorder.h>
+#include <utils/lockfreequeue.h>
 #include <unordered_map>
 #include <mutex>
 
@@ -37,21 +40,35 @@ private:
     int mScreenSaveTimeOut;
     bool mInited;
     bool mRunning;
-    bool mIsPlayback;
     bool mIsScreenSaveActived;
-    nsecs_t mLastPlaybackEventTime;/*for event record and playback*/
     nsecs_t mLastInputEventTime;/*for screensaver*/
-    std::ofstream frecord;
+    InputEventRecorder mRecorder;
+    std::unique_ptr<InputEventPlayer>mPlayer;
     std::unordered_map<int,std::shared_ptr<InputDevice>>mDevices;
+    SPSCQueue<INPUTEVENT>mRawEvents;/*from the InputThread of platforms without pollable fds*/
+    std::vector<MotionEvent*>mBatchedMotions;
+    Runnable mConsumeBatchedInput;
+    bool mBatchScheduled;
+    bool mResampleTouch;
+    static constexpr nsecs_t RESAMPLE_LATENCY = 5;/*ms*/
+    static constexpr nsecs_t RESAMPLE_MIN_DELTA = 2;
+    static constexpr nsecs_t RESAMPLE_MAX_DELTA = 20;
+    static constexpr nsecs_t RESAMPLE_MAX_PREDICTION = 8;
 private:
     std::shared_ptr<InputDevice>getDevice(int fd);
+    void putRawEvents(const INPUTEVENT*es,int count);
+    void drainRawEvents();
+    void flushBatchedMotions();
     void doEventsConsume();
+    static int inputFdCallback(int fd,int events,void*data);
     bool needCancel(InputDevice*dev);
-    void recordEvent(InputEvent&);
-    InputEvent*parseEvent(const char*);
 protected:
     InputEventSource();
     void onDeviceChanged(const INPUTEVENT*es);
+    void batchMotion(MotionEvent*);
+    void consumeBatchedInput();
+    static void resampleMotion(MotionEvent&,nsecs_t sampleTime);
+    virtual void dispatchEvent(InputEvent&);
 public:
     static InputEventSource& getInstance();
     ~InputEventSource()override;
@@ -60,10 +77,13 @@ public:
     void closeScreenSaver();
     bool isScreenSaverActived()const;
     void record(const std::string&fname);
-    void playback(const std::string&fname);
+    /*replays a recording made by record() once,speed<=0 plays it as fast as possible*/
+    void playback(const std::string&fname,float speed=1.f,int delay=1000);
+    void stopPlayback();
     int checkEvents()override;
     int handleEvents()override;
     void sendEvent(InputEvent&);
+    void setResampleTouch(bool);
 };
 }
 #endif
@@ -0,0 +1,236 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <core/inputlatencytracker.h>
+#include <core/systemclock.h>
+#include <porting/cdlog.h>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+namespace cdroid{
+
+InputLatencyTracker::InputLatencyTracker(){
+    mEnabled = false;
+    mFrameNumber = 0;
+    mRecentPos = 0;
+    memset(mHistogram,0,sizeof(mHistogram));
+    memset(mCount,0,sizeof(mCount));
+    memset(mTotal,0,sizeof(mTotal));
+    memset(mMax,0,sizeof(mMax));
+}
+
+InputLatencyTracker& InputLatencyTracker::getInstance(){
+    static InputLatencyTracker* mInstance = nullptr;
+    static std::once_flag flag;
+    std::call_once(flag, []() {
+        mInstance = new InputLatencyTracker();
+    });
+    return *mInstance;
+}
+
+void InputLatencyTracker::setEnabled(bool enabled){
+    std::lock_guard<std::mutex>lock(mLock);
+    mEnabled = enabled;
+    if(!enabled){
+        mPending.clear();
+        mDrawn.clear();
+    }
+}
+
+bool InputLatencyTracker::isEnabled()const{
+    return mEnabled;
+}
+
+void InputLatencyTracker::recordLocked(int stage,nsecs_t nanos){
+    if(nanos < 0)return;
+    const int64_t ms = nanos/SystemClock::NANOS_PER_MS;
+    int bucket = 0;
+    while((bucket < BUCKET_COUNT-1) && (ms >= (int64_t(1)<<bucket)))
+        bucket++;
+    mHistogram[stage][bucket]++;
+    mCount[stage]++;
+    mTotal[stage] += nanos;
+    mMax[stage] = std::max(mMax[stage],nanos);
+}
+
+void InputLatencyTracker::onEventDispatched(const InputEvent&event){
+    if(mEnabled) onEventDispatched(event,SystemClock::uptimeNanos());
+}
+
+void InputLatencyTracker::onEventDispatched(const InputEvent&event,nsecs_t dispatchTime){
+    std::lock_guard<std::mutex>lock(mLock);
+    if(!mEnabled)return;
+    Record r;
+    r.eventId = event.getId();
+    r.action = event.getAction();
+    r.type = event.getType();
+    r.frame = 0;
+    r.hardwareTime = event.getHardwareTimeNanos();
+    r.dispatchTime = dispatchTime;
+    r.drawTime = r.flipTime = 0;
+    /*a timestamp in the future or from another clock base is of no use*/
+    if((r.hardwareTime > dispatchTime) || (dispatchTime - r.hardwareTime > MAX_PENDING_NANOS*20))
+        r.hardwareTime = 0;
+    if(r.hardwareTime)
+        recordLocked(INPUT_TO_DISPATCH,dispatchTime - r.hardwareTime);
+    if(mPending.size() >= MAX_PENDING)
+        mPending.erase(mPending.begin());
+    mPending.push_back(r);
+}
+
+void InputLatencyTracker::onFrameDrawn(){
+    if(mEnabled) onFrameDrawn(SystemClock::uptimeNanos());
+}
+
+void InputLatencyTracker::onFrameDrawn(nsecs_t drawTime){
+    std::lock_guard<std::mutex>lock(mLock);
+    if(!mEnabled)return;
+    mFrameNumber++;
+    for(Record&r:mPending){
+        if(drawTime - r.dispatchTime > MAX_PENDING_NANOS)
+            continue;
+        r.frame = mFrameNumber;
+        r.drawTime = drawTime;
+        recordLocked(DISPATCH_TO_DRAW,drawTime - r.dispatchTime);
+        mDrawn.push_back(r);
+    }
+    mPending.clear();
+}
+
+void InputLatencyTracker::onFrameFlipped(){
+    if(mEnabled) onFrameFlipped(SystemClock::uptimeNanos());
+}
+
+void InputLatencyTracker::onFrameFlipped(nsecs_t flipTime){
+    std::lock_guard<std::mutex>lock(mLock);
+    if(!mEnabled||mDrawn.empty())return;
+    for(Record&r:mDrawn){
+        r.flipTime = flipTime;
+        recordLocked(DRAW_TO_FLIP,flipTime - r.drawTime);
+        if(r.hardwareTime)
+            recordLocked(INPUT_TO_FLIP,flipTime - r.hardwareTime);
+        if(mRecent.size() < RECENT_COUNT)
+            mRecent.push_back(r);
+        else
+            mRecent[mRecentPos] = r;
+        mRecentPos = (mRecentPos + 1)%RECENT_COUNT;
+        LOGV("event %d action=%d consumed by frame %u latency %.2fms",r.eventId,r.action,r.frame,
+             float(flipTime - (r.hardwareTime?r.hardwareTime:r.dispatchTime))/SystemClock::NANOS_PER_MS);
+    }
+    mDrawn.clear();
+}
+
+uint32_t InputLatencyTracker::getFrameNumber()const{
+    std::lock_guard<std::mutex>lock(mLock);
+    return mFrameNumber;
+}
+
+uint64_t InputLatencyTracker::getCount(int stage)const{
+    std::lock_guard<std::mutex>lock(mLock);
+    return (stage>=0)&&(stage<STAGE_COUNT)?mCount[stage]:0;
+}
+
+int InputLatencyTracker::getHistogram(int stage,uint64_t*counts)const{
+    std::lock_guard<std::mutex>lock(mLock);
+    if((stage<0)||(stage>=STAGE_COUNT))return 0;
+    memcpy(counts,mHistogram[stage],sizeof(mHistogram[stage]));
+    return BUCKET_COUNT;
+}
+
+float InputLatencyTracker::getPercentile(int stage,float percent)const{
+    std::lock_guard<std::mutex>lock(mLock);
+    if((stage<0)||(stage>=STAGE_COUNT)||(mCount[stage]==0))return -1.f;
+    const uint64_t target = std::max<uint64_t>(1,uint64_t(mCount[stage]*std::min(percent,100.f)/100.f+.5f));
+    uint64_t sum = 0;
+    for(int i = 0;i < BUCKET_COUNT;i++){
+        sum += mHistogram[stage][i];
+        if(sum >= target)
+            return std::min(float(int64_t(1)<<i),float(mMax[stage])/SystemClock::NANOS_PER_MS);
+    }
+    return float(mMax[stage])/SystemClock::NANOS_PER_MS;
+}
+
+float InputLatencyTracker::getAverage(int stage)const{
+    std::lock_guard<std::mutex>lock(mLock);
+    if((stage<0)||(stage>=STAGE_COUNT)||(mCount[stage]==0))return -1.f;
+    return float(mTotal[stage])/mCount[stage]/SystemClock::NANOS_PER_MS;
+}
+
+std::vector<InputLatencyTracker::Record>InputLatencyTracker::getRecentRecords()const{
+    std::lock_guard<std::mutex>lock(mLock);
+    std::vector<Record>records;
+    if(mRecent.size() < RECENT_COUNT)
+        return mRecent;
+    records.insert(records.end(),mRecent.begin() + mRecentPos,mRecent.end());
+    records.insert(records.end(),mRecent.begin(),mRecent.begin() + mRecentPos);
+    return records;
+}
+
+void InputLatencyTracker::reset(){
+    std::lock_guard<std::mutex>lock(mLock);
+    memset(mHistogram,0,sizeof(mHistogram));
+    memset(mCount,0,sizeof(mCount));
+    memset(mTotal,0,sizeof(mTotal));
+    memset(mMax,0,sizeof(mMax));
+    mPending.clear();
+    mDrawn.clear();
+    mRecent.clear();
+    mRecentPos = 0;
+}
+
+const char*InputLatencyTracker::stageToString(int stage){
+    switch(stage){
+    case INPUT_TO_DISPATCH:return "input->dispatch";
+    case DISPATCH_TO_DRAW :return "dispatch->draw";
+    case DRAW_TO_FLIP     :return "draw->flip";
+    case INPUT_TO_FLIP    :return "input->flip";
+    default:return "unknown";
+    }
+}
+
+void InputLatencyTracker::dump(std::ostream&os)const{
+    std::lock_guard<std::mutex>lock(mLock);
+    dumpLocked(os);
+}
+
+void InputLatencyTracker::dumpLocked(std::ostream&os)const{
+    os<<"InputLatency frames="<<mFrameNumber<<std::endl;
+    for(int s = 0;s < STAGE_COUNT;s++){
+        os<<"  "<<std::setw(16)<<std::left<<stageToString(s)<<std::right<<" n="<<mCount[s];
+        if(mCount[s]){
+            os<<std::fixed<<std::setprecision(2)<<" avg="<<float(mTotal[s])/mCount[s]/SystemClock::NANOS_PER_MS
+              <<"ms max="<<float(mMax[s])/SystemClock::NANOS_PER_MS<<"ms";
+        }
+        os<<" [";
+        for(int i = 0;i < BUCKET_COUNT;i++)
+            os<<(i?" ":"")<<mHistogram[s][i];
+        os<<"]"<<std::endl;
+    }
+}
+
+std::string InputLatencyTracker::getSummary()const{
+    std::ostringstream oss;
+    const float p50 = getPercentile(INPUT_TO_FLIP,50.f);
+    const float p95 = getPercentile(INPUT_TO_FLIP,95.f);
+    if(p50 < 0)return std::string();
+    oss<<"input p50<"<<p50<<"ms p95<"<<p95<<"ms";
+    return oss.str();
+}
+
+}/*endof namespace*/
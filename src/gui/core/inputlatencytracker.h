@@ -0,0 +1,95 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __INPUT_LATENCY_TRACKER_H__
+#define __INPUT_LATENCY_TRACKER_H__
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <view/inputevent.h>
+namespace cdroid{
+
+/*Measures how long input takes to reach the screen.Every dispatched event is
+ *stamped with its kernel time,the next drawn frame consumes all pending events
+ *and the following flip completes them.Latencies are kept in log2 histograms*/
+class InputLatencyTracker{
+public:
+    enum Stage{
+        INPUT_TO_DISPATCH,/*kernel timestamp -> WindowManager::processEvent*/
+        DISPATCH_TO_DRAW, /*processEvent -> Window::draw finished*/
+        DRAW_TO_FLIP,     /*draw finished -> GFXFlip*/
+        INPUT_TO_FLIP,    /*end to end*/
+        STAGE_COUNT
+    };
+    /*bucket i counts latencies in [2^(i-1),2^i) ms,bucket 0 is below 1ms*/
+    static constexpr int BUCKET_COUNT = 12;
+    static constexpr int RECENT_COUNT = 64;
+    struct Record{
+        int32_t eventId;
+        int32_t action;
+        int32_t type;
+        uint32_t frame;/*the frame that consumed the event*/
+        nsecs_t hardwareTime;/*all times are uptime nanos,0 if unknown*/
+        nsecs_t dispatchTime;
+        nsecs_t drawTime;
+        nsecs_t flipTime;
+    };
+private:
+    /*events not followed by a frame within this time did not cause one*/
+    static constexpr nsecs_t MAX_PENDING_NANOS = 500LL*1000000LL;
+    static constexpr size_t MAX_PENDING = 256;
+    mutable std::mutex mLock;
+    std::atomic<bool> mEnabled;/*read without the lock by the input and compose threads*/
+    uint32_t mFrameNumber;
+    uint64_t mHistogram[STAGE_COUNT][BUCKET_COUNT];
+    uint64_t mCount[STAGE_COUNT];
+    nsecs_t mTotal[STAGE_COUNT];
+    nsecs_t mMax[STAGE_COUNT];
+    std::vector<Record>mPending;/*dispatched,waiting for a draw*/
+    std::vector<Record>mDrawn;  /*drawn,waiting for the flip*/
+    std::vector<Record>mRecent;
+    size_t mRecentPos;
+    InputLatencyTracker();
+    void recordLocked(int stage,nsecs_t nanos);
+    void dumpLocked(std::ostream&)const;
+public:
+    static InputLatencyTracker& getInstance();
+    void setEnabled(bool enabled);
+    bool isEnabled()const;
+    void onEventDispatched(const InputEvent&event);
+    void onEventDispatched(const InputEvent&event,nsecs_t dispatchTime);
+    void onFrameDrawn();
+    void onFrameDrawn(nsecs_t drawTime);
+    void onFrameFlipped();
+    void onFrameFlipped(nsecs_t flipTime);
+    uint32_t getFrameNumber()const;
+    uint64_t getCount(int stage)const;
+    int getHistogram(int stage,uint64_t*counts)const;
+    /*upper bound in ms of the bucket holding the given percentile(0..100),-1 if empty*/
+    float getPercentile(int stage,float percent)const;
+    float getAverage(int stage)const;
+    std::vector<Record>getRecentRecords()const;
+    void reset();
+    void dump(std::ostream&os)const;
+    std::string getSummary()const;
+    static const char*stageToString(int stage);
+};
+
+}/*endof namespace*/
+#endif/*__INPUT_LATENCY_TRACKER_H__*/
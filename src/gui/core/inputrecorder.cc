@@ -0,0 +1,361 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <core/inputrecorder.h>
+#include <core/inputlatencytracker.h>
+#include <core/systemclock.h>
+#include <porting/cdlog.h>
+#include <vector>
+
+namespace cdroid{
+
+template<typename T>
+static void put(std::ostream&os,T v){
+    os.write((const char*)&v,sizeof(T));
+}
+
+template<typename T>
+static T get(std::istream&is){
+    T v = T();
+    is.read((char*)&v,sizeof(T));
+    return v;
+}
+
+static int bitCount(uint64_t bits){
+    int count = 0;
+    for(;bits;bits &= bits-1)count++;
+    return count;
+}
+
+InputEventRecorder::InputEventRecorder(){
+    mEventCount = 0;
+}
+
+InputEventRecorder::~InputEventRecorder(){
+    close();
+}
+
+bool InputEventRecorder::open(const std::string&path){
+    close();
+    mStream.open(path,std::ios::binary|std::ios::trunc);
+    if(!mStream.is_open()){
+        LOGE("can't record events to %s",path.c_str());
+        return false;
+    }
+    writeHeader(mStream);
+    mEventCount = 0;
+    LOGI("record events to %s",path.c_str());
+    return true;
+}
+
+void InputEventRecorder::close(){
+    if(mStream.is_open()){
+        mStream.close();
+        LOGI("%u events recorded",mEventCount);
+    }
+}
+
+bool InputEventRecorder::isOpen()const{
+    return mStream.is_open();
+}
+
+uint32_t InputEventRecorder::getEventCount()const{
+    return mEventCount;
+}
+
+bool InputEventRecorder::write(const InputEvent&event){
+    if(!mStream.is_open())return false;
+    writeEvent(mStream,event);
+    mEventCount++;
+    return mStream.good();
+}
+
+void InputEventRecorder::writeHeader(std::ostream&os){
+    put<uint32_t>(os,MAGIC);
+    put<uint32_t>(os,VERSION);
+}
+
+bool InputEventRecorder::readHeader(std::istream&is){
+    const uint32_t magic = get<uint32_t>(is);
+    const uint32_t version = get<uint32_t>(is);
+    return is.good() && (magic == MAGIC) && (version == VERSION);
+}
+
+void InputEventRecorder::writeEvent(std::ostream&os,const InputEvent&event){
+    const int type = event.getType();
+    if(type == InputEvent::INPUT_EVENT_TYPE_KEY){
+        const KeyEvent&k = (const KeyEvent&)event;
+        put<uint8_t>(os,type);
+        put<int64_t>(os,k.getEventTime());
+        put<int64_t>(os,k.getDownTime());
+        put<int64_t>(os,k.getHardwareTimeNanos());
+        put<int32_t>(os,k.getDeviceId());
+        put<int32_t>(os,k.getSource());
+        put<int32_t>(os,k.getDisplayId());
+        put<int32_t>(os,k.getAction());
+        put<int32_t>(os,k.getFlags());
+        put<int32_t>(os,k.getMetaState());
+        put<int32_t>(os,k.getKeyCode());
+        put<int32_t>(os,k.getScanCode());
+        put<int32_t>(os,k.getRepeatCount());
+    }else if(type == InputEvent::INPUT_EVENT_TYPE_MOTION){
+        const MotionEvent&m = (const MotionEvent&)event;
+        const size_t pointerCount = m.getPointerCount();
+        const size_t historySize = m.getHistorySize();
+        put<uint8_t>(os,type);
+        put<int64_t>(os,m.getEventTime());
+        put<int64_t>(os,m.getDownTime());
+        put<int64_t>(os,m.getHardwareTimeNanos());
+        put<int32_t>(os,m.getDeviceId());
+        put<int32_t>(os,m.getSource());
+        put<int32_t>(os,m.getDisplayId());
+        put<int32_t>(os,m.getAction());
+        put<int32_t>(os,m.getFlags());
+        put<int32_t>(os,m.getMetaState());
+        put<int32_t>(os,m.getActionButton());
+        put<int32_t>(os,m.getButtonState());
+        put<int32_t>(os,m.getEdgeFlags());
+        put<int32_t>(os,m.getClassification());
+        put<float>(os,m.getRawXOffset());
+        put<float>(os,m.getRawYOffset());
+        put<float>(os,m.getXPrecision());
+        put<float>(os,m.getYPrecision());
+        put<float>(os,m.getXCursorPosition());
+        put<float>(os,m.getYCursorPosition());
+        put<uint32_t>(os,uint32_t(pointerCount));
+        put<uint32_t>(os,uint32_t(historySize + 1));
+        for(size_t i = 0;i < pointerCount;i++){
+            PointerProperties pp;
+            m.getPointerProperties(i,pp);
+            put<int32_t>(os,pp.id);
+            put<int32_t>(os,pp.toolType);
+        }
+        for(size_t h = 0;h <= historySize;h++){
+            put<int64_t>(os,m.getHistoricalEventTime(h));
+            for(size_t i = 0;i < pointerCount;i++){
+                PointerCoords pc;
+                m.getHistoricalPointerCoords(i,h,pc);
+                put<uint64_t>(os,pc.bits);
+                os.write((const char*)pc.values,sizeof(float)*bitCount(pc.bits));
+            }
+        }
+    }
+}
+
+nsecs_t InputEventRecorder::peekEventTime(std::istream&is,nsecs_t*downTime){
+    const std::streampos pos = is.tellg();
+    get<uint8_t>(is);
+    const nsecs_t eventTime = get<int64_t>(is);
+    const nsecs_t down = get<int64_t>(is);
+    const bool good = is.good();
+    is.clear();
+    is.seekg(pos);
+    if(!good)return -1;
+    if(downTime)*downTime = down;
+    return eventTime;
+}
+
+InputEvent*InputEventRecorder::readEvent(std::istream&is,nsecs_t timeOffset){
+    const int type = get<uint8_t>(is);
+    const nsecs_t eventTime = get<int64_t>(is) + timeOffset;
+    const nsecs_t downTime = get<int64_t>(is) + timeOffset;
+    const nsecs_t hardwareTime = get<int64_t>(is);
+    const int32_t deviceId = get<int32_t>(is);
+    const int32_t source = get<int32_t>(is);
+    const int32_t displayId = get<int32_t>(is);
+    const int32_t action = get<int32_t>(is);
+    const int32_t flags = get<int32_t>(is);
+    const int32_t metaState = get<int32_t>(is);
+    if(!is.good())return nullptr;
+    InputEvent*event = nullptr;
+    if(type == InputEvent::INPUT_EVENT_TYPE_KEY){
+        const int32_t keyCode = get<int32_t>(is);
+        const int32_t scanCode = get<int32_t>(is);
+        const int32_t repeatCount = get<int32_t>(is);
+        if(!is.good())return nullptr;
+        event = KeyEvent::obtain(downTime,eventTime,action,keyCode,repeatCount,metaState,
+                 deviceId,scanCode,flags,source,displayId);
+    }else if(type == InputEvent::INPUT_EVENT_TYPE_MOTION){
+        const int32_t actionButton = get<int32_t>(is);
+        const int32_t buttonState = get<int32_t>(is);
+        const int32_t edgeFlags = get<int32_t>(is);
+        const int32_t classification = get<int32_t>(is);
+        const float xOffset = get<float>(is);
+        const float yOffset = get<float>(is);
+        const float xPrecision = get<float>(is);
+        const float yPrecision = get<float>(is);
+        const float xCursor = get<float>(is);
+        const float yCursor = get<float>(is);
+        const uint32_t pointerCount = get<uint32_t>(is);
+        const uint32_t sampleCount = get<uint32_t>(is);
+        if(!is.good()||(pointerCount == 0)||(pointerCount > MotionEvent::MAX_POINTERS)||(sampleCount == 0))
+            return nullptr;
+        std::vector<PointerProperties>props(pointerCount);
+        for(uint32_t i = 0;i < pointerCount;i++){
+            props[i].clear();
+            props[i].id = get<int32_t>(is);
+            props[i].toolType = get<int32_t>(is);
+        }
+        std::vector<nsecs_t>times(sampleCount);
+        std::vector<PointerCoords>coords(sampleCount*pointerCount);
+        for(uint32_t h = 0;h < sampleCount;h++){
+            times[h] = get<int64_t>(is) + timeOffset;
+            for(uint32_t i = 0;i < pointerCount;i++){
+                PointerCoords&pc = coords[h*pointerCount + i];
+                pc.clear();
+                pc.bits = get<uint64_t>(is);
+                const int axisCount = bitCount(pc.bits);
+                if(axisCount > PointerCoords::MAX_AXES)return nullptr;
+                is.read((char*)pc.values,sizeof(float)*axisCount);
+            }
+        }
+        if(!is.good())return nullptr;
+        MotionEvent*m = MotionEvent::obtain(downTime,times[0],action,pointerCount,props.data(),coords.data(),
+                metaState,buttonState,xPrecision,yPrecision,deviceId,edgeFlags,source,displayId,flags,classification);
+        m->setActionButton(actionButton);
+        m->offsetLocation(xOffset,yOffset);
+        m->setCursorPosition(xCursor,yCursor);
+        for(uint32_t h = 1;h < sampleCount;h++)
+            m->addSample(times[h],&coords[h*pointerCount]);
+        event = m;
+    }
+    if(event)
+        event->setHardwareTimeNanos(hardwareTime ? hardwareTime + timeOffset*SystemClock::NANOS_PER_MS : 0);
+    return event;
+}
+
+InputEventPlayer::InputEventPlayer(Dispatcher dispatcher)
+  :mDispatcher(dispatcher){
+    mSpeed = 1.f;
+    mFirstEventTime = mStartTime = mTimeOffset = 0;
+    mEventCount = 0;
+    mStartFrame = 0;
+    mLatencyWasEnabled = false;
+}
+
+InputEventPlayer::~InputEventPlayer(){
+    stop();
+}
+
+bool InputEventPlayer::load(const std::string&path){
+    std::ifstream in(path,std::ios::binary);
+    if(!in.is_open()){
+        LOGE("can't open recording %s",path.c_str());
+        return false;
+    }
+    std::ostringstream data;
+    data<<in.rdbuf();
+    mStream.str(data.str());
+    mStream.clear();
+    if(!InputEventRecorder::readHeader(mStream)){
+        LOGE("%s is not an input recording",path.c_str());
+        mStream.str(std::string());
+        return false;
+    }
+    mPath = path;
+    return true;
+}
+
+nsecs_t InputEventPlayer::toReplayTime(nsecs_t eventTime)const{
+    if(mSpeed <= 0.f)
+        return SystemClock::uptimeMillis();
+    return mStartTime + nsecs_t((eventTime - mFirstEventTime)/mSpeed);
+}
+
+void InputEventPlayer::start(float speed,nsecs_t delay){
+    stop();
+    mStream.clear();
+    mStream.seekg(sizeof(uint32_t)*2);
+    mFirstEventTime = InputEventRecorder::peekEventTime(mStream);
+    if(mFirstEventTime < 0){
+        LOGW("nothing to play in '%s'",mPath.c_str());
+        return;
+    }
+    InputLatencyTracker&tracker = InputLatencyTracker::getInstance();
+    /*stats collected with --latency are kept,the tracker is only switched on for the replay*/
+    mLatencyWasEnabled = tracker.isEnabled();
+    if(!mLatencyWasEnabled)
+        tracker.setEnabled(true);
+    mStartFrame = tracker.getFrameNumber();
+    mSpeed = speed;
+    mEventCount = 0;
+    mStartTime = SystemClock::uptimeMillis() + delay;
+    mTimeOffset = mStartTime - mFirstEventTime;
+    LOGI("play %s at speed %.2f",mPath.c_str(),speed);
+    Message msg;
+    Looper::getMainLooper()->sendMessageAtTime(mStartTime,this,msg);
+}
+
+void InputEventPlayer::stop(){
+    if(!isPlaying())return;
+    Looper::getMainLooper()->removeMessages(this);
+    finish();
+}
+
+bool InputEventPlayer::isPlaying()const{
+    return mStartTime != 0;
+}
+
+void InputEventPlayer::scheduleNext(){
+    const nsecs_t eventTime = InputEventRecorder::peekEventTime(mStream);
+    if(eventTime < 0){
+        finish();
+        return;
+    }
+    Message msg;
+    Looper::getMainLooper()->sendMessageAtTime(toReplayTime(eventTime),this,msg);
+}
+
+void InputEventPlayer::handleMessage(Message&msg){
+    const nsecs_t now = SystemClock::uptimeMillis();
+    nsecs_t downTime = 0;
+    nsecs_t eventTime;
+    /*speed<=0 plays one event per message so that frames get their turn*/
+    do{
+        eventTime = InputEventRecorder::peekEventTime(mStream,&downTime);
+        if(eventTime < 0)break;
+        if((mSpeed > 0.f) && (toReplayTime(eventTime) > now))break;
+        if(downTime == eventTime)/*a new gesture starts*/
+            mTimeOffset = now - eventTime;
+        InputEvent*e = InputEventRecorder::readEvent(mStream,mTimeOffset);
+        if(e == nullptr){
+            LOGE("%s is corrupted after %u events",mPath.c_str(),mEventCount);
+            mStream.setstate(std::ios::eofbit);
+            break;
+        }
+        mDispatcher(*e);
+        e->recycle();
+        mEventCount++;
+    }while(mSpeed > 0.f);
+    scheduleNext();
+}
+
+void InputEventPlayer::finish(){
+    if(!isPlaying())return;
+    InputLatencyTracker&tracker = InputLatencyTracker::getInstance();
+    const nsecs_t duration = SystemClock::uptimeMillis() - mStartTime;
+    const uint32_t frames = tracker.getFrameNumber() - mStartFrame;
+    std::ostringstream oss;
+    tracker.dump(oss);
+    LOGI("%s played %u events in %lldms,%u frames %.2ffps\n%s",mPath.c_str(),mEventCount,(long long)duration,
+            frames,(duration > 0 ? frames*1000.f/duration : 0.f),oss.str().c_str());
+    if(!mLatencyWasEnabled)
+        tracker.setEnabled(false);
+    mStartTime = 0;
+}
+
+}/*endof namespace*/
@@ -0,0 +1,97 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __INPUT_RECORDER_H__
+#define __INPUT_RECORDER_H__
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <core/looper.h>
+#include <view/keyevent.h>
+#include <view/motionevent.h>
+namespace cdroid{
+
+/*Binary input recording,a header followed by one record per dispatched event:
+ *  header: uint32 MAGIC,uint32 VERSION
+ *  record: uint8 type,int64 eventTime(ms),int64 downTime(ms),int64 hardwareTime(ns),
+ *          int32 deviceId,source,displayId,action,flags,metaState
+ *  key   : int32 keyCode,scanCode,repeatCount
+ *  motion: int32 actionButton,buttonState,edgeFlags,classification,
+ *          float xOffset,yOffset,xPrecision,yPrecision,xCursor,yCursor,
+ *          uint32 pointerCount,sampleCount,pointerCount*(int32 id,toolType),
+ *          sampleCount*(int64 time,pointerCount*(uint64 bits,float values[popcount(bits)]))
+ *Values are stored in host byte order*/
+class InputEventRecorder{
+public:
+    static constexpr uint32_t MAGIC = 0x52494443;/*"CDIR"*/
+    static constexpr uint32_t VERSION = 1;
+private:
+    std::ofstream mStream;
+    uint32_t mEventCount;
+public:
+    InputEventRecorder();
+    ~InputEventRecorder();
+    bool open(const std::string&path);
+    void close();
+    bool isOpen()const;
+    uint32_t getEventCount()const;
+    bool write(const InputEvent&event);
+
+    static void writeHeader(std::ostream&);
+    static bool readHeader(std::istream&);
+    static void writeEvent(std::ostream&,const InputEvent&event);
+    /*returns an obtained event whose times are shifted by timeOffset(ms),nullptr at the end or on error*/
+    static InputEvent*readEvent(std::istream&,nsecs_t timeOffset=0);
+    /*the event time of the next record without consuming it,-1 at the end*/
+    static nsecs_t peekEventTime(std::istream&,nsecs_t*downTime=nullptr);
+};
+
+/*Replays a recording on the main looper through the normal dispatch path.
+ *speed scales the delays between events,a speed<=0 replays them back to back.
+ *Event times are rebased at the start of every gesture so that the spacing
+ *inside a gesture(and the velocities derived from it)stays as recorded.
+ *Frame stats of the run are logged when the recording ends*/
+class InputEventPlayer:public MessageHandler{
+public:
+    typedef std::function<void(InputEvent&)>Dispatcher;
+private:
+    std::istringstream mStream;
+    std::string mPath;
+    Dispatcher mDispatcher;
+    float mSpeed;
+    nsecs_t mFirstEventTime;/*time base of the recording*/
+    nsecs_t mStartTime;     /*time base of the replay*/
+    nsecs_t mTimeOffset;    /*recorded->replayed event time of the current gesture*/
+    uint32_t mEventCount;
+    uint32_t mStartFrame;
+    bool mLatencyWasEnabled;
+    nsecs_t toReplayTime(nsecs_t eventTime)const;
+    void scheduleNext();
+    void finish();
+public:
+    InputEventPlayer(Dispatcher dispatcher);
+    ~InputEventPlayer()override;
+    bool load(const std::string&path);
+    void start(float speed=1.f,nsecs_t delay=0);
+    void stop();
+    bool isPlaying()const;
+    void handleMessage(Message&)override;
+};
+
+}/*endof namespace*/
+#endif/*__INPUT_RECORDER_H__*/
@@ -22,6 +22,7 @@
 #include <pthread.h>
 #include <core/looper.h>
 #include <core/systemclock.h>
+#include <core/trace.h>
 #include <core/epollwrapper.h>
 #include <porting/cdlog.h>
 #if defined(_WIN32)||defined(_WIN64)||defined(_MSVC_VER)
@@ -81,7 +82,7 @@ Looper::Looper(bool allowNonCallbacks) :
         mSendingMessage(false),mPolling(false),
         mEpollRebuildRequired(false),
         mWakeEventFd(-1),mEpoll(nullptr),
-        mNextRequestSeq(WAKE_EVENT_FD_SEQ+1),
+        mNextRequestSeq(WAKE_EVENT_FD_SEQ+1),mNextMessageSeq(0),
         mResponseIndex(0), mNextMessageUptime(LLONG_MAX) {
 #if defined(HAVE_EVENTFD)
     mWakeEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
@@ -93,6 +94,7 @@ Looper::Looper(bool allowNonCallbacks) :
 
 #define FLAG_OWNED 2
 #define FLAG_REMOVED 1
+#define FLAG_READINESS 4
 Looper::~Looper() {
     LOGD("~Looper %p sMainLooper=%p",this,sMainLooper);
     close(mWakeEventFd);
@@ -103,6 +105,15 @@ Looper::~Looper() {
         if((hdl->mFlags&FLAG_OWNED)==FLAG_OWNED)delete hdl;
     }
     mEventHandlers.clear();
+    for(MessageEnvelope*envelope:mMessageHeap){
+        delete envelope;
+    }
+    for(MessageEnvelope*envelope:mEnvelopePool){
+        delete envelope;
+    }
+    mMessageHeap.clear();
+    mEnvelopePool.clear();
+    mHandlerMessages.clear();
 }
 
 static void initTLSKey() {
@@ -243,7 +254,8 @@ int Looper::pollOnce(int timeoutMillis, int* outFd, int* outEvents, void** outDa
 
 int Looper::doEventHandlers(){
     int count = 0;
-    if(mNextMessageUptime>(nsecs_t)SystemClock::uptimeMillis()){
+    const nsecs_t now = SystemClock::uptimeMillis();
+    if(mNextMessageUptime>now){
         for(auto it = mHandlers.begin();it != mHandlers.end();){
             MessageHandler*hdl = (*it);
             uint32_t eFlags = (*it)->mFlags;
@@ -265,7 +277,13 @@ int Looper::doEventHandlers(){
         EventHandler*es=(*it);
         uint32_t eFlags = es->mFlags;
         if(es&&((eFlags&FLAG_REMOVED)==0)){
-            if(es->checkEvents()>0){
+            bool ready = true;
+            if(eFlags&FLAG_READINESS){
+                /*consume the readiness before checking,signals raised while handling are kept for the next pass*/
+                nsecs_t readyTime = es->mReadyTime.load();
+                ready = (readyTime<=now) && es->mReadyTime.compare_exchange_strong(readyTime,LLONG_MAX);
+            }
+            if(ready && (es->checkEvents()>0)){
                 es->handleEvents();  count++;
             }
             eFlags = es->mFlags;//Maybe EventHandler::handleEvents will remove itself,so we recheck the flags
@@ -284,18 +302,20 @@ int Looper::doEventHandlers(){
 
 
 int Looper::pollInner(int timeoutMillis) {
+    ATRACE_NAME("Looper::pollInner");
 #if DEBUG_POLL_AND_WAKE
     LOGD("%p waiting: timeoutMillis=%d mNextMessageUptime=%lld/%lld",this,timeoutMillis,mNextMessageUptime,LLONG_MAX);
 #endif
-    // Adjust the timeout based on when the next message is due.
-    if (timeoutMillis != 0 && mNextMessageUptime != LLONG_MAX) {
+    // Adjust the timeout based on when the next message or readiness driven EventHandler is due.
+    const nsecs_t nextUptime = std::min(mNextMessageUptime,getNextEventHandlerUptime());
+    if (timeoutMillis != 0 && nextUptime != LLONG_MAX) {
         nsecs_t now = SystemClock::uptimeMillis();
-        int messageTimeoutMillis = toMillisecondTimeoutDelay(now, mNextMessageUptime);
+        int messageTimeoutMillis = toMillisecondTimeoutDelay(now, nextUptime);
         if ( (messageTimeoutMillis >= 0 ) && (timeoutMillis < 0 || messageTimeoutMillis < timeoutMillis)) {
             timeoutMillis = messageTimeoutMillis;
         }
 #if DEBUG_POLL_AND_WAKE
-        LOGD("%p next message in %lld ns, adjusted timeout:timeoutMillis=%d",this,mNextMessageUptime - now, timeoutMillis);
+        LOGD("%p next message in %lld ms, adjusted timeout:timeoutMillis=%d",this,nextUptime - now, timeoutMillis);
 #endif
     }
 
@@ -306,7 +326,9 @@ int Looper::pollInner(int timeoutMillis) {
     //We are about to idle
     mPolling = true;
     std::vector<struct epoll_event> eventItems;
+    ATRACE_BEGIN("Looper::waitEvents");
     const int eventCount = mEpoll->waitEvents(eventItems,timeoutMillis);// epoll_wait(mEpollFd, eventItems, EPOLL_MAX_EVENTS, timeoutMillis);
+    ATRACE_END();
     //No longer idling.
     mPolling = false;
     // Acquire lock.
@@ -360,17 +382,18 @@ int Looper::pollInner(int timeoutMillis) {
 Done:
     // Invoke pending message callbacks.
     mNextMessageUptime = LLONG_MAX;
-    while (mMessageEnvelopes.size() != 0) {
+    while (mMessageHeap.size() != 0) {
         nsecs_t now = SystemClock::uptimeMillis();
-        const MessageEnvelope& messageEnvelope = mMessageEnvelopes.front();
-        if (messageEnvelope.uptime <= now) {
-            //Remove the envelope from the list. We keep a strong reference to the handler
+        MessageEnvelope* messageEnvelope = mMessageHeap.front();
+        if (messageEnvelope->uptime <= now) {
+            //Remove the envelope from the queue. We keep a strong reference to the handler
             //until the call to handleMessage finishes. Then we drop it so that the handler
             //can be deleted *before* we reacquire our lock.
             {//obtain handler
-                MessageHandler* handler = messageEnvelope.handler;
-                Message message = messageEnvelope.message;
-                mMessageEnvelopes.pop_front();
+                MessageHandler* handler = messageEnvelope->handler;
+                Message message(std::move(messageEnvelope->message));
+                removeMessageLocked(messageEnvelope);
+                recycleEnvelopesLocked(messageEnvelope);
                 mSendingMessage = true;
                 mLock.unlock();
 #if DEBUG_POLL_AND_WAKE||DEBUG_CALLBACKS
@@ -384,7 +407,7 @@ Done:
             result = POLL_CALLBACK;
         } else {
             // The last message left at the head of the queue determines the next wakeup time.
-            mNextMessageUptime = messageEnvelope.uptime;
+            mNextMessageUptime = messageEnvelope->uptime;
             break;
         }
     }
@@ -640,18 +663,17 @@ void Looper::sendMessageAtTime(nsecs_t uptime, const MessageHandler* handler,
 #if DEBUG_CALLBACKS
     LOGD("%p  sendMessageAtTime - uptime=%lld, handler=%p, what=%d", this, uptime, handler, message.what);
 #endif
-    size_t i = 0;
+    bool atHead = false;
     { // acquire lock
         std::lock_guard<std::recursive_mutex> _l(mLock);
 
-        std::list<MessageEnvelope>::const_iterator it;
-        for(it = mMessageEnvelopes.begin();it != mMessageEnvelopes.end();++it){
-            if(it->uptime >= uptime)break;
-            i += 1;
-        }
-
-        MessageEnvelope messageEnvelope(uptime,const_cast<MessageHandler*>(handler), message);
-        mMessageEnvelopes.insert(it,messageEnvelope);
+        MessageEnvelope* messageEnvelope = obtainEnvelopeLocked();
+        messageEnvelope->uptime = uptime;
+        messageEnvelope->seq = mNextMessageSeq++;
+        messageEnvelope->handler = const_cast<MessageHandler*>(handler);
+        messageEnvelope->message = message;
+        pushMessageLocked(messageEnvelope);
+        atHead = (mMessageHeap.front() == messageEnvelope);
 
         // Optimization: If the Looper is currently sending a message, then we can skip
         // the call to wake() because the next thing the Looper will do after processing
@@ -661,7 +683,104 @@ void Looper::sendMessageAtTime(nsecs_t uptime, const MessageHandler* handler,
     } // release lock
 
     // Wake the poll loop only when we enqueue a new message at the head.
-    if (i == 0) wake();
+    if (atHead) wake();
+}
+
+Looper::MessageEnvelope* Looper::obtainEnvelopeLocked(){
+    if(mEnvelopePool.empty())
+        return new MessageEnvelope();
+    MessageEnvelope* envelope = mEnvelopePool.back();
+    mEnvelopePool.pop_back();
+    return envelope;
+}
+
+/*recycles the chain of removed envelopes linked by nextOfHandler*/
+void Looper::recycleEnvelopesLocked(MessageEnvelope*envelope){
+    while(envelope){
+        MessageEnvelope* next = envelope->nextOfHandler;
+        Runnable released(std::move(envelope->message.callback));//drop the captures now,not when the envelope is reused
+        envelope->message.obj = nullptr;
+        envelope->handler = nullptr;
+        envelope->nextOfHandler = nullptr;
+        if(mEnvelopePool.size() < MAX_ENVELOPE_POOL_SIZE)
+            mEnvelopePool.push_back(envelope);
+        else
+            delete envelope;
+        envelope = next;
+    }
+}
+
+static inline bool isEarlier(nsecs_t uptime1,uint64_t seq1,nsecs_t uptime2,uint64_t seq2){
+    return (uptime1 < uptime2) || ((uptime1 == uptime2) && (seq1 < seq2));
+}
+
+void Looper::siftUpLocked(size_t index){
+    MessageEnvelope* envelope = mMessageHeap[index];
+    while(index > 0){
+        const size_t parent = (index - 1) / 2;
+        MessageEnvelope* p = mMessageHeap[parent];
+        if(!isEarlier(envelope->uptime,envelope->seq,p->uptime,p->seq))break;
+        mMessageHeap[index] = p;
+        p->heapIndex = index;
+        index = parent;
+    }
+    mMessageHeap[index] = envelope;
+    envelope->heapIndex = index;
+}
+
+void Looper::siftDownLocked(size_t index){
+    const size_t count = mMessageHeap.size();
+    MessageEnvelope* envelope = mMessageHeap[index];
+    for(;;){
+        size_t child = index * 2 + 1;
+        if(child >= count)break;
+        MessageEnvelope* c = mMessageHeap[child];
+        if( (child + 1 < count) && isEarlier(mMessageHeap[child+1]->uptime,mMessageHeap[child+1]->seq,c->uptime,c->seq) ){
+            c = mMessageHeap[++child];
+        }
+        if(!isEarlier(c->uptime,c->seq,envelope->uptime,envelope->seq))break;
+        mMessageHeap[index] = c;
+        c->heapIndex = index;
+        index = child;
+    }
+    mMessageHeap[index] = envelope;
+    envelope->heapIndex = index;
+}
+
+void Looper::pushMessageLocked(MessageEnvelope*envelope){
+    mMessageHeap.push_back(envelope);
+    siftUpLocked(mMessageHeap.size() - 1);
+
+    MessageEnvelope*& head = mHandlerMessages[envelope->handler];
+    envelope->prevOfHandler = nullptr;
+    envelope->nextOfHandler = head;
+    if(head) head->prevOfHandler = envelope;
+    head = envelope;
+}
+
+void Looper::removeMessageLocked(MessageEnvelope*envelope){
+    const size_t index = envelope->heapIndex;
+    MessageEnvelope* last = mMessageHeap.back();
+    mMessageHeap.pop_back();
+    if(last != envelope){
+        mMessageHeap[index] = last;
+        last->heapIndex = index;
+        siftDownLocked(index);
+        siftUpLocked(last->heapIndex);
+    }
+
+    if(envelope->prevOfHandler){
+        envelope->prevOfHandler->nextOfHandler = envelope->nextOfHandler;
+    }else if(envelope->nextOfHandler){
+        mHandlerMessages[envelope->handler] = envelope->nextOfHandler;
+    }else{
+        /*no entries are left for removed or destroyed handlers*/
+        mHandlerMessages.erase(envelope->handler);
+    }
+    if(envelope->nextOfHandler){
+        envelope->nextOfHandler->prevOfHandler = envelope->prevOfHandler;
+    }
+    envelope->prevOfHandler = envelope->nextOfHandler = nullptr;
 }
 
 void Looper::addHandler(MessageHandler*handler){
@@ -684,10 +803,28 @@ void Looper::removeHandler(MessageHandler*handler){
 void Looper::addEventHandler(const EventHandler*handler){
     auto it =std::find(mEventHandlers.begin(),mEventHandlers.end(),const_cast<EventHandler*>(handler));
     if( it == mEventHandlers.end()){
+        const_cast<EventHandler*>(handler)->mEventLooper = this;
         mEventHandlers.insert(mEventHandlers.begin(),const_cast<EventHandler*>(handler));
     }
 }
 
+nsecs_t Looper::getNextEventHandlerUptime()const{
+    nsecs_t nextUptime = LLONG_MAX;
+    for(EventHandler*es:mEventHandlers){
+        if((es->mFlags&(FLAG_READINESS|FLAG_REMOVED))==FLAG_READINESS)
+            nextUptime = std::min(nextUptime,es->mReadyTime.load());
+    }
+    return nextUptime;
+}
+
+bool Looper::hasPolledEventHandlers()const{
+    for(EventHandler*es:mEventHandlers){
+        if((es->mFlags&(FLAG_READINESS|FLAG_REMOVED))==0)
+            return true;
+    }
+    return false;
+}
+
 void Looper::removeEventHandler(const EventHandler*handler){
     for(auto it = mEventHandlers.begin();it != mEventHandlers.end();it++){
         if( (*it) ==handler){
@@ -700,9 +837,11 @@ void Looper::removeEventHandler(const EventHandler*handler){
 
 bool Looper::hasMessages(const MessageHandler* handler,int what,void*obj){
     std::lock_guard<std::recursive_mutex> _l(mLock);
-    for( auto it = mMessageEnvelopes.begin();it != mMessageEnvelopes.end();it++){
-        const Message&m = it->message;
-        if((it->handler==handler)&&(m.what==what)&&((m.obj==obj)||(obj==nullptr))){
+    auto it = mHandlerMessages.find(handler);
+    MessageEnvelope* envelope = (it == mHandlerMessages.end()) ? nullptr : it->second;
+    for(;envelope;envelope = envelope->nextOfHandler){
+        const Message&m = envelope->message;
+        if((m.what==what)&&((m.obj==obj)||(obj==nullptr))){
            return true;
         }
     }
@@ -715,40 +854,58 @@ void Looper::removeMessages(const MessageHandler* handler) {
 #endif
     { // acquire lock
         std::lock_guard<std::recursive_mutex> _l(mLock);
-
-        for( auto it = mMessageEnvelopes.begin();it != mMessageEnvelopes.end();){
-            if(it->handler==handler){
-               it = mMessageEnvelopes.erase(it);
-               continue;
-            }it++;
-        } 
+        auto it = mHandlerMessages.find(handler);
+        if(it == mHandlerMessages.end())return;
+        MessageEnvelope* envelope = it->second;
+        MessageEnvelope* removed = nullptr;
+        while(envelope){
+            MessageEnvelope* next = envelope->nextOfHandler;
+            removeMessageLocked(envelope);
+            envelope->nextOfHandler = removed;
+            removed = envelope;
+            envelope = next;
+        }
+        recycleEnvelopesLocked(removed);
     } // release lock
 }
 
 void Looper::removeMessages(const MessageHandler* handler, int what) {
 #if DEBUG_CALLBACKS
-    LOGD("%p  removeMessages - handler=%p, what=%d size=%d", this, handler, what,mMessageEnvelopes.size());
+    LOGD("%p  removeMessages - handler=%p, what=%d size=%d", this, handler, what,mMessageHeap.size());
 #endif
     { // acquire lock
         std::lock_guard<std::recursive_mutex> _l(mLock);
-
-        for( auto it = mMessageEnvelopes.begin();it != mMessageEnvelopes.end();){
-            if((it->handler==handler) && (it->message.what==what)){
-                it = mMessageEnvelopes.erase(it);
-                continue;
-            }it++;
+        auto it = mHandlerMessages.find(handler);
+        MessageEnvelope* envelope = (it == mHandlerMessages.end()) ? nullptr : it->second;
+        MessageEnvelope* removed = nullptr;
+        while(envelope){
+            MessageEnvelope* next = envelope->nextOfHandler;
+            if(envelope->message.what==what){
+                removeMessageLocked(envelope);
+                envelope->nextOfHandler = removed;
+                removed = envelope;
+            }
+            envelope = next;
         }
+        recycleEnvelopesLocked(removed);
     } // release lock
 }
 
 void Looper::removeCallbacks(const MessageHandler* handler,const Runnable& r){
     std::lock_guard<std::recursive_mutex> _l(mLock);
-    for( auto it = mMessageEnvelopes.begin();it != mMessageEnvelopes.end();){
-        if((it->handler==handler) && (it->message.callback==r)){
-            it = mMessageEnvelopes.erase(it);
-            continue;
-        }it++;
+    auto it = mHandlerMessages.find(handler);
+    MessageEnvelope* envelope = (it == mHandlerMessages.end()) ? nullptr : it->second;
+    MessageEnvelope* removed = nullptr;
+    while(envelope){
+        MessageEnvelope* next = envelope->nextOfHandler;
+        if(envelope->message.callback==r){
+            removeMessageLocked(envelope);
+            envelope->nextOfHandler = removed;
+            removed = envelope;
+        }
+        envelope = next;
     }
+    recycleEnvelopesLocked(removed);
 }
 
 bool Looper::isPolling() const {
@@ -787,8 +944,9 @@ void MessageHandler::dispatchMessage(Message&message){
 void MessageHandler::handleIdle(){
 }
 
-EventHandler::EventHandler(){
+EventHandler::EventHandler():mReadyTime(0){
     mFlags = 0;
+    mEventLooper = nullptr;
 }
 
 EventHandler::~EventHandler(){
@@ -799,4 +957,29 @@ void EventHandler::setOwned(bool looper){
     else mFlags&=~FLAG_OWNED;
 }
 
+void EventHandler::setReadinessDriven(bool readiness){
+    if(readiness)mFlags|=FLAG_READINESS;
+    else mFlags&=~FLAG_READINESS;
+}
+
+bool EventHandler::isReadinessDriven()const{
+    return (mFlags&FLAG_READINESS)!=0;
+}
+
+void EventHandler::signalReady(){
+    signalReadyAt(0);
+}
+
+void EventHandler::signalReadyAt(nsecs_t uptimeMillis){
+    nsecs_t readyTime = mReadyTime.load();
+    while(uptimeMillis<readyTime){
+        if(mReadyTime.compare_exchange_weak(readyTime,uptimeMillis)){
+            /*the looper thread recomputes its timeout before blocking,only other threads need to wake it*/
+            if(mEventLooper && (Looper::getForThread()!=mEventLooper))
+                mEventLooper->wake();
+            break;
+        }
+    }
+}
+
 }
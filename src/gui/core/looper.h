@@ -21,6 +21,7 @@
 #include <vector>
 #include <mutex>
 #include <list>
+#include <atomic>
 #include <cstdint>
 #include <core/callbackbase.h>
 
@@ -61,15 +62,25 @@ public:
     virtual void handleIdle();
 };
 
+class Looper;
 class EventHandler{
 protected:
     uint32_t mFlags;
+    /*uptime(ms) at which a readiness driven handler wants to be checked,LLONG_MAX for not ready*/
+    std::atomic<nsecs_t> mReadyTime;
+    Looper* mEventLooper;
     friend class Looper;
 protected:
     EventHandler();
     virtual ~EventHandler();
     void setOwned(bool looper);
+    /*readiness driven handlers are only checked after signalReady(At),
+     *others are polled on every loop iteration*/
+    void setReadinessDriven(bool);
 public:
+    bool isReadinessDriven()const;
+    void signalReady();
+    void signalReadyAt(nsecs_t uptimeMillis);
     virtual int checkEvents()=0;
     virtual int handleEvents()=0;
 };
@@ -92,19 +103,23 @@ private:
     };
 
     struct MessageEnvelope {
-        MessageEnvelope() : uptime(0),handler(nullptr){}
-        MessageEnvelope(nsecs_t u, MessageHandler* h,
-            const Message& m) : uptime(u), handler(h), message(m) {
-        }
         nsecs_t uptime;
+        SequenceNumber seq;/*keeps messages with the same uptime in FIFO order*/
+        size_t heapIndex;
         MessageHandler* handler;
+        MessageEnvelope* prevOfHandler;/*intrusive list of the handler's pending messages*/
+        MessageEnvelope* nextOfHandler;
         Message message;
     };
-    
+    static constexpr size_t MAX_ENVELOPE_POOL_SIZE = 256;
+
     int  mWakeEventFd;// immutable
     std::recursive_mutex mLock;
 
-    std::list<MessageEnvelope> mMessageEnvelopes; // guarded by mLock
+    std::vector<MessageEnvelope*> mMessageHeap; // guarded by mLock,min-heap ordered by (uptime,seq)
+    std::vector<MessageEnvelope*> mEnvelopePool; // guarded by mLock,recycled envelopes
+    std::unordered_map<const MessageHandler*,MessageEnvelope*> mHandlerMessages; // guarded by mLock
+    SequenceNumber mNextMessageSeq; // guarded by mLock
     std::list<MessageHandler*>mHandlers;
     std::list<EventHandler*> mEventHandlers;
 
@@ -131,6 +146,7 @@ private:
 private:
     static Looper*sMainLooper;
     int doEventHandlers();
+    nsecs_t getNextEventHandlerUptime()const;
     int pollInner(int timeoutMillis);
     int removeSequenceNumberLocked(SequenceNumber seq);
     void awoken();
@@ -138,6 +154,12 @@ private:
     void rebuildEpollLocked();
     void scheduleEpollRebuildLocked();
     int  addFd(int fd, int ident, int events,const LooperCallback* callback1,Looper_callbackFunc callback2, void* data);
+    MessageEnvelope* obtainEnvelopeLocked();
+    void recycleEnvelopesLocked(MessageEnvelope*envelope);
+    void pushMessageLocked(MessageEnvelope*envelope);
+    void removeMessageLocked(MessageEnvelope*envelope);
+    void siftUpLocked(size_t index);
+    void siftDownLocked(size_t index);
 protected:
 public:
     enum {
@@ -194,6 +216,7 @@ public:
     void removeHandler(MessageHandler*);
     void addEventHandler(const EventHandler*handler);
     void removeEventHandler(const EventHandler*handler);
+    bool hasPolledEventHandlers()const;
 };
 }
 #endif
@@ -0,0 +1,234 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <core/trace.h>
+#include <core/systemclock.h>
+#include <porting/cdlog.h>
+#if defined(__linux__)||defined(__unix__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace cdroid{
+
+namespace{
+struct TraceEvent{
+    int64_t time;
+    const char*name;
+    int64_t value;
+    char phase;/*chrome trace phases:B E C b e*/
+};
+
+/*Written only by its own thread.A ring outlives its thread so that the events
+ *can still be exported,the next dump or clear frees it for a new thread*/
+enum RingState{RING_ACTIVE,RING_EXITED,RING_FREE};
+struct ThreadRing{
+    ThreadRing*next;
+    int tid;
+    char name[32];
+    std::atomic<int>state;
+    std::atomic<uint32_t>head;
+    TraceEvent events[Trace::MAX_EVENTS_PER_THREAD];
+};
+
+std::atomic<ThreadRing*>sRings(nullptr);
+
+struct RingOwner{
+    ThreadRing*ring = nullptr;
+    ~RingOwner(){
+        if(ring)ring->state.store(RING_EXITED,std::memory_order_release);
+    }
+};
+thread_local RingOwner tOwner;
+
+int currentTid(){
+#if defined(__linux__)
+    return int(syscall(SYS_gettid));
+#else
+    return int(std::hash<std::thread::id>()(std::this_thread::get_id())&0x7FFFFFFF);
+#endif
+}
+
+ThreadRing*claimRing(){
+    for(ThreadRing*ring = sRings.load(std::memory_order_acquire);ring;ring = ring->next){
+        int state = RING_FREE;
+        if(ring->state.compare_exchange_strong(state,RING_ACTIVE,std::memory_order_acq_rel))
+            return ring;
+    }
+    ThreadRing*ring = new ThreadRing();
+    ring->state.store(RING_ACTIVE,std::memory_order_relaxed);
+    ring->next = sRings.load(std::memory_order_relaxed);
+    while(!sRings.compare_exchange_weak(ring->next,ring,std::memory_order_release,std::memory_order_relaxed));
+    return ring;
+}
+
+ThreadRing*attachThread(){
+    ThreadRing*ring = claimRing();
+    ring->tid = currentTid();
+    snprintf(ring->name,sizeof(ring->name),"Thread-%d",ring->tid);
+    ring->head.store(0,std::memory_order_release);
+    tOwner.ring = ring;
+    return ring;
+}
+
+/*rings of finished threads are handed to new threads once their events were exported*/
+void releaseExitedRing(ThreadRing*ring){
+    int state = RING_EXITED;
+    ring->state.compare_exchange_strong(state,RING_FREE,std::memory_order_acq_rel);
+}
+
+void writeString(std::ostream&os,const char*s){
+    os<<'"';
+    for(;s&&*s;s++){
+        if((*s=='"')||(*s=='\\'))os<<'\\'<<*s;
+        else if(uint8_t(*s)>=0x20)os<<*s;
+    }
+    os<<'"';
+}
+
+void writeTime(std::ostream&os,int64_t nanos){
+    char buf[32];/*chrome expects microseconds*/
+    snprintf(buf,sizeof(buf),"%lld.%03d",(long long)(nanos/1000),int(nanos%1000));
+    os<<buf;
+}
+}/*endof anonymous namespace*/
+
+std::atomic<bool> Trace::sEnabled(false);
+
+void Trace::setEnabled(bool enabled){
+    sEnabled.store(enabled,std::memory_order_relaxed);
+    LOGI("tracing %s",enabled?"enabled":"disabled");
+}
+
+void Trace::record(char phase,const char*name,int64_t value){
+    ThreadRing*ring = tOwner.ring?tOwner.ring:attachThread();
+    const uint32_t pos = ring->head.load(std::memory_order_relaxed);
+    TraceEvent&e = ring->events[pos&(MAX_EVENTS_PER_THREAD-1)];
+    e.time = SystemClock::uptimeNanos();
+    e.name = name;
+    e.value= value;
+    e.phase= phase;
+    ring->head.store(pos+1,std::memory_order_release);
+}
+
+void Trace::beginSection(const char*sectionName){
+    record('B',sectionName,0);
+}
+
+void Trace::endSection(){
+    record('E',nullptr,0);
+}
+
+void Trace::beginAsyncSection(const char*methodName,int32_t cookie){
+    record('b',methodName,cookie);
+}
+
+void Trace::endAsyncSection(const char*methodName,int32_t cookie){
+    record('e',methodName,cookie);
+}
+
+void Trace::setCounter(const char*counterName,int64_t counterValue){
+    record('C',counterName,counterValue);
+}
+
+void Trace::setThreadName(const char*name){
+    ThreadRing*ring = tOwner.ring?tOwner.ring:attachThread();
+    snprintf(ring->name,sizeof(ring->name),"%s",name);
+}
+
+size_t Trace::getEventCount(){
+    size_t count = 0;
+    for(ThreadRing*ring = sRings.load(std::memory_order_acquire);ring;ring = ring->next){
+        if(ring->state.load(std::memory_order_acquire)==RING_FREE)continue;
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        count += std::min<uint32_t>(head,MAX_EVENTS_PER_THREAD);
+    }
+    return count;
+}
+
+void Trace::clear(){
+    for(ThreadRing*ring = sRings.load(std::memory_order_acquire);ring;ring = ring->next){
+        ring->head.store(0,std::memory_order_release);
+        releaseExitedRing(ring);
+    }
+}
+
+void Trace::dump(std::ostream&os){
+#if defined(__linux__)||defined(__unix__)
+    const int pid = getpid();
+#else
+    const int pid = 0;
+#endif
+    bool first = true;
+    auto separate=[&os,&first](){
+        if(!first)os<<",\n";
+        first = false;
+    };
+    os<<"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    for(ThreadRing*ring = sRings.load(std::memory_order_acquire);ring;ring = ring->next){
+        if(ring->state.load(std::memory_order_acquire)==RING_FREE)continue;
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        const uint32_t start= (head>MAX_EVENTS_PER_THREAD)?head-MAX_EVENTS_PER_THREAD:0;
+        separate();
+        os<<"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"<<pid<<",\"tid\":"<<ring->tid<<",\"args\":{\"name\":";
+        writeString(os,ring->name);
+        os<<"}}";
+        int depth = 0;/*the oldest events may have been overwritten,skip their unmatched ends*/
+        for(uint32_t i = start;i != head;i++){
+            const TraceEvent&e = ring->events[i&(MAX_EVENTS_PER_THREAD-1)];
+            if(e.phase=='B')depth++;
+            else if(e.phase=='E'){
+                if(depth==0)continue;
+                depth--;
+            }
+            separate();
+            os<<"{\"ph\":\""<<e.phase<<"\",\"ts\":";
+            writeTime(os,e.time);
+            os<<",\"pid\":"<<pid<<",\"tid\":"<<ring->tid;
+            if(e.phase!='E'){
+                os<<",\"name\":";
+                writeString(os,e.name);
+            }
+            if(e.phase=='C')
+                os<<",\"args\":{\"value\":"<<e.value<<"}";
+            else if((e.phase=='b')||(e.phase=='e'))
+                os<<",\"cat\":\"async\",\"id\":"<<e.value;
+            os<<"}";
+        }
+        releaseExitedRing(ring);
+    }
+    os<<"\n]}\n";
+}
+
+bool Trace::dump(const std::string&path){
+    std::ofstream fs(path);
+    if(!fs.is_open()){
+        LOGE("can't open %s for trace",path.c_str());
+        return false;
+    }
+    const size_t count = getEventCount();
+    dump(fs);
+    LOGI("%d trace events saved to %s",int(count),path.c_str());
+    return fs.good();
+}
+
+}/*endof namespace*/
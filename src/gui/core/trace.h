@@ -0,0 +1,84 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __CDROID_TRACE_H__
+#define __CDROID_TRACE_H__
+#include <atomic>
+#include <string>
+#include <ostream>
+#include <cstdint>
+namespace cdroid{
+
+/*Lightweight tracing in the spirit of android.os.Trace.
+ *Sections,counters and async slices are recorded into per thread rings
+ *with nanosecond uptime stamps,the recording thread never locks.
+ *The ring of a finished thread is kept until the next dump() or clear(),
+ *then reused by a new thread.
+ *Names are kept by pointer and must be string literals.
+ *Everything is compiled in,nothing is recorded until setEnabled(true).
+ *dump() writes the Chrome trace event JSON,loadable by Perfetto and chrome://tracing*/
+class Trace{
+public:
+    static constexpr int MAX_EVENTS_PER_THREAD = 8192;/*must be a power of 2,older events are overwritten*/
+private:
+    static std::atomic<bool> sEnabled;
+    static void record(char phase,const char*name,int64_t value);
+public:
+    static bool isEnabled(){
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled);
+    static void beginSection(const char*sectionName);
+    static void endSection();
+    /*async slices may begin and end on different threads,the cookie pairs them*/
+    static void beginAsyncSection(const char*methodName,int32_t cookie);
+    static void endAsyncSection(const char*methodName,int32_t cookie);
+    static void setCounter(const char*counterName,int64_t counterValue);
+    /*names the calling thread in the exported trace*/
+    static void setThreadName(const char*name);
+    static size_t getEventCount();
+    static void clear();
+    /*rings may still be written while dumping,disable tracing first for an exact snapshot*/
+    static void dump(std::ostream&os);
+    static bool dump(const std::string&path);
+};
+
+class ScopedTrace{
+private:
+    bool mActive;
+public:
+    explicit ScopedTrace(const char*name):mActive(Trace::isEnabled()){
+        if(mActive)Trace::beginSection(name);
+    }
+    ~ScopedTrace(){
+        if(mActive)Trace::endSection();
+    }
+};
+
+}/*endof namespace*/
+
+#define ATRACE_CONCAT_(a,b) a##b
+#define ATRACE_CONCAT(a,b) ATRACE_CONCAT_(a,b)
+#define ATRACE_NAME(name) cdroid::ScopedTrace ATRACE_CONCAT(__atrace_,__LINE__)(name)
+#define ATRACE_CALL() ATRACE_NAME(__FUNCTION__)
+#define ATRACE_BEGIN(name) do{ if(cdroid::Trace::isEnabled())cdroid::Trace::beginSection(name); }while(0)
+#define ATRACE_END() do{ if(cdroid::Trace::isEnabled())cdroid::Trace::endSection(); }while(0)
+#define ATRACE_INT(name,value) do{ if(cdroid::Trace::isEnabled())cdroid::Trace::setCounter(name,value); }while(0)
+#define ATRACE_ASYNC_BEGIN(name,cookie) do{ if(cdroid::Trace::isEnabled())cdroid::Trace::beginAsyncSection(name,cookie); }while(0)
+#define ATRACE_ASYNC_END(name,cookie) do{ if(cdroid::Trace::isEnabled())cdroid::Trace::endAsyncSection(name,cookie); }while(0)
+
+#endif/*__CDROID_TRACE_H__*/
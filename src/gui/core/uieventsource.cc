@@ -17,15 +17,20 @@
  *********************************************************************************/
 #include <uieventsource.h>
 #include <windowmanager.h>
+#include <inputlatencytracker.h>
 #include <cdlog.h>
 #include <systemclock.h>
-#include <list>
+#include <trace.h>
+#include <algorithm>
 
 namespace cdroid{
 
 UIEventSource::UIEventSource(View*v,const Runnable&r):mLayoutRunner(r){
+    mRunnerSeq = 0;
+    mRemovedCount = 0;
     mAttachedView = dynamic_cast<ViewGroup*>(v);
     setOwned(true);
+    setReadinessDriven(true);
 }
 
 UIEventSource::~UIEventSource(){
@@ -33,13 +38,25 @@ UIEventSource::~UIEventSource(){
 
 void UIEventSource::cleanUp(){
     mRunnables.clear();
+    mRunnerStates.clear();
+    mRemovedCount = 0;
+}
+
+void UIEventSource::signalNextRunner(){
+    /*runners are due one ms after their time,see handleRunnables*/
+    dropRemovedRunners();
+    if(mRunnables.size())
+        signalReadyAt(std::max(mRunnables.front().time,(nsecs_t)SystemClock::uptimeMillis())+1);
 }
 
 int UIEventSource::checkEvents(){
-    return hasDelayedRunners()||(mAttachedView&&mAttachedView->isDirty())
+    const int ret = hasDelayedRunners()||(mAttachedView&&mAttachedView->isDirty())
            ||mAttachedView->isLayoutRequested()
            //||mAttachInfo->mViewRequestingLayout
            ||GraphDevice::getInstance().needCompose();
+    /*readiness is consumed before checking,keep the next runner armed*/
+    if(ret==0)signalNextRunner();
+    return ret;
 }
 
 void UIEventSource::handleCompose(){
@@ -54,6 +71,7 @@ void UIEventSource::handleCompose(){
 }
 
 int UIEventSource::handleRunnables(){
+    ATRACE_NAME("UIEventSource::handleRunnables");
     int count=0;
     GraphDevice::getInstance().lock();
     if ( ((mFlags&1)==0) && mAttachedView && mAttachedView->isAttachedToWindow()){
@@ -61,17 +79,18 @@ int UIEventSource::handleRunnables(){
         //    mLayoutRunner();
         const nsecs_t nowms = SystemClock::uptimeMillis()-1;/*-1 to prevent postDelay(mRunable,0)in some Runnable*/
         //maybe user will removed runnable itself in its runnable'proc,so we use removed flag to flag it
+        Runnable run;
         while(mRunnables.size() && ((mFlags&1)==0)){
-            RUNNER runner = mRunnables.front();
-            if(runner.time > nowms)break;
-            mRunnables.pop_front();
-            if(runner.run)runner.run();
+            if(mRunnables.front().time > nowms)break;
+            if(!popRunner(&run))continue;
+            if(run)run();
             count++;
         }
         if(((mFlags&1)==0)&&mAttachedView->isLayoutRequested())
             mLayoutRunner();
         if(((mFlags&1)==0) && mAttachedView->isDirty() && mAttachedView->getVisibility()==View::VISIBLE){
             ((Window*)mAttachedView)->draw();
+            InputLatencyTracker::getInstance().onFrameDrawn();
             GraphDevice::getInstance().flip();
         }
     }
@@ -82,53 +101,91 @@ int UIEventSource::handleRunnables(){
 int UIEventSource::handleEvents(){
     handleRunnables();
     handleCompose();
+    signalNextRunner();
     return 0;
 }
 
-#pragma GCC push_options
-#pragma GCC optimize("O0")
-//codes between pragma will crashed in ubuntu GCC V8.x,bus GCC V7 wroked well.
+bool UIEventSource::isLaterRunner(const RUNNER&a,const RUNNER&b){
+    return (a.time > b.time) || ((a.time == b.time) && (a.seq > b.seq));
+}
+
+/*pops the earliest runner,returns false if it was removed*/
+bool UIEventSource::popRunner(Runnable*run){
+    std::pop_heap(mRunnables.begin(),mRunnables.end(),isLaterRunner);
+    RUNNER&runner = mRunnables.back();
+    auto it = mRunnerStates.find(runner.run.getId());
+    const bool removed = runner.seq < it->second.removedBefore;
+    if(removed) mRemovedCount--;
+    else it->second.pending--;
+    if(--it->second.queued == 0)
+        mRunnerStates.erase(it);
+    if(run && !removed) *run = std::move(runner.run);
+    mRunnables.pop_back();
+    return !removed;
+}
+
+void UIEventSource::dropRemovedRunners(){
+    while(mRemovedCount && mRunnables.size()){
+        const RUNNER&runner = mRunnables.front();
+        if(runner.seq >= mRunnerStates.find(runner.run.getId())->second.removedBefore)break;
+        popRunner(nullptr);
+    }
+}
+
+/*rebuilds the heap once removed runners outnumber the live ones*/
+void UIEventSource::compactRunners(){
+    if((mRemovedCount < 32) || (mRemovedCount*2 < mRunnables.size()))
+        return;
+    auto end = std::remove_if(mRunnables.begin(),mRunnables.end(),[this](const RUNNER&runner){
+        auto it = mRunnerStates.find(runner.run.getId());
+        if(runner.seq >= it->second.removedBefore)
+            return false;
+        if(--it->second.queued == 0)
+            mRunnerStates.erase(it);
+        return true;
+    });
+    mRunnables.erase(end,mRunnables.end());
+    std::make_heap(mRunnables.begin(),mRunnables.end(),isLaterRunner);
+    mRemovedCount = 0;
+}
+
 bool UIEventSource::postDelayed(const Runnable& run,long delayedtime){
     RUNNER runner;
     runner.run = run;
     runner.time = SystemClock::uptimeMillis() + delayedtime;
+    runner.seq = mRunnerSeq++;
 
-    for(auto itr = mRunnables.begin();itr != mRunnables.end();itr++){
-        if(runner.time < itr->time){
-            mRunnables.insert(itr,runner);
-            return true;
-        }
-    }
-    mRunnables.push_back(runner);
+    RunnerState&state = mRunnerStates[run.getId()];
+    state.pending++;
+    state.queued++;
+    signalReadyAt(runner.time+1);
+    mRunnables.push_back(std::move(runner));
+    std::push_heap(mRunnables.begin(),mRunnables.end(),isLaterRunner);
     return true;
 }
-#pragma GCC pop_options
 
-bool UIEventSource::hasDelayedRunners()const{
+bool UIEventSource::hasDelayedRunners(){
+    dropRemovedRunners();
     if(mRunnables.empty())return false;
-    nsecs_t nowms = SystemClock::uptimeMillis();
-    RUNNER runner = mRunnables.front();
-    return runner.time < nowms;
+    const nsecs_t nowms = SystemClock::uptimeMillis();
+    return mRunnables.front().time < nowms;
 }
 
 int UIEventSource::removeCallbacks(const Runnable& what){
-    int count=0;
-    for(auto it = mRunnables.begin();it != mRunnables.end();){
-        if(it->run == what){
-            it = mRunnables.erase(it);
-            count++;
-        }else it++;
-    }
+    auto it = mRunnerStates.find(what.getId());
+    if(it == mRunnerStates.end())
+        return 0;
+    const int count = it->second.pending;
+    it->second.pending = 0;
+    it->second.removedBefore = mRunnerSeq;
+    mRemovedCount += count;
+    compactRunners();
     return count;
 }
 
 bool UIEventSource::hasCallbacks(const Runnable& what)const{
-    for(auto it = mRunnables.begin();it != mRunnables.end();){
-        if(it->run == what){
-            return true;
-        }
-    }
-    return false;
+    auto it = mRunnerStates.find(what.getId());
+    return (it != mRunnerStates.end()) && (it->second.pending > 0);
 }
 
 }//end namespace
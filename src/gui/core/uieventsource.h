@@ -18,21 +18,38 @@
 #ifndef __UIEVENT_SOURCE_H__
 #define __UIEVENT_SOURCE_H__
 #include <core/looper.h>
-#include <list>
-#include <unordered_set>
+#include <vector>
+#include <unordered_map>
 #include <view/view.h>
 namespace cdroid{
 
 class UIEventSource:public EventHandler{
 private:
-    typedef struct{
+    /*mRunnables is a min heap on (time,seq),seq keeps runners due at the same time in post order*/
+    struct RUNNER{
         nsecs_t  time;
+        uint64_t seq;
         Runnable run;
-    }RUNNER;
-    std::list<RUNNER>mRunnables;
+    };
+    /*removeCallbacks only marks the runners of a Runnable as removed,they are
+     *dropped when they reach the top of the heap or when the heap is compacted*/
+    struct RunnerState{
+        int pending;/*runners of this Runnable still to run*/
+        int queued; /*its entries in the heap,removed ones included*/
+        uint64_t removedBefore;/*its entries with a lower seq are removed*/
+    };
+    std::vector<RUNNER>mRunnables;
+    std::unordered_map<const void*,RunnerState>mRunnerStates;
+    uint64_t mRunnerSeq;
+    size_t mRemovedCount;
     Runnable mLayoutRunner;
     ViewGroup*mAttachedView;
-    bool hasDelayedRunners()const;
+    static bool isLaterRunner(const RUNNER&a,const RUNNER&b);
+    bool popRunner(Runnable*run);
+    void dropRemovedRunners();
+    void compactRunners();
+    bool hasDelayedRunners();
+    void signalNextRunner();
     void handleCompose();
     int handleRunnables();
 public:
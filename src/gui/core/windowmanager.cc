@@ -21,6 +21,7 @@
 #include <core/graphdevice.h>
 #include <core/windowmanager.h>
 #include <core/uieventsource.h>
+#include <core/inputlatencytracker.h>
 #include <mutex>
 
 namespace cdroid {
@@ -165,10 +166,19 @@ void WindowManager::removeWindow(Window*w){
         } 
     }
     //GraphDevice::getInstance().invalidate(wrect);
-    GraphDevice::getInstance().flip();
+    requestCompose();
     LOGI("w=%p windows.size=%d",w,mWindows.size());
 }
 
+void WindowManager::requestCompose(){
+    GraphDevice::getInstance().flip();
+#if !USE_UIEVENTHANDLER
+    /*surfaces are composed by the windows' event sources,which only run when signaled*/
+    if(mWindows.size())
+        mWindows.back()->mUIEventHandler->signalReady();
+#endif
+}
+
 void WindowManager::removeWindows(const std::vector<Window*>&ws){
     Cairo::RefPtr<Cairo::Region>rgn=Cairo::Region::create();
     for(auto w:ws){
@@ -214,7 +224,7 @@ void WindowManager::removeWindows(const std::vector<Window*>&ws){
     }
     //const Cairo::RectangleInt re = rgn->get_extents();
     //GraphDevice::getInstance().invalidate({re.x,re.y,re.width,re.height});
-    GraphDevice::getInstance().flip();
+    requestCompose();
 }
 
 void WindowManager::moveWindow(Window*w,int x,int y){
@@ -238,7 +248,7 @@ void WindowManager::moveWindow(Window*w,int x,int y){
            (*it)->mPendingRgn->do_union((Cairo::RectangleInt&)rcw);
            (*it)->mPendingRgn->subtract((Cairo::RectangleInt&)rcw2);
         }
-        GraphDevice::getInstance().flip();
+        requestCompose();
     }
 }
 
@@ -263,7 +273,7 @@ void WindowManager::sendToBack(Window*win){
     mActiveWindow->post([newActWin](){
         newActWin->onActive();
     });
-    GraphDevice::getInstance().flip();
+    requestCompose();
 }
 
 void WindowManager::bringToFront(Window*win){
@@ -285,7 +295,7 @@ void WindowManager::bringToFront(Window*win){
     });
     mActiveWindow = win;
     win->mPendingRgn->do_union({0,0,win->getWidth(),win->getHeight()});
-    GraphDevice::getInstance().flip();
+    requestCompose();
 }
 
 int WindowManager::enumWindows(WNDENUMPROC cbk){
@@ -309,6 +319,7 @@ int WindowManager::getVisibleWindows(std::vector<Window*>&wins){
 }
 
 void WindowManager::processEvent(InputEvent&e){
+   InputLatencyTracker::getInstance().onEventDispatched(e);
    switch(e.getType()){
    case InputEvent::INPUT_EVENT_TYPE_KEY: onKeyEvent((KeyEvent&)e); break;
    case InputEvent::INPUT_EVENT_TYPE_MOTION: onMotion((MotionEvent&)e);break;
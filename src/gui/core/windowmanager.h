@@ -37,6 +37,7 @@ private:
 private:
     friend class GraphDevice;
     WindowManager();
+    void requestCompose();
 public:
     DECLARE_UIEVENT(bool,WNDENUMPROC,Window*);
     class LayoutParams:public ViewGroup::LayoutParams{
@@ -27,8 +27,6 @@
 #include <future>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <atomic>
 #if HAVE_SYS_PRCTL_H
 #include <sys/prctl.h>
@@ -39,10 +37,9 @@
 namespace cdroid{
 #define ENABLE_DMABLIT 0
 
-std::queue<std::pair<AnimatedImageDrawable*, int>> AnimatedImageDrawable::sDecodeQueue;
+/*each drawable has at most one frame queued*/
+MPSCQueue<std::pair<AnimatedImageDrawable*, int>> AnimatedImageDrawable::sDecodeQueue(64);
 std::thread AnimatedImageDrawable::sDecodeThread;
-std::mutex AnimatedImageDrawable::sDecodeMutex;
-std::condition_variable AnimatedImageDrawable::sDecodeCV;
 
 AnimatedImageDrawable::AnimatedImageDrawable()
   :AnimatedImageDrawable(std::make_shared<AnimatedImageState>()){
@@ -130,18 +127,9 @@ AnimatedImageDrawable::~AnimatedImageDrawable(){
     Choreographer::getInstance().removeCallbacks(Choreographer::CALLBACK_ANIMATION,nullptr,this);
     if(mRunnable) unscheduleSelf(mRunnable);
     mRunnable = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(sDecodeMutex);
-        std::queue<std::pair<AnimatedImageDrawable*, int>> filteredQueue;
-        while(!sDecodeQueue.empty()){
-            auto task = sDecodeQueue.front();
-            sDecodeQueue.pop();
-            if(task.first != this){
-                filteredQueue.push(task);
-            }
-        }
-        std::swap(sDecodeQueue, filteredQueue);
-    }
+    /*a queued frame can't be taken back from the lock free queue,wait for the worker to finish it*/
+    if(mDecodeFuture.valid())
+        mDecodeFuture.wait();
     while(mDecodeInProgress){
         std::this_thread::yield();
     }
@@ -452,11 +440,11 @@ int AnimatedImageDrawable::AnimatedImageState::getChangingConfigurations()const{
 void AnimatedImageDrawable::submitDecodeTask(int frameIndex) {
     mDecodePromise = std::promise<void>();
     mDecodeFuture = mDecodePromise.get_future();
-    {
-        std::lock_guard<std::mutex> lock(sDecodeMutex);
-        sDecodeQueue.push({this, frameIndex});
+    /*never block the UI thread on a full queue,the dropped frame is decoded by draw() when it is due*/
+    if(!sDecodeQueue.offer({this, frameIndex})){
+        LOGV("%p decode queue full,frame %d dropped",this,frameIndex);
+        mDecodeFuture = std::shared_future<void>();
     }
-    sDecodeCV.notify_one();
 }
 
 void AnimatedImageDrawable::decodeWorker() {
@@ -466,18 +454,10 @@ void AnimatedImageDrawable::decodeWorker() {
     pthread_setname_np(pthread_self(), "AniImageDecoder");
 #endif
     while(true) {
-        std::pair<AnimatedImageDrawable*, int> task;
-        AnimatedImageDrawable* instance = nullptr;
-        int frameIndex = -1;
-        {
-            std::unique_lock<std::mutex> lock(sDecodeMutex);
-            sDecodeCV.wait(lock, []{ return !sDecodeQueue.empty(); });
-            task = sDecodeQueue.front();
-            sDecodeQueue.pop();
-            instance = task.first;
-            frameIndex = task.second;
-            instance->mDecodeInProgress = true;
-        }
+        std::pair<AnimatedImageDrawable*, int> task = sDecodeQueue.take();
+        AnimatedImageDrawable* instance = task.first;
+        const int frameIndex = task.second;
+        instance->mDecodeInProgress = true;
         // decode
         const int prevFrame = (frameIndex - 1 + instance->mAnimatedImageState->mFrameCount) % instance->mAnimatedImageState->mFrameCount;
         {
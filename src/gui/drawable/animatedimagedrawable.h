@@ -22,9 +22,8 @@
 #include <future>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <atomic>
+#include <utils/lockfreequeue.h>
 namespace cdroid{
 class FrameSequence;
 class FrameSequenceState;
@@ -69,10 +68,8 @@ private:
     std::shared_ptr<Cairo::ImageSurface> mDecodeImage;
     std::atomic<bool> mDecodeInProgress;
     std::mutex mFrameSequenceMutex;
-    static std::queue<std::pair<AnimatedImageDrawable*, int>> sDecodeQueue;
+    static MPSCQueue<std::pair<AnimatedImageDrawable*, int>> sDecodeQueue;
     static std::thread sDecodeThread;
-    static std::mutex sDecodeMutex;
-    static std::condition_variable sDecodeCV;
     void postOnAnimationStart();
     void postOnAnimationEnd();
     void updateStateFromTypedArray(const AttributeSet&atts,int srcDensityOverride);
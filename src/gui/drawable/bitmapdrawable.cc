@@ -49,6 +49,8 @@ BitmapDrawable::BitmapState::BitmapState(RefPtr<ImageSurface>bitmap)
 
 BitmapDrawable::BitmapState::BitmapState(const BitmapState&bitmapState){
     mBitmap = bitmapState.mBitmap;
+    mAtlasRegion = bitmapState.mAtlasRegion;
+    mExtracted = bitmapState.mExtracted;
     mTint   = bitmapState.mTint;
     mTintMode   = bitmapState.mTintMode;
     mThemeAttrs = bitmapState.mThemeAttrs;
@@ -73,6 +75,8 @@ BitmapDrawable::BitmapState::BitmapState(const BitmapState&bitmapState){
 
 BitmapDrawable::BitmapState::~BitmapState(){
     mBitmap = nullptr;
+    mAtlasRegion = nullptr;
+    mExtracted = nullptr;
     LOGV("%p %s",this,mResource.c_str());
 }
 
@@ -104,19 +108,9 @@ BitmapDrawable::BitmapDrawable(std::shared_ptr<BitmapState>state){
 
 BitmapDrawable::BitmapDrawable(Context*ctx,const std::string&resname)
   :BitmapDrawable(std::make_shared<BitmapState>()){
-    RefPtr<ImageSurface>b;
-#if 0
-    std::ifstream fs(resname,std::ios::binary);
-    if((ctx==nullptr)||fs.good()){
-        b = ImageSurface::create_from_stream(fs);
-    }else {
-        b = ctx->loadImage(resname);
-    }
-#else
-    b = ImageDecoder::loadImage(ctx,resname);
-#endif
     mBitmapState->mResource = resname;
-    setBitmap(b);
+    loadBitmap(ctx,resname);
+    RefPtr<ImageSurface>b = mBitmapState->mBitmap;
 #if defined(DEBUG) && ( defined(__x86_64__) || defined(__i386__) )
     const char*tNames[] = {"UNKNOWN","TRANSLUCENT","TRANSPARENT","OPAQUE"};
     DisplayMetrics dm = ctx->getDisplayMetrics();
@@ -134,17 +128,48 @@ BitmapDrawable::~BitmapDrawable(){
 }
 
 RefPtr<ImageSurface> BitmapDrawable::getBitmap()const{
+    if(mBitmapState->mAtlasRegion){
+        /*extracted once,the region is immutable and drops the copy only with the bitmap*/
+        if(mBitmapState->mExtracted == nullptr)
+            mBitmapState->mExtracted = mBitmapState->mAtlasRegion->extract();
+        return mBitmapState->mExtracted;
+    }
     return mBitmapState->mBitmap;
 }
 
 void BitmapDrawable::setBitmap(RefPtr<ImageSurface>bmp){
     mBitmapState->mBitmap = bmp;
+    mBitmapState->mAtlasRegion = nullptr;
+    mBitmapState->mExtracted = nullptr;
     mBitmapState->mTransparency = ImageDecoder::getTransparency(bmp);
     mDstRectAndInsetsDirty = true;
     computeBitmapSize();
     invalidateSelf();
 }
 
+/*small untiled bitmaps are shared from the context's atlas when it is enabled*/
+void BitmapDrawable::loadBitmap(Context*ctx,const std::string&resid){
+    ImageAtlas*atlas = ctx ? ctx->getImageAtlas() : nullptr;
+    const bool tiled = (mBitmapState->mTileModeX!=TileMode::DISABLED)||(mBitmapState->mTileModeY!=TileMode::DISABLED);
+    std::shared_ptr<ImageAtlas::Region>region = (atlas&&!tiled) ? atlas->get(resid) : nullptr;
+    if(region == nullptr){
+        RefPtr<ImageSurface>bmp = ImageDecoder::loadImage(ctx,resid);
+        if(atlas && !tiled && bmp && atlas->isCandidate(resid,bmp->get_width(),bmp->get_height()))
+            region = atlas->add(resid,bmp);
+        if(region == nullptr){
+            setBitmap(bmp);
+            return;
+        }
+    }
+    mBitmapState->mBitmap = nullptr;
+    mBitmapState->mAtlasRegion = region;
+    mBitmapState->mExtracted = nullptr;
+    mBitmapState->mTransparency = region->getTransparency();
+    mDstRectAndInsetsDirty = true;
+    computeBitmapSize();
+    invalidateSelf();
+}
+
 int BitmapDrawable::getAlpha()const{
     return mBitmapState->mAlpha;
 }
@@ -209,7 +234,7 @@ bool BitmapDrawable::isAutoMirrored()const{
 int BitmapDrawable::getOpacity()const{
     if(mBitmapState->mGravity != Gravity::FILL)
         return PixelFormat::TRANSLUCENT;
-    if(mBitmapState->mBitmap==nullptr)
+    if((mBitmapState->mBitmap==nullptr)&&(mBitmapState->mAtlasRegion==nullptr))
         return PixelFormat::TRANSPARENT;
 
     return mBitmapState->mTransparency;
@@ -253,7 +278,7 @@ void BitmapDrawable::setMipMap(bool mipMap) {
 }
 
 bool BitmapDrawable::hasMipMap() const{
-    return mBitmapState->mBitmap!=nullptr;  //&& mBitmapStatemBitmap.hasMipMap();
+    return (mBitmapState->mBitmap!=nullptr)||(mBitmapState->mAtlasRegion!=nullptr);  //&& mBitmapStatemBitmap.hasMipMap();
 }
 
 void BitmapDrawable::setAntiAlias(bool aa) {
@@ -280,6 +305,9 @@ void BitmapDrawable::computeBitmapSize() {
     if (mBitmapState->mBitmap != nullptr) {
         mBitmapWidth = mBitmapState->mBitmap->get_width();//getScaledWidth(mTargetDensity);
         mBitmapHeight= mBitmapState->mBitmap->get_height();//getScaledHeight(mTargetDensity);
+    } else if(mBitmapState->mAtlasRegion != nullptr){
+        mBitmapWidth = mBitmapState->mAtlasRegion->getRect().width;
+        mBitmapHeight= mBitmapState->mAtlasRegion->getRect().height;
     } else {
         mBitmapWidth = mBitmapHeight = -1;
     }
@@ -355,11 +383,11 @@ static int getRotateAngle(Canvas&canvas){
 }
 
 void BitmapDrawable::draw(Canvas&canvas){
-    if(mBitmapState->mBitmap==nullptr) return;
+    if((mBitmapState->mBitmap==nullptr)&&(mBitmapState->mAtlasRegion==nullptr)) return;
     updateDstRectAndInsetsIfDirty();
     LOGV("BitmapSize=%dx%d bounds=%d,%d-%d,%d dst=%d,%d-%d,%d alpha=%d mColorFilter=%p",mBitmapWidth,mBitmapHeight,
             mBounds.left,mBounds.top,mBounds.width,mBounds.height, mDstRect.left,mDstRect.top,
-	    mDstRect.width,mDstRect.height,mBitmapState->mAlpha,mTintFilter);
+	    mDstRect.width,mDstRect.height,mBitmapState->mAlpha,mTintFilter.get());
 
     LOGD_IF(mBounds.empty(),"%p's(%d,%d) bounds is empty,skip drawing,otherwise will caused crash",this,mBitmapWidth,mBitmapHeight);
     if(mBounds.empty())return;
@@ -382,7 +410,14 @@ void BitmapDrawable::draw(Canvas&canvas){
         canvas.set_antialias(Cairo::ANTIALIAS_DEFAULT);
 
     if((mBitmapState->mTileModeX>=0)||(mBitmapState->mTileModeY>=0)){
-        RefPtr<SurfacePattern> pat =SurfacePattern::create(mBitmapState->mBitmap);
+        if(mBitmapState->mBitmap == nullptr){
+            /*tiling needs a standalone surface,take the bitmap out of the atlas once*/
+            mBitmapState->mBitmap = getBitmap();
+            mBitmapState->mAtlasRegion = nullptr;
+            mBitmapState->mExtracted = nullptr;
+        }
+        RefPtr<ImageSurface>bitmap = mBitmapState->mBitmap;
+        RefPtr<SurfacePattern> pat =SurfacePattern::create(bitmap);
         if(mBitmapState->mTileModeX!=TileMode::DISABLED){
             RefPtr<Surface> subs = ImageSurface::create(Surface::Format::ARGB32,mBounds.width,mBitmapHeight);
             RefPtr<Cairo::Context> subcanvas = Cairo::Context::create(subs);
@@ -442,7 +477,13 @@ void BitmapDrawable::draw(Canvas&canvas){
             canvas.translate(mDstRect.width,0);
             canvas.scale(-1.f,1.f);
         }
-        canvas.set_source(mBitmapState->mBitmap, dx, dy);
+        if(mBitmapState->mAtlasRegion){
+            /*the region is surrounded by a transparent gap,so clipping to bounds is enough*/
+            const Rect& rc = mBitmapState->mAtlasRegion->getRect();
+            canvas.set_source(mBitmapState->mAtlasRegion->getSurface(), dx - rc.left, dy - rc.top);
+        }else{
+            canvas.set_source(mBitmapState->mBitmap, dx, dy);
+        }
         if(getOpacity()==PixelFormat::OPAQUE){
             canvas.set_operator(Cairo::Context::Operator::SOURCE);
         }
@@ -482,8 +523,6 @@ void BitmapDrawable::updateStateFromTypedArray(const AttributeSet&atts){
 
 void BitmapDrawable::inflate(XmlPullParser&parser,const AttributeSet&atts){
     Drawable::inflate(parser,atts);
-    auto bmp = ImageDecoder::loadImage(atts.getContext(),atts.getString("src"));
-    mBitmapState->mBitmap = bmp;
     static std::unordered_map<std::string,int>kvs={
           {"disabled",TileMode::DISABLED},
           {"clamp",TileMode::CLAMP},
@@ -497,7 +536,7 @@ void BitmapDrawable::inflate(XmlPullParser&parser,const AttributeSet&atts){
     mBitmapState->mGravity = atts.getGravity("gravity",Gravity::CENTER);
     mBitmapState->mFilterBitmap=atts.getBoolean("filter",false);
     mBitmapState->mAntiAlias=atts.getBoolean("antialias",true);
-    setBitmap(bmp);//computeBitmapSize();
+    loadBitmap(atts.getContext(),atts.getString("src"));//computeBitmapSize();
 }
 
 }
@@ -18,6 +18,7 @@
 #ifndef __BITMAP_DRAWABLE_H__
 #define __BITMAP_DRAWABLE_H__
 #include <drawable/drawable.h>
+#include <drawable/imageatlas.h>
 #include <cairomm/surface.h>
 #include <cairomm/refptr.h>
 namespace cdroid{
@@ -50,6 +51,8 @@ private:
         int mSrcDensityOverride;
         int mTargetDensity;
         Cairo::RefPtr<Cairo::ImageSurface>mBitmap;
+        std::shared_ptr<ImageAtlas::Region>mAtlasRegion;/*set instead of mBitmap when packed into atlas*/
+        mutable Cairo::RefPtr<Cairo::ImageSurface>mExtracted;/*copy of mAtlasRegion made by getBitmap()*/
         BitmapState();
         BitmapState(Cairo::RefPtr<Cairo::ImageSurface>bitmap);
         BitmapState(const BitmapState&bitmapState);
@@ -64,6 +67,7 @@ private:
     cdroid::RefPtr<PorterDuffColorFilter>mTintFilter;
     bool needMirroring();
     void computeBitmapSize();
+    void loadBitmap(Context*ctx,const std::string&resid);
     void updateDstRectAndInsetsIfDirty();
     BitmapDrawable(std::shared_ptr<BitmapState>state);
     void updateStateFromTypedArray(const AttributeSet&atts);
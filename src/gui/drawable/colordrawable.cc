@@ -161,7 +161,7 @@ void ColorDrawable::getOutline(Outline& outline) {
 
 void ColorDrawable::draw(Canvas&canvas){
     LOGV("%p color=%x  bounds=%d,%d-%d,%d mTintFilter=%p",this,mColorState->mUseColor,
-	mBounds.left,mBounds.top,mBounds.width,mBounds.height,mTintFilter);
+	mBounds.left,mBounds.top,mBounds.width,mBounds.height,mTintFilter.get());
     canvas.save();
     if((mColorState->mUseColor>>24)||mTintFilter){
         canvas.set_color(mColorState->mUseColor);
@@ -151,7 +151,7 @@ bool Drawable::isFilterBitmap()const{
 void Drawable::setColorFilter(const cdroid::RefPtr<ColorFilter>&cf) {
     mColorFilter = cf;
     invalidateSelf();
-    LOGV("setColorFilter %p:%p",this,cf);
+    LOGV("setColorFilter %p:%p",this,cf.get());
 }
 
 const cdroid::RefPtr<ColorFilter>Drawable::getColorFilter()const{
@@ -22,6 +22,7 @@ SET(DRAWABLE_SOURCES
     drawable/hwpathparser.cc
     drawable/hwvectordrawable.cc
     drawable/hwvectordrawableutils.cc
+    drawable/imageatlas.cc
     drawable/insetdrawable.cc
     drawable/layerdrawable.cc
     drawable/levellistdrawable.cc
@@ -0,0 +1,274 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <drawable/imageatlas.h>
+#include <image-decoders/imagedecoder.h>
+#include <porting/cdlog.h>
+
+using namespace Cairo;
+namespace cdroid{
+
+class ImageAtlas::Page{
+public:
+    struct Shelf{
+        int y;
+        int height;
+        int x;/*next free column*/
+    };
+    int mId;
+    int mNextY;
+    int mUsedArea;
+    int mRegionCount;
+    RefPtr<ImageSurface>mSurface;
+    std::vector<Shelf>mShelves;
+    std::vector<Rect>mFreeSlots;/*slots released by dead regions,reused as a whole*/
+    Page(int id,int size);
+    bool allocate(int width,int height,Rect&slot);
+    void release(const Rect&slot);
+};
+
+ImageAtlas::Page::Page(int id,int size){
+    mId = id;
+    mNextY = 0;
+    mUsedArea = 0;
+    mRegionCount = 0;
+    mSurface = ImageSurface::create(Surface::Format::ARGB32,size,size);
+}
+
+bool ImageAtlas::Page::allocate(int width,int height,Rect&slot){
+    const int size = mSurface->get_width();
+    const int fw = width + PADDING;
+    const int fh = height+ PADDING;
+    int best = -1;
+    for(int i = 0;i < int(mFreeSlots.size());i++){
+        const Rect& r = mFreeSlots[i];
+        if( (r.width < fw) || (r.height < fh) )continue;
+        if( (best < 0) || (r.width*r.height < mFreeSlots[best].width*mFreeSlots[best].height) )
+            best = i;
+    }
+    if(best >= 0){
+        slot = mFreeSlots[best];
+        mFreeSlots.erase(mFreeSlots.begin()+best);
+    }else{
+        Shelf* shelf = nullptr;
+        for(auto& s:mShelves){
+            if( (s.height < fh) || (s.x + fw > size) )continue;
+            if( (shelf == nullptr) || (s.height < shelf->height) )
+                shelf = &s;
+        }
+        /*a shelf much higher than the bitmap wastes its rest,open a new one while there is room*/
+        if( ((shelf == nullptr) || (shelf->height > fh*3/2)) && (mNextY + fh <= size) ){
+            mShelves.push_back({mNextY,fh,0});
+            mNextY += fh;
+            shelf = &mShelves.back();
+        }
+        if(shelf == nullptr)
+            return false;
+        slot = Rect::Make(shelf->x,shelf->y,fw,shelf->height);
+        shelf->x += fw;
+    }
+    mUsedArea += slot.width*slot.height;
+    mRegionCount++;
+    return true;
+}
+
+void ImageAtlas::Page::release(const Rect&slot){
+    RefPtr<Cairo::Context>cr = Cairo::Context::create(mSurface);
+    cr->set_operator(Cairo::Context::Operator::CLEAR);
+    cr->rectangle(slot.left,slot.top,slot.width,slot.height);
+    cr->fill();
+    mFreeSlots.push_back(slot);
+    mUsedArea -= slot.width*slot.height;
+    mRegionCount--;
+}
+
+ImageAtlas::Region::Region(std::shared_ptr<Page>page,const Rect&slot,int width,int height,int transparency)
+    :mPage(page),mSlot(slot){
+    mRect = Rect::Make(slot.left,slot.top,width,height);
+    mTransparency = transparency;
+}
+
+ImageAtlas::Region::~Region(){
+    mPage->release(mSlot);
+}
+
+const Rect& ImageAtlas::Region::getRect()const{
+    return mRect;
+}
+
+int ImageAtlas::Region::getTransparency()const{
+    return mTransparency;
+}
+
+RefPtr<ImageSurface>ImageAtlas::Region::getSurface()const{
+    return mPage->mSurface;
+}
+
+RefPtr<ImageSurface>ImageAtlas::Region::extract()const{
+    RefPtr<ImageSurface>image = ImageSurface::create(Surface::Format::ARGB32,mRect.width,mRect.height);
+    RefPtr<Cairo::Context>cr = Cairo::Context::create(image);
+    cr->set_operator(Cairo::Context::Operator::SOURCE);
+    cr->set_source(mPage->mSurface,-mRect.left,-mRect.top);
+    cr->paint();
+    ImageDecoder::setTransparency(image,mTransparency);
+    return image;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////
+
+ImageAtlas::ImageAtlas(int pageSize,int maxItemSize){
+    mPageSize = pageSize;
+    mMaxItemSize = maxItemSize;
+    mNextPageId = 0;
+}
+
+ImageAtlas::~ImageAtlas(){
+    /*pages still referenced by drawables outlive the atlas,they are freed with their last region*/
+    LOGD_IF(getPageCount(),"%d pages %d regions still in use",getPageCount(),getRegionCount());
+}
+
+std::string ImageAtlas::stripExtension(const std::string&resid){
+    std::string name = resid;
+    if(!name.empty() && (name[0] == '@'))
+        name.erase(0,1);
+    size_t pos = name.find_last_of('/');
+    pos = name.find('.',(pos == std::string::npos) ? 0 : pos);
+    if(pos != std::string::npos)
+        name.erase(pos);
+    return name;
+}
+
+/*regions are keyed with the extension,so icon.png and icon.jpg never share one*/
+std::string ImageAtlas::getKey(const std::string&resid){
+    if(!resid.empty() && (resid[0] == '@'))
+        return resid.substr(1);
+    return resid;
+}
+
+int ImageAtlas::loadList(std::istream&stream,const std::string&package){
+    int count = 0;
+    std::string line;
+    while(std::getline(stream,line)){
+        const size_t start = line.find_first_not_of(" \t\r");
+        if( (start == std::string::npos) || (line[start] == '#') )
+            continue;
+        line = line.substr(start,line.find_last_not_of(" \t\r") - start + 1);
+        if(line.find(':') == std::string::npos)
+            line = package + ":" + line;
+        mCandidates.insert(stripExtension(line));
+        count++;
+    }
+    LOGD("%d bitmaps of %s listed for atlas",count,package.c_str());
+    return count;
+}
+
+bool ImageAtlas::isCandidate(const std::string&resid,int width,int height)const{
+    if( (width <= 0) || (height <= 0) || (width + PADDING > mPageSize) || (height + PADDING > mPageSize) )
+        return false;
+    if(!mCandidates.empty())
+        return mCandidates.find(stripExtension(resid)) != mCandidates.end();
+    return (width <= mMaxItemSize) && (height <= mMaxItemSize);
+}
+
+std::shared_ptr<ImageAtlas::Region>ImageAtlas::get(const std::string&resid)const{
+    auto it = mRegions.find(getKey(resid));
+    return (it == mRegions.end()) ? nullptr : it->second.lock();
+}
+
+std::shared_ptr<ImageAtlas::Region>ImageAtlas::add(const std::string&resid,RefPtr<ImageSurface>image){
+    std::shared_ptr<Region>region = get(resid);
+    if( region || (image == nullptr) )
+        return region;
+    const Surface::Format format = image->get_format();
+    if( (format != Surface::Format::ARGB32) && (format != Surface::Format::RGB24) )
+        return nullptr;/*RGB565/A8 bitmaps are already compact,keep them standalone*/
+
+    const int width = image->get_width();
+    const int height= image->get_height();
+    std::shared_ptr<Page>page;
+    Rect slot;
+    trim();
+    for(auto& wp:mPages){
+        std::shared_ptr<Page>p = wp.lock();
+        if(p && p->allocate(width,height,slot)){
+            page = p;
+            break;
+        }
+    }
+    if(page == nullptr){
+        page = std::make_shared<Page>(mNextPageId++,mPageSize);
+        if(!page->allocate(width,height,slot))
+            return nullptr;
+        mPages.push_back(page);
+        LOGD("atlas page %d created for %s",page->mId,resid.c_str());
+    }
+    RefPtr<Cairo::Context>cr = Cairo::Context::create(page->mSurface);
+    cr->set_operator(Cairo::Context::Operator::SOURCE);
+    cr->set_source(image,slot.left,slot.top);
+    cr->rectangle(slot.left,slot.top,width,height);
+    cr->fill();
+    region = std::make_shared<Region>(page,slot,width,height,ImageDecoder::getTransparency(image));
+    mRegions[getKey(resid)] = region;
+    return region;
+}
+
+void ImageAtlas::trim(){
+    for(auto it = mRegions.begin();it != mRegions.end();){
+        if(it->second.expired()) it = mRegions.erase(it);
+        else it++;
+    }
+    for(auto it = mPages.begin();it != mPages.end();){
+        if(it->expired()) it = mPages.erase(it);
+        else it++;
+    }
+}
+
+int ImageAtlas::getPageCount()const{
+    int count = 0;
+    for(auto& wp:mPages){
+        if(!wp.expired())count++;
+    }
+    return count;
+}
+
+int ImageAtlas::getRegionCount()const{
+    int count = 0;
+    for(auto& r:mRegions){
+        if(!r.second.expired())count++;
+    }
+    return count;
+}
+
+void ImageAtlas::dump(const std::string&dir)const{
+    LOGI("ImageAtlas %d pages(%dx%d) %d regions",getPageCount(),mPageSize,mPageSize,getRegionCount());
+    for(auto& wp:mPages){
+        std::shared_ptr<Page>page = wp.lock();
+        if(page == nullptr)continue;
+        LOGI("  page %d: %d regions,%d%% used,%d free slots",page->mId,page->mRegionCount,
+             int(page->mUsedArea*100LL/(mPageSize*mPageSize)),int(page->mFreeSlots.size()));
+        if(!dir.empty())
+            page->mSurface->write_to_png(dir+"/atlas-"+std::to_string(page->mId)+".png");
+    }
+    for(auto& r:mRegions){
+        std::shared_ptr<Region>region = r.second.lock();
+        if(region == nullptr)continue;
+        const Rect& rc = region->getRect();
+        LOGV("  %s (%d,%d,%d,%d)",r.first.c_str(),rc.left,rc.top,rc.width,rc.height);
+    }
+}
+
+}/*endof namespace*/
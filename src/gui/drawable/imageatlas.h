@@ -0,0 +1,78 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __IMAGE_ATLAS_H__
+#define __IMAGE_ATLAS_H__
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <unordered_map>
+#include <unordered_set>
+#include <core/canvas.h>
+namespace cdroid{
+/*
+ * ImageAtlas packs small bitmaps into a few large page surfaces(shelf packing),
+ * so hundreds of icons don't each own a heap block and a cairo surface.
+ * A Region keeps its page alive,a page is released when its last region dies,
+ * the atlas itself only holds weak references.
+ */
+class ImageAtlas{
+public:
+    class Page;
+    class Region{
+    private:
+        std::shared_ptr<Page>mPage;
+        Rect mSlot;/*allocated area including padding*/
+        Rect mRect;/*the bitmap area in page*/
+        int mTransparency;
+    public:
+        Region(std::shared_ptr<Page>page,const Rect&slot,int width,int height,int transparency);
+        ~Region();
+        const Rect&getRect()const;
+        int getTransparency()const;
+        Cairo::RefPtr<Cairo::ImageSurface>getSurface()const;
+        /*a standalone copy of the bitmap,for the callers that need a real ImageSurface*/
+        Cairo::RefPtr<Cairo::ImageSurface>extract()const;
+    };
+    static constexpr int PAGE_SIZE = 512;
+    static constexpr int MAX_ITEM_SIZE = 64;
+    static constexpr int PADDING = 1;/*transparent gap,keeps filtered sampling from bleeding into neighbours*/
+private:
+    int mPageSize;
+    int mMaxItemSize;
+    int mNextPageId;
+    std::vector<std::weak_ptr<Page>>mPages;
+    std::unordered_map<std::string,std::weak_ptr<Region>>mRegions;
+    std::unordered_set<std::string>mCandidates;/*resources listed at build time(atlas.lst)*/
+    static std::string stripExtension(const std::string&resid);
+    static std::string getKey(const std::string&resid);
+public:
+    ImageAtlas(int pageSize=PAGE_SIZE,int maxItemSize=MAX_ITEM_SIZE);
+    ~ImageAtlas();
+    int loadList(std::istream&,const std::string&package);
+    bool isCandidate(const std::string&resid,int width,int height)const;
+    std::shared_ptr<Region>get(const std::string&resid)const;
+    std::shared_ptr<Region>add(const std::string&resid,Cairo::RefPtr<Cairo::ImageSurface>image);
+    void trim();
+    int getPageCount()const;
+    int getRegionCount()const;
+    void dump(const std::string&dir=std::string())const;
+};
+
+}/*endof namespace*/
+#endif/*__IMAGE_ATLAS_H__*/
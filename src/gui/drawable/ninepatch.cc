@@ -726,6 +726,13 @@ void* Res_png_9patch::serialize(const Res_png_9patch& patch, const int32_t* xDiv
     return newData;
 }
 
+Res_png_9patch* Res_png_9patch::deserialize(void* inData){
+    Res_png_9patch* patch = reinterpret_cast<Res_png_9patch*>(inData);
+    patch->wasDeserialized = true;
+    fill9patchOffsets(patch);
+    return patch;
+}
+
 void Res_png_9patch::serialize(const Res_png_9patch& patch, const int32_t* xDivs,
                                const int32_t* yDivs, const uint32_t* colors, void* outData){
     uint8_t* data = (uint8_t*) outData;
@@ -55,7 +55,6 @@ NinePatchDrawable::~NinePatchDrawable(){
 void NinePatchDrawable::computeBitmapSize(){
     mPadding.setEmpty();
     if ( (mNinePatchState->mNinePatch==nullptr)|| (mNinePatchState->mNinePatch->mImage==nullptr))return;
-    const RefPtr<ImageSurface> ninePatch = mNinePatchState->mNinePatch->mImage;
 
     const int sourceDensity =160;// ninePatch.getDensity();
     const int targetDensity = mTargetDensity;
@@ -79,8 +78,8 @@ void NinePatchDrawable::computeBitmapSize(){
         mPadding.height= Drawable::scaleFromDensity( sourcePadding.height, sourceDensity, targetDensity, false);
     }
 
-    mBitmapHeight= Drawable::scaleFromDensity( ninePatch->get_height(), sourceDensity, targetDensity, true);
-    mBitmapWidth = Drawable::scaleFromDensity( ninePatch->get_width() , sourceDensity, targetDensity, true);
+    mBitmapHeight= Drawable::scaleFromDensity( mNinePatchState->mNinePatch->getBitmapHeight(), sourceDensity, targetDensity, true);
+    mBitmapWidth = Drawable::scaleFromDensity( mNinePatchState->mNinePatch->getBitmapWidth() , sourceDensity, targetDensity, true);
 
     mOutlineRadius = mNinePatchState->mNinePatch->getRadius();
     /*const NinePatch.InsetStruct insets = ninePatch.getBitmap().getNinePatchInsets();
@@ -317,7 +316,7 @@ void NinePatchDrawable::updateStateFromTypedArray(const AttributeSet&a){
         Rect padding ,opticalInsets;
         Cairo::RefPtr<Cairo::ImageSurface> bitmap;
         auto is= a.getContext()->getInputStream(srcResId);
-        bitmap = ImageDecoder::loadImage(*is,-1,-1);
+        bitmap = ImageDecoder::loadImage(*is,-1,-1,ImageDecoder::ARGB_8888);
         if (bitmap == nullptr) {
             throw std::logic_error(//a.getPositionDescription() +
                     ": <nine-patch> requires a valid src attribute");
@@ -361,7 +360,7 @@ NinePatchDrawable::NinePatchState::NinePatchState(){
 }
 
 void NinePatchDrawable::NinePatchState::setBitmap(Context*ctx,const std::string&resid,const Rect*padding){
-    auto bitmap = ctx->loadImage(resid,-1,-1);
+    auto bitmap = ImageDecoder::loadImage(ctx,resid,-1,-1,ImageDecoder::ARGB_8888);
     setBitmap(bitmap,padding);
 }
 
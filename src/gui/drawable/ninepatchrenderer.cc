@@ -270,6 +270,70 @@ static uint8_t maxAlphaOverCol(uint8_t** rows, int offsetX, int startY, int endY
 
 NinePatchRenderer::NinePatchRenderer(Cairo::RefPtr<ImageSurface> image)
     : mImage(image){
+    mRadius = 0;
+    mOpacity = ImageDecoder::getTransparency(mImage);
+    if(loadPrecompiledChunks()){
+        mBorder = 0;
+    }else{
+        mBorder = 1;
+        parseBorderTicks();
+    }
+    mContentArea.set(mPadding.left,mPadding.top,
+        image->get_width()-mPadding.left-2*mBorder,
+        image->get_height()-mPadding.top-2*mBorder);
+    mAlpha =1.f;
+    if (!mResizeDistancesX.size() || !mResizeDistancesY.size()) {
+        //throw new ExceptionNot9Patch;
+        throw "Not ninepatch image!";
+    }
+}
+
+bool NinePatchRenderer::loadPrecompiledChunks(){
+    size_t len = 0;
+    const uint8_t*chunk = ImageDecoder::getChunk(mImage,"npTc",len);
+    if((chunk == nullptr) || (len < 32))
+        return false;
+    /*the deserialized patch is used in place,copy it to an aligned buffer first*/
+    std::vector<uintptr_t>buffer((len + sizeof(uintptr_t) - 1)/sizeof(uintptr_t));
+    memcpy(buffer.data(),chunk,len);
+    Res_png_9patch*patch = Res_png_9patch::deserialize(buffer.data());
+    if(patch->serializedSize() > len)
+        return false;
+    patch->fileToDevice();
+    const int32_t*xDivs = patch->getXDivs();
+    const int32_t*yDivs = patch->getYDivs();
+    for(int i = 0; i + 1 < patch->numXDivs; i += 2){
+        mResizeDistancesX.push_back({xDivs[i],xDivs[i+1]-xDivs[i]});
+    }
+    for(int i = 0; i + 1 < patch->numYDivs; i += 2){
+        mResizeDistancesY.push_back({yDivs[i],yDivs[i+1]-yDivs[i]});
+    }
+    mPadding.left  = patch->paddingLeft;
+    mPadding.top   = patch->paddingTop;
+    mPadding.width = patch->paddingRight;
+    mPadding.height= patch->paddingBottom;
+
+    chunk = ImageDecoder::getChunk(mImage,"npLb",len);
+    if(chunk && (len >= sizeof(int32_t)*4)){
+        int32_t bounds[4];
+        memcpy(bounds,chunk,sizeof(bounds));
+        mOpticalInsets.set(bounds[0],bounds[1],bounds[2],bounds[3]);
+    }
+    chunk = ImageDecoder::getChunk(mImage,"npOl",len);
+    if(chunk && (len >= sizeof(int32_t)*6)){
+        int32_t outline[4];
+        float radius;
+        memcpy(outline,chunk,sizeof(outline));
+        memcpy(&radius,chunk+sizeof(outline),sizeof(radius));
+        mOutlineInsets.set(outline[0],outline[1],outline[2],outline[3]);
+        mRadius = static_cast<int>(radius);
+    }
+    LOGV("%p precompiled ninepatch %dx%d divs=%d/%d",this,mImage->get_width(),mImage->get_height(),patch->numXDivs,patch->numYDivs);
+    return true;
+}
+
+void NinePatchRenderer::parseBorderTicks(){
+    Cairo::RefPtr<ImageSurface>&image = mImage;
     const uint32_t numRows = image->get_height();
     auto rows = std::unique_ptr<uint8_t*[]>(new uint8_t*[numRows]);
     uint8_t*pd = image->get_data();
@@ -277,7 +341,12 @@ NinePatchRenderer::NinePatchRenderer(Cairo::RefPtr<ImageSurface> image)
         rows[i] = pd;
         pd += image->get_stride();
     }
-    auto anp = NinePatch::Create(rows.get(),image->get_width(),numRows,nullptr);
+    std::string error;
+    auto anp = NinePatch::Create(rows.get(),image->get_width(),numRows,&error);
+    if(anp == nullptr){
+        LOGE("%s",error.c_str());
+        return;
+    }
     for(auto&r:anp->horizontal_stretch_regions){
         mResizeDistancesX.push_back({r.start,r.end-r.start});
     }
@@ -349,15 +418,6 @@ NinePatchRenderer::NinePatchRenderer(Cairo::RefPtr<ImageSurface> image)
     mPadding.width = anp->padding.right;
     mPadding.height= anp->padding.bottom;
     mRadius = static_cast<int>(anp->outline_radius);
-    mOpacity = ImageDecoder::getTransparency(mImage);
-    mContentArea.set(mPadding.left,mPadding.top,
-        image->get_width()-mPadding.left-2,
-        image->get_height()-mPadding.top-2);
-    mAlpha =1.f;
-    if (!mResizeDistancesX.size() || !mResizeDistancesY.size()) {
-        //throw new ExceptionNot9Patch;
-        throw "Not ninepatch image!";
-    }
     LOGD_IF(haveLayoutBounds,"OutlineInsets=(%d,%d,%d,%d) OpticalInsets=(%d,%d,%d,%d) padding=(%d,%d,%d,%d)",
             mOpticalInsets.left,mOpticalInsets.top,mOpticalInsets.right,mOpticalInsets.bottom,
             mOpticalInsets.left,mOpticalInsets.top,mOpticalInsets.right,mOpticalInsets.bottom,
@@ -365,7 +425,7 @@ NinePatchRenderer::NinePatchRenderer(Cairo::RefPtr<ImageSurface> image)
 }
 
 NinePatchRenderer::NinePatchRenderer(Context*ctx,const std::string&resid)
-    :NinePatchRenderer(ImageDecoder::loadImage(ctx,resid)){
+    :NinePatchRenderer(ImageDecoder::loadImage(ctx,resid,-1,-1,ImageDecoder::ARGB_8888)){
 }
 
 NinePatchRenderer::~NinePatchRenderer() {
@@ -385,44 +445,14 @@ void NinePatchRenderer::draw(Canvas& painter, int  x, int  y,float alpha) {
     painter.clip();
     Cairo::RefPtr<SurfacePattern>spat = painter.get_source_for_surface();
     if(spat)spat->set_filter(filterMode);
-    painter.paint();
+    if(alpha >= 1.f) painter.paint();
+    else painter.paint_with_alpha(alpha);
     painter.restore();
 }
 
 void NinePatchRenderer::draw(Canvas& painter, const Rect&rect,float alpha){
-    int resizeWidth = 0,resizeHeight = 0;
-    const int width = rect.width;
-    const int height= rect.height;
-    std::ostringstream oss;
-
-    painter.save();
-    painter.translate(rect.left,rect.top);
-    mAlpha = alpha;
-    for (int i = 0; i < mResizeDistancesX.size(); i++) {
-        resizeWidth += mResizeDistancesX[i].second;
-    }
-    for (int i = 0; i < mResizeDistancesY.size(); i++) {
-        resizeHeight += mResizeDistancesY[i].second;
-    }
-
-    if (width < (mImage->get_width() - 2 - resizeWidth) && height < (mImage->get_height() - 2 - resizeHeight)) {
-        oss<<"IncorrectWidth("<<width<<") must>="<<mImage->get_width()<<"(image.width)-2-"<<resizeWidth<<"(resizeWidth) && incorrectHeight("
-                <<height<<")>="<<mImage->get_height()<<"(image.height)-2-"<<resizeHeight<<"(resizeHeight))";
-    }
-    if (width < (mImage->get_width() - 2 - resizeWidth)) {
-        oss<<"IncorrectWidth("<<width<<"must>="<<mImage->get_width()<<"image.width)-2-"<<resizeWidth<<"(resizeWidth)";
-    }
-    if (height < (mImage->get_height() - 2 - resizeHeight)) {
-        oss<<"IncorrectHeight("<<height<<"must>="<<mImage->get_height()<<"(image.height)-2-"<<resizeHeight<<"(resizeHeight)";
-    }
-    const bool hasErrors = (oss.str().empty()==false);
-    LOGE_IF(hasErrors,"%s",oss.str().c_str());
-    mWidth = rect.width;
-    mHeight= rect.height;
-	painter.save();
-	painter.translate(rect.left,rect.top);
-    updateCachedImage(mWidth,mHeight,&painter);
-	painter.restore();
+    setImageSize(rect.width,rect.height);
+    draw(painter,rect.left,rect.top,alpha);
 }
 
 void NinePatchRenderer::setImageSize(int width, int height) {
@@ -436,24 +466,41 @@ void NinePatchRenderer::setImageSize(int width, int height) {
     for (int i = 0; i < mResizeDistancesY.size(); i++) {
         resizeHeight += mResizeDistancesY[i].second;
     }
-    if (width < (mImage->get_width() - 2 - resizeWidth) && height < (mImage->get_height() - 2 - resizeHeight)) {
+    if (width < (mImage->get_width() - 2*mBorder - resizeWidth) && height < (mImage->get_height() - 2*mBorder - resizeHeight)) {
         oss<<"IncorrectWidth("<<width<<") must>="<<mImage->get_width()<<"(image.width)-2-"<<resizeWidth<<"(resizeWidth) && incorrectHeight("
 		<<height<<")>="<<mImage->get_height()<<"(image.height)-2-"<<resizeHeight<<"(resizeHeight))";
     }
-    if (width < (mImage->get_width() - 2 - resizeWidth)) {
+    if (width < (mImage->get_width() - 2*mBorder - resizeWidth)) {
 		oss<<"IncorrectWidth("<<width<<"must>="<<mImage->get_width()<<"image.width)-2-"<<resizeWidth<<"(resizeWidth)";
     }
-    if (height < (mImage->get_height() - 2 - resizeHeight)) {
+    if (height < (mImage->get_height() - 2*mBorder - resizeHeight)) {
         oss<<"IncorrectHeight("<<height<<"must>="<<mImage->get_height()<<"(image.height)-2-"<<resizeHeight<<"(resizeHeight)";
     }
     if(oss.str().empty()==false){
         LOG(ERROR)<<oss.str();
     }
-    if (width != mWidth || height != mHeight) {
-        mWidth = width;
-        mHeight = height;
-        updateCachedImage(width, height,nullptr);
+    mWidth = width;
+    mHeight = height;
+    const uint64_t key = (uint64_t(uint32_t(width))<<32)|uint32_t(height);
+    for(auto it = mCachedImages.begin();it != mCachedImages.end();it++){
+        if(it->first == key){
+            mCachedImage = it->second;
+            mCachedImages.splice(mCachedImages.begin(),mCachedImages,it);
+            return;
+        }
     }
+    updateCachedImage(width, height,nullptr);
+    mCachedImages.push_front({key,mCachedImage});
+    if(mCachedImages.size() > MAX_CACHED_SIZES)
+        mCachedImages.pop_back();
+}
+
+int NinePatchRenderer::getBitmapWidth()const{
+    return mImage->get_width() + 2*(1-mBorder);
+}
+
+int NinePatchRenderer::getBitmapHeight()const{
+    return mImage->get_height() + 2*(1-mBorder);
 }
 
 Rect NinePatchRenderer::getPadding()const{
@@ -600,8 +647,8 @@ Insets NinePatchRenderer::getOpticalInsets(Cairo::RefPtr<ImageSurface>bitmap) co
 }
 
 void NinePatchRenderer::getFactor(int width, int height, double& factorX, double& factorY) {
-    int topResize = width - (mImage->get_width() - 2);
-    int leftResize = height - (mImage->get_height() - 2);
+    int topResize = width - (mImage->get_width() - 2*mBorder);
+    int leftResize = height - (mImage->get_height() - 2*mBorder);
     for (int i = 0; i < mResizeDistancesX.size(); i++) {
         topResize += mResizeDistancesX[i].second;
         factorX += mResizeDistancesX[i].second;
@@ -625,6 +672,8 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
     RefPtr<Cairo::Context> imgPainter;
     Cairo::Context*ppainter = painterIn;
     if(painterIn==nullptr){
+        /*cached image is rendered with full alpha,alpha is applied while drawing it*/
+        mAlpha = 1.f;
         mCachedImage = ImageSurface::create(Surface::Format::ARGB32,width,height);
         imgPainter=Cairo::Context::create(mCachedImage);
 		imgPainter->save();
@@ -644,7 +693,7 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
             widthResize = mResizeDistancesX[i].first - x1;
             heightResize = mResizeDistancesY[j].first - y1;
 
-            drawConstPart(Rect{x1 + 1, y1 + 1, widthResize, heightResize},
+            drawConstPart(Rect{x1 + mBorder, y1 + mBorder, widthResize, heightResize},
                  Rect{x1 + offsetX, y1 + offsetY, widthResize, heightResize}, painter);
 
             int  y2 = mResizeDistancesY[j].first;
@@ -655,7 +704,7 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
                 if (lostY < 0) {  resizeY += 1;   lostY += 1.0; }
                 else { resizeY -= 1;  lostY -= 1.0; }
             }
-            drawScaledPart(Rect{x1 + 1, y2 + 1, widthResize, heightResize},
+            drawScaledPart(Rect{x1 + mBorder, y2 + mBorder, widthResize, heightResize},
                 Rect{x1 + offsetX, y2 + offsetY, widthResize, resizeY}, painter);
 
             int  x2 = mResizeDistancesX[i].first;
@@ -667,11 +716,11 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
                 if (lostX < 0) { resizeX += 1; lostX += 1.0;}
                 else { resizeX -= 1; lostX -= 1.0; }
             }
-            drawScaledPart(Rect{x2 + 1, y1 + 1, widthResize, heightResize},
+            drawScaledPart(Rect{x2 + mBorder, y1 + mBorder, widthResize, heightResize},
                 Rect{x2 + offsetX, y1 + offsetY, resizeX, heightResize}, painter);
 
             heightResize = mResizeDistancesY[j].second;
-            drawScaledPart(Rect{x2 + 1, y2 + 1, widthResize, heightResize},
+            drawScaledPart(Rect{x2 + mBorder, y2 + mBorder, widthResize, heightResize},
                 Rect{x2 + offsetX, y2 + offsetY, resizeX, resizeY}, painter);
 
             y1 = mResizeDistancesY[j].first + mResizeDistancesY[j].second;
@@ -681,13 +730,13 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
         offsetX += resizeX - mResizeDistancesX[i].second;
     }
     x1 = mResizeDistancesX[mResizeDistancesX.size() - 1].first + mResizeDistancesX[mResizeDistancesX.size() - 1].second;
-    widthResize = mImage->get_width() - x1 - 2;
+    widthResize = mImage->get_width() - x1 - 2*mBorder;
     y1 = 0;
     lostX = 0.0;
     lostY = 0.0;
     offsetY = 0;
     for (int i = 0; i < mResizeDistancesY.size(); i++) {
-        drawConstPart(Rect{x1 + 1, y1 + 1, widthResize, mResizeDistancesY[i].first - y1},
+        drawConstPart(Rect{x1 + mBorder, y1 + mBorder, widthResize, mResizeDistancesY[i].first - y1},
             Rect{x1 + offsetX, y1 + offsetY, widthResize, mResizeDistancesY[i].first - y1}, painter);
         y1 = mResizeDistancesY[i].first;
         resizeY = round((double)mResizeDistancesY[i].second * factorY);
@@ -696,17 +745,17 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
             if (lostY < 0) { resizeY += 1;  lostY += 1.0; }
             else { resizeY -= 1;  lostY -= 1.0; }
         }
-        drawScaledPart(Rect{x1 + 1, y1 + 1, widthResize, mResizeDistancesY[i].second},
+        drawScaledPart(Rect{x1 + mBorder, y1 + mBorder, widthResize, mResizeDistancesY[i].second},
             Rect{x1 + offsetX, y1 + offsetY, widthResize, resizeY}, painter);
         y1 = mResizeDistancesY[i].first + mResizeDistancesY[i].second;
         offsetY += resizeY - mResizeDistancesY[i].second;
     }
     y1 = mResizeDistancesY[mResizeDistancesY.size() - 1].first + mResizeDistancesY[mResizeDistancesY.size() - 1].second;
-    heightResize = mImage->get_height() - y1 - 2;
+    heightResize = mImage->get_height() - y1 - 2*mBorder;
     x1 = 0;
     offsetX = 0;
     for (int i = 0; i < mResizeDistancesX.size(); i++) {
-        drawConstPart(Rect{x1 + 1, y1 + 1, mResizeDistancesX[i].first - x1, heightResize},
+        drawConstPart(Rect{x1 + mBorder, y1 + mBorder, mResizeDistancesX[i].first - x1, heightResize},
             Rect{x1 + offsetX, y1 + offsetY, mResizeDistancesX[i].first - x1, heightResize}, painter);
         x1 = mResizeDistancesX[i].first;
         resizeX = round((double)mResizeDistancesX[i].second * factorX);
@@ -715,16 +764,16 @@ void NinePatchRenderer::updateCachedImage(int width, int height,Cairo::Context*p
             if (lostX < 0) {  resizeX += 1;  lostX += 1.0; }
             else { resizeX -= 1;  lostX += 1.0; }
         }
-        drawScaledPart(Rect{x1 + 1, y1 + 1, mResizeDistancesX[i].second, heightResize},
+        drawScaledPart(Rect{x1 + mBorder, y1 + mBorder, mResizeDistancesX[i].second, heightResize},
             Rect{x1 + offsetX, y1 + offsetY, resizeX, heightResize}, painter);
         x1 = mResizeDistancesX[i].first + mResizeDistancesX[i].second;
         offsetX += resizeX - mResizeDistancesX[i].second;
     }
     x1 = mResizeDistancesX[mResizeDistancesX.size() - 1].first + mResizeDistancesX[mResizeDistancesX.size() - 1].second;
-    widthResize = mImage->get_width() - x1 - 2;
+    widthResize = mImage->get_width() - x1 - 2*mBorder;
     y1 = mResizeDistancesY[mResizeDistancesY.size() - 1].first + mResizeDistancesY[mResizeDistancesY.size() - 1].second;
-    heightResize = mImage->get_height() - y1 - 2;
-    drawConstPart(Rect{x1 + 1, y1 + 1, widthResize, heightResize},
+    heightResize = mImage->get_height() - y1 - 2*mBorder;
+    drawConstPart(Rect{x1 + mBorder, y1 + mBorder, widthResize, heightResize},
          Rect{x1 + offsetX, y1 + offsetY, widthResize, heightResize}, painter);
 }
 
@@ -17,6 +17,7 @@
  *********************************************************************************/
 #ifndef __NINEPATCH_RENDERER_H__
 #define __NINEPATCH_RENDERER_H__
+#include <list>
 #include <core/canvas.h>
 #include <core/insets.h>
 namespace cdroid{
@@ -27,6 +28,7 @@ private:
     int mHeight= -1;/*CacheImage.Height*/
     int mOpacity;
     int mRadius;
+    int mBorder;/*1:image has the 1 pixel ticks border,0:precompiled image(border stripped)*/
     Rect mContentArea;
     Rect mPadding;
     Insets mOutlineInsets;
@@ -35,14 +37,19 @@ private:
     std::vector<std::pair< int, int >>mResizeDistancesY;
     std::vector<std::pair< int, int >>mResizeDistancesX;
     Cairo::RefPtr<Cairo::ImageSurface> mCachedImage;
+    /*recently rendered sizes,front is the most recently used one*/
+    std::list<std::pair<uint64_t,Cairo::RefPtr<Cairo::ImageSurface>>>mCachedImages;
 public:
     Cairo::RefPtr<Cairo::ImageSurface> mImage;
 private:
+    bool loadPrecompiledChunks();
+    void parseBorderTicks();
     void getFactor(int width, int height, double& factorX, double& factorY);
     void updateCachedImage(int width, int height,Cairo::Context*);
     int getCornerRadius(Cairo::RefPtr<Cairo::ImageSurface> bitmap,int start,int step);
     Insets getOpticalInsets(Cairo::RefPtr<Cairo::ImageSurface>bitmap)const;
 public:
+    static constexpr int MAX_CACHED_SIZES = 4;
     NinePatchRenderer(Cairo::RefPtr<Cairo::ImageSurface> image);
     NinePatchRenderer(cdroid::Context*ctx,const std::string&resid);
     ~NinePatchRenderer();
@@ -51,6 +58,9 @@ public:
     void drawScaledPart(const Rect& oldRect,const Rect& newRect,Cairo::Context&painter);
     void drawConstPart (const Rect& oldRect,const Rect& newRect,Cairo::Context&painter);
     void setImageSize(int width, int height);
+    /*size of the source .9.png including the ticks border,same for raw and precompiled images*/
+    int getBitmapWidth()const;
+    int getBitmapHeight()const;
     Rect getContentArea(int  widht, int  height);
     Rect getPadding()const;
     Insets getOpticalInsets()const;
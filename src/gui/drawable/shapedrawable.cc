@@ -149,6 +149,10 @@ int ShapeDrawable::ShapeDrawable::getAlpha()const{
 }
 
 int ShapeDrawable::getOpacity()const{
+    if(mShapeState->mShape){
+        /*ovals,rounded corners and paths leave their bounds partly uncovered*/
+        return PixelFormat::TRANSLUCENT;
+    }
     switch(mShapeState->mAlpha){
     case 255: return PixelFormat::OPAQUE;
     case   0: return PixelFormat::TRANSPARENT;
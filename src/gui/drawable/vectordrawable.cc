@@ -701,6 +701,10 @@ public:                                                     \
     }                                                       \
     AnimateValue get(void*obj)const override                \
             { return ((CLASS*)obj)->get##METHOD(); }        \
+    void setFloat(void*obj,float v)const override           \
+            { ((CLASS*)obj)->set##METHOD(v); }              \
+    float getFloat(void*obj)const override                  \
+            { return ((CLASS*)obj)->get##METHOD(); }        \
 };                                                          \
 static const prop_##PROJ INST_##PROJ;                       \
 }const FloatProperty*const CLASS::PROJ = &INST_##PROJ;
@@ -715,6 +719,10 @@ public:                                                     \
     }                                                       \
     AnimateValue get(void*obj)const override                \
             { return ((CLASS*)obj)->get##METHOD(); }        \
+    void setInt(void*obj,int v)const override               \
+            { ((CLASS*)obj)->set##METHOD(v); }              \
+    int getInt(void*obj)const override                      \
+            { return ((CLASS*)obj)->get##METHOD(); }        \
 };                                                          \
 static const prop_##PROJ INTPROP_##PROJ;                    \
 }const Property*const CLASS::PROJ = &INTPROP_##PROJ;
@@ -28,6 +28,7 @@
 #include <core/context.h>
 #include <png.h>
 #include <porting/cdlog.h>
+#include <core/trace.h>
 #if ENABLE(LCMS)
 #include <lcms2.h>
 #endif
@@ -55,6 +56,7 @@ ImageDecoder::~ImageDecoder(){
 }
 
 uint32_t ImageDecoder::mHeaderBytesRequired = 0;
+int ImageDecoder::mPreferredConfig = ImageDecoder::ARGB_8888;
 std::unordered_map<std::string,ImageDecoder::Registry> ImageDecoder::mFactories;
 
 ImageDecoder::Registry::Registry(uint32_t msize,Factory& fun,Verifier& v)
@@ -148,6 +150,66 @@ void ImageDecoder::setTransparency(Cairo::RefPtr<Cairo::ImageSurface>bmp,int tra
         bmp->set_mime_data((const char*)TRANSPARENCY,(unsigned char*)(long(transparency)),0,nullptr);
 }
 
+const uint8_t*ImageDecoder::getChunk(Cairo::RefPtr<Cairo::ImageSurface>bmp,const char*name,size_t&len){
+    unsigned long size = 0;
+    const unsigned char*data = nullptr;
+    if(bmp) data = bmp->get_mime_data(name,size);
+    len = size;
+    return data;
+}
+
+void ImageDecoder::setChunk(Cairo::RefPtr<Cairo::ImageSurface>bmp,const char*name,const uint8_t*data,size_t len){
+    if((bmp == nullptr) || (data == nullptr) || (len == 0))
+        return;
+    unsigned char*copy = (unsigned char*)malloc(len);
+    memcpy(copy,data,len);
+    cairo_surface_set_mime_data(bmp->cobj(),name,copy,len,free,copy);
+}
+
+void ImageDecoder::setPreferredConfig(int config){
+    mPreferredConfig = config;
+}
+
+int ImageDecoder::getPreferredConfig(){
+    return mPreferredConfig;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface>ImageDecoder::applyConfig(Cairo::RefPtr<Cairo::ImageSurface>bmp,int config){
+    if(config < 0)
+        config = mPreferredConfig;
+    if((bmp == nullptr) || (config == ARGB_8888) || (bmp->get_format() != Surface::Format::ARGB32))
+        return bmp;
+    /*precompiled ninepatch keeps its chunks on the ARGB32 surface it was decoded to*/
+    size_t len;
+    if(getChunk(bmp,"npTc",len))
+        return bmp;
+    /*decoders that don't tag the surface(eg gif) must not be taken for opaque*/
+    unsigned long tlen;
+    const int transparency = bmp->get_mime_data((const char*)TRANSPARENCY,tlen)
+            ? getTransparency(bmp) : computeTransparency(bmp);
+    const int width  = bmp->get_width();
+    const int height = bmp->get_height();
+    Cairo::RefPtr<Cairo::ImageSurface> result;
+    bmp->flush();
+    if((config == RGB_565) && (transparency == PixelFormat::OPAQUE)){
+        result = ImageSurface::create(Surface::Format::RGB16_565,width,height);
+        for(int y = 0; y < height; y++){
+            const uint32_t*src = (const uint32_t*)(bmp->get_data() + bmp->get_stride()*y);
+            uint16_t*dst = (uint16_t*)(result->get_data() + result->get_stride()*y);
+            for(int x = 0; x < width; x++){
+                const uint32_t p = src[x];
+                dst[x] = ((p>>8)&0xF800)|((p>>5)&0x07E0)|((p>>3)&0x001F);
+            }
+        }
+    }else{
+        return bmp;
+    }
+    result->mark_dirty();
+    setTransparency(result,transparency);
+    LOGV("image %dx%d converted to format %d",width,height,result->get_format());
+    return result;
+}
+
 static int registerBuildinCodesc(){
     ImageDecoder::registerFactory(std::string("mime/png"),8,PNGDecoder::isPNG,
             [](std::istream&stream){return std::make_unique<PNGDecoder>(stream);});
@@ -208,7 +270,7 @@ std::unique_ptr<ImageDecoder>ImageDecoder::getDecoder(std::istream&istm){
     return nullptr;
 }
 
-Cairo::RefPtr<Cairo::ImageSurface> ImageDecoder::loadImage(std::istream&istm,int width,int height){
+Cairo::RefPtr<Cairo::ImageSurface> ImageDecoder::loadImage(std::istream&istm,int width,int height,int config){
     float scale = 1.f;
     std::unique_ptr<ImageDecoder>decoder = getDecoder(istm);
     if(decoder == nullptr)
@@ -219,21 +281,24 @@ Cairo::RefPtr<Cairo::ImageSurface> ImageDecoder::loadImage(std::istream&istm,int
         scale = std::min(scale,float(width)/decoder->getWidth());
     else if(height > 0)
         scale = std::max(scale,float(height)/decoder->getHeight());
-    return decoder->decode(scale,mLCMSProfile.get());
+    ATRACE_NAME("ImageDecoder::decode");
+    return applyConfig(decoder->decode(scale,mLCMSProfile.get()),config);
 }
 
-Cairo::RefPtr<Cairo::ImageSurface>ImageDecoder::loadImage(Context*ctx,const std::string&resourceId,int width,int height){
+Cairo::RefPtr<Cairo::ImageSurface>ImageDecoder::loadImage(Context*ctx,const std::string&resourceId,int width,int height,int config){
     std::unique_ptr<ImageDecoder>decoder;
     std::unique_ptr<std::istream>istm = ctx ? ctx->getInputStream(resourceId) : std::make_unique<std::ifstream>(resourceId);
     if((istm == nullptr)||(!*istm))
         return nullptr;
-    return loadImage(*istm,width,height);
+    return loadImage(*istm,width,height,config);
 }
 
 Drawable*ImageDecoder::createAsDrawable(Context*ctx,const std::string&resourceId){
     std::unique_ptr<std::istream> istm = ctx ? ctx->getInputStream(resourceId) : std::make_unique<std::ifstream>(resourceId);
     std::unique_ptr<ImageDecoder> decoder = ((istm==nullptr)||(!*istm))?nullptr:getDecoder(*istm);
+    ATRACE_BEGIN("ImageDecoder::decode");
     Cairo::RefPtr<Cairo::ImageSurface> image = decoder?decoder->decode(1.0):nullptr;
+    ATRACE_END();
 
     if(image && decoder && (decoder->getFrameCount()==1)){
         Drawable*d = nullptr;
@@ -241,7 +306,7 @@ Drawable*ImageDecoder::createAsDrawable(Context*ctx,const std::string&resourceId
             d = new NinePatchDrawable(image);
         else if( (image->get_width() >0) && (image->get_height() > 0) ){
             //TextUtils::endWith(resourceId,".png")||TextUtils::endWith(resourceId,".jpg")||TextUtils::endWith(resourceId,".webp")||TextUtils::endWith(resourceId,".gif"))
-            d = new BitmapDrawable(image);
+            d = new BitmapDrawable(applyConfig(image));
         }
         if(d != nullptr) {
 #if !defined(NDEBUG)
@@ -30,6 +30,10 @@ typedef struct png_info_def* png_infop;
 namespace cdroid{
 class ImageDecoder{
 public:
+    enum Config{
+        ARGB_8888 = 0,/*all images are decoded as Surface::Format::ARGB32*/
+        RGB_565   = 1 /*opaque images are stored as Surface::Format::RGB16_565*/
+    };
     typedef std::function<int(const uint8_t*,uint32_t)>Verifier;
     typedef std::function<std::unique_ptr<ImageDecoder>(std::istream&)> Factory;
     struct Registry{
@@ -41,6 +45,7 @@ public:
 private:
     static std::unordered_map<std::string,Registry>mFactories;
     static uint32_t mHeaderBytesRequired;
+    static int mPreferredConfig;
 protected:
     struct PRIVATE*mPrivate;
     int mImageWidth;
@@ -61,8 +66,15 @@ public:
     static int  computeTransparency(Cairo::RefPtr<Cairo::ImageSurface>bmp);
     static int  getTransparency(Cairo::RefPtr<Cairo::ImageSurface>bmp);
     static void setTransparency(Cairo::RefPtr<Cairo::ImageSurface>bmp,int);
-    static Cairo::RefPtr<Cairo::ImageSurface>loadImage(std::istream&,int width=-1,int height=-1);
-    static Cairo::RefPtr<Cairo::ImageSurface>loadImage(Context*ctx,const std::string&,int width=-1,int height=-1);
+    /*ancillary png chunks kept by decoder(npTc/npLb/npOl of the precompiled ninepatch)*/
+    static const uint8_t*getChunk(Cairo::RefPtr<Cairo::ImageSurface>bmp,const char*name,size_t&len);
+    static void setChunk(Cairo::RefPtr<Cairo::ImageSurface>bmp,const char*name,const uint8_t*data,size_t len);
+    static void setPreferredConfig(int config);
+    static int  getPreferredConfig();
+    /*convert the decoded ARGB32 image to the format required by config(<0 for preferred config)*/
+    static Cairo::RefPtr<Cairo::ImageSurface>applyConfig(Cairo::RefPtr<Cairo::ImageSurface>bmp,int config=-1);
+    static Cairo::RefPtr<Cairo::ImageSurface>loadImage(std::istream&,int width=-1,int height=-1,int config=-1);
+    static Cairo::RefPtr<Cairo::ImageSurface>loadImage(Context*ctx,const std::string&,int width=-1,int height=-1,int config=-1);
     static Drawable*createAsDrawable(Context*ctx,const std::string&resourceId);
 };
 
@@ -41,8 +41,12 @@ struct PRIVATE {
     png_infop info_ptr;
     int transparency;
     std::istream*istream;
+    std::vector<std::pair<std::string,std::vector<uint8_t>>>chunks;
 };
 
+/*chunks written by scripts/ninepatch_compile.py for the precompiled .9.png*/
+static const png_byte NINEPATCH_CHUNKS[] = "npTc\0npLb\0npOl";
+
 static void istream_png_reader(png_structp png_ptr, png_bytep png_data, png_size_t data_size) {
     PRIVATE*priv = (PRIVATE*)(png_get_io_ptr(png_ptr));
     priv->istream->read(reinterpret_cast<char*>(png_data), data_size);
@@ -157,6 +161,9 @@ Cairo::RefPtr<Cairo::ImageSurface> PNGDecoder::decode(float scale,void*targetPro
 #endif
     png_read_end (png_ptr, info_ptr);
     cairo_surface_set_mime_data(image->cobj(), CAIRO_MIME_TYPE_PNG, nullptr, 0, nullptr,nullptr);
+    for(auto&chunk:mPrivate->chunks){
+        ImageDecoder::setChunk(image,chunk.first.c_str(),chunk.second.data(),chunk.second.size());
+    }
     const int transparency = mPrivate->transparency!=PixelFormat::UNKNOWN ? mPrivate->transparency:ImageDecoder::computeTransparency(image);
     ImageDecoder::setTransparency(image,transparency);
     return image;
@@ -254,8 +261,19 @@ bool PNGDecoder::decodeSize() {
         //png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         return false;
     }
+#ifdef PNG_STORE_UNKNOWN_CHUNKS_SUPPORTED
+    png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_ALWAYS, NINEPATCH_CHUNKS, 3);
+#endif
     png_read_info(png_ptr, info_ptr);
     png_get_IHDR(png_ptr, info_ptr,(uint32_t*)&mImageWidth, (uint32_t*)&mImageHeight, &bit_depth, &color_type,&interlace, NULL, NULL);
+#ifdef PNG_STORE_UNKNOWN_CHUNKS_SUPPORTED
+    png_unknown_chunkp unknowns = nullptr;
+    const int numChunks = png_get_unknown_chunks(png_ptr, info_ptr, &unknowns);
+    for(int i = 0; i < numChunks; i++){
+        mPrivate->chunks.push_back({std::string((const char*)unknowns[i].name),
+            std::vector<uint8_t>(unknowns[i].data,unknowns[i].data + unknowns[i].size)});
+    }
+#endif
 
     /* convert palette/gray image to rgb */
     if (color_type == PNG_COLOR_TYPE_PALETTE) {
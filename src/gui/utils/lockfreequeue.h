@@ -0,0 +1,281 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __LOCKFREE_QUEUE_H__
+#define __LOCKFREE_QUEUE_H__
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <stdexcept>
+#if defined(__linux__)
+#include <climits>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#else
+#include <mutex>
+#include <condition_variable>
+#endif
+
+/*Bounded lock free ring buffer queues.
+ *SPSCQueue takes one producer and one consumer thread,MPSCQueue any number of producers.
+ *offer/try_take never block nor allocate.put/take spin a little,then sleep on a futex
+ *(a condition variable on other platforms) which producers only touch while someone waits.
+ *The capacity is rounded up to a power of 2*/
+namespace cdroid{
+namespace lockfree{
+
+static constexpr size_t CACHE_LINE = 64;
+static constexpr int SPIN_COUNT = 64;
+
+static inline size_t roundUpPowerOf2(size_t n){
+    size_t size = 2;
+    while(size < n)size <<= 1;
+    return size;
+}
+
+/*a counter waiters sleep on,notify() is a fence and a load when nobody waits*/
+class EventCount{
+private:
+    std::atomic<uint32_t>mEpoch;
+    std::atomic<int>mWaiters;
+#if !defined(__linux__)
+    std::mutex mLock;
+    std::condition_variable mCond;
+#endif
+public:
+    EventCount():mEpoch(0),mWaiters(0){}
+    /*call,recheck the condition,then wait() or cancelWait()*/
+    uint32_t prepareWait(){
+        mWaiters.fetch_add(1,std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return mEpoch.load(std::memory_order_acquire);
+    }
+    void cancelWait(){
+        mWaiters.fetch_sub(1,std::memory_order_relaxed);
+    }
+    void wait(uint32_t key){
+#if defined(__linux__)
+        while(mEpoch.load(std::memory_order_acquire) == key)
+            syscall(SYS_futex,&mEpoch,FUTEX_WAIT_PRIVATE,key,nullptr,nullptr,0);
+#else
+        std::unique_lock<std::mutex>lock(mLock);
+        mCond.wait(lock,[this,key](){return mEpoch.load(std::memory_order_acquire) != key;});
+#endif
+        mWaiters.fetch_sub(1,std::memory_order_relaxed);
+    }
+    void notify(){
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(mWaiters.load(std::memory_order_relaxed) == 0)
+            return;
+        mEpoch.fetch_add(1,std::memory_order_release);
+#if defined(__linux__)
+        syscall(SYS_futex,&mEpoch,FUTEX_WAKE_PRIVATE,INT_MAX,nullptr,nullptr,0);
+#else
+        {std::lock_guard<std::mutex>lock(mLock);}
+        mCond.notify_all();
+#endif
+    }
+};
+
+/*put/take built on offer/try_take of the derived queue*/
+template<typename Queue,typename T>
+class BlockingOps{
+protected:
+    EventCount mNotEmpty;
+    EventCount mNotFull;
+public:
+    void put(const T&item){
+        Queue*q = static_cast<Queue*>(this);
+        for(int spins = 0;!q->offer(item);spins++){
+            if(spins < SPIN_COUNT){
+                std::this_thread::yield();
+                continue;
+            }
+            const uint32_t key = mNotFull.prepareWait();
+            if(q->offer(item)){
+                mNotFull.cancelWait();
+                return;
+            }
+            mNotFull.wait(key);
+        }
+    }
+
+    T take(){
+        Queue*q = static_cast<Queue*>(this);
+        T item;
+        for(int spins = 0;!q->try_take(item);spins++){
+            if(spins < SPIN_COUNT){
+                std::this_thread::yield();
+                continue;
+            }
+            const uint32_t key = mNotEmpty.prepareWait();
+            if(q->try_take(item)){
+                mNotEmpty.cancelWait();
+                break;
+            }
+            mNotEmpty.wait(key);
+        }
+        return item;
+    }
+};
+}/*endof namespace lockfree*/
+
+template<typename T>
+class SPSCQueue:public lockfree::BlockingOps<SPSCQueue<T>,T>{
+private:
+    const size_t mMask;
+    std::unique_ptr<T[]>mBuffer;
+    char mPad0[lockfree::CACHE_LINE];
+    std::atomic<size_t>mHead;/*written by the consumer*/
+    size_t mCachedTail;
+    char mPad1[lockfree::CACHE_LINE];
+    std::atomic<size_t>mTail;/*written by the producer*/
+    size_t mCachedHead;
+    char mPad2[lockfree::CACHE_LINE];
+public:
+    explicit SPSCQueue(size_t capacity):mMask(lockfree::roundUpPowerOf2(capacity)-1){
+        if(capacity == 0){
+            throw std::invalid_argument("Capacity must be greater than zero");
+        }
+        mBuffer.reset(new T[mMask+1]);
+        mHead.store(0,std::memory_order_relaxed);
+        mTail.store(0,std::memory_order_relaxed);
+        mCachedTail = mCachedHead = 0;
+    }
+
+    /*producer thread only*/
+    bool offer(const T&item){
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if(tail - mCachedHead > mMask){
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if(tail - mCachedHead > mMask)
+                return false;
+        }
+        mBuffer[tail&mMask] = item;
+        mTail.store(tail+1,std::memory_order_release);
+        this->mNotEmpty.notify();
+        return true;
+    }
+
+    /*consumer thread only*/
+    bool try_take(T&item){
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if(head == mCachedTail){
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if(head == mCachedTail)
+                return false;
+        }
+        item = std::move(mBuffer[head&mMask]);
+        mHead.store(head+1,std::memory_order_release);
+        this->mNotFull.notify();
+        return true;
+    }
+
+    size_t size()const{
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+
+    bool isEmpty()const{
+        return size() == 0;
+    }
+
+    size_t capacity()const{
+        return mMask + 1;
+    }
+};
+
+/*Vyukov's bounded queue,producers claim a slot by CAS and publish it through its sequence*/
+template<typename T>
+class MPSCQueue:public lockfree::BlockingOps<MPSCQueue<T>,T>{
+private:
+    struct Slot{
+        std::atomic<size_t>seq;
+        T value;
+    };
+    const size_t mMask;
+    std::unique_ptr<Slot[]>mSlots;
+    char mPad0[lockfree::CACHE_LINE];
+    std::atomic<size_t>mHead;/*written by the consumer*/
+    char mPad1[lockfree::CACHE_LINE];
+    std::atomic<size_t>mTail;/*claimed by the producers*/
+    char mPad2[lockfree::CACHE_LINE];
+public:
+    explicit MPSCQueue(size_t capacity):mMask(lockfree::roundUpPowerOf2(capacity)-1){
+        if(capacity == 0){
+            throw std::invalid_argument("Capacity must be greater than zero");
+        }
+        mSlots.reset(new Slot[mMask+1]);
+        for(size_t i = 0;i <= mMask;i++)
+            mSlots[i].seq.store(i,std::memory_order_relaxed);
+        mHead.store(0,std::memory_order_relaxed);
+        mTail.store(0,std::memory_order_relaxed);
+    }
+
+    bool offer(const T&item){
+        size_t pos = mTail.load(std::memory_order_relaxed);
+        Slot*slot;
+        for(;;){
+            slot = &mSlots[pos&mMask];
+            const intptr_t diff = intptr_t(slot->seq.load(std::memory_order_acquire)) - intptr_t(pos);
+            if(diff == 0){
+                if(mTail.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed))
+                    break;
+            }else if(diff < 0){
+                return false;
+            }else{
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = item;
+        slot->seq.store(pos+1,std::memory_order_release);
+        this->mNotEmpty.notify();
+        return true;
+    }
+
+    /*consumer thread only*/
+    bool try_take(T&item){
+        const size_t pos = mHead.load(std::memory_order_relaxed);
+        Slot&slot = mSlots[pos&mMask];
+        if(intptr_t(slot.seq.load(std::memory_order_acquire)) - intptr_t(pos+1) < 0)
+            return false;
+        item = std::move(slot.value);
+        slot.seq.store(pos+mMask+1,std::memory_order_release);
+        mHead.store(pos+1,std::memory_order_release);
+        this->mNotFull.notify();
+        return true;
+    }
+
+    /*claimed slots are counted before they are published*/
+    size_t size()const{
+        const size_t head = mHead.load(std::memory_order_acquire);
+        const size_t tail = mTail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool isEmpty()const{
+        return size() == 0;
+    }
+
+    size_t capacity()const{
+        return mMask + 1;
+    }
+};
+
+}/*endof namespace*/
+#endif/*__LOCKFREE_QUEUE_H__*/
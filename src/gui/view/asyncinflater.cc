@@ -104,14 +104,7 @@ AsyncLayoutInflater::InflateThread*AsyncLayoutInflater::InflateThread::getInstan
 // scope by the GC. This is needed to avoid keeping previous request references
 // alive for an indeterminate amount of time, see b/33158143 for details
 void AsyncLayoutInflater::InflateThread::runInner() {
-    InflateRequest* request = nullptr;
-    try {
-        request = mQueue.take();
-    } catch (std::exception& ex) {
-        // Odd, just continue
-        LOGW("%s",ex.what());
-        return;
-    }
+    InflateRequest* request = mQueue.take();
 
     try {
         request->view = request->inflater->mInflater->inflate(
@@ -154,10 +147,6 @@ void AsyncLayoutInflater::InflateThread::releaseRequest(InflateRequest* obj) {
 }
 
 void AsyncLayoutInflater::InflateThread::enqueue(InflateRequest* request) {
-    try {
-        mQueue.put(request);
-    } catch (std::exception& e) {
-        throw std::runtime_error("Failed to enqueue async inflate request");
-    }
+    mQueue.put(request);
 }
 }/*endof namespace*/
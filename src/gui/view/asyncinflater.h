@@ -19,7 +19,7 @@
 #define __ASYNC_INFLATER_H__
 #include <core/pools.h>
 #include <core/handler.h>
-#include <utils/arrayblockingqueue.h>
+#include <utils/lockfreequeue.h>
 #include <view/layoutinflater.h>
 
 namespace cdroid{
@@ -68,7 +68,7 @@ protected:
 class AsyncLayoutInflater::InflateThread{
 private:
     static std::unique_ptr<InflateThread> sInstance;
-    ArrayBlockingQueue<InflateRequest*> mQueue;
+    MPSCQueue<InflateRequest*> mQueue;
     Pools::SynchronizedPool<InflateRequest> mRequestPool;
 public:
     static InflateThread* getInstance();
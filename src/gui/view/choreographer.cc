@@ -18,6 +18,8 @@
 #include <view/choreographer.h>
 #include <systemclock.h>
 #include <cdlog.h>
+#include <algorithm>
+#include <climits>
 
 namespace cdroid{
 #define FRAME_CALLBACK_TOKEN 1
@@ -30,6 +32,7 @@ Choreographer::Choreographer(){
     mFrameScheduled  = false;
     mCallbacksRunning= false;
     mLastFrameTimeNanos = 0;
+    mScheduledFrameTimeNanos = 0;
     mFrameIntervalNanos = static_cast<nsecs_t>(1E9/getRefreshRate());
     mCallbackPool = nullptr;
     for(int i = 0;i <= CALLBACK_LAST;i++){
@@ -65,6 +68,7 @@ Choreographer& Choreographer::getInstance(){
         mInst.mLooper = Looper::getMainLooper();
         mInst.mLooper->addEventHandler(&mInst);
         mInst.setOwned(false);
+        mInst.setReadinessDriven(true);
         mInst.mFrameIntervalNanos = static_cast<nsecs_t>(1E9/getRefreshRate());
     }
     return mInst;
@@ -107,6 +111,18 @@ int64_t Choreographer::getFrameIntervalNanos()const{
     return mFrameIntervalNanos;
 }
 
+int64_t Choreographer::getNextFrameTimeNanos()const{
+    if(mFrameScheduled){
+        return mScheduledFrameTimeNanos;
+    }
+    return getNextFrameTimeNanos(mLastFrameTimeNanos,mFrameIntervalNanos,SystemClock::uptimeNanos());
+}
+
+int64_t Choreographer::getNextFrameTimeNanos(int64_t lastFrameTimeNanos,int64_t frameIntervalNanos,int64_t nowNanos){
+    const int64_t nextFrameTime = lastFrameTimeNanos + frameIntervalNanos;
+    return nextFrameTime > nowNanos ? nextFrameTime : nowNanos + frameIntervalNanos;
+}
+
 Choreographer::CallbackRecord* Choreographer::obtainCallbackLocked(int64_t dueTime,void* action, void* token) {
     CallbackRecord* callback = mCallbackPool;
     if (callback == nullptr) {
@@ -139,6 +155,7 @@ void Choreographer::postCallbackDelayedInternal(int callbackType,void* action, v
     const auto dueTime = now + delayMillis;
     if(mCallbackQueues[callbackType]){
         mCallbackQueues[callbackType]->addCallbackLocked(dueTime, action, token);
+        scheduleFrameLocked();
     }
     /*if (dueTime <= now) {
         scheduleFrameLocked(now);
@@ -190,25 +207,35 @@ void Choreographer::postFrameCallbackDelayed(const FrameCallback& callback, long
     postCallbackDelayedInternal(CALLBACK_ANIMATION,(void*)&callback, (void*)FRAME_CALLBACK_TOKEN, delayMillis);    
 }
 
-void Choreographer::scheduleFrameLocked(int64_t now){
-    if (!mFrameScheduled) {
-        mFrameScheduled = true;
-        nsecs_t nextFrameTime = std::max(mLastFrameTimeNanos /SystemClock::NANOS_PER_MS + sFrameDelay, nsecs_t(now));
-        LOG(DEBUG)<<"Scheduling next frame in " << (nextFrameTime - now) << " ms.";
-        //Message msg = mHandler.obtainMessage(MSG_DO_FRAME);
-        //msg.setAsynchronous(true);
-        //mHandler.sendMessageAtTime(msg, nextFrameTime);
+void Choreographer::scheduleFrameLocked(){
+    int64_t dueTime = LLONG_MAX;
+    for(int i = 0;i <= CALLBACK_LAST;i++){
+        const CallbackRecord*head = mCallbackQueues[i]->mHead;
+        if(head && (head->dueTime < dueTime))
+            dueTime = head->dueTime;
     }
+    if(dueTime == LLONG_MAX)return;
+    /*round up,checkEvents needs a whole frame interval to be elapsed*/
+    const int64_t nextFrameTime = (mLastFrameTimeNanos + mFrameIntervalNanos + SystemClock::NANOS_PER_MS - 1)/SystemClock::NANOS_PER_MS;
+    mFrameScheduled = true;
+    mScheduledFrameTimeNanos = std::max(dueTime,nextFrameTime)*SystemClock::NANOS_PER_MS;
+    signalReadyAt(std::max(dueTime,nextFrameTime));
+    //Message msg = mHandler.obtainMessage(MSG_DO_FRAME);
+    //msg.setAsynchronous(true);
+    //mHandler.sendMessageAtTime(msg, nextFrameTime);
 }
 
 int Choreographer::checkEvents(){
     const nsecs_t now = SystemClock::uptimeNanos();
-    return (now - mLastFrameTimeNanos)>=getFrameIntervalNanos();
+    const int ret = (now - mLastFrameTimeNanos)>=getFrameIntervalNanos();
+    if(ret==0)scheduleFrameLocked();/*the readiness was consumed too early*/
+    return ret;
 }
 
 int Choreographer::handleEvents(){
     const nsecs_t now = SystemClock::uptimeNanos();
     doFrame(now,0);
+    scheduleFrameLocked();
     return 0;
 }
 
@@ -62,6 +62,7 @@ private:
     bool mCallbacksRunning;
     nsecs_t mLastFrameTimeNanos;
     nsecs_t mFrameIntervalNanos;
+    nsecs_t mScheduledFrameTimeNanos;
     CallbackRecord* mCallbackPool;
     CallbackQueue* mCallbackQueues[CALLBACK_LAST+1];
     static long sFrameDelay;
@@ -72,7 +73,7 @@ private:
     void recycleCallbackLocked(CallbackRecord* callback);
     int removeCallbacksInternal(int callbackType,void* action, void* token);
     void postCallbackDelayedInternal(int callbackType,void* action, void* token, int64_t delayMillis);
-    void scheduleFrameLocked(int64_t);
+    void scheduleFrameLocked();
 protected:
     int checkEvents()override;
     int handleEvents()override;
@@ -87,6 +88,10 @@ public:
     int64_t getLastFrameTimeNanos()const;
     int64_t getFrameTime()const;
     int64_t getFrameIntervalNanos()const;
+    /*when the next frame is expected to start,idle work such as prefetch must be done by then*/
+    int64_t getNextFrameTimeNanos()const;
+    /*the earliest start of a frame posted at nowNanos,one interval after the last frame but never in the past*/
+    static int64_t getNextFrameTimeNanos(int64_t lastFrameTimeNanos,int64_t frameIntervalNanos,int64_t nowNanos);
     void postCallback(int callbackType,const Runnable& action, void* token);
     void postCallbackDelayed(int callbackType,const Runnable& action,void*token,long delayMillis);
     int removeCallbacks(int callbackType, const Runnable* action,void*token);
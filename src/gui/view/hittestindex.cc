@@ -0,0 +1,122 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <cmath>
+#include <view/view.h>
+#include <view/hittestindex.h>
+
+namespace cdroid{
+
+HitTestIndex::HitTestIndex(){
+    mCellSize = MIN_CELL_SIZE;
+    mColumns = mRows = 0;
+    mValid = false;
+}
+
+bool HitTestIndex::isValid()const{
+    return mValid;
+}
+
+void HitTestIndex::invalidate(){
+    mValid = false;
+}
+
+void HitTestIndex::getCellRange(const Rect& r,int& c0,int& r0,int& c1,int& r1)const{
+    c0 = std::max(0,(r.left - mBounds.left)/mCellSize);
+    r0 = std::max(0,(r.top - mBounds.top)/mCellSize);
+    c1 = std::min(mColumns - 1,(r.right() - 1 - mBounds.left)/mCellSize);
+    r1 = std::min(mRows - 1,(r.bottom() - 1 - mBounds.top)/mCellSize);
+}
+
+/*bounds of the transformed child in its parent,not getHitRect() which ignores
+ *the matrix of detached views*/
+static void getTransformedBounds(View* child,Rect& out){
+    if(child->hasIdentityMatrix()){
+        out.set(child->getLeft(),child->getTop(),child->getWidth(),child->getHeight());
+        return;
+    }
+    Cairo::Rectangle r = {0,0,double(child->getWidth()),double(child->getHeight())};
+    child->getMatrix().transform_rectangle(r);
+    const int left = int(std::floor(r.x));
+    const int top  = int(std::floor(r.y));
+    out.set(child->getLeft() + left,child->getTop() + top,
+            int(std::ceil(r.x + r.width)) - left,int(std::ceil(r.y + r.height)) - top);
+}
+
+void HitTestIndex::build(const std::vector<View*>& children){
+    const size_t count = children.size();
+    std::vector<Rect> rects(count);
+    mBounds.setEmpty();
+    for(size_t i = 0;i < count;i++){
+        Rect& r = rects[i];
+        getTransformedBounds(children[i],r);
+        if(r.empty())continue;/*can't be hit*/
+        /*local coordinates are truncated toward zero by the exact test,points up to
+         *a pixel outside the left/top edges still hit*/
+        r.inflate(1,1);
+        mBounds.Union(r);
+    }
+    mEntries.clear();
+    mCellStart.clear();
+    mColumns = mRows = 0;
+    mValid = true;
+    if(mBounds.empty())return;
+
+    /*about one child per cell*/
+    const double area = double(mBounds.width)*mBounds.height;
+    mCellSize = std::max(MIN_CELL_SIZE,int(std::sqrt(area/count)));
+    mCellSize = std::max(mCellSize,(std::max(mBounds.width,mBounds.height) + MAX_CELLS_PER_AXIS - 1)/MAX_CELLS_PER_AXIS);
+    mColumns = (mBounds.width + mCellSize - 1)/mCellSize;
+    mRows = (mBounds.height + mCellSize - 1)/mCellSize;
+
+    /*counting pass,then fill the cells in dispatch order*/
+    mCellStart.assign(mColumns*mRows + 1,0);
+    int c0,r0,c1,r1;
+    for(size_t i = 0;i < count;i++){
+        if(rects[i].empty())continue;
+        getCellRange(rects[i],c0,r0,c1,r1);
+        for(int row = r0;row <= r1;row++){
+            for(int col = c0;col <= c1;col++)
+                mCellStart[row*mColumns + col + 1]++;
+        }
+    }
+    for(size_t i = 1;i < mCellStart.size();i++)
+        mCellStart[i] += mCellStart[i-1];
+    mEntries.resize(mCellStart.back());
+    std::vector<int> fill(mCellStart.begin(),mCellStart.end() - 1);
+    for(size_t i = 0;i < count;i++){
+        if(rects[i].empty())continue;
+        getCellRange(rects[i],c0,r0,c1,r1);
+        for(int row = r0;row <= r1;row++){
+            for(int col = c0;col <= c1;col++)
+                mEntries[fill[row*mColumns + col]++] = children[i];
+        }
+    }
+}
+
+void HitTestIndex::offset(int dx,int dy){
+    mBounds.offset(dx,dy);
+}
+
+void HitTestIndex::query(int x,int y,std::vector<View*>& out)const{
+    out.clear();
+    if(!mBounds.contains(x,y))return;
+    const int cell = ((y - mBounds.top)/mCellSize)*mColumns + (x - mBounds.left)/mCellSize;
+    out.assign(mEntries.begin() + mCellStart[cell],mEntries.begin() + mCellStart[cell + 1]);
+}
+
+}/*endof namespace*/
@@ -0,0 +1,53 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __HITTEST_INDEX_H__
+#define __HITTEST_INDEX_H__
+#include <vector>
+#include <core/rect.h>
+namespace cdroid{
+class View;
+
+/*Uniform grid over the hit rects of a ViewGroup's children,in the group's content
+ *coordinates(scroll included).A cell lists the children overlapping it in the order
+ *they were given,so query() yields a point's candidates in dispatch order,topmost last.
+ *Cells are conservative,callers still run the exact isTransformedTouchPointInView()*/
+class HitTestIndex{
+private:
+    static constexpr int MIN_CELL_SIZE = 16;
+    static constexpr int MAX_CELLS_PER_AXIS = 64;
+    Rect mBounds;/*union of all hit rects*/
+    int mCellSize;
+    int mColumns;
+    int mRows;
+    bool mValid;
+    std::vector<int> mCellStart;/*mColumns*mRows+1 offsets into mEntries*/
+    std::vector<View*> mEntries;
+    void getCellRange(const Rect& r,int& c0,int& r0,int& c1,int& r1)const;
+public:
+    HitTestIndex();
+    bool isValid()const;
+    void invalidate();
+    /*children in dispatch order*/
+    void build(const std::vector<View*>& children);
+    /*all children moved by the same amount,as in offsetChildrenTopAndBottom()*/
+    void offset(int dx,int dy);
+    void query(int x,int y,std::vector<View*>& out)const;
+};
+
+}/*endof namespace*/
+#endif/*__HITTEST_INDEX_H__*/
@@ -39,6 +39,7 @@ int InputEvent::mNextSeq=0;
 InputEvent::InputEvent(){
    mSource = InputDevice::SOURCE_UNKNOWN;
    mDisplayId = 0;
+   mHardwareTime = 0;
    mSeq = mNextSeq++;
 }
 
@@ -46,6 +47,7 @@ InputEvent::~InputEvent(){
 }
 
 void InputEvent::prepareForReuse(){
+   mHardwareTime = 0;
    mSeq = mNextSeq++;
 }
 
@@ -121,6 +123,7 @@ void InputEvent::initialize(const InputEvent& from) {
     mSource = from.mSource;
     mId = from.mId;
     mDisplayId = from.mDisplayId;
+    mHardwareTime = from.mHardwareTime;
 }
 
 void InputEvent::recycle(){
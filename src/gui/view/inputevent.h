@@ -92,6 +92,7 @@ protected:
     long mSeq;
     static int mNextSeq;
     nsecs_t mEventTime;
+    nsecs_t mHardwareTime;/*kernel timestamp of the raw input,0 if unknown*/
 protected:
     void prepareForReuse();
 public:
@@ -122,6 +123,8 @@ public:
     virtual void setTainted(bool)=0;
     virtual nsecs_t getEventTimeNanos() const { return mEventTime*NS_PER_MS; }
     virtual nsecs_t getEventTime()const{ return mEventTime;}
+    nsecs_t getHardwareTimeNanos()const{ return mHardwareTime;}
+    void setHardwareTimeNanos(nsecs_t nanos){ mHardwareTime = nanos;}
     virtual void recycle();/*only obtained event can call recycle*/
     static int32_t nextId();
     static std::string sourceToString(int32_t source);
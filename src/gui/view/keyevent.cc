@@ -60,6 +60,7 @@ KeyEvent* KeyEvent::obtain(const KeyEvent& other){
     ev->mFlags = other.mFlags;
     ev->mSource = other.mSource;
     ev->mDisplayId = other.mDisplayId;
+    ev->mHardwareTime = other.mHardwareTime;
     //ev->mCharacters = other.mCharacters;
     return ev;
 }
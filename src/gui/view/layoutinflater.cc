@@ -19,6 +19,7 @@
 #include <view/viewgroup.h>
 #include <view/layoutinflater.h>
 #include <porting/cdlog.h>
+#include <core/trace.h>
 #include <fstream>
 #include <iomanip>
 
@@ -174,6 +175,7 @@ View* LayoutInflater::inflate(XmlPullParser& parser,ViewGroup* root){
 }
 
 View* LayoutInflater::inflate(XmlPullParser& parser,ViewGroup* root, bool attachToRoot){
+    ATRACE_NAME("LayoutInflater::inflate");
     int type;
     View*result = root;
     AttributeSet& attrs = parser;
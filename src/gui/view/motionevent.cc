@@ -202,6 +202,7 @@ void MotionEvent::setSource(int32_t source){
 
 MotionEvent*MotionEvent::obtain(){
     MotionEvent*ev = PooledInputEventFactory::getInstance().createMotionEvent();
+    ev->mHardwareTime = 0;
     ev->mTransform.reset();
     ev->mPointerProperties.clear();
     ev->mSamplePointerCoords.clear();
@@ -340,6 +341,7 @@ MotionEvent::MotionEvent(const MotionEvent&other){
 
 void MotionEvent::copyFrom(const MotionEvent& other, bool keepHistory) {
     InputEvent::initialize(nextId(),other.mDeviceId, other.mSource,other.mDisplayId);
+    mHardwareTime = other.mHardwareTime;
     mAction = other.mAction;
     mActionButton = other.mActionButton;
     mFlags = other.mFlags;
@@ -800,7 +802,7 @@ int MotionEvent::getHistoricalRawPointerCoords( size_t pointerIndex, size_t hist
         return -1;
     }
     if(historicalIndex==HISTORY_CURRENT){
-        pc = mSamplePointerCoords[pointerIndex];
+        pc = mSamplePointerCoords[getHistorySize() * pointerCount + pointerIndex];
     }else{
         const size_t position = historicalIndex * getPointerCount() + pointerIndex;
         pc = mSamplePointerCoords[position];
@@ -817,7 +819,7 @@ void MotionEvent::addBatch(nsecs_t eventTime, float x, float y, float pressure,
     pc[0].setAxisValue(AXIS_PRESSURE,pressure);//pressure = pressure;
     pc[0].setAxisValue(AXIS_SIZE,size);//size = size;
     //nativeAddBatch(mNativePtr, eventTime * NS_PER_MS, pc, metaState);
-    addSample(eventTime * NS_PER_MS,pc);
+    addSample(eventTime,pc);/*samples are kept in ms*/
     setMetaState(metaState|getMetaState());
 }
 
@@ -868,9 +870,9 @@ bool MotionEvent::addBatch(const MotionEvent& event){
                 event.getHistoricalPointerCoords(i, historyPos, pc[i]);
             }
 
-            const int64_t eventTimeNanos = event.getHistoricalEventTimeNanos(historyPos);
+            const int64_t eventTime = event.getHistoricalEventTime(historyPos);
             //nativeAddBatch(mNativePtr, eventTimeNanos, pc, metaState);
-            addSample(eventTimeNanos,pc);
+            addSample(eventTime,pc);
             setMetaState(metaState|getMetaState());
         }
     }
@@ -41,6 +41,7 @@
 #include <core/app.h>
 #include <core/color.h>
 #include <porting/cdlog.h>
+#include <core/trace.h>
 #define UNDEFINED_PADDING INT_MIN
 using namespace Cairo;
 namespace cdroid{
@@ -512,6 +513,18 @@ void View::setShowingLayoutBounds(bool debugLayout){
     }
 }
 
+bool View::isShowingOverdraw()const{
+    return mAttachInfo && mAttachInfo->mDebugOverdraw;
+}
+
+void View::setShowingOverdraw(bool debugOverdraw){
+    if (mAttachInfo && (mAttachInfo->mDebugOverdraw != debugOverdraw)) {
+        mAttachInfo->mDebugOverdraw = debugOverdraw;
+        mAttachInfo->mOverdrawRects.clear();
+        if (mAttachInfo->mRootView) mAttachInfo->mRootView->invalidate(true);
+    }
+}
+
 bool View::debugDraw()const {
     return View::VIEW_DEBUG|| (mAttachInfo && mAttachInfo->mDebugLayout);
 }
@@ -630,6 +643,7 @@ void View::setLeft(int left){
 
     mLeft = left;
     mRenderNode->setLeft(float(left));
+    invalidateParentHitTestIndex();
 
     sizeChange(mRight - mLeft, height, oldWidth, height);
 
@@ -675,6 +689,7 @@ void View::setTop(int top){
 
     mTop = top;
     mRenderNode->setTop(float(mTop));
+    invalidateParentHitTestIndex();
 
     sizeChange(width, mBottom - mTop, width, oldHeight);
 
@@ -717,6 +732,7 @@ void View::setRight(int right){
 
     mRight = right;
     mRenderNode->setRight(float(mRight));
+    invalidateParentHitTestIndex();
 
     sizeChange(mRight - mLeft, height, oldWidth, height);
 
@@ -759,6 +775,7 @@ void View::setBottom(int bottom){
     
     mBottom = bottom;
     mRenderNode->setBottom(float(mBottom));
+    invalidateParentHitTestIndex();
     
     sizeChange(width, mBottom - mTop, width, oldHeight);
     
@@ -2966,6 +2983,36 @@ void View::drawBackground(Canvas&canvas){
     }else{
         mBackground->draw(canvas);
     }
+    if(mAttachInfo && mAttachInfo->mDebugOverdraw)
+        recordOverdraw(canvas,mScrollX,mScrollY,getWidth(),getHeight());
+}
+
+bool View::isBackgroundOccluded(Canvas&canvas){
+    return false;
+}
+
+/*only what lands on the window canvas is counted,drawing caches are blitted later*/
+void View::recordOverdraw(Canvas&canvas,int x,int y,int w,int h){
+    if(&canvas != mAttachInfo->mCanvas.get())
+        return;
+    double x1,y1,x2,y2;
+    canvas.get_clip_extents(x1,y1,x2,y2);
+    x1 = std::max(x1,double(x));
+    y1 = std::max(y1,double(y));
+    x2 = std::min(x2,double(x + w));
+    y2 = std::min(y2,double(y + h));
+    if((x1 >= x2) || (y1 >= y2))
+        return;
+    double dx[4] = {x1,x2,x2,x1};
+    double dy[4] = {y1,y1,y2,y2};
+    for(int i = 0;i < 4;i++)
+        canvas.user_to_device(dx[i],dy[i]);
+    const double left  = std::min(std::min(dx[0],dx[1]),std::min(dx[2],dx[3]));
+    const double top   = std::min(std::min(dy[0],dy[1]),std::min(dy[2],dy[3]));
+    const double right = std::max(std::max(dx[0],dx[1]),std::max(dx[2],dx[3]));
+    const double bottom= std::max(std::max(dy[0],dy[1]),std::max(dy[2],dy[3]));
+    mAttachInfo->mOverdrawRects.push_back(Rect::MakeLTRB(int(std::round(left)),int(std::round(top)),
+            int(std::round(right)),int(std::round(bottom))));
 }
 
 void View::setBackgroundBounds() {
@@ -3058,6 +3105,7 @@ bool View::applyLegacyAnimation(ViewGroup* parent, int64_t drawingTime, Animatio
 }
 
 void View::draw(Canvas&canvas){
+    ATRACE_NAME("View::draw");
     const int privateFlags = mPrivateFlags;
     const bool dirtyOpaque = (privateFlags & PFLAG_DIRTY_MASK) == PFLAG_DIRTY_OPAQUE &&
                     (mAttachInfo == nullptr || !mAttachInfo->mIgnoreDirtyState);
@@ -3075,9 +3123,9 @@ void View::draw(Canvas&canvas){
      *      6. Draw decorations (scrollbars for instance)
      */
 
-    // Step 1, draw the background, if needed
+    // Step 1, draw the background, if needed(and not hidden under opaque children)
 
-    if (!dirtyOpaque) {
+    if (!dirtyOpaque && !isBackgroundOccluded(canvas)) {
         drawBackground(canvas);
     }
 
@@ -3247,7 +3295,9 @@ bool View::draw(Canvas&canvas,ViewGroup*parent,int64_t drawingTime){
         more = applyLegacyAnimation(parent, drawingTime, a, scalingRequired);
         concatMatrix = a->willChangeTransformationMatrix();
         if (concatMatrix) {
+            /*keep the parent's hit test index in step while the animation transforms the child*/
             mPrivateFlags3 |= PFLAG3_VIEW_IS_ANIMATING_TRANSFORM;
+            invalidateParentHitTestIndex();
         }
         transformToApply = parent->getChildTransformation();
     } else {
@@ -3255,6 +3305,7 @@ bool View::draw(Canvas&canvas,ViewGroup*parent,int64_t drawingTime){
             // No longer animating: clear out old animation matrix
             //mRenderNode.setAnimationMatrix(nullptr);
             mPrivateFlags3 &= ~PFLAG3_VIEW_IS_ANIMATING_TRANSFORM;
+            invalidateParentHitTestIndex();
         }
         if (!drawingWithRenderNode
                 && (parentFlags & ViewGroup::FLAG_SUPPORT_STATIC_TRANSFORMATIONS) != 0) {
@@ -4204,6 +4255,7 @@ void View::offsetTopAndBottom(int offset){
         mTop += offset;
         mBottom += offset;
         mRenderNode->offsetTopAndBottom(offset);
+        invalidateParentHitTestIndex();
         if(isHardwareAccelerated()){
             invalidateViewProperty(false, false);
             invalidateParentIfNeededAndWasQuickRejected();
@@ -4246,6 +4298,7 @@ void View::offsetLeftAndRight(int offset){
         mLeft += offset;
         mRight += offset;
         mRenderNode->offsetLeftAndRight(offset);
+        invalidateParentHitTestIndex();
         if (isHardwareAccelerated()) {
             invalidateViewProperty(false, false);
             invalidateParentIfNeededAndWasQuickRejected();
@@ -4462,6 +4515,7 @@ bool View::setFrame(int left,int top,int width,int height){
         mRight  = left+ width;
         mBottom = top + height;
         mRenderNode->setLeftTopRightBottom(mLeft, mTop, mRight, mBottom);
+        invalidateParentHitTestIndex();
         LOGV("%p:%d (%d,%d %d,%d)",this,mID,left,top,width,height);
         mPrivateFlags |= PFLAG_HAS_BOUNDS;
 
@@ -5811,6 +5865,12 @@ bool View::skipInvalidate()const{
            && mParent && (!mParent->isViewTransitioning((View*)this));
 }
 
+/*wake the window's event source,it is readiness driven and only checked for layout/draw when signaled*/
+void View::scheduleTraversals(){
+    if(mAttachInfo && mAttachInfo->mEventSource)
+        mAttachInfo->mEventSource->signalReady();
+}
+
 RefPtr<ImageSurface>View::getDrawingCache(bool autoScale){
     if ((mViewFlags & WILL_NOT_CACHE_DRAWING) == WILL_NOT_CACHE_DRAWING) {
         return nullptr;
@@ -6103,6 +6163,10 @@ void View::invalidateParentCaches(){
     if(mParent)mParent->mPrivateFlags |= PFLAG_INVALIDATED;
 }
 
+void View::invalidateParentHitTestIndex(){
+    if(mParent)mParent->invalidateHitTestIndex();
+}
+
 void View::invalidateParentIfNeeded(){
     if(isHardwareAccelerated()&&mParent)mParent->invalidate(true);
 }
@@ -6149,6 +6213,7 @@ void View::invalidateInternal(int l, int t, int w, int h, bool invalidateCache,b
             mPrivateFlags|=PFLAG_DIRTY;
             ((ViewGroup*)this)->mInvalidRgn->do_union(damage);
         }
+        scheduleTraversals();
     }
 }
 
@@ -7459,6 +7524,7 @@ bool View::showTooltip(int x, int y, bool fromLongClick){
 }
 
 void View::layout(int l, int t, int w, int h){
+    ATRACE_NAME("View::layout");
     if ((mPrivateFlags3 & PFLAG3_MEASURE_NEEDED_BEFORE_LAYOUT) != 0) {
         onMeasure(mOldWidthMeasureSpec, mOldHeightMeasureSpec);
         mPrivateFlags3 &= ~PFLAG3_MEASURE_NEEDED_BEFORE_LAYOUT;
@@ -7469,6 +7535,7 @@ void View::layout(int l, int t, int w, int h){
     int oldH = mBottom-mTop;
     mPrivateFlags &= ~PFLAG_FORCE_LAYOUT;
     mPrivateFlags3 |= PFLAG3_IS_LAID_OUT;
+    mPrivateFlags4 &= ~PFLAG4_MEASURED_SINCE_FORCE_LAYOUT;
     bool changed = setFrame(l,t,w,h);
     if(changed|| ((mPrivateFlags & PFLAG_LAYOUT_REQUIRED) == PFLAG_LAYOUT_REQUIRED)){
         onLayout(changed, l, t, w, h);
@@ -8685,20 +8752,30 @@ void View::requestLayout(){
         }
         mAttachInfo->mViewRequestingLayout = this;
     }
+    mMeasureCache.clear();
     mPrivateFlags |= PFLAG_FORCE_LAYOUT;
     mPrivateFlags |= PFLAG_INVALIDATED;
+    mPrivateFlags4 &= ~PFLAG4_MEASURED_SINCE_FORCE_LAYOUT;
     if (mParent != nullptr && !mParent->isLayoutRequested()) {
         mParent->requestLayout();
+    } else {
+        /*ancestors already measured in this pass must measure again*/
+        for(ViewGroup*p = mParent;p && (p->mPrivateFlags4 & PFLAG4_MEASURED_SINCE_FORCE_LAYOUT);p = p->mParent){
+            p->mPrivateFlags4 &= ~PFLAG4_MEASURED_SINCE_FORCE_LAYOUT;
+            p->mMeasureCache.clear();
+        }
     }
     if ( mAttachInfo && (mAttachInfo->mViewRequestingLayout == this) ) {
          mAttachInfo->mViewRequestingLayout = nullptr;
     }
+    scheduleTraversals();
 }
 
 void View::forceLayout(){
     mMeasureCache.clear();
     mPrivateFlags |= PFLAG_FORCE_LAYOUT;
     mPrivateFlags |= PFLAG_INVALIDATED;
+    mPrivateFlags4 &= ~PFLAG4_MEASURED_SINCE_FORCE_LAYOUT;
 }
 
 /**Returns true if this view has been through at least one layout since it
@@ -9369,6 +9446,7 @@ void View::setElevation(float elevation){
         elevation = sanitizeFloatPropertyValue(elevation, "elevation");
         invalidateViewProperty(true, false);
         mRenderNode->setElevation(elevation);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false, true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9415,6 +9493,7 @@ void View::setScaleX(float scaleX){
         scaleX = sanitizeFloatPropertyValue(scaleX, "scaleX");
         invalidateViewProperty(true,false);
         mRenderNode->setScaleX(scaleX);//scale cant be zero
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9429,6 +9508,7 @@ void View::setScaleY(float scaleY){
         scaleY = sanitizeFloatPropertyValue(scaleY, "scaleY");
         invalidateViewProperty(true,false);
         mRenderNode->setScaleY(scaleY);//scale cant be zero
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9442,6 +9522,7 @@ void View::setTranslationX(float x){
     if(x != getTranslationX()){
         invalidateViewProperty(true,false);
         mRenderNode->setTranslationX(x);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
 
         invalidateParentIfNeededAndWasQuickRejected();
@@ -9457,6 +9538,7 @@ void View::setTranslationY(float y){
     if(y!=getTranslationY()){
         invalidateViewProperty(true,false);
         mRenderNode->setTranslationY(y); 
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
 
         invalidateParentIfNeededAndWasQuickRejected();
@@ -9473,6 +9555,7 @@ void View::setTranslationZ(float translationZ){
         translationZ = sanitizeFloatPropertyValue(translationZ, "translationZ");
         invalidateViewProperty(true,false);
         mRenderNode->setTranslationZ(translationZ);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9492,6 +9575,7 @@ void View::setRotation(float rotation){
     if(rotation != getRotation()){
         invalidateViewProperty(true,false);
         mRenderNode->setRotation(rotation);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
         notifySubtreeAccessibilityStateChangedIfNeeded();
@@ -9506,6 +9590,7 @@ void View::setRotationX(float rotationX){
     if(rotationX!= getRotationX()){
         invalidateViewProperty(true,false);
         mRenderNode->setRotationX(rotationX);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
         notifySubtreeAccessibilityStateChangedIfNeeded();
@@ -9520,6 +9605,7 @@ void View::setRotationY(float rotationY){
     if(rotationY!= getRotationY()){
         invalidateViewProperty(true,false);
         mRenderNode->setRotationY(rotationY);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
         notifySubtreeAccessibilityStateChangedIfNeeded();
@@ -9534,6 +9620,7 @@ void View::setPivotX(float x){
     if((mRenderNode->isPivotExplicitlySet()==false)||(x!=getPivotX())){
         invalidateViewProperty(true,false);
         mRenderNode->setPivotX(x);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9547,6 +9634,7 @@ void View::setPivotY(float y){
     if((mRenderNode->isPivotExplicitlySet()==false)||(y!=getPivotY())){
         invalidateViewProperty(true,false);
         mRenderNode->setPivotY(y);
+        invalidateParentHitTestIndex();
         invalidateViewProperty(false,true);
         invalidateParentIfNeededAndWasQuickRejected();
     }
@@ -9755,6 +9843,7 @@ ViewPropertyAnimator& View::animate() {
 }
 
 void View::measure(int widthMeasureSpec, int heightMeasureSpec){
+    ATRACE_NAME("View::measure");
     bool optical = isLayoutModeOptical(this);
     if (optical != isLayoutModeOptical(mParent)) {
         Insets insets = getOpticalInsets();
@@ -9765,9 +9854,12 @@ void View::measure(int widthMeasureSpec, int heightMeasureSpec){
     }
 
     // Suppress sign extension for the low bytes
-    const uint64_t key =(uint64_t(widthMeasureSpec)<<32)|heightMeasureSpec;
+    const uint64_t key =(uint64_t(uint32_t(widthMeasureSpec))<<32)|uint32_t(heightMeasureSpec);
 
-    const bool forceLayout = (mPrivateFlags & PFLAG_FORCE_LAYOUT) == PFLAG_FORCE_LAYOUT;
+    /*a layout request is satisfied by the first onMeasure after it,parents measuring
+     *a child twice with the same spec in one pass(weights,table columns..) get the cache*/
+    const bool forceLayout = ((mPrivateFlags & PFLAG_FORCE_LAYOUT) == PFLAG_FORCE_LAYOUT)
+                && ((mPrivateFlags4 & PFLAG4_MEASURED_SINCE_FORCE_LAYOUT) == 0);
 
     // Optimize layout by avoiding an extra EXACTLY pass when the view is
     // already measured as the correct size. In API 23 and below, this
@@ -9789,6 +9881,7 @@ void View::measure(int widthMeasureSpec, int heightMeasureSpec){
             // measure ourselves, this should set the measured dimension flag back
             onMeasure(widthMeasureSpec, heightMeasureSpec);
             mPrivateFlags3 &= ~PFLAG3_MEASURE_NEEDED_BEFORE_LAYOUT;
+            if(forceLayout)mPrivateFlags4 |= PFLAG4_MEASURED_SINCE_FORCE_LAYOUT;
         } else {
             uint64_t value =itc->second;// mMeasureCache.valueAt(cacheIndex);
             // Casting a long to int drops the high 32 bits, no mask needed
@@ -9806,7 +9899,7 @@ void View::measure(int widthMeasureSpec, int heightMeasureSpec){
 
     mOldWidthMeasureSpec = widthMeasureSpec;
     mOldHeightMeasureSpec = heightMeasureSpec;
-    const uint64_t szMeasured = (uint64_t(mMeasuredWidth)<<32)| mMeasuredHeight;
+    const uint64_t szMeasured = (uint64_t(uint32_t(mMeasuredWidth))<<32)| uint32_t(mMeasuredHeight);
     mMeasureCache[key] = szMeasured;//
     //mMeasureCache.insert(std::pair<Size,Size>(key,szMeasured)); // suppress sign extension
 }
@@ -9869,6 +9962,7 @@ View::AttachInfo::AttachInfo(Context*ctx){
     mAlwaysConsumeSystemBars= false;
     mRecomputeGlobalAttributes=false;
     mDebugLayout  = false;
+    mDebugOverdraw= false;
     mViewVelocityApi=true;
     mDrawingTime  = 0;
     mInTouchMode  = true;
@@ -10252,6 +10346,10 @@ public:                                                     \
     { ((View*)obj)->set##METHOD(GET_VARIANT(v,float)); }    \
     AnimateValue get(void* obj)const override               \
     { return ((View*)obj)->get##METHOD(); }                 \
+    void setFloat(void* obj,float v)const override          \
+    { ((View*)obj)->set##METHOD(v); }                       \
+    float getFloat(void* obj)const override                 \
+    { return ((View*)obj)->get##METHOD(); }                 \
 };                                                          \
 static  prop_##PROJ INST_##PROJ;        \
 }                                       \
@@ -23,6 +23,7 @@ SET(VIEW_SOURCES
     view/view.cc
     view/viewconfiguration.cc
     view/viewgroup.cc
+    view/hittestindex.cc
     view/viewoverlay.cc
     view/viewpropertyanimator.cc
     view/viewstub.cc
@@ -225,6 +225,8 @@ protected:
     static constexpr int PFLAG3_AUTOFILLID_EXPLICITLY_SET = 0x40000000;
     static constexpr int PFLAG3_ACCESSIBILITY_HEADING   = 0x80000000;
 
+    /** Set once onMeasure ran for a pending forceLayout,later measures with the same spec hit the cache */
+    static constexpr int PFLAG4_MEASURED_SINCE_FORCE_LAYOUT = 0x0001;
     /** Indicates if rotary scroll haptics support for the view has been determined. */
     static constexpr int PFLAG4_ROTARY_HAPTICS_DETERMINED = 0x100000;
     static constexpr int PFLAG4_ROTARY_HAPTICS_ENABLED = 0x200000;
@@ -591,6 +593,7 @@ private:
     bool showLongClickTooltip(int x, int y);
     void initView();
     void drawBackground(Canvas&canvas);
+    void recordOverdraw(Canvas&canvas,int x,int y,int w,int h);
     void applyBackgroundTint();
     void applyForegroundTint();
     View* findViewInsideOutShouldExist(View* root, int id)const;
@@ -641,6 +644,7 @@ private:
     bool applyLegacyAnimation(ViewGroup* parent, int64_t drawingTime, Animation* a, bool scalingRequired);
     bool needRtlPropertiesResolution()const;
     bool skipInvalidate()const;
+    void scheduleTraversals();
     void buildDrawingCache(bool autoScale);
     void buildDrawingCacheImpl(bool autoScale);
     bool hasParentWantsFocus()const;
@@ -732,6 +736,7 @@ protected:
     virtual void internalSetPadding(int left, int top, int right, int bottom);
     void assignParent(ViewGroup*p);
     bool debugDraw()const;
+    virtual bool isBackgroundOccluded(Canvas&canvas);
     void setBackgroundBounds();
     int dipsToPixels(int dips)const;
     void computeOpaqueFlags();
@@ -893,10 +898,14 @@ public:
     virtual ~View();
     bool isShowingLayoutBounds()const;
     void setShowingLayoutBounds(bool debugLayout);
+    /*tints the window by how many backgrounds each pixel got in the frame*/
+    bool isShowingOverdraw()const;
+    void setShowingOverdraw(bool debugOverdraw);
     virtual void draw(Canvas&canvas);
     bool draw(Canvas&canvas,ViewGroup*parent,int64_t drawingTime);
 
     virtual void invalidateParentCaches();
+    void invalidateParentHitTestIndex();
     virtual void invalidateParentIfNeeded();
     virtual void invalidateViewProperty(bool invalidateParent, bool forceRedraw);
     virtual void invalidate(const Rect&dirty);
@@ -1586,6 +1595,8 @@ public:
     bool mKeepScreenOn;
     bool mHasSystemUiListeners;
     bool mDebugLayout;
+    bool mDebugOverdraw;
+    std::vector<Rect> mOverdrawRects;/*device space,filled during a frame when mDebugOverdraw*/
     bool mNextFocusLooped;
     bool mViewVelocityApi;
     UIEventSource*mEventSource;
@@ -16,6 +16,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  *********************************************************************************/
 #include <view/viewgroup.h>
+#include <view/hittestindex.h>
 #include <view/accessibility/accessibilitymanager.h>
 #include <animation/layouttransition.h>
 #include <animation/layoutanimationcontroller.h>
@@ -175,6 +176,7 @@ void ViewGroup::initGroup(){
     mChildUnhandledKeyListeners  = 0;
     mInvalidRgn = Cairo::Region::create();
     mChildTransformation = nullptr;
+    mHitTestIndex = nullptr;
     mInvalidationTransformation = nullptr;
     mAccessibilityFocusedVirtualView = nullptr;
     mPersistentDrawingCache = PERSISTENT_SCROLLING_CACHE;
@@ -228,6 +230,8 @@ void ViewGroup::initFromAttributes(Context*ctx,const AttributeSet&atts){
     setLayoutMode(layoutMode);
     setTransitionGroup(atts.getBoolean("transitionGroup",false));
     setTouchscreenBlocksFocus(atts.getBoolean("touchscreenBlocksFocus",false));
+    setHitTestIndexEnabled(atts.getBoolean("hitTestIndex",false));
+    setOcclusionCullingEnabled(atts.getBoolean("occlusionCulling",false));
 }
 
 ViewGroup::~ViewGroup() {
@@ -237,6 +241,7 @@ ViewGroup::~ViewGroup() {
         delete v;
     }
     mChildren.clear();
+    delete mHitTestIndex;
     delete mChildTransformation;
     delete mInvalidationTransformation;
     delete mLayoutAnimationController;
@@ -447,10 +452,11 @@ bool ViewGroup::dispatchTooltipHoverEvent(MotionEvent& event) {
             const float x = event.getXDispatchLocation(0);
             const float y = event.getYDispatchLocation(0);
 
-            std::vector<View*> preorderedList = buildOrderedChildList();
+            int hitCount;
+            std::vector<View*> preorderedList = buildHitTestChildList(x, y, hitCount);
             const bool customOrder = preorderedList.size()==0 && isChildrenDrawingOrderEnabled();
             auto children = mChildren;
-            for (int i = childrenCount - 1; i >= 0; i--) {
+            for (int i = hitCount - 1; i >= 0; i--) {
                 const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
                 View* child = getAndVerifyPreorderedView(preorderedList, children, childIndex);
                 if (!child->canReceivePointerEvents()
@@ -678,9 +684,10 @@ bool ViewGroup::dispatchGenericPointerEvent(MotionEvent& event) {
     if (childrenCount != 0) {
         const float x = event.getXDispatchLocation(0);
         const float y = event.getYDispatchLocation(0);
-        std::vector<View*> preorderedList = buildOrderedChildList();
+        int hitCount;
+        std::vector<View*> preorderedList = buildHitTestChildList(x, y, hitCount);
         bool customOrder = preorderedList.empty()  && isChildrenDrawingOrderEnabled();
-        for (int i = childrenCount - 1; i >= 0; i--) {
+        for (int i = hitCount - 1; i >= 0; i--) {
             int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
             View* child = getAndVerifyPreorderedView(preorderedList, mChildren, childIndex);
             if (!canViewReceivePointerEvents(*child)
@@ -798,6 +805,7 @@ void ViewGroup::removeFromArray(int index){
     if ( (index >= 0) && (index < mChildren.size()) ) {
         /*auto it=*/mChildren.erase(mChildren.begin()+index);
         //delete *it;cant delete here 
+        invalidateHitTestIndex();
     } else {
         LOGE("IndexOutOfBounds %d",index);
     }
@@ -822,6 +830,7 @@ void ViewGroup::removeFromArray(int start, int count){
         mChildren[i] = nullptr;
     }
     mChildren.erase(mChildren.begin()+start,mChildren.begin()+start+count);
+    invalidateHitTestIndex();
 }
 
 void ViewGroup::detachAllViewsFromParent(){
@@ -834,6 +843,7 @@ void ViewGroup::detachAllViewsFromParent(){
         mChildren[i] = nullptr;
     }
     mChildren.clear();
+    invalidateHitTestIndex();
 }
 
 bool ViewGroup::addViewInLayout(View* child, int index,LayoutParams* params){
@@ -1488,6 +1498,160 @@ std::vector<View*> ViewGroup::buildTouchDispatchChildList(){
     return buildOrderedChildList();
 }
 
+/*Children to hit test at (x,y),iterated from count-1 down to 0 like buildOrderedChildList().
+ *With the hit test index only the children whose bounds cover the point are returned*/
+std::vector<View*> ViewGroup::buildHitTestChildList(float x,float y,int& count){
+    if ((mHitTestIndex == nullptr) || isChildrenDrawingOrderEnabled()) {
+        count = (int)mChildren.size();
+        return buildTouchDispatchChildList();
+    }
+    if (!mHitTestIndex->isValid()) {
+        std::vector<View*> orderedList = buildOrderedChildList();
+        mHitTestIndex->build(orderedList.empty() ? mChildren : orderedList);
+    }
+    std::vector<View*> candidates;
+    mHitTestIndex->query(int(std::floor(x)) + mScrollX, int(std::floor(y)) + mScrollY, candidates);
+    count = (int)candidates.size();
+    return candidates;
+}
+
+void ViewGroup::invalidateHitTestIndex(){
+    if (mHitTestIndex != nullptr) {
+        mHitTestIndex->invalidate();
+    }
+}
+
+void ViewGroup::setHitTestIndexEnabled(bool enabled){
+    if (enabled == (mHitTestIndex != nullptr)) {
+        return;
+    }
+    if (enabled) {
+        mHitTestIndex = new HitTestIndex();
+    } else {
+        delete mHitTestIndex;
+        mHitTestIndex = nullptr;
+    }
+}
+
+bool ViewGroup::isHitTestIndexEnabled()const{
+    return mHitTestIndex != nullptr;
+}
+
+void ViewGroup::setOcclusionCullingEnabled(bool enabled){
+    if (hasBooleanFlag(FLAG_OCCLUSION_CULLING) != enabled) {
+        setBooleanFlag(FLAG_OCCLUSION_CULLING, enabled);
+        invalidate();
+    }
+}
+
+bool ViewGroup::isOcclusionCullingEnabled()const{
+    return hasBooleanFlag(FLAG_OCCLUSION_CULLING);
+}
+
+static inline bool rectContains(const Rect&outer,const Rect&r){
+    return (r.left >= outer.left) && (r.top >= outer.top)
+        && (r.right() <= outer.right()) && (r.bottom() <= outer.bottom());
+}
+
+static inline Rect getClipRect(Canvas&canvas){
+    double x1,y1,x2,y2;
+    canvas.get_clip_extents(x1,y1,x2,y2);
+    return Rect::MakeLTRB(int(std::floor(x1)),int(std::floor(y1)),int(std::ceil(x2)),int(std::ceil(y2)));
+}
+
+/*outer:pixels the child may touch,inner:pixels it surely covers(empty when rotated or skewed)*/
+static void getChildDrawBounds(View*child,Rect&outer,Rect&inner){
+    if (child->hasIdentityMatrix()) {
+        outer.set(child->getLeft(),child->getTop(),child->getWidth(),child->getHeight());
+        inner = outer;
+        return;
+    }
+    const Cairo::Matrix&m = child->getMatrix();
+    Cairo::Rectangle r = {0,0,double(child->getWidth()),double(child->getHeight())};
+    m.transform_rectangle(r);
+    outer = Rect::MakeLTRB(int(std::floor(r.x)),int(std::floor(r.y)),
+            int(std::ceil(r.x + r.width)),int(std::ceil(r.y + r.height)));
+    outer.offset(child->getLeft(),child->getTop());
+    if ((m.xy == 0) && (m.yx == 0)) {
+        inner = Rect::MakeLTRB(int(std::ceil(r.x)),int(std::ceil(r.y)),
+                int(std::floor(r.x + r.width)),int(std::floor(r.y + r.height)));
+        inner.offset(child->getLeft(),child->getTop());
+    } else {
+        inner.setEmpty();
+    }
+}
+
+bool ViewGroup::isOccluder(View*child,const Rect&clip,Rect&inner)const{
+    if (((child->mViewFlags & VISIBILITY_MASK) != VISIBLE) || (child->getAnimation() != nullptr)
+            || !child->isOpaque() || !child->mClipBounds.empty() || child->getClipToOutline()) {
+        return false;
+    }
+    Rect outer;
+    getChildDrawBounds(child,outer,inner);
+    inner.intersect(clip);
+    return !inner.empty();
+}
+
+bool ViewGroup::isBackgroundOccluded(Canvas&canvas){
+    if ((mBackground == nullptr) || !hasBooleanFlag(FLAG_OCCLUSION_CULLING)
+            || hasBooleanFlag(FLAG_SUPPORT_STATIC_TRANSFORMATIONS) || mChildren.empty()) {
+        return false;
+    }
+    Rect visible = getClipRect(canvas);
+    Rect clip = Rect::Make(mScrollX,mScrollY,getWidth(),getHeight());
+    if ((mGroupFlags & CLIP_TO_PADDING_MASK) == CLIP_TO_PADDING_MASK) {
+        clip.set(mScrollX + mPaddingLeft,mScrollY + mPaddingTop,
+                getWidth() - mPaddingLeft - mPaddingRight,getHeight() - mPaddingTop - mPaddingBottom);
+    }
+    visible.intersect(mScrollX,mScrollY,getWidth(),getHeight());
+    if (visible.empty()) {
+        return false;
+    }
+    Rect inner;
+    for (View*child:mChildren) {
+        if (isOccluder(child,clip,inner) && rectContains(inner,visible)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*Walks the children from the top of the drawing order down,collecting the rects of a few
+ *opaque ones.A child whose visible part lies inside one of them need not be drawn*/
+void ViewGroup::cullOccludedChildren(Canvas&canvas,const std::vector<View*>&preorderedList,bool customOrder,std::vector<bool>&culled){
+    constexpr int MAX_OCCLUDERS = 4;
+    const int childrenCount = mChildren.size();
+    culled.assign(childrenCount,false);
+    if (!hasBooleanFlag(FLAG_OCCLUSION_CULLING) || !hasBooleanFlag(FLAG_CLIP_CHILDREN)
+            || hasBooleanFlag(FLAG_SUPPORT_STATIC_TRANSFORMATIONS) || (childrenCount < 2)) {
+        return;
+    }
+    const Rect clip = getClipRect(canvas);
+    Rect occluders[MAX_OCCLUDERS];
+    int occluderCount = 0;
+    Rect outer,inner;
+    for (int i = childrenCount - 1; i >= 0; i--) {
+        const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
+        View* child = getAndVerifyPreorderedView(preorderedList, mChildren, childIndex);
+        if (((child->mViewFlags & VISIBILITY_MASK) != VISIBLE) || (child->getAnimation() != nullptr)) {
+            continue;
+        }
+        getChildDrawBounds(child,outer,inner);
+        outer.intersect(clip);
+        bool hidden = outer.empty();
+        for (int j = 0; !hidden && (j < occluderCount); j++) {
+            hidden = rectContains(occluders[j],outer);
+        }
+        if (hidden) {
+            culled[i] = true;
+            continue;
+        }
+        if ((occluderCount < MAX_OCCLUDERS) && isOccluder(child,clip,inner)) {
+            occluders[occluderCount++] = inner;
+        }
+    }
+}
+
 View* ViewGroup::getAccessibilityFocusedHost()const{
     return mAccessibilityFocusedHost;
 }
@@ -1572,10 +1736,11 @@ PointerIcon* ViewGroup::onResolvePointerIcon(MotionEvent& event, int pointerInde
     // Check what the child under the pointer says about the pointer.
     const int childrenCount = mChildren.size();//Count;
     if (childrenCount != 0) {
-        std::vector<View*> preorderedList = buildOrderedChildList();
+        int hitCount;
+        std::vector<View*> preorderedList = buildHitTestChildList(x, y, hitCount);
         const bool customOrder = preorderedList.empty() && isChildrenDrawingOrderEnabled();
         auto& children = mChildren;
-        for (int i = childrenCount - 1; i >= 0; i--) {
+        for (int i = hitCount - 1; i >= 0; i--) {
             const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
             View* child = getAndVerifyPreorderedView(preorderedList,children, childIndex);
             if (!canViewReceivePointerEvents(*child)
@@ -1774,6 +1939,7 @@ void ViewGroup::addInArray(View* child, int index){
         mChildren.push_back(child);
     else
         mChildren.insert(mChildren.begin()+index,child);
+    invalidateHitTestIndex();
 }
 
 void ViewGroup::cleanupLayoutState(View* child)const{
@@ -2038,6 +2204,7 @@ void ViewGroup::removeAllViewsInLayout() {
     }
 
     mChildren.clear();
+    invalidateHitTestIndex();
     if (mDefaultFocus)  clearDefaultFocus(mDefaultFocus);
 
     if (mFocusedInCluster) clearFocusedInCluster(mFocusedInCluster);
@@ -2388,6 +2555,8 @@ void ViewGroup::dispatchDraw(Canvas&canvas){
     // draw reordering internally
     std::vector<View*> preorderedList=buildOrderedChildList();
     const bool customOrder = preorderedList.empty() && isChildrenDrawingOrderEnabled();
+    std::vector<bool> culled;
+    cullOccludedChildren(canvas,preorderedList,customOrder,culled);
     for (int i = 0; i < childrenCount; i++) {
         while (transientIndex >= 0 && mTransientIndices.at(transientIndex) == i) {
             View* transientChild = mTransientViews.at(transientIndex);
@@ -2403,7 +2572,11 @@ void ViewGroup::dispatchDraw(Canvas&canvas){
 
         const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
         View* child = getAndVerifyPreorderedView(preorderedList, mChildren, childIndex);
-        if ((child->mViewFlags & VISIBILITY_MASK) == VISIBLE || child->getAnimation() != nullptr) {
+        if (culled[i]) {
+            /*as if quick rejected by View::draw()*/
+            child->mPrivateFlags |= PFLAG_DRAWN;
+            child->mPrivateFlags2|= PFLAG2_VIEW_QUICK_REJECTED;
+        } else if ((child->mViewFlags & VISIBILITY_MASK) == VISIBLE || child->getAnimation() != nullptr) {
             more |= drawChild(canvas, child, drawingTime);
         }
     }
@@ -2522,6 +2695,7 @@ void ViewGroup::invalidateChild(View*child,Rect&dirty){
         dirty.intersect(0,0,root->getWidth(),root->getHeight());
         root->mInvalidRgn->do_union((const RectangleInt&)dirty);
     }
+    scheduleTraversals();
 }
 
 ViewGroup*ViewGroup::invalidateChildInParent(int* location, Rect& dirty){
@@ -2995,6 +3169,9 @@ void ViewGroup::offsetChildrenTopAndBottom(int offset){
             v->mRenderNode->offsetTopAndBottom(offset);
         }
     }
+    if (mHitTestIndex != nullptr) {
+        mHitTestIndex->offset(0, offset);
+    }
     if (bInvalidate) {
         invalidateViewProperty(false, false);
     }
@@ -3635,6 +3812,8 @@ void ViewGroup::onDescendantInvalidated(View* child,View* target){
 
     if (mParent != nullptr) {
         mParent->onDescendantInvalidated(this, target);
+    } else {
+        scheduleTraversals();
     }
 }
 
@@ -3781,10 +3960,13 @@ bool ViewGroup::dispatchTouchEvent(MotionEvent&ev){
                     const int x = ev.getXDispatchLocation(actionIndex);
                     const int y = ev.getYDispatchLocation(actionIndex);
 
-                    std::vector<View*>preorderedList = buildTouchDispatchChildList();
+                    // the accessibility focused child is searched through all children
+                    int hitCount = childrenCount;
+                    std::vector<View*>preorderedList = childWithAccessibilityFocus ? buildTouchDispatchChildList()
+                            : buildHitTestChildList(x, y, hitCount);
                     const bool customOrder = preorderedList.empty() && isChildrenDrawingOrderEnabled();
                     std::vector<View*>&children = mChildren;
-                    for(int i = childrenCount-1;i >= 0;i--){
+                    for(int i = hitCount-1;i >= 0;i--){
                         const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
                         View* child = getAndVerifyPreorderedView(preorderedList, children, childIndex);
 
@@ -3820,7 +4002,7 @@ bool ViewGroup::dispatchTouchEvent(MotionEvent&ev){
                             mLastTouchDownTime = ev.getDownTime();
                             if(preorderedList.size()){
                                 for(int j=0;j<childrenCount;j++){
-                                    if(children[childIndex]==mChildren[j]){
+                                    if(child==mChildren[j]){
                                         mLastTouchDownIndex=j; break;
                                     }
                                 } 
@@ -3911,10 +4093,11 @@ bool ViewGroup::dispatchHoverEvent(MotionEvent&event){
         const float y = event.getYDispatchLocation(0);
         const int childrenCount = mChildren.size();
         if (childrenCount != 0) {
-            std::vector<View*> preorderedList = buildOrderedChildList();
+            int hitCount;
+            std::vector<View*> preorderedList = buildHitTestChildList(x, y, hitCount);
             const bool customOrder = preorderedList.empty() && isChildrenDrawingOrderEnabled();
             HoverTarget* lastHoverTarget = nullptr;
-            for (int i = childrenCount - 1; i >= 0; i--) {
+            for (int i = hitCount - 1; i >= 0; i--) {
                 const int childIndex = getAndVerifyPreorderedIndex(childrenCount, i, customOrder);
                 View* child = getAndVerifyPreorderedView(preorderedList, mChildren, childIndex);
                 if (!child->canReceivePointerEvents() || !isTransformedTouchPointInView(x, y, *child, nullptr)) {
@@ -58,6 +58,7 @@ private:
     static constexpr int FLAG_START_ACTION_MODE_FOR_CHILD_IS_TYPED = 0x8000000;
     static constexpr int FLAG_START_ACTION_MODE_FOR_CHILD_IS_NOT_TYPED = 0x10000000;
     static constexpr int FLAG_SHOW_CONTEXT_MENU_WITH_COORDS = 0x20000000;
+    static constexpr int FLAG_OCCLUSION_CULLING = 0x40000000;
 
     static constexpr int LAYOUT_MODE_UNDEFINED   = -1;
     static constexpr int ARRAY_INITIAL_CAPACITY = 12;
@@ -124,6 +125,7 @@ private:
     class HoverTarget* mFirstHoverTarget;
     View* mTooltipHoverTarget;
     Transformation* mChildTransformation;
+    class HitTestIndex* mHitTestIndex;
     void initGroup();
     void initFromAttributes(Context*,const AttributeSet&);
     void setBooleanFlag(int flag, bool value);
@@ -136,6 +138,10 @@ private:
 
     int getAndVerifyPreorderedIndex(int childrenCount, int i, bool customOrder);
     static View*getAndVerifyPreorderedView(const std::vector<View*>&,const std::vector<View*>&, int childIndex);
+    std::vector<View*> buildHitTestChildList(float x,float y,int& count);
+    void invalidateHitTestIndex();
+    bool isOccluder(View*child,const Rect&clip,Rect&inner)const;
+    void cullOccludedChildren(Canvas&canvas,const std::vector<View*>&preorderedList,bool customOrder,std::vector<bool>&culled);
     TouchTarget* getTouchTarget(View* child)const;
     TouchTarget* addTouchTarget(View* child, int pointerIdBits);
     View*findChildWithAccessibilityFocus();
@@ -270,6 +276,7 @@ protected:
 
     virtual void onDebugDrawMargins(Canvas& canvas);
     virtual void onDebugDraw(Canvas& canvas);
+    bool isBackgroundOccluded(Canvas&canvas)override;
     void onAttachedToWindow()override;
     void onDetachedFromWindow()override;
     void drawInvalidateRegion(Canvas&canvas);
@@ -449,6 +456,15 @@ public:
 
     void setMotionEventSplittingEnabled(bool split);
     bool isMotionEventSplittingEnabled()const; 
+    /*grid index of the children bounds,pointer events then test only the children under
+     *the pointer.Worth it with many children,unused with a custom drawing order*/
+    void setHitTestIndexEnabled(bool enabled);
+    bool isHitTestIndexEnabled()const;
+    /*children lying entirely under opaque siblings drawn above them are skipped,
+     *as is the background when an opaque child covers it.Off by default,it trusts
+     *Drawable::getOpacity() of the children's backgrounds*/
+    void setOcclusionCullingEnabled(bool enabled);
+    bool isOcclusionCullingEnabled()const;
     bool dispatchKeyEvent(KeyEvent&)override;
     bool dispatchKeyShortcutEvent(KeyEvent&)override;
     bool dispatchDragEvent(DragEvent& event)override;
@@ -88,79 +88,73 @@ ViewPropertyAnimator::ViewPropertyAnimator(View* view){
             mAnimatorMap.erase(it2);
         }
     };
+}
 
-    mAnimatorEventListener2 = [this](ValueAnimator&animation){
-        auto it = mAnimatorMap.find(&animation);
-        if (it == mAnimatorMap.end()) {
-            // Shouldn't happen, but just to play it safe
-            return;
-        }
+/*the bundle is bound to its animator when started,no lookup is needed per frame*/
+void ViewPropertyAnimator::onAnimationUpdate(ValueAnimator&animation,PropertyBundle&propertyBundle){
+    const bool hardwareAccelerated = mView->isHardwareAccelerated();
 
-        const bool hardwareAccelerated = mView->isHardwareAccelerated();
-        PropertyBundle& propertyBundle =it->second;/* = mAnimatorMap.get(animation);*/
+    // alpha requires slightly different treatment than the other (transform) properties.
+    // The logic in setAlpha() is not simply setting mAlpha, plus the invalidation
+    // logic is dependent on how the view handles an internal call to onSetAlpha().
+    // We track what kinds of properties are set, and how alpha is handled when it is
+    // set, and perform the invalidation steps appropriately.
+    bool alphaHandled = false;
+    if (!hardwareAccelerated) {
+        mView->invalidateParentCaches();
+    }
+    const float fraction = animation.getAnimatedFraction();
+    const int propertyMask = propertyBundle.mPropertyMask;
+    if ((propertyMask & TRANSFORM_MASK) != 0) {
+        mView->invalidateViewProperty(hardwareAccelerated, false);
+    }
+    std::vector<NameValuesHolder>& valueList = propertyBundle.mNameValuesHolder;
 
-        // alpha requires slightly different treatment than the other (transform) properties.
-        // The logic in setAlpha() is not simply setting mAlpha, plus the invalidation
-        // logic is dependent on how the view handles an internal call to onSetAlpha().
-        // We track what kinds of properties are set, and how alpha is handled when it is
-        // set, and perform the invalidation steps appropriately.
-        bool alphaHandled = false;
-        if (!hardwareAccelerated) {
-            mView->invalidateParentCaches();
-        }
-        const float fraction = animation.getAnimatedFraction();
-        const int propertyMask = propertyBundle.mPropertyMask;
-        if ((propertyMask & TRANSFORM_MASK) != 0) {
-            mView->invalidateViewProperty(hardwareAccelerated, false);
-        }
-        std::vector<NameValuesHolder>& valueList = propertyBundle.mNameValuesHolder;
-
-        const int count = valueList.size();
-        RenderNode* node = mView->mRenderNode;
-        Matrix matrix;
-        Rect rect1,rect2;
-        node->getMatrix(matrix);
-        rect1.set(mView->getLeft(),mView->getTop(), mView->getWidth(),mView->getHeight());
-        matrix.transform_rectangle((Cairo::RectangleInt&)rect1);
-
-        for (int i = 0; i < count; ++i) {
-            NameValuesHolder& values = valueList.at(i);
-            const float value = values.mFromValue + fraction * values.mDeltaValue;
-            /*if (values.mNameConstant == ALPHA) {//must be setted in setValue
-                alphaHandled = mView->setAlphaNoInvalidation(value);
-            } else */{
-                setValue(values.mNameConstant, value);
-            }
-        }
-        node->getMatrix(matrix);
-        //LOGD("matrix=(%.3f,%.3f , %.3f,%.3f , %.3f,%.3f) node.scale=%.3f,%.3f",matrix.xx,matrix.yx,matrix.xy,matrix.yy,
-        //    matrix.x0,matrix.y0,node->getScaleX(),node->getScaleY());
-        rect2.set(mView->getLeft(),mView->getTop(), mView->getWidth(),mView->getHeight());
-        matrix.transform_rectangle((Cairo::RectangleInt&)rect2);
-        rect1.inflate(1,1);rect2.inflate(1,1);
-        rect2.Union(rect1);
-        if(mView->mParent){
-            mView->mParent->invalidate(rect2);
-        } else if(dynamic_cast<Window*>(mView)){
-            mView->invalidate(rect2);
+    const int count = valueList.size();
+    RenderNode* node = mView->mRenderNode;
+    Matrix matrix;
+    Rect rect1,rect2;
+    node->getMatrix(matrix);
+    rect1.set(mView->getLeft(),mView->getTop(), mView->getWidth(),mView->getHeight());
+    matrix.transform_rectangle((Cairo::RectangleInt&)rect1);
+
+    for (int i = 0; i < count; ++i) {
+        NameValuesHolder& values = valueList.at(i);
+        const float value = values.mFromValue + fraction * values.mDeltaValue;
+        /*if (values.mNameConstant == ALPHA) {//must be setted in setValue
+            alphaHandled = mView->setAlphaNoInvalidation(value);
+        } else */{
+            setValue(values.mNameConstant, value);
         }
+    }
+    node->getMatrix(matrix);
+    //LOGD("matrix=(%.3f,%.3f , %.3f,%.3f , %.3f,%.3f) node.scale=%.3f,%.3f",matrix.xx,matrix.yx,matrix.xy,matrix.yy,
+    //    matrix.x0,matrix.y0,node->getScaleX(),node->getScaleY());
+    rect2.set(mView->getLeft(),mView->getTop(), mView->getWidth(),mView->getHeight());
+    matrix.transform_rectangle((Cairo::RectangleInt&)rect2);
+    rect1.inflate(1,1);rect2.inflate(1,1);
+    rect2.Union(rect1);
+    if(mView->mParent){
+        mView->mParent->invalidate(rect2);
+    } else if(dynamic_cast<Window*>(mView)){
+        mView->invalidate(rect2);
+    }
 
-        if ((propertyMask & TRANSFORM_MASK) != 0) {
-            if (!hardwareAccelerated) {
-                mView->mPrivateFlags |= View::PFLAG_DRAWN; // force another invalidation
-            }
-        }
-        // invalidate(false) in all cases except if alphaHandled gets set to true
-        // via the call to setAlphaNoInvalidation(), above
-        if (alphaHandled) {
-            mView->invalidate(true);
-        } else {
-            mView->invalidateViewProperty(false, false);
-        }
-        if (mUpdateListener != nullptr) {
-            mUpdateListener(animation);
+    if ((propertyMask & TRANSFORM_MASK) != 0) {
+        if (!hardwareAccelerated) {
+            mView->mPrivateFlags |= View::PFLAG_DRAWN; // force another invalidation
         }
-    }; 
+    }
+    // invalidate(false) in all cases except if alphaHandled gets set to true
+    // via the call to setAlphaNoInvalidation(), above
+    if (alphaHandled) {
+        mView->invalidate(true);
+    } else {
+        mView->invalidateViewProperty(false, false);
+    }
+    if (mUpdateListener != nullptr) {
+        mUpdateListener(animation);
+    }
 }
 
 ViewPropertyAnimator::~ViewPropertyAnimator(){
@@ -414,7 +408,7 @@ bool ViewPropertyAnimator::hasActions()const{
 void ViewPropertyAnimator::startAnimation(){
     mView->setHasTransientState(true);
     ValueAnimator* animator = ValueAnimator::ofFloat({0,1.0f});
-    std::vector<NameValuesHolder> nameValueList =mPendingAnimations;
+    std::vector<NameValuesHolder> nameValueList = std::move(mPendingAnimations);
     mPendingAnimations.clear();
     int propertyMask = 0;
     const int propertyCount = nameValueList.size();
@@ -422,7 +416,9 @@ void ViewPropertyAnimator::startAnimation(){
         NameValuesHolder& nameValuesHolder = nameValueList.at(i);
         propertyMask |= nameValuesHolder.mNameConstant;
     }
-    mAnimatorMap.insert(std::pair<Animator*,PropertyBundle>(animator,PropertyBundle(propertyMask, nameValueList)));
+    /*elements of an unordered_map keep their address until erased*/
+    PropertyBundle* bundle = &mAnimatorMap.insert(std::pair<Animator*,PropertyBundle>(animator,
+            PropertyBundle(propertyMask, std::move(nameValueList)))).first->second;
     if (mPendingSetupAction) {
         mAnimatorSetupMap.insert(std::pair<Animator*,Runnable>(animator, mPendingSetupAction));
         mPendingSetupAction = nullptr;
@@ -439,7 +435,9 @@ void ViewPropertyAnimator::startAnimation(){
         mAnimatorOnEndMap.insert(std::pair<Animator*,Runnable>(animator, mPendingOnEndAction));
         mPendingOnEndAction = nullptr;
     }
-    animator->addUpdateListener(mAnimatorEventListener2);
+    animator->addUpdateListener([this,bundle](ValueAnimator&animation){
+        onAnimationUpdate(animation,*bundle);
+    });
     animator->addListener(mAnimatorEventListener);
     if (mStartDelaySet) {
         animator->setStartDelay(mStartDelay);
@@ -509,8 +507,10 @@ void ViewPropertyAnimator::setValue(int propertyConstant, float value) {
     case ALPHA:
              mView->mTransformationInfo->mAlpha = value;
              node->setAlpha(value);
-             break;
+             return;
     }
+    // Written behind the View setters' back, the parent's hit test index must be told
+    mView->invalidateParentHitTestIndex();
 }
 
 float ViewPropertyAnimator::getValue(int propertyConstant)const{
@@ -73,7 +73,6 @@ private:
 
     //AnimatorEventListener mAnimatorEventListener;
     Animator::AnimatorListener mAnimatorEventListener;
-    ValueAnimator::AnimatorUpdateListener mAnimatorEventListener2;
 
     std::vector<NameValuesHolder> mPendingAnimations;
     Runnable mAnimationStarter;
@@ -95,6 +94,7 @@ private:
     void setValue(int propertyConstant, float value);
     float getValue(int propertyConstant)const;
     void startAnimation();
+    void onAnimationUpdate(ValueAnimator&animation,PropertyBundle&propertyBundle);
 public:
     ViewPropertyAnimator(View* view);
     ~ViewPropertyAnimator();
@@ -8,6 +8,9 @@
 #include <view/accessibility/accessibilitynodeinfo.h>
 #include <view/accessibility/accessibilitymanager.h>
 //#include <porting/cdtypes.h>
+#include <view/choreographer.h>
+#include <core/systemclock.h>
+#include <core/trace.h>
 #include <porting/cdlog.h>
 
 namespace cdroid {
@@ -40,6 +43,11 @@ void AbsListView::initAbsListView(const AttributeSet&atts) {
     mContextMenuInfo= nullptr;
     mFiltered    = false;
     mIsDetaching = false;
+    mPrefetchEnabled = true;
+    mPrefetchPosted  = false;
+    mPrefetchDelta = 0;
+    mPrefetchDrawingTime = 0;
+    mPrefetchBindNanos = 0;
     mPopupHidden = false;
     mStackFromBottom = false;
     mTextFilterEnabled = false;
@@ -62,6 +70,9 @@ void AbsListView::initAbsListView(const AttributeSet&atts) {
     mPendingCheckForKeyLongPress = new CheckForKeyLongPress(this);
     mPerformClick = new PerformClick(this);
     mFlingRunnable = new FlingRunnable(this);
+    mPrefetchRunner = [this](){
+        prefetchItems();
+    };
 
     mGlobalLayoutListener =[this](){
         onGlobalLayout();
@@ -348,6 +359,19 @@ bool AbsListView::isScrollingCacheEnabled()const {
     return mScrollingCacheEnabled;
 }
 
+void AbsListView::setItemPrefetchEnabled(bool enabled) {
+    if (mPrefetchEnabled && !enabled) {
+        removeCallbacks(mPrefetchRunner);
+        mPrefetchPosted = false;
+        mRecycler->scrapPrefetchedViews();
+    }
+    mPrefetchEnabled = enabled;
+}
+
+bool AbsListView::isItemPrefetchEnabled()const {
+    return mPrefetchEnabled;
+}
+
 void AbsListView::setFastScrollerEnabledUiThread(bool enabled) {
     if (mFastScroll != nullptr) {
         mFastScroll->setEnabled(enabled);
@@ -1695,17 +1719,26 @@ View*AbsListView::obtainView(int position, bool*outMetadata) {
         transientView->dispatchFinishTemporaryDetach();
         return transientView;
     }
-    View* scrapView = mRecycler->getScrapView(position);
-    View* child = mAdapter->getView(position, scrapView, this);
-    if (scrapView != nullptr) {
-        if (child != scrapView) {
-            // Failed to re-bind the data, return scrap to the heap.
-            mRecycler->addScrapView(scrapView, position);
-        } else if (child->isTemporarilyDetached()) {
+    // A view bound by prefetchItems() is ready to use, otherwise bind one now.
+    View* child = mRecycler->getPrefetchedView(position);
+    if (child != nullptr) {
+        if (child->isTemporarilyDetached()) {
             outMetadata[0] = true;
-            // Finish the temporary detach started in addScrapView().
             child->dispatchFinishTemporaryDetach();
         }
+    } else {
+        View* scrapView = mRecycler->getScrapView(position);
+        child = mAdapter->getView(position, scrapView, this);
+        if (scrapView != nullptr) {
+            if (child != scrapView) {
+                // Failed to re-bind the data, return scrap to the heap.
+                mRecycler->addScrapView(scrapView, position);
+            } else if (child->isTemporarilyDetached()) {
+                outMetadata[0] = true;
+                // Finish the temporary detach started in addScrapView().
+                child->dispatchFinishTemporaryDetach();
+            }
+        }
     }
 
     if (mCacheColorHint != 0){
@@ -1728,6 +1761,77 @@ View*AbsListView::obtainView(int position, bool*outMetadata) {
     return child;
 }
 
+int AbsListView::getPrefetchItemCount(int distance) {
+    const int childCount = getChildCount();
+    const int extent = getChildAt(childCount - 1)->getBottom() - getChildAt(0)->getTop();
+    return distance * childCount / std::max(1, extent) + 1;
+}
+
+void AbsListView::schedulePrefetch(int delta) {
+    if (!mPrefetchEnabled || (delta == 0) || (mAdapter == nullptr)) {
+        return;
+    }
+    mPrefetchDelta = delta;
+    mPrefetchDrawingTime = getDrawingTime();
+    if (!mPrefetchPosted) {
+        mPrefetchPosted = true;
+        post(mPrefetchRunner);
+    }
+}
+
+/*Binds the items the next fling frames will scroll in,nearest first.Runs between two
+ *frames and stops before the average bind cost would push it past the next frame*/
+void AbsListView::prefetchItems() {
+    mPrefetchPosted = false;
+    const int childCount = getChildCount();
+    if (!mPrefetchEnabled || mDataChanged || (mAdapter == nullptr) || (childCount == 0) || (mPrefetchDelta == 0)) {
+        return;
+    }
+    if ((mPrefetchDrawingTime >= 0) && (getDrawingTime() == mPrefetchDrawingTime)) {
+        // The frame of the last fling step is not drawn yet, don't delay it.
+        mPrefetchDrawingTime = -1;
+        mPrefetchPosted = true;
+        post(mPrefetchRunner);
+        return;
+    }
+    const int64_t deadlineNs = getDrawingTime() * 1000000LL + Choreographer::getInstance().getFrameIntervalNanos();
+    const int count = std::min(childCount, getPrefetchItemCount(std::abs(mPrefetchDelta)));
+    // A negative delta moves the list up, the items below the last child come in.
+    int first, last;
+    if (mPrefetchDelta < 0) {
+        first = mFirstPosition + childCount;
+        last  = first + count - 1;
+    } else {
+        last  = mFirstPosition - 1;
+        first = last - count + 1;
+    }
+    first = std::max(first, getHeaderViewsCount());
+    last  = std::min(last, mItemCount - getFooterViewsCount() - 1);
+    mRecycler->scrapPrefetchedViews(first, last);
+
+    ATRACE_NAME("AbsListView::prefetchItems");
+    for (int i = 0; i <= last - first; i++) {
+        const int position = (mPrefetchDelta < 0) ? first + i : last - i;
+        if (mRecycler->hasPrefetchedView(position) || (mAdapter->getItemViewType(position) < 0)) {
+            continue;
+        }
+        const int64_t start = SystemClock::uptimeNanos();
+        if (start + mPrefetchBindNanos > deadlineNs) {
+            break;
+        }
+        View* scrapView = mRecycler->getScrapView(position);
+        View* child = mAdapter->getView(position, scrapView, this);
+        if ((scrapView != nullptr) && (child != scrapView)) {
+            mRecycler->addScrapView(scrapView, position);
+        }
+        setItemViewLayoutParams(child, position);
+        mRecycler->addPrefetchedView(child, position);
+        const int64_t cost = SystemClock::uptimeNanos() - start;
+        mPrefetchBindNanos = mPrefetchBindNanos ? (mPrefetchBindNanos * 3 + cost) / 4 : cost;
+    }
+    ATRACE_INT("prefetchedItems", int64_t(mRecycler->getPrefetchedViewCount()));
+}
+
 void AbsListView::draw(Canvas& canvas) {
     AdapterView::draw(canvas);
     if (shouldDisplayEdgeEffects()) {
@@ -2096,6 +2200,8 @@ void AbsListView::onDetachedFromWindow() {
     mPendingCheckForTap->removeCallbacks();
     mPendingCheckForKeyLongPress->removeCallbacks();
     mFlingRunnable->removeCallbacks();
+    removeCallbacks(mPrefetchRunner);
+    mPrefetchPosted = false;
     mIsDetaching = true;
 
     // Dismiss the popup in case onSaveInstanceState() was not invoked
@@ -4433,6 +4539,9 @@ void AbsListView::FlingRunnable::endFling() {
 
     mLV->clearScrollingCache();
     mScroller->abortAnimation();
+    // Whatever was prefetched and not scrolled in is plain scrap again.
+    mLV->mPrefetchDelta = 0;
+    mLV->mRecycler->scrapPrefetchedViews();
 
     /*if (mFlingStrictSpan != nullptr) {
         mFlingStrictSpan.finish();
@@ -4517,6 +4626,7 @@ void AbsListView::FlingRunnable::run() {
             if (atEdge) mLV->invalidate();
             mLastFlingY = y;
             postOnAnimation();//mLV->mFlingRunnable);
+            mLV->schedulePrefetch(delta);
         } else {
             endFling();
             if (PROFILE_FLINGING) {
@@ -165,6 +165,7 @@ private:
     Runnable mTouchModeReset;
     Runnable mClearScrollingCache;
     Runnable mPostScrollRunner;
+    Runnable mPrefetchRunner;
     PopupWindow*mPopup;
     class EditText* mTextFilter;
     OnScrollListener mOnScrollListener;
@@ -216,6 +217,8 @@ private:
     static bool isItemClickable(View* view);
     bool showContextMenuInternal(float x, float y, bool useOffsets);
     bool showContextMenuForChildInternal(View* originalView, float x, float y,bool useOffsets);
+    void schedulePrefetch(int delta);
+    void prefetchItems();
 protected:
     int mChoiceMode;
     int mCheckedItemCount;
@@ -253,6 +256,11 @@ protected:
     int mOverscrollMax;
     bool mIsScrap[2]; 
     bool mIsDetaching;
+    bool mPrefetchEnabled;
+    bool mPrefetchPosted;
+    int mPrefetchDelta;/*last fling step in pixels,its sign gives the direction*/
+    int64_t mPrefetchDrawingTime;
+    int64_t mPrefetchBindNanos;/*running average cost of one bind*/
     Rect mSelectorRect;
     Rect mListPadding;/*The view's padding*/
     int mWidthMeasureSpec;
@@ -303,6 +311,7 @@ protected:
     void handleDataChanged()override;
     static int getDistance(const Rect& source,const Rect& dest, int direction);
     virtual View* obtainView(int position, bool*outMetadata);
+    virtual int getPrefetchItemCount(int distance);
     void positionSelector(int position, View* sel);
     void hideSelector();
     void setVisibleRangeHint(int start,int end);
@@ -362,6 +371,9 @@ public:
     void setOnScrollListener(const OnScrollListener&);
     bool isScrollingCacheEnabled()const;
     void setScrollingCacheEnabled(bool enabled);
+    /*While flinging,items about to scroll in are bound in the idle time after each frame*/
+    bool isItemPrefetchEnabled()const;
+    void setItemPrefetchEnabled(bool enabled);
 
     std::string getAccessibilityClassName()const override;
     void onInitializeAccessibilityNodeInfoInternal(AccessibilityNodeInfo& info)override;
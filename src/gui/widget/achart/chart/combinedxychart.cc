@@ -264,6 +264,10 @@ void CombinedXYChart::setSelection(int seriesIndex,int pointIndex){
     }
 }
 
+bool CombinedXYChart::isDecimationSupported(int seriesIndex) const{
+    return mCharts[seriesIndex]->isDecimationSupported(0);
+}
+
 std::string CombinedXYChart::getChartType() const{
     return "Combined";
 }
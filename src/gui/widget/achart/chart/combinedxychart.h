@@ -34,6 +34,7 @@ private:
 protected:
     std::vector<ClickableArea> clickableAreasForPoints(const std::vector<float>& points,const std::vector<double>& values,
             float yAxisValue, int seriesIndex, int startIndex)override;
+    bool isDecimationSupported(int seriesIndex) const override;
 
     void drawSeries(const std::shared_ptr<XYSeries>& series, Canvas& canvas,  Paint& paint,std::vector<float>& pointsList,
             const std::shared_ptr<XYSeriesRenderer>& seriesRenderer, float yAxisValue, int seriesIndex, int orientation,int startIndex)override;
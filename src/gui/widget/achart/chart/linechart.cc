@@ -228,6 +228,10 @@ ScatterChart* LineChart::getPointsChart() const{
     return mPointsChart;
 }
 
+bool LineChart::isDecimationSupported(int seriesIndex) const{
+    return true;
+}
+
 std::string LineChart::getChartType() const{
     return "Line"/*TYPE*/;
 }
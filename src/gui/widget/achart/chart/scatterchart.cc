@@ -191,6 +191,10 @@ void ScatterChart::drawDiamond(Canvas& canvas,  Paint& paint, float x, float y)
     drawPath(canvas, path, paint, true);
 }
 
+bool ScatterChart::isDecimationSupported(int seriesIndex) const{
+    return true;
+}
+
 std::string ScatterChart::getChartType() const{
     return "Scatter"/*()TYPE*/;
 }
@@ -42,6 +42,7 @@ protected:
             const std::shared_ptr<XYMultipleSeriesRenderer>& renderer)override;
     std::vector<ClickableArea> clickableAreasForPoints(const std::vector<float>& points,const std::vector<double>& values,
             float yAxisValue, int seriesIndex, int startIndex) override;
+    bool isDecimationSupported(int seriesIndex) const override;
 public:
     ScatterChart();
     ScatterChart(const std::shared_ptr<XYMultipleSeriesDataset>& dataset,
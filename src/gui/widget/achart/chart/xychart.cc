@@ -207,7 +207,20 @@ void XYChart::draw(Canvas& canvas, int x, int y, int width, int height,  Paint&
         const float yAxisValue = std::min((float)bottom, (float) (bottom + yPixelsPerUnit[scale] * minY[scale]));
         std::vector<ClickableArea>& clickableArea = mClickableAreas[i];
 
-        auto range = series->getRange(minX[scale], maxX[scale], seriesRenderer->isDisplayBoundingPoints());
+        const Decimator::Mode decimation = isDecimationSupported(i) ? seriesRenderer->getDecimation() : Decimator::NONE;
+        std::vector<std::pair<double, double>> range;
+        series->getRange(minX[scale], maxX[scale], seriesRenderer->isDisplayBoundingPoints(), right - left, decimation, range);
+        auto addClickableAreas = [&](int startIndex) {
+            auto areas = clickableAreasForPoints(points, values, yAxisValue, i, startIndex);
+            if (decimation != Decimator::NONE) {
+                /*decimated points are not consecutive in the series,look each one up by its x*/
+                for (size_t k = 0; (k < areas.size()) && (k * 2 < values.size()); k++) {
+                    const ClickableArea area = areas[k];
+                    areas[k] = ClickableArea(area.getRect(), area.getX(), area.getY(), series->getIndexForKey(values[k * 2]));
+                }
+            }
+            clickableArea.insert(clickableArea.end(), areas.begin(), areas.end());
+        };
         int startIndex = -1;
         clickableArea.clear();
         if(i==mSeriesIndex){
@@ -232,8 +245,7 @@ void XYChart::draw(Canvas& canvas, int x, int y, int width, int height,  Paint&
             } else {
                 if (points.size() > 0) {
                     drawSeries(series, canvas, paint, points, seriesRenderer, yAxisValue, i, orientation, startIndex);
-                    auto  clickableAreasForSubSeries = clickableAreasForPoints(points, values, yAxisValue, i, startIndex);
-                    clickableArea.insert(clickableArea.end(),clickableAreasForSubSeries.begin(),clickableAreasForSubSeries.end());
+                    addClickableAreas(startIndex);
                     points.clear();
                     values.clear();
                     startIndex = -1;
@@ -261,8 +273,7 @@ void XYChart::draw(Canvas& canvas, int x, int y, int width, int height,  Paint&
 
         if (points.size() > 0) {
             drawSeries(series, canvas, paint, points, seriesRenderer, yAxisValue, i, orientation, startIndex);
-            auto clickableAreasForSubSeries = clickableAreasForPoints(points, values, yAxisValue, i, startIndex);
-            clickableArea.insert(clickableArea.end(),clickableAreasForSubSeries.begin(),clickableAreasForSubSeries.end());
+            addClickableAreas(startIndex);
         }
         if(i==mSeriesIndex){
             seriesRenderer->setLineWidth(seriesRenderer->getLineWidth()-2);
@@ -820,6 +831,10 @@ bool XYChart::isRenderNullValues() const{
     return false;
 }
 
+bool XYChart::isDecimationSupported(int seriesIndex) const{
+    return false;
+}
+
 bool XYChart::isRenderPoints(const std::shared_ptr<SimpleSeriesRenderer>& renderer) const{
     return false;
 }
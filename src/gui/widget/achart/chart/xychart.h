@@ -178,6 +178,14 @@ protected:
      * @return if null values should be rendered
      */
     virtual bool isRenderNullValues() const;
+
+    /**
+     * Returns if the series may be drawn from decimated points,charts indexing
+     * the series by the position of the points can't.
+     *
+     * @param seriesIndex the series index
+     */
+    virtual bool isDecimationSupported(int seriesIndex) const;
 public:
     XYChart(const std::shared_ptr<XYMultipleSeriesDataset>& dataset,const std::shared_ptr<XYMultipleSeriesRenderer>& renderer);
     void draw(Canvas& canvas, int x, int y, int width, int height, Paint& paint)override;
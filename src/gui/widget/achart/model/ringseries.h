@@ -0,0 +1,289 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __RING_SERIES_H__
+#define __RING_SERIES_H__
+#include <stdexcept>
+#include <algorithm>
+#include <widget/achart/model/xyseries.h>
+namespace cdroid{
+/**
+ * A fixed capacity XY series for live data.The points are kept in contiguous
+ * ring buffers,appending is O(1) and drops the oldest point once the series is
+ * full,ranges are found by binary search.X values must not decrease,samples older
+ * than the last one are ignored.
+ */
+class RingSeries :public XYSeries {
+private:
+    /*sequence numbers of a sliding window min or max,oldest first*/
+    class MonotonicQueue{
+    private:
+        std::vector<uint64_t> mSeqs;
+        size_t mHead = 0;
+        size_t mCount = 0;
+    public:
+        void reset(size_t capacity) {
+            mSeqs.assign(capacity, 0);
+            mHead = mCount = 0;
+        }
+        bool empty() const{
+            return mCount == 0;
+        }
+        uint64_t front() const{
+            return mSeqs[mHead];
+        }
+        uint64_t back() const{
+            return mSeqs[(mHead + mCount - 1) % mSeqs.size()];
+        }
+        void popFront() {
+            mHead = (mHead + 1) % mSeqs.size();
+            mCount--;
+        }
+        void popBack() {
+            mCount--;
+        }
+        void pushBack(uint64_t seq) {
+            mSeqs[(mHead + mCount) % mSeqs.size()] = seq;
+            mCount++;
+        }
+    };
+    std::vector<double> mX;
+    std::vector<double> mY;
+    /** The sequence number of the oldest point,point seq lives in slot seq%capacity. */
+    uint64_t mFirstSeq = 0;
+    size_t mCount = 0;
+    MonotonicQueue mMinQueue;
+    MonotonicQueue mMaxQueue;
+private:
+    size_t slot(size_t index) const{
+        return (mFirstSeq + index) % mX.size();
+    }
+    double yOf(uint64_t seq) const{
+        return mY[seq % mY.size()];
+    }
+    void pushY(uint64_t seq, double y) {
+        while (!mMinQueue.empty() && (yOf(mMinQueue.back()) >= y)) mMinQueue.popBack();
+        mMinQueue.pushBack(seq);
+        while (!mMaxQueue.empty() && (yOf(mMaxQueue.back()) <= y)) mMaxQueue.popBack();
+        mMaxQueue.pushBack(seq);
+    }
+    void evictOldest() {
+        if (!mMinQueue.empty() && (mMinQueue.front() == mFirstSeq)) mMinQueue.popFront();
+        if (!mMaxQueue.empty() && (mMaxQueue.front() == mFirstSeq)) mMaxQueue.popFront();
+        mFirstSeq++;
+        mCount--;
+    }
+    void checkIndex(int index) const{
+        if ((index < 0) || (size_t(index) >= mCount)) {
+            throw std::out_of_range("Index out of bounds");
+        }
+    }
+    size_t lowerBound(double x) const{
+        size_t lo = 0, hi = mCount;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (mX[slot(mid)] < x) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+public:
+    /**
+     * Builds a new ring series.
+     *
+     * @param title the series title
+     * @param capacity the maximum number of points
+     * @param scaleNumber the series scale number
+     */
+    RingSeries(const std::string& title, size_t capacity, int scaleNumber = 0)
+        :XYSeries(title, scaleNumber) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity must be greater than zero");
+        }
+        mX.resize(capacity);
+        mY.resize(capacity);
+        mMinQueue.reset(capacity);
+        mMaxQueue.reset(capacity);
+    }
+
+    /**
+     * Returns the maximum number of points.
+     */
+    size_t getCapacity() const{
+        return mX.size();
+    }
+
+    /**
+     * Appends a new value,dropping the oldest one when the series is full.
+     *
+     * @param x the value for the X axis,not less than the last one
+     * @param y the value for the Y axis
+     */
+    void add(double x, double y) override{
+        if ((mCount > 0) && (x < mX[slot(mCount - 1)])) {
+            return;
+        }
+        if (mCount == mX.size()) {
+            evictOldest();
+        }
+        const uint64_t seq = mFirstSeq + mCount;
+        mX[seq % mX.size()] = x;
+        mY[seq % mY.size()] = y;
+        mCount++;
+        pushY(seq, y);
+    }
+
+    /**
+     * Points are ordered by x,the index is ignored.
+     */
+    void add(int index, double x, double y) override{
+        add(x, y);
+    }
+
+    void remove(int index) override{
+        checkIndex(index);
+        if (index == 0) {
+            evictOldest();
+            return;
+        }
+        for (size_t i = index; i + 1 < mCount; i++) {
+            mX[slot(i)] = mX[slot(i + 1)];
+            mY[slot(i)] = mY[slot(i + 1)];
+        }
+        mCount--;
+        mMinQueue.reset(mX.size());
+        mMaxQueue.reset(mX.size());
+        for (size_t i = 0; i < mCount; i++) {
+            pushY(mFirstSeq + i, mY[slot(i)]);
+        }
+    }
+
+    void clear() override{
+        mFirstSeq = 0;
+        mCount = 0;
+        mMinQueue.reset(mX.size());
+        mMaxQueue.reset(mX.size());
+        XYSeries::clear();
+    }
+
+    double getX(int index) const override{
+        checkIndex(index);
+        return mX[slot(index)];
+    }
+
+    double getY(int index) const override{
+        checkIndex(index);
+        return mY[slot(index)];
+    }
+
+    int getItemCount() const override{
+        return int(mCount);
+    }
+
+    int getIndexForKey(double key) const override{
+        const size_t index = lowerBound(key);
+        if ((index < mCount) && (mX[slot(index)] == key)) {
+            return int(index);
+        }
+        return -(int(index) + 1);
+    }
+
+    std::map<double, double> getRange(double start, double stop, bool beforeAfterPoints) const override{
+        size_t first = lowerBound(start);
+        size_t last = lowerBound(stop);
+        if (beforeAfterPoints) {
+            if (first > 0) first--;
+            if (last < mCount) last++;
+        }
+        std::map<double, double> range;
+        for (size_t i = first; i < last; i++) {
+            range.insert(range.end(), {mX[slot(i)], mY[slot(i)]});
+        }
+        return range;
+    }
+
+    /**
+     * Reduces the window in one pass over its points,the first,min,max and last
+     * point of each pixel column are kept(then thinned by LTTB if asked).
+     */
+    void getRange(double start, double stop, bool beforeAfterPoints, int columns,
+            Decimator::Mode mode, std::vector<std::pair<double, double>>& out) const override{
+        size_t first = lowerBound(start);
+        size_t last = lowerBound(stop);
+        if (beforeAfterPoints) {
+            if (first > 0) first--;
+            if (last < mCount) last++;
+        }
+        const size_t perColumn = (mode == Decimator::LTTB) ? 2 : 4;
+        if ((mode == Decimator::NONE) || (columns <= 0) || (stop <= start) || (last - first <= size_t(columns) * perColumn)) {
+            out.reserve(out.size() + (last - first));
+            for (size_t i = first; i < last; i++) {
+                out.emplace_back(mX[slot(i)], mY[slot(i)]);
+            }
+            return;
+        }
+        std::vector<std::pair<double, double>> reduced;
+        std::vector<std::pair<double, double>>& dst = (mode == Decimator::LTTB) ? reduced : out;
+        const double step = (stop - start) / columns;
+        size_t colFirst = first, colMin = first, colMax = first;
+        int column = -1;
+        auto flush = [&](size_t colLast) {
+            if (colLast <= colFirst) return;
+            size_t indices[4] = {colFirst, std::min(colMin, colMax), std::max(colMin, colMax), colLast - 1};
+            for (int k = 0; k < 4; k++) {
+                if ((k == 0) || (indices[k] != indices[k - 1]))
+                    dst.emplace_back(mX[slot(indices[k])], mY[slot(indices[k])]);
+            }
+        };
+        for (size_t i = first; i < last; i++) {
+            const double x = mX[slot(i)];
+            const double y = mY[slot(i)];
+            /*bounding points outside the window are columns of their own*/
+            const int c = (x < start) ? -2 : ((x >= stop) ? columns : std::min(int((x - start) / step), columns - 1));
+            if ((c != column) || (c < 0) || (c == columns)) {
+                flush(i);
+                column = c;
+                colFirst = colMin = colMax = i;
+            } else {
+                if (y < mY[slot(colMin)]) colMin = i;
+                if (y > mY[slot(colMax)]) colMax = i;
+            }
+        }
+        flush(last);
+        if (mode == Decimator::LTTB) {
+            Decimator::lttb(reduced, size_t(columns) * 2, out);
+        }
+    }
+
+    double getMinX() const override{
+        return mCount ? mX[slot(0)] : MathHelper::NULL_VALUE;
+    }
+
+    double getMaxX() const override{
+        return mCount ? mX[slot(mCount - 1)] : -MathHelper::NULL_VALUE;
+    }
+
+    double getMinY() const override{
+        return mCount ? yOf(mMinQueue.front()) : MathHelper::NULL_VALUE;
+    }
+
+    double getMaxY() const override{
+        return mCount ? yOf(mMaxQueue.front()) : -MathHelper::NULL_VALUE;
+    }
+};
+}/*endof namespace*/
+#endif/*__RING_SERIES_H__*/
@@ -1,7 +1,9 @@
 #ifndef __XY_SERRIES_H__
 #define __XY_SERRIES_H__
+#include <memory>
 #include <widget/achart/util/mathhelper.h>
 #include <widget/achart/util/indexxymap.h>
+#include <widget/achart/util/decimator.h>
 namespace cdroid{
 class XYSeries{
 private:
@@ -25,6 +27,8 @@ private:
     std::vector<std::string> mAnnotations;
     /** A map contain a (x,y) value for each String annotation. */
     IndexXYMap<double, double> mStringXY;
+    /** The points sorted by x with their min/max summary,built on the first ranged draw. */
+    mutable std::shared_ptr<Decimator> mDecimator;
 private:
     void initRange() {
         mMinX = MathHelper::NULL_VALUE;
@@ -44,6 +48,25 @@ private:
         mMinY = std::min(mMinY, y);
         mMaxY = std::max(mMaxY, y);
     }
+    void updateDecimator(double x, double y) {
+        if (mDecimator == nullptr) {
+            return;
+        }
+        // appended samples (live traces) extend the summary,anything else rebuilds it
+        const size_t count = mDecimator->size();
+        if ((mDecimator.use_count() == 1) && ((count == 0) || (x > mDecimator->getX(count - 1)))) {
+            mDecimator->append(x, y);
+        } else {
+            mDecimator.reset();
+        }
+    }
+    const Decimator& getDecimator() const{
+        if (mDecimator == nullptr) {
+            mDecimator = std::make_shared<Decimator>();
+            mDecimator->build(mXY);
+        }
+        return *mDecimator;
+    }
 protected:
     double getPadding() const{
         return PADDING;
@@ -105,6 +128,7 @@ public:
         }
         mXY.put(x, y);
         updateRange(x, y);
+        updateDecimator(x, y);
     }
 
     /**
@@ -114,7 +138,7 @@ public:
      * @param x the value for the X axis
      * @param y the value for the Y axis
      */
-    void add(int index, double x, double y) {
+    virtual void add(int index, double x, double y) {
         while (mXY.find(x) != mXY.end()) {
             // add a very small value to x such as data points sharing the same x will
             // still be added
@@ -122,6 +146,7 @@ public:
         }
         mXY.put(index,x , y);
         updateRange(x, y);
+        updateDecimator(x, y);
     }
 
     /**
@@ -129,8 +154,9 @@ public:
      *
      * @param index the index in the series of the value to remove
      */
-    void remove(int index) {
+    virtual void remove(int index) {
         XYEntry<double, double> removedEntry = mXY.removeByIndex(index);
+        mDecimator.reset();
         double removedX = removedEntry.getKey();
         double removedY = removedEntry.getValue();
         if (removedX == mMinX || removedX == mMaxX || removedY == mMinY || removedY == mMaxY) {
@@ -141,9 +167,10 @@ public:
     /**
      * Removes all the existing values from the series.
      */
-    void clear() {
+    virtual void clear() {
         mXY.clear();
         mStringXY.clear();
+        mDecimator.reset();
         initRange();
     }
 
@@ -153,7 +180,7 @@ public:
      * @param index the index
      * @return the X value
      */
-    double getX(int index) const{
+    virtual double getX(int index) const{
         return mXY.getXByIndex(index);
     }
 
@@ -163,7 +190,7 @@ public:
      * @param index the index
      * @return the Y value
      */
-    double getY(int index) const{
+    virtual double getY(int index) const{
         return mXY.getYByIndex(index);
     }
 
@@ -237,7 +264,7 @@ public:
      *          visible ones must be displayed
      * @return a submap of x and y values
      */
-    std::map<double, double> getRange(double start, double stop,bool beforeAfterPoints) const{
+    virtual std::map<double, double> getRange(double start, double stop,bool beforeAfterPoints) const{
         double actualStart = start;
         double actualStop = stop;
         if (beforeAfterPoints) {
@@ -258,7 +285,42 @@ public:
         return std::map<double, double>(first, last);
     }
 
-    int getIndexForKey(double key) const{
+    /**
+     * Appends the x and y values between the given start and end to out,
+     * reduced to a few points per pixel column when there are more of them.
+     *
+     * @param start start x value
+     * @param stop stop x value
+     * @param beforeAfterPoints if the points before and after the first and last
+     *          visible ones must be displayed
+     * @param columns the number of pixel columns between start and stop
+     * @param mode the decimation of the visible points
+     * @param out the x and y values
+     */
+    virtual void getRange(double start, double stop, bool beforeAfterPoints, int columns,
+            Decimator::Mode mode, std::vector<std::pair<double, double>>& out) const{
+        if (mode == Decimator::NONE) {
+            /*no sorted copy is needed to hand out every visible point*/
+            auto first = mXY.lower_bound(start);
+            auto last = mXY.lower_bound(stop);
+            if (beforeAfterPoints) {
+                if (first != mXY.begin()) --first;
+                if (last != mXY.end()) ++last;
+            }
+            out.insert(out.end(), first, last);
+            return;
+        }
+        const Decimator& decimator = getDecimator();
+        size_t first = decimator.lowerBound(start);
+        size_t last = decimator.lowerBound(stop);
+        if (beforeAfterPoints) {
+            if (first > 0) first--;
+            if (last < decimator.size()) last++;
+        }
+        decimator.decimate(first, last, start, stop, columns, mode, out);
+    }
+
+    virtual int getIndexForKey(double key) const{
         return mXY.getIndexForKey(key);
     }
 
@@ -267,7 +329,7 @@ public:
      *
      * @return the series item count
      */
-    int getItemCount() const{
+    virtual int getItemCount() const{
         return mXY.size();
     }
 
@@ -276,7 +338,7 @@ public:
      *
      * @return the X axis minimum value
      */
-    double getMinX() const{
+    virtual double getMinX() const{
         return mMinX;
     }
 
@@ -285,7 +347,7 @@ public:
      *
      * @return the Y axis minimum value
      */
-    double getMinY() const{
+    virtual double getMinY() const{
         return mMinY;
     }
 
@@ -294,7 +356,7 @@ public:
      *
      * @return the X axis maximum value
      */
-    double getMaxX() const{
+    virtual double getMaxX() const{
         return mMaxX;
     }
 
@@ -303,7 +365,7 @@ public:
      *
      * @return the Y axis maximum value
      */
-    double getMaxY() const{
+    virtual double getMaxY() const{
         return mMaxY;
     }
 };
@@ -80,7 +80,7 @@ public:
      *
      * @param index the index in the series of the value to remove
      */
-    void remove(int index) {
+    void remove(int index) override{
         XYSeries::remove(index);
         double removedValue = mValue[index];
         mValue.erase(mValue.begin()+index);
@@ -92,7 +92,7 @@ public:
     /**
      * Removes all the values from the series.
      */
-    void clear() {
+    void clear() override{
         XYSeries::clear();
         mValue.clear();
         initRange();
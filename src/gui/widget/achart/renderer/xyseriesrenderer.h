@@ -19,6 +19,7 @@
 #define __XYSERIES_RENDERER_H__
 #include <widget/achart/chart/pointstyle.h>
 #include <widget/achart/renderer/simpleseriesrenderer.h>
+#include <widget/achart/util/decimator.h>
 namespace cdroid{
 /**
  * A renderer for the XY type series.
@@ -78,6 +79,8 @@ private:
     float mPointStrokeWidth = 1;
     /** The chart line width. */
     float mLineWidth = 1;
+    /** The decimation of the visible points. */
+    Decimator::Mode mDecimation = Decimator::NONE;
 public:
     /**
      * Returns if the chart should be filled below the line.
@@ -232,6 +235,26 @@ public:
     void setLineWidth(float lineWidth) {
         mLineWidth = lineWidth;
     }
+
+    /**
+     * Returns the decimation applied when there are more visible points than pixels.
+     *
+     * @return the decimation mode
+     */
+    Decimator::Mode getDecimation() const{
+        return mDecimation;
+    }
+
+    /**
+     * Sets the decimation applied when there are more visible points than pixels.
+     * Only line and scatter charts decimate,charts that index their points
+     * (bar,bubble...) always draw every point.
+     *
+     * @param mode the decimation mode
+     */
+    void setDecimation(Decimator::Mode mode) {
+        mDecimation = mode;
+    }
 };
 }/*endof namespace*/
 #endif/*__XYSERIES_RENDERER_H__*/
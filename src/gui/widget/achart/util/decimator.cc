@@ -0,0 +1,217 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <cmath>
+#include <algorithm>
+#include <widget/achart/util/decimator.h>
+
+namespace cdroid{
+
+void Decimator::build(const std::map<double,double>&xy){
+    mX.clear();
+    mY.clear();
+    mMinIndex.clear();
+    mMaxIndex.clear();
+    mX.reserve(xy.size());
+    mY.reserve(xy.size());
+    for(auto&p:xy){
+        mX.push_back(p.first);
+        mY.push_back(p.second);
+    }
+    while(blockSize(mMinIndex.size()) <= mX.size())
+        addLevel();
+}
+
+void Decimator::addLevel(){
+    const size_t level = mMinIndex.size();
+    const size_t fanout = size_t(1)<<FANOUT_SHIFT;
+    /*the last block may be partial,append() completes it*/
+    const size_t blocks = (mX.size() + blockSize(level) - 1)/blockSize(level);
+    std::vector<uint32_t>mins(blocks),maxs(blocks);
+    for(size_t b = 0;b < blocks;b++){
+        size_t imin,imax;
+        if(level == 0){
+            imin = imax = b*fanout;
+            for(size_t i = imin+1,end = std::min(imin+fanout,mX.size());i < end;i++){
+                if(mY[i] < mY[imin])imin = i;
+                if(mY[i] > mY[imax])imax = i;
+            }
+        }else{
+            const std::vector<uint32_t>&childMins = mMinIndex[level-1];
+            const std::vector<uint32_t>&childMaxs = mMaxIndex[level-1];
+            imin = childMins[b*fanout];
+            imax = childMaxs[b*fanout];
+            for(size_t c = b*fanout+1,end = std::min(b*fanout+fanout,childMins.size());c < end;c++){
+                if(mY[childMins[c]] < mY[imin])imin = childMins[c];
+                if(mY[childMaxs[c]] > mY[imax])imax = childMaxs[c];
+            }
+        }
+        mins[b] = uint32_t(imin);
+        maxs[b] = uint32_t(imax);
+    }
+    mMinIndex.push_back(std::move(mins));
+    mMaxIndex.push_back(std::move(maxs));
+}
+
+void Decimator::append(double x,double y){
+    const size_t index = mX.size();
+    mX.push_back(x);
+    mY.push_back(y);
+    for(size_t level = 0;level < mMinIndex.size();level++){
+        std::vector<uint32_t>&mins = mMinIndex[level];
+        std::vector<uint32_t>&maxs = mMaxIndex[level];
+        const size_t block = index/blockSize(level);
+        if(block == mins.size()){
+            mins.push_back(uint32_t(index));
+            maxs.push_back(uint32_t(index));
+        }else{
+            if(y < mY[mins[block]])mins[block] = uint32_t(index);
+            if(y > mY[maxs[block]])maxs[block] = uint32_t(index);
+        }
+    }
+    while(blockSize(mMinIndex.size()) <= mX.size())
+        addLevel();
+}
+
+size_t Decimator::size()const{
+    return mX.size();
+}
+
+double Decimator::getX(size_t index)const{
+    return mX[index];
+}
+
+double Decimator::getY(size_t index)const{
+    return mY[index];
+}
+
+size_t Decimator::lowerBound(double x)const{
+    return std::lower_bound(mX.begin(),mX.end(),x) - mX.begin();
+}
+
+void Decimator::minMax(size_t first,size_t last,size_t&imin,size_t&imax)const{
+    imin = imax = first;
+    size_t i = first;
+    while(i < last){
+        /*the largest complete block starting at i and ending before last*/
+        size_t level = 0;
+        while((level < mMinIndex.size()) && ((i & (blockSize(level)-1)) == 0)
+                && (i + blockSize(level) <= last)){
+            level++;
+        }
+        size_t bmin = i,bmax = i;
+        if(level == 0){
+            i++;
+        }else{
+            level--;
+            const size_t block = i/blockSize(level);
+            bmin = mMinIndex[level][block];
+            bmax = mMaxIndex[level][block];
+            i += blockSize(level);
+        }
+        if(mY[bmin] < mY[imin])imin = bmin;
+        if(mY[bmax] > mY[imax])imax = bmax;
+    }
+}
+
+void Decimator::addColumn(size_t first,size_t last,std::vector<std::pair<double,double>>&out)const{
+    if(last - first <= 4){
+        for(size_t i = first;i < last;i++)
+            out.emplace_back(mX[i],mY[i]);
+        return;
+    }
+    size_t imin,imax;
+    minMax(first,last,imin,imax);
+    size_t indices[4] = {first,std::min(imin,imax),std::max(imin,imax),last-1};
+    for(int i = 0;i < 4;i++){
+        if((i == 0) || (indices[i] != indices[i-1]))
+            out.emplace_back(mX[indices[i]],mY[indices[i]]);
+    }
+}
+
+void Decimator::decimate(size_t first,size_t last,double minX,double maxX,int columns,Mode mode,
+        std::vector<std::pair<double,double>>&out)const{
+    last = std::min(last,mX.size());
+    if(first >= last)return;
+    const size_t perColumn = (mode == LTTB) ? 2 : 4;
+    if((mode == NONE) || (columns <= 0) || (maxX <= minX) || (last - first <= size_t(columns)*perColumn)){
+        for(size_t i = first;i < last;i++)
+            out.emplace_back(mX[i],mY[i]);
+        return;
+    }
+    std::vector<std::pair<double,double>>reduced;
+    std::vector<std::pair<double,double>>&dst = (mode == LTTB) ? reduced : out;
+    dst.reserve(dst.size() + size_t(columns)*4 + 2);
+    /*bounding points outside the window are kept as they are*/
+    size_t start = first;
+    for(;(start < last) && (mX[start] < minX);start++)
+        dst.emplace_back(mX[start],mY[start]);
+    const double step = (maxX - minX)/columns;
+    for(int c = 0;(c < columns) && (start < last);c++){
+        const double edge = (c == columns-1) ? maxX : minX + step*(c+1);
+        const size_t end = std::lower_bound(mX.begin()+start,mX.begin()+last,edge) - mX.begin();
+        addColumn(start,end,dst);
+        start = end;
+    }
+    for(;start < last;start++)
+        dst.emplace_back(mX[start],mY[start]);
+    if(mode == LTTB)
+        lttb(reduced,size_t(columns)*2,out);
+}
+
+void Decimator::lttb(const std::vector<std::pair<double,double>>&in,size_t threshold,std::vector<std::pair<double,double>>&out){
+    const size_t count = in.size();
+    if((threshold >= count) || (threshold < 3)){
+        out.insert(out.end(),in.begin(),in.end());
+        return;
+    }
+    const double every = double(count - 2)/(threshold - 2);
+    size_t a = 0;
+    out.push_back(in[0]);
+    for(size_t i = 0;i < threshold - 2;i++){
+        /*the average of the next bucket is the third vertex of the triangles*/
+        const size_t avgStart = size_t((i + 1)*every) + 1;
+        const size_t avgEnd = std::min(size_t((i + 2)*every) + 1,count);
+        double avgX = 0,avgY = 0;
+        for(size_t j = avgStart;j < avgEnd;j++){
+            avgX += in[j].first;
+            avgY += in[j].second;
+        }
+        if(avgEnd > avgStart){
+            avgX /= (avgEnd - avgStart);
+            avgY /= (avgEnd - avgStart);
+        }
+        const size_t rangeStart = size_t(i*every) + 1;
+        const size_t rangeEnd = size_t((i + 1)*every) + 1;
+        const double ax = in[a].first;
+        const double ay = in[a].second;
+        double maxArea = -1.0;
+        size_t next = rangeStart;
+        for(size_t j = rangeStart;j < rangeEnd;j++){
+            const double area = std::fabs((ax - avgX)*(in[j].second - ay) - (ax - in[j].first)*(avgY - ay));
+            if(area > maxArea){
+                maxArea = area;
+                next = j;
+            }
+        }
+        out.push_back(in[next]);
+        a = next;
+    }
+    out.push_back(in[count-1]);
+}
+
+}/*endof namespace*/
@@ -0,0 +1,68 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __ACHART_DECIMATOR_H__
+#define __ACHART_DECIMATOR_H__
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+namespace cdroid{
+
+/*A copy of a series sorted by x with a multi resolution min/max summary.
+ *decimate() reduces a visible window to a few points per pixel column in
+ *O(columns*log(points)),so drawing a million samples costs about as much as a thousand*/
+class Decimator{
+public:
+    enum Mode{
+        NONE,    /*every visible point*/
+        MIN_MAX, /*first,min,max and last point of each pixel column*/
+        LTTB     /*largest triangle three buckets over the min/max points,2 per column*/
+    };
+private:
+    static constexpr int FANOUT_SHIFT = 3;
+    std::vector<double>mX;
+    std::vector<double>mY;
+    /*level L keeps the index of the min/max y of each block of 8^(L+1) points*/
+    std::vector<std::vector<uint32_t>>mMinIndex;
+    std::vector<std::vector<uint32_t>>mMaxIndex;
+    static size_t blockSize(size_t level){
+        return size_t(1)<<((level+1)*FANOUT_SHIFT);
+    }
+    void addLevel();
+    void minMax(size_t first,size_t last,size_t&imin,size_t&imax)const;
+    void addColumn(size_t first,size_t last,std::vector<std::pair<double,double>>&out)const;
+public:
+    /*appends threshold points of in picked by largest triangle three buckets to out*/
+    static void lttb(const std::vector<std::pair<double,double>>&in,size_t threshold,std::vector<std::pair<double,double>>&out);
+    void build(const std::map<double,double>&xy);
+    /*x must be greater than the last x*/
+    void append(double x,double y);
+    size_t size()const;
+    double getX(size_t index)const;
+    double getY(size_t index)const;
+    /*index of the first point whose x is not less than x*/
+    size_t lowerBound(double x)const;
+    /*appends the points [first,last) to out.When there are more of them than a few per column,
+     *the ones between minX and maxX are reduced to columns pixel columns*/
+    void decimate(size_t first,size_t last,double minX,double maxX,int columns,Mode mode,
+            std::vector<std::pair<double,double>>&out)const;
+};
+
+}/*endof namespace*/
+#endif/*__ACHART_DECIMATOR_H__*/
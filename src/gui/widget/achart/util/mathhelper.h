@@ -15,6 +15,7 @@
  */
 #ifndef __MATH_HELPER_H__
 #define __MATH_HELPER_H__
+#include <cmath>
 #include <cfloat>
 #include <string>
 #include <vector>
@@ -57,6 +57,7 @@ Window::Window(int x,int y,int width,int height,int type)
 
 void Window::initWindow(){
     mInLayout= false;
+    mSurfaceFormat = -1;
     mAccessibilityManager =&AccessibilityManager::getInstance(mContext);
     mSendWindowContentChangedAccessibilityEvent = nullptr;
     mPendingRgn = Cairo::Region::create();
@@ -388,7 +389,9 @@ void Window::draw(){
     mAttachInfo->mDrawingTime = SystemClock::uptimeMillis();
 
     mAttachInfo->mTreeObserver->dispatchOnPreDraw();
+    mAttachInfo->mOverdrawRects.clear();
     FrameLayout::draw(*canvas);
+    if(mAttachInfo->mDebugOverdraw) drawOverdraw(*canvas);
     drawAccessibilityFocusedDrawableIfNeeded(*canvas);
     mAttachInfo->mTreeObserver->dispatchOnDraw();
 
@@ -414,6 +417,7 @@ void Window::setPos(int x,int y){
         mAttachInfo->mWindowTop = y;
     }
     GraphDevice::getInstance().flip();
+    scheduleTraversals();
 }
 
 View& Window::setAlpha(float alpha){
@@ -432,6 +436,7 @@ void Window::onSizeChanged(int w,int h,int oldw,int oldh){
 void Window::onVisibilityChanged(View& changedView,int visibility){
     //GraphDevice::getInstance().invalidate(getBound());
     GraphDevice::getInstance().flip();
+    scheduleTraversals();
 }
 
 ViewGroup*Window::invalidateChildInParent(int* location,Rect& dirty){
@@ -445,6 +450,21 @@ void Window::onFinishInflate(){
     startLayoutAnimation();
 }
 
+void Window::setSurfaceFormat(int format){
+    if(mSurfaceFormat == format)
+        return;
+    mSurfaceFormat = format;
+    if(mAttachInfo && mAttachInfo->mCanvas){
+        /*surface will be recreated with the new format at next draw*/
+        mAttachInfo->mCanvas = nullptr;
+        invalidate();
+    }
+}
+
+int Window::getSurfaceFormat()const{
+    return mSurfaceFormat;
+}
+
 RefPtr<Canvas>Window::getCanvas(){
     RefPtr<Canvas> canvas;
     //for children's canvas is allcated by it slef and delete by drawing thread(UIEventSource)
@@ -457,7 +477,10 @@ RefPtr<Canvas>Window::getCanvas(){
         const int canvasWidth = swapeWH?getHeight():getWidth();
         const int canvasHeight= swapeWH?getWidth():getHeight();
 
-        canvas = make_refptr_for_instance<Canvas>(new Canvas(canvasWidth,canvasHeight));
+        int format = mSurfaceFormat;
+        if(format < 0)
+            format = isOpaque() ? GraphDevice::getInstance().getOpaqueFormat() : GPF_ARGB;
+        canvas = make_refptr_for_instance<Canvas>(new Canvas(canvasWidth,canvasHeight,format));
         mAttachInfo->mCanvas = canvas;
         Cairo::Matrix matrix = Cairo::identity_matrix();
         Cairo::FontOptions options;
@@ -841,6 +864,56 @@ void Window::drawAccessibilityFocusedDrawableIfNeeded(Canvas& canvas){
     }    
 }
 
+/*Counts the backgrounds filled into each pixel this frame and tints the pixels drawn
+ *more than once,blue/green/pink/red for 1,2,3,4+ times of overdraw as android does.
+ *Content other than backgrounds(text,images) is not counted*/
+void Window::drawOverdraw(Canvas& canvas){
+    static const uint32_t colors[] = {0,0,0x2f0000ff,0x2f00ff00,0x3fff0000,0x7fff0000};
+    auto image = std::dynamic_pointer_cast<Cairo::ImageSurface>(canvas.get_target());
+    std::vector<Rect>& rects = mAttachInfo->mOverdrawRects;
+    if((image == nullptr) || rects.empty()){
+        rects.clear();
+        return;
+    }
+    const int width = image->get_width();
+    const int height= image->get_height();
+    std::vector<uint8_t>& counts = mOverdrawCounts;
+    counts.assign(size_t(width)*height,0);
+    for(Rect r:rects){
+        if(!r.intersect(0,0,width,height))continue;
+        for(int y = r.top; y < r.bottom(); y++){
+            uint8_t* row = counts.data() + y*width;
+            for(int x = r.left; x < r.right(); x++){
+                if(row[x] < 255) row[x]++;
+            }
+        }
+    }
+    rects.clear();
+    if((mOverdrawOverlay == nullptr) || (mOverdrawOverlay->get_width() != width) || (mOverdrawOverlay->get_height() != height)){
+        mOverdrawOverlay = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32,width,height);
+    }
+    RefPtr<Cairo::ImageSurface>& overlay = mOverdrawOverlay;
+    overlay->flush();
+    uint8_t* data = overlay->get_data();
+    const int stride = overlay->get_stride();
+    for(int y = 0; y < height; y++){
+        uint32_t* pixels = (uint32_t*)(data + y*stride);
+        const uint8_t* row = counts.data() + y*width;
+        for(int x = 0; x < width; x++){
+            const uint32_t c = colors[std::min<int>(row[x],5)];
+            const uint32_t a = c >> 24;/*cairo wants premultiplied pixels*/
+            pixels[x] = (a << 24) | ((((c >> 16) & 0xFF)*a/255) << 16)
+                    | ((((c >> 8) & 0xFF)*a/255) << 8) | ((c & 0xFF)*a/255);
+        }
+    }
+    overlay->mark_dirty();
+    canvas.save();
+    canvas.set_identity_matrix();
+    canvas.set_source(overlay,0,0);
+    canvas.paint();
+    canvas.restore();
+}
+
 bool Window::getAccessibilityFocusedRect(Rect& bounds){
     AccessibilityManager& manager = AccessibilityManager::getInstance(mContext);
     if (!manager.isEnabled() || !manager.isTouchExplorationEnabled()) {
@@ -40,6 +40,8 @@ private:
     AccessibilityManager*mAccessibilityManager;
     SendWindowContentChangedAccessibilityEvent* mSendWindowContentChangedAccessibilityEvent;
     std::vector<LayoutTransition*> mPendingTransitions;
+    std::vector<uint8_t> mOverdrawCounts;/*fill count per pixel,reused by drawOverdraw*/
+    Cairo::RefPtr<Cairo::ImageSurface> mOverdrawOverlay;
 private:
     void doLayout();
     bool performFocusNavigation(KeyEvent& event);
@@ -54,6 +56,7 @@ private:
     void postSendWindowContentChangedCallback(View*source,int changeType);
     void removeSendWindowContentChangedCallback();
     void drawAccessibilityFocusedDrawableIfNeeded(Canvas& canvas);
+    void drawOverdraw(Canvas& canvas);
     bool getAccessibilityFocusedRect(Rect& bounds);
     Drawable* getAccessibilityFocusedDrawable();
     void handleWindowContentChangedEvent(AccessibilityEvent& event);
@@ -65,6 +68,7 @@ protected:
     Cairo::RefPtr<Cairo::Region>mPendingRgn;
     int window_type;/*window type*/
     int mLayer;/*surface layer*/
+    int mSurfaceFormat;/*GFXPIXELFORMAT of window surface,<0 for auto*/
     std::string mText;
     InvalidateOnAnimationRunnable mInvalidateOnAnimationRunnable;
 #if USE_UIEVENTHANDLER	
@@ -100,6 +104,9 @@ public:
     virtual void setText(const std::string&);
     const std::string getText()const;
     void setPos(int x,int y);
+    /*GPF_ARGB/GPF_RGB565...,-1(default) use GraphDevice::getOpaqueFormat() for opaque windows*/
+    void setSurfaceFormat(int format);
+    int getSurfaceFormat()const;
     bool ensureTouchMode(bool inTouchMode)override;
     View& setAlpha(float a);
     void sendToBack();
@@ -610,10 +610,6 @@ bool GridLayout::canStretch(int flexibility) {
 void GridLayout::onMeasure(int widthSpec, int heightSpec){
     consistencyCheck();
 
-    /** If we have been called by {@link View#measure(int, int)}, one of width or height
-     *  is  likely to have changed. We must invalidate if so. */
-    invalidateValues();
-
     const int hPadding = getPaddingLeft() + getPaddingRight();
     const int vPadding = getPaddingTop()  + getPaddingBottom();
 
@@ -625,14 +621,20 @@ void GridLayout::onMeasure(int widthSpec, int heightSpec){
     int widthSansPadding;
     int heightSansPadding;
 
+    /* An axis keeps its solution while the children it was computed from are measured
+     * the same,so a request deep inside the grid that doesn't resize any cell re-solves nothing*/
     // Use the orientation property to decide which axis should be laid out first.
     if (mOrientation == HORIZONTAL) {
+        mHorizontalAxis->invalidateValuesIfChanged();
         widthSansPadding = mHorizontalAxis->getMeasure(widthSpecSansPadding);
         measureChildrenWithMargins(widthSpecSansPadding, heightSpecSansPadding, false);
+        mVerticalAxis->invalidateValuesIfChanged();
         heightSansPadding = mVerticalAxis->getMeasure(heightSpecSansPadding);
     } else {
+        mVerticalAxis->invalidateValuesIfChanged();
         heightSansPadding = mVerticalAxis->getMeasure(heightSpecSansPadding);
         measureChildrenWithMargins(widthSpecSansPadding, heightSpecSansPadding, false);
+        mHorizontalAxis->invalidateValuesIfChanged();
         widthSansPadding = mHorizontalAxis->getMeasure(widthSpecSansPadding);
     }
 
@@ -656,8 +658,8 @@ int GridLayout::getMeasurementIncludingMargin(View* c, bool horizontal) {
 }
 
 void GridLayout::requestLayout() {
+    /*values are invalidated by onMeasure once the children are measured differently*/
     ViewGroup::requestLayout();
-    invalidateValues();
 }
 
 void GridLayout::onLayout(bool changed, int left, int top, int w, int h){
@@ -1146,14 +1148,16 @@ int  GridLayout::Axis::size(const std::vector<int>&locations){
 }
 
 void GridLayout::Axis::setParentConstraints(int min, int max) {
-    parentMin = min;
-    parentMax = -max;
-    mLocationsValid = false;
+    if ((parentMin.value != min) || (parentMax.value != -max)) {
+        parentMin = min;
+        parentMax = -max;
+        mLocationsValid = false;
+    }
 }
 
 int GridLayout::Axis::getMeasure(int min,int max){
-    setParentConstraints(min,max);
-    parentMax = max;
+    /*same (min,-max) encoding as layout,so a measure/layout pass with equal bounds keeps the solved locations*/
+    setParentConstraints(min, max);
     const std::vector<int>& ls = getLocations();
     return size(ls);
 }
@@ -1214,6 +1218,31 @@ void GridLayout::Axis::invalidateValues(){
     mLocationsValid = false;
 }
 
+bool GridLayout::Axis::invalidateValuesIfChanged(){
+    const int N = mGrid->getChildCount();
+    std::vector<int>& measurements = mMeasureScratch;
+    measurements.clear();
+    for (int i = 0; i < N; i++) {
+        View* c = mGrid->getChildAt(i);
+        const LayoutParams* lp = mGrid->getLayoutParams(c);
+        const auto spec = mHorizontal ? lp->columnSpec : lp->rowSpec;
+        measurements.push_back(c->getVisibility());
+        measurements.push_back(mGrid->getMeasurementIncludingMargin(c, mHorizontal));
+        measurements.push_back(mGrid->getMargin1(c, mHorizontal, true));
+        measurements.push_back(mGrid->getMargin1(c, mHorizontal, false));
+        if (spec->getAbsoluteAlignment(mHorizontal) == BASELINE) {
+            measurements.push_back(c->getBaseline());
+        }
+    }
+    /*weights are distributed from the parent constraints on every solve*/
+    if ((measurements == mMeasurements) && !hasWeights()) {
+        return false;
+    }
+    mMeasurements.swap(measurements);
+    invalidateValues();
+    return true;
+}
+
 void GridLayout::Axis::computeMargins(bool leading){
     std::vector<int>& margins = leading ? mLeadingMargins : mTrailingMargins;
     for (int i = 0, N = mGrid->getChildCount(); i < N; i++) {
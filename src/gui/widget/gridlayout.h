@@ -247,6 +247,8 @@ protected:
         bool mOrderPreserved = DEFAULT_ORDER_PRESERVED;
         bool mLocationsValid = false;
         int mDefinedCount;
+        std::vector<int>mMeasurements;/*the child sizes the values were computed from*/
+        std::vector<int>mMeasureScratch;/*reused by invalidateValuesIfChanged*/
         std::vector<int>mLeadingMargins;
         std::vector<int>mTrailingMargins;
         std::vector<int>mLocations;
@@ -264,6 +266,7 @@ protected:
         void setOrderPreserved(bool);
         void invalidateStructure();
         void invalidateValues();
+        bool invalidateValuesIfChanged();
         const std::vector<int>& getLocations();
         const std::vector<int>& getLeadingMargins();
         const std::vector<int>& getTrailingMargins();
@@ -302,6 +305,7 @@ public:
     };
 
 private:
+    friend class GridLayoutTestAccessor;/*lets the measure cache tests move the solved locations*/
     static constexpr int INFLEXIBLE  =0;
     static constexpr int CAN_STRETCH =2;
     int mOrientation;
@@ -1214,6 +1214,12 @@ void GridView::setSelectionInt(int position) {
     }
 }
 
+int GridView::getPrefetchItemCount(int distance) {
+    // Rows scroll in as a whole, prefetch complete rows.
+    const int rowHeight = std::max(1, getChildAt(0)->getHeight() + mVerticalSpacing);
+    return (distance / rowHeight + 1) * mNumColumns;
+}
+
 bool GridView::dispatchKeyEvent(KeyEvent& event) {
     bool handled = AbsListView::dispatchKeyEvent(event);
     if (!handled) {// If we didn't handle it...
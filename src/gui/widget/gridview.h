@@ -58,6 +58,7 @@ protected:
     void onMeasure(int widthMeasureSpec, int heightMeasureSpec)override;
     void layoutChildren() override;
     void setSelectionInt(int position)override;
+    int getPrefetchItemCount(int distance)override;
     bool pageScroll(int direction);
     bool fullScroll(int direction);
     bool arrowScroll(int direction);
@@ -36,6 +36,29 @@ public:
     double thickness;
     RefPtr<Pattern> pen, linePen, barPen, labelPen;
     RefPtr<Pattern> brush, barBrush;
+    /*streamed samples,a contiguous ring of samples.size() slots kept at double
+     *precision so that large x values such as timestamps stay distinct*/
+    std::vector<std::pair<double,double>> samples;
+    size_t sampleHead = 0;
+    size_t sampleCount = 0;
+
+    const std::pair<double,double>& sample(size_t i) const{
+        return samples[(sampleHead + i) % samples.size()];
+    }
+    PointF mapSample(PlotView*pw,size_t i) const{
+        return pw->mapToWidget(sample(i).first, sample(i).second);
+    }
+    /*index of the first sample that maps at or right of the pixel column px*/
+    size_t lowerSample(PlotView*pw,float px) const{
+        size_t lo = 0, hi = sampleCount;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (mapSample(pw, mid).x < px) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+    void drawPoint(cdroid::Canvas&painter,PlotView*pw,const PointF&pt,const std::string&label);
 };
 
 PlotObject::PlotObject(uint32_t color, PlotType t, double size, PointStyle ps)
@@ -189,7 +212,7 @@ PlotPoint& PlotObject::addPoint(double x, double y, const std::string &label, do
 }
 
 void PlotObject::removePoint(int index){
-    if ((index < 0) || (index >= d->pList.size())) {
+    if ((index < 0) || (index >= int(d->pList.size()))) {
         LOG(WARN) << "PlotObject::removePoint(): index " << index << " out of range!";
         return;
     }
@@ -203,17 +226,176 @@ void PlotObject::clearPoints(){
     d->pList.clear();
 }
 
+void PlotObject::setCapacity(int capacity){
+    if (capacity < 0) {
+        LOG(WARN) << "PlotObject::setCapacity(): invalid capacity " << capacity;
+        return;
+    }
+    d->samples.assign(capacity, std::pair<double,double>(0.0, 0.0));
+    d->sampleHead = d->sampleCount = 0;
+}
+
+int PlotObject::capacity() const{
+    return int(d->samples.size());
+}
+
+void PlotObject::addSample(double x, double y){
+    const size_t capacity = d->samples.size();
+    if (capacity == 0) {
+        LOG(WARN) << "PlotObject::addSample(): no capacity set";
+        return;
+    }
+    if (d->sampleCount && (x < d->sample(d->sampleCount - 1).first)) {
+        return;
+    }
+    if (d->sampleCount == capacity) {
+        d->sampleHead = (d->sampleHead + 1) % capacity;
+        d->sampleCount--;
+    }
+    d->samples[(d->sampleHead + d->sampleCount) % capacity] = std::pair<double,double>(x, y);
+    d->sampleCount++;
+}
+
+int PlotObject::sampleCount() const{
+    return int(d->sampleCount);
+}
+
+std::pair<double,double> PlotObject::sample(int index) const{
+    if ((index < 0) || (index >= int(d->sampleCount))) {
+        LOG(WARN) << "PlotObject::sample(): index " << index << " out of range";
+        return std::pair<double,double>(0.0, 0.0);
+    }
+    return d->sample(index);
+}
+
+void PlotObject::clearSamples(){
+    d->sampleHead = d->sampleCount = 0;
+}
+
+void PlotObject::Private::drawPoint(cdroid::Canvas&painter,PlotView*pw,const PointF&pt,const std::string&label){
+    double x1 = pt.x - size;
+    double y1 = pt.y - size;
+    Rect rect;
+    RectF qr = RectF::Make(static_cast<float>(x1), static_cast<float>(y1),
+        static_cast<float>(2.f * size), static_cast<float>(2 * size));
+    // Mask out this rect in the plot for label avoidance
+    pw->maskRect(qr, 2.0);
+
+    switch (pointStyle) {
+    case Circle:
+        painter.arc(pt.x,pt.y,size,0,M_PI*2.f);
+        painter.stroke();
+        break;
+
+    case Letter:
+        //painter->drawText(qr, Qt::AlignCenter, label.left(1));
+        rect = Rect::Make(static_cast<int>(qr.left), static_cast<int>(qr.top),
+            static_cast<int>(2.f * size), static_cast<int>(2.f * size));
+        painter.draw_text(rect,label,cdroid::Gravity::CENTER);
+        break;
+
+    case Triangle:
+        painter.set_source(brush);
+        painter.move_to(pt.x - size, pt.y + size);
+        painter.line_to(pt.x, pt.y - size);
+        painter.line_to(pt.x + size, pt.y + size);
+        painter.line_to(pt.x - size, pt.y + size);
+        painter.line_to(pt.x - size, pt.y + size);//line to 1st point(closepath)
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();
+        break;
+
+    case Square:
+        painter.rectangle(static_cast<int>(qr.left),static_cast<int>(qr.top),
+            static_cast<int>(qr.width), static_cast<int>(qr.height) );
+        painter.set_source(brush);
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();
+        break;
+
+    case Pentagon:
+        painter.move_to(pt.x, pt.y - size);
+        painter.line_to(pt.x + size, pt.y - 0.309 * size);
+        painter.line_to(pt.x + 0.588 * size, pt.y + size);
+        painter.line_to(pt.x - 0.588 * size, pt.y + size);
+        painter.line_to(pt.x - size, pt.y - 0.309 * size);
+        painter.line_to(pt.x, pt.y - size);//line to 1st point(closepath)
+
+        painter.set_source(brush);
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();		    
+        break;
+
+    case Hexagon:
+        painter.move_to(pt.x, pt.y + size);
+        painter.line_to(pt.x + size, pt.y + 0.5 * size);
+        painter.line_to(pt.x + size, pt.y - 0.5 * size);
+        painter.line_to(pt.x, pt.y - size);
+        painter.line_to(pt.x - size, pt.y + 0.5 * size);
+        painter.line_to(pt.x - size, pt.y - 0.5 * size);
+        painter.line_to(pt.x, pt.y + size);//line to 1st point(closepath)
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();
+        break;
+
+    case Asterisk:
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x, pt.y + size);
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x + size, pt.y - 0.5 * size);
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x + size, pt.y - 0.5 * size);
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x, pt.y - size);
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x - size, pt.y + 0.5 * size);
+        painter.move_to(pt.x,pt.y);
+        painter.line_to(pt.x - size, pt.y - 0.5 * size);
+        painter.line_to(pt.x,pt.y);//line to 1st point(closepath)
+        painter.set_source(brush);
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();
+        break;
+
+    case Star:
+        painter.move_to(pt.x, pt.y - size);
+        painter.line_to(pt.x + 0.2245 * size, pt.y - 0.309 * size);
+        painter.line_to(pt.x + size, pt.y - 0.309 * size);
+        painter.line_to(pt.x + 0.363 * size, pt.y + 0.118 * size);
+        painter.line_to(pt.x + 0.588 * size, pt.y + size);
+        painter.line_to(pt.x, pt.y + 0.382 * size);
+        painter.line_to(pt.x - 0.588 * size, pt.y + size);
+        painter.line_to(pt.x - 0.363 * size, pt.y + 0.118 * size);
+        painter.line_to(pt.x - size, pt.y - 0.309 * size);
+        painter.line_to(pt.x - 0.2245 * size, pt.y - 0.309 * size);
+        painter.line_to(pt.x, pt.y - size);//line to 1st point(closepath)
+        painter.set_source(brush);
+        painter.fill_preserve();
+        painter.set_source(pen);
+        painter.stroke();
+        break;
+
+    default:
+        break;
+    }
+}
+
 void PlotObject::draw(cdroid::Canvas&painter,PlotView*pw){
     // Order of drawing determines z-distance: Bars in the back, then lines,
     // then points, then labels.
 
     if (d->type & Bars) {
         double w = 0;
-        for (int i = 0; i < d->pList.size(); ++i) {
+        for (int i = 0; i < int(d->pList.size()); ++i) {
             auto it =d->pList.begin();
             std::advance(it,i);
             if ((*it)->barWidth() == 0.0) {
-                if (i < d->pList.size() - 1) {
+                if (i < int(d->pList.size()) - 1) {
                     auto next=it;
                     std::advance(next,1);
                     w = (*next)->x() - (*it)->x();
@@ -240,25 +422,11 @@ void PlotObject::draw(cdroid::Canvas&painter,PlotView*pw){
         }
     }
     if(d->type&Pie){
-        double w;
-        for (int i = 0; i < d->pList.size(); ++i) {
+        for (int i = 0; i < int(d->pList.size()); ++i) {
             auto it =d->pList.begin();
             std::advance(it,i);
-            if ((*it)->barWidth() == 0.0) {
-                if (i < d->pList.size() - 1) {
-                    auto next=it;
-                    std::advance(next,1);
-                    w = (*next)->x() - (*it)->x();
-                }
-                // For the last bin, we'll just keep the previous width
-            } else {
-                w = (*it)->barWidth();
-            }
             PointF pp =(*it)->position();
-            PointF sp1= pw->mapToWidget(pp);
             PointF pc = pw->mapToWidget(d->mCenter);
-            PointF ps = pw->mapToWidget({float(d->size),0});
-            RectF dr = pw->dataRect();
             painter.arc(pc.x,pc.y,d->size,pp.x*M_PI/180.f,(pp.x+pp.y)*M_PI/180.f);
             if(d->thickness!=0.f){d->thickness=d->size-20;
                 painter.arc_negative(pc.x,pc.y,d->size-d->thickness,(pp.x+pp.y)*M_PI/180.f,(pp.x*M_PI)/180.f);
@@ -269,6 +437,17 @@ void PlotObject::draw(cdroid::Canvas&painter,PlotView*pw){
             painter.stroke();
         }	
     }
+    // Streamed samples are searched for the visible x range and drawn in place,
+    // keeping the samples just outside it so lines run to the edges.
+    size_t firstSample = 0, lastSample = 0;
+    if (d->sampleCount && (d->type & (Lines | Points))) {
+        const Rect pr = pw->pixRect();
+        firstSample = d->lowerSample(pw, float(pr.left));
+        lastSample = d->lowerSample(pw, float(pr.right()));
+        if (firstSample > 0) firstSample--;
+        if (lastSample < d->sampleCount) lastSample++;
+    }
+
     // Draw lines:
     if (d->type & Lines) {
         bool bPrevious = false;
@@ -287,6 +466,16 @@ void PlotObject::draw(cdroid::Canvas&painter,PlotView*pw){
             }
             Previous = q;
         }
+        for (size_t i = firstSample; i < lastSample; i++) {
+            const PointF q = d->mapSample(pw, i);
+            if (i > firstSample) {
+                painter.line_to(q.x,q.y);
+                pw->maskAlongLine(Previous, q);
+            }else{
+                painter.move_to(q.x,q.y);
+            }
+            Previous = q;
+        }
         painter.stroke();
     }
 
@@ -296,116 +485,13 @@ void PlotObject::draw(cdroid::Canvas&painter,PlotView*pw){
             // q is the position of the point in screen pixel coordinates
             PointF q = pw->mapToWidget(pp->position());
             if (pw->pixRect().contains(static_cast<int>(q.x),static_cast<int>(q.y))) {
-                double x1 = q.x - size();
-                double y1 = q.y - size();
-                Rect rect;
-                RectF qr = RectF::Make(static_cast<float>(x1), static_cast<float>(y1),
-                    static_cast<float>(2.f * size()), static_cast<float>(2 * size()));
-                // Mask out this rect in the plot for label avoidance
-                pw->maskRect(qr, 2.0);
-
-                switch (pointStyle()) {
-                case Circle:
-                    painter.arc(q.x,q.y,size(),0,M_PI*2.f);
-                    painter.stroke();
-                    break;
-
-                case Letter:
-                    //painter->drawText(qr, Qt::AlignCenter, pp->label().left(1));
-                    rect = Rect::Make(static_cast<int>(qr.left), static_cast<int>(qr.top),
-                        static_cast<int>(2.f * size()), static_cast<int>(2.f * size()));
-                    painter.draw_text(rect,pp->label(),cdroid::Gravity::CENTER);
-                    break;
-
-                case Triangle:
-                    painter.set_source(brush());
-                    painter.move_to(q.x - size(), q.y + size());
-                    painter.line_to(q.x, q.y - size());
-                    painter.line_to(q.x + size(), q.y + size());
-                    painter.line_to(q.x - size(), q.y + size());
-                    painter.line_to(q.x - size(), q.y + size());//line to 1st point(closepath)
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();
-                    break;
-
-                case Square:
-                    painter.rectangle(static_cast<int>(qr.left),static_cast<int>(qr.top),
-                        static_cast<int>(qr.width), static_cast<int>(qr.height) );
-                    painter.set_source(brush());
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();
-                    break;
-
-                case Pentagon:
-                    painter.move_to(q.x, q.y - size());
-                    painter.line_to(q.x + size(), q.y - 0.309 * size());
-                    painter.line_to(q.x + 0.588 * size(), q.y + size());
-                    painter.line_to(q.x - 0.588 * size(), q.y + size());
-                    painter.line_to(q.x - size(), q.y - 0.309 * size());
-                    painter.line_to(q.x, q.y - size());//line to 1st point(closepath)
-
-                    painter.set_source(brush());
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();		    
-                    break;
-
-                case Hexagon:
-                    painter.move_to(q.x, q.y + size());
-                    painter.line_to(q.x + size(), q.y + 0.5 * size());
-                    painter.line_to(q.x + size(), q.y - 0.5 * size());
-                    painter.line_to(q.x, q.y - size());
-                    painter.line_to(q.x - size(), q.y + 0.5 * size());
-                    painter.line_to(q.x - size(), q.y - 0.5 * size());
-                    painter.line_to(q.x, q.y + size());//line to 1st point(closepath)
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();
-                    break;
-
-                case Asterisk:
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x, q.y + size());
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x + size(), q.y - 0.5 * size());
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x + size(), q.y - 0.5 * size());
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x, q.y - size());
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x - size(), q.y + 0.5 * size());
-                    painter.move_to(q.x,q.y);
-                    painter.line_to(q.x - size(), q.y - 0.5 * size());
-                    painter.line_to(q.x,q.y);//line to 1st point(closepath)
-                    painter.set_source(brush());
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();
-                    break;
-
-                case Star:
-                    painter.move_to(q.x, q.y - size());
-                    painter.line_to(q.x + 0.2245 * size(), q.y - 0.309 * size());
-                    painter.line_to(q.x + size(), q.y - 0.309 * size());
-                    painter.line_to(q.x + 0.363 * size(), q.y + 0.118 * size());
-                    painter.line_to(q.x + 0.588 * size(), q.y + size());
-                    painter.line_to(q.x, q.y + 0.382 * size());
-                    painter.line_to(q.x - 0.588 * size(), q.y + size());
-                    painter.line_to(q.x - 0.363 * size(), q.y + 0.118 * size());
-                    painter.line_to(q.x - size(), q.y - 0.309 * size());
-                    painter.line_to(q.x - 0.2245 * size(), q.y - 0.309 * size());
-                    painter.line_to(q.x, q.y - size());//line to 1st point(closepath)
-                    painter.set_source(brush());
-                    painter.fill_preserve();
-                    painter.set_source(pen());
-                    painter.stroke();
-                    break;
-
-                default:
-                    break;
-                }
+                d->drawPoint(painter, pw, q, pp->label());
+            }
+        }
+        for (size_t i = firstSample; i < lastSample; i++) {
+            const PointF q = d->mapSample(pw, i);
+            if (pw->pixRect().contains(static_cast<int>(q.x),static_cast<int>(q.y))) {
+                d->drawPoint(painter, pw, q, std::string());
             }
         }
     }
@@ -13,6 +13,7 @@
 #include <view/view.h>
 #include <string>
 #include <list>
+#include <utility>
 
 namespace cdroid{
 
@@ -250,6 +251,42 @@ public:
      */
     void clearPoints();
 
+    /**
+     * Set the number of streamed samples kept by this object,older samples
+     * are dropped once it is reached.Setting it clears the samples.
+     * @param capacity the maximum number of samples,0 disables streaming
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @return the maximum number of streamed samples
+     */
+    int capacity() const;
+
+    /**
+     * Append a sample to the ring buffer of this object.Samples have no label nor
+     * bar and are drawn as lines and points,their x values must not decrease.
+     * @param x the X-coordinate of the sample
+     * @param y the Y-coordinate of the sample
+     */
+    void addSample(double x, double y);
+
+    /**
+     * @return the number of streamed samples
+     */
+    int sampleCount() const;
+
+    /**
+     * @return the x and y of a streamed sample,the oldest one is at index 0
+     * @param index the index of the sample
+     */
+    std::pair<double,double> sample(int index) const;
+
+    /**
+     * Remove all streamed samples
+     */
+    void clearSamples();
+
     /**
      * Draw this PlotObject on the given QPainter
      * @param p The QPainter to draw on
@@ -16,7 +16,7 @@ class PlotPoint::Private
 {
 public:
     Private(PlotPoint *qq, const PointF &p, const std::string &l, double bw)
-        : q(qq)     , point(p) , plot(nullptr)
+        : q(qq)     , plot(nullptr) , point(p)
         , label(l)  , barWidth(bw)
     {
     }
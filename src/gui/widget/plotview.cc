@@ -87,6 +87,8 @@ public:
     std::vector<PlotObject *> objectList;
     // Limits of the plot area in data units
     RectF dataRect, secondDataRect;
+    // dataRect's origin and size at double precision
+    double dataX, dataY, dataWidth, dataHeight;
     // Limits of the plot area in pixel units
     Rect pixRect;
     // Array holding the mask of "used" regions of the plot
@@ -178,6 +180,10 @@ void PlotView::Private::calcDataRectLimits(double x1, double x2, double y1, doub
         YA2 = YA1 + 1.0;
     }
     dataRect = RectF::Make(XA1, YA1, XA2 - XA1, YA2 - YA1);
+    dataX = XA1;
+    dataY = YA1;
+    dataWidth = XA2 - XA1;
+    dataHeight= YA2 - YA1;
 
     q->axis(LeftAxis)->setTickMarks(dataRect.top, dataRect.height);
     q->axis(BottomAxis)->setTickMarks(dataRect.left, dataRect.width);
@@ -316,7 +322,7 @@ void PlotView::resetPlot(){
 
 void PlotView::replacePlotObject(int i, PlotObject *o){
     // skip null pointers and invalid indexes
-    if ((o==nullptr) || (i < 0) || (i >= d->objectList.size())) {
+    if ((o==nullptr) || (i < 0) || (i >= int(d->objectList.size()))) {
         return;
     }
     if (d->objectList.at(i) == o) {
@@ -444,6 +450,12 @@ PointF PlotView::mapToWidget(const PointF &p) const{
     return PointF{px, py};
 }
 
+PointF PlotView::mapToWidget(double x, double y) const{
+    const double px = d->pixRect.left + d->pixRect.width * (x - d->dataX) / d->dataWidth;
+    const double py = d->pixRect.top + d->pixRect.height * (d->dataY + d->dataHeight - y) / d->dataHeight;
+    return PointF{float(px), float(py)};
+}
+
 void PlotView::maskRect(const RectF &rf, float fvalue){
     const int value = int(fvalue);
     Rect r;//= rf.toRect().intersected(d->pixRect);
@@ -512,7 +524,7 @@ void PlotView::maskAlongLine(const PointF &p1, const PointF &p2, float fvalue){
                 uint8_t*pixel = pixels+(y*stride+x*4);
                 pixel[0]=100;
                 pixel[1]=std::min(pixel[1]+value,255);
-                uint32_t newColor = 0;//uint32_t(d->plotMask.pixel(x, y));
+                //uint32_t newColor = uint32_t(d->plotMask.pixel(x, y));
                 //newColor.setAlpha(uint8_t(100));
                 //newColor.setRed(uint8_t(std::min(newColor.red() + value, 255)));
                 //d->plotMask.setPixel(x, y, newColor.rgba());
@@ -606,7 +618,7 @@ void PlotView::placeLabel(cdroid::Canvas&painter, PlotPoint *pp){
         // which direction leads to the lowest cost?
 	std::vector<float> costList={upCost,downCost,leftCost,rightCost};
         int imin = -1;
-        for (int i = 0; i < costList.size(); ++i) {
+        for (int i = 0; i < int(costList.size()); ++i) {
 	    auto it=std::find(TriedPathIndex.begin(),TriedPathIndex.end(),i);
             if (iter == 0 && it!=TriedPathIndex.end()){//TriedPathIndex.contains(i)) {
                 continue; // Skip this first-step path, we already tried it!
@@ -746,7 +758,7 @@ float PlotView::Private::rectCost(const RectF &r) const{
     for(int ix = ri.left;ix<ri.right();ix++){
 	for(int iy = ri.top;iy<ri.bottom();iy++){
             uint8_t*pixel = (uint8_t*)(pixels+(iy*stride+ix*4));
-	    cost +=pixels[1];
+	    cost +=pixel[1];
 	}
     }
 #endif
@@ -275,6 +275,15 @@ public:
      */
     PointF mapToWidget(const PointF &p) const;
 
+    /**
+     * Map a coordinate given at double precision from the data rect to the
+     * physical pixel rect.
+     * @param x the x coordinate, in natural data units
+     * @param y the y coordinate, in natural data units
+     * @return the coordinate in the pixel coordinate system
+     */
+    PointF mapToWidget(double x, double y) const;
+
     /**
      * Indicate that object labels should try to avoid the given
      * rectangle in the plot.  The rectangle is in pixel coordinates.
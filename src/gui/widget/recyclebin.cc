@@ -64,6 +64,9 @@ void RecycleBin::markChildrenDirty() {
             mTransientStateViewsById.valueAt(i)->forceLayout();
         }
     }
+    for (size_t i = 0; i < mPrefetchedViews.size(); i++) {
+        mPrefetchedViews.valueAt(i)->forceLayout();
+    }
 }
 
 void RecycleBin::clear() {
@@ -71,6 +74,12 @@ void RecycleBin::clear() {
         std::vector<View*>& scrap = mScrapViews[i];
         clearScrap(scrap);
     }
+    std::vector<View*> prefetched;
+    for (size_t i = 0; i < mPrefetchedViews.size(); i++) {
+        prefetched.push_back(mPrefetchedViews.valueAt(i));
+    }
+    mPrefetchedViews.clear();
+    clearScrap(prefetched);
     clearTransientStateViews();
 }
 
@@ -179,7 +188,10 @@ void RecycleBin::addScrapView(View* scrap, int position) {
         return;
     }
 
-    scrap->dispatchStartTemporaryDetach();
+    // Prefetched views that were rebound from the scrap heap are still detached.
+    if (!scrap->isTemporarilyDetached()) {
+        scrap->dispatchStartTemporaryDetach();
+    }
 
     // The the accessibility state of the view may change while temporary
     // detached and we do not allow detached views to fire accessibility
@@ -214,11 +226,65 @@ void RecycleBin::addScrapView(View* scrap, int position) {
     }
 }
 
-std::vector<View*>RecycleBin::getSkippedScrap() {
+std::vector<View*>&RecycleBin::getSkippedScrap() {
     LOGV("mSkippedScrap.size=%d",mSkippedScrap.size());
     return mSkippedScrap;
 }
 
+void RecycleBin::addPrefetchedView(View* view, int position) {
+    mPrefetchedViews.put(position, view);
+}
+
+View* RecycleBin::getPrefetchedView(int position) {
+    const int index = mPrefetchedViews.indexOfKey(position);
+    if (index < 0) {
+        return nullptr;
+    }
+    if (LV->mDataChanged) {
+        // Bound to data that is gone, let obtainView() rebind them as scrap.
+        scrapPrefetchedViews();
+        return nullptr;
+    }
+    View* view = mPrefetchedViews.valueAt(index);
+    mPrefetchedViews.removeAt(index);
+    AbsListView::LayoutParams* lp = (AbsListView::LayoutParams*) view->getLayoutParams();
+    if (lp->viewType != getAdapter()->getItemViewType(position)) {
+        discardPrefetchedView(view, position);
+        return nullptr;
+    }
+    return view;
+}
+
+void RecycleBin::discardPrefetchedView(View* view, int position) {
+    if (view->isTemporarilyDetached()) {
+        // Rebound from the scrap heap, it is still attached to the window.
+        addScrapView(view, position);
+    } else {
+        // Never attached, attachViewToParent() can't bring it back from the heap.
+        delete view;
+    }
+}
+
+bool RecycleBin::hasPrefetchedView(int position)const {
+    return mPrefetchedViews.indexOfKey(position) >= 0;
+}
+
+size_t RecycleBin::getPrefetchedViewCount()const {
+    return mPrefetchedViews.size();
+}
+
+void RecycleBin::scrapPrefetchedViews(int keepFirst, int keepLast) {
+    for (int i = int(mPrefetchedViews.size()) - 1; i >= 0; i--) {
+        const int position = mPrefetchedViews.keyAt(i);
+        if (position >= keepFirst && position <= keepLast) {
+            continue;
+        }
+        View* view = mPrefetchedViews.valueAt(i);
+        mPrefetchedViews.removeAt(i);
+        discardPrefetchedView(view, position);
+    }
+}
+
 void RecycleBin::removeSkippedScrap() {
     size_t count = mSkippedScrap.size();
     for (size_t i = 0; i < count; i++) {
@@ -347,6 +413,9 @@ void RecycleBin::setCacheColorHint(int color) {
             scrap[j]->setDrawingCacheBackgroundColor(color);
         }
     }
+    for (size_t i = 0; i < mPrefetchedViews.size(); i++) {
+        mPrefetchedViews.valueAt(i)->setDrawingCacheBackgroundColor(color);
+    }
 
     // Just in case this is called during a layout pass
     size_t count = mActiveViews.size();
@@ -35,11 +35,13 @@ private:
     std::vector<View*>mSkippedScrap;
     SparseArray<View*>mTransientStateViews;
     SparseArray<View*>mTransientStateViewsById;
+    SparseArray<View*>mPrefetchedViews;
 
     class Adapter*getAdapter();//refto abslistview's mAdapter;
-    std::vector<View*>getSkippedScrap();
+    std::vector<View*>&getSkippedScrap();
     void pruneScrapViews();
     View* retrieveFromScrap(std::vector<View*>& scrapViews, int position);
+    void discardPrefetchedView(View* view, int position);
     void clearScrap(std::vector<View*>& scrap);
     void clearScrapForRebind(View* view);
     void removeDetachedView(View* child, bool animate) ;
@@ -57,6 +59,15 @@ public:
     void clearTransientStateViews();
     View* getScrapView(int position);
     void addScrapView(View* scrap, int position);
+    /*Views bound ahead of a fling by AbsListView's prefetcher,they are not attached
+     *until obtainView takes them.Positions outside [keepFirst,keepLast] are dropped,
+     *all of them by default:views rebound from the scrap heap go back to it and
+     *views that were never attached are deleted*/
+    void addPrefetchedView(View* view, int position);
+    View* getPrefetchedView(int position);
+    bool hasPrefetchedView(int position)const;
+    size_t getPrefetchedViewCount()const;
+    void scrapPrefetchedViews(int keepFirst = 0, int keepLast = -1);
     void removeSkippedScrap();
     void scrapActiveViews();
     void fullyDetachScrapViews();
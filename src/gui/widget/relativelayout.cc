@@ -111,8 +111,26 @@ int RelativeLayout::getBaseline() {
 }
 
 void RelativeLayout::requestLayout() {
+    /*the dependency graph only depends on the children and their rules,
+     *onMeasure compares them instead of sorting again on every request*/
     ViewGroup::requestLayout();
-    mDirtyHierarchy = true;
+}
+
+bool RelativeLayout::isHierarchyChanged(){
+    const int count = getChildCount();
+    std::vector<intptr_t> key;
+    key.reserve(count*(2+sizeof(RULES_VERTICAL)/sizeof(int)+sizeof(RULES_HORIZONTAL)/sizeof(int)));
+    for (int i = 0; i < count; i++) {
+        View* child = getChildAt(i);
+        const int* rules = ((LayoutParams*)child->getLayoutParams())->mRules;
+        key.push_back(intptr_t(child));
+        key.push_back(child->getId());
+        for (int rule:RULES_VERTICAL) key.push_back(rules[rule]);
+        for (int rule:RULES_HORIZONTAL) key.push_back(rules[rule]);
+    }
+    if (key == mGraphKey) return false;
+    mGraphKey = std::move(key);
+    return true;
 }
 
 void RelativeLayout::sortChildren(){
@@ -131,7 +149,7 @@ void RelativeLayout::sortChildren(){
 }
 
 void RelativeLayout::onMeasure(int widthMeasureSpec, int heightMeasureSpec){
-    if (mDirtyHierarchy) {
+    if (isHierarchyChanged() || mDirtyHierarchy) {
         mDirtyHierarchy = false;
         sortChildren();
     }
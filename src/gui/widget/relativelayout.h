@@ -120,6 +120,8 @@ private:
     std::set<View*,TopToBottomLeftToRightComparator> mTopToBottomLeftToRightSet;
 
     bool mDirtyHierarchy;
+    /*children,ids and relation rules the graph was sorted with*/
+    std::vector<intptr_t> mGraphKey;
     std::vector<View*> mSortedHorizontalChildren;
     std::vector<View*> mSortedVerticalChildren;
     DependencyGraph *mGraph;
@@ -141,6 +143,7 @@ private:
 
 private://function
     void sortChildren();
+    bool isHierarchyChanged();
     int compareLayoutPosition(const LayoutParams* p1,const LayoutParams* p2);
     void measureChild(View* child, LayoutParams* params, int myWidth, int myHeight);
     void measureChildHorizontal(View* child, LayoutParams* params, int myWidth, int myHeight);
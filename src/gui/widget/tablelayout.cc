@@ -119,12 +119,8 @@ void TableLayout::requestRowsLayout(){
 }
 
 void TableLayout::requestLayout(){
-    if (mInitialized) {
-        int count = getChildCount();
-        for (int i = 0; i < count; i++) {
-            getChildAt(i)->forceLayout();
-        }
-    }
+    /*rows are no longer forced here,TableRow::setColumnsWidthConstraints()
+     *forces the rows whose column widths really changed*/
     LinearLayout::requestLayout();
 }
 
@@ -271,8 +267,10 @@ void TableLayout::findLargestCells(int widthMeasureSpec, int heightMeasureSpec)
             int length = (int)mMaxWidths.size();
             // the current row is wider than the previous rows, so
             // we just grow the array and copy the values
-            mMaxWidths.resize(newLength);
-            for(i=length;i<newLength;i++)mMaxWidths[i] = widths[i];
+            if (newLength > length) {
+                mMaxWidths.resize(newLength);
+                for (int j = length; j < newLength; j++) mMaxWidths[j] = widths[j];
+            }
 
             // the row is narrower or of the same width as the previous
             // rows, so we find the maximum width for each column
@@ -317,15 +315,8 @@ void TableLayout::mutateColumnsWidth(SparseBooleanArray& columns,bool allColumns
     int totalExtraSpace = size - totalWidth;
     int extraSpace = int(totalExtraSpace / count);
 
-    // Column's widths are changed: force child table rows to re-measure.
-    // (done by super.measureVertical after shrinkAndStretchColumns.)
-    const int nbChildren = (int)getChildCount();
-    for (int i = 0; i < nbChildren; i++) {
-        View* child = getChildAt(i);
-        if (dynamic_cast<TableRow*>(child)) {
-            child->forceLayout();
-        }
-    }
+    // Column's widths are changed: the rows are forced to re-measure by
+    // TableRow::setColumnsWidthConstraints() in measureChildBeforeLayout().
 
     if (!allColumns) {
         for (size_t i=0;i<count;i++){
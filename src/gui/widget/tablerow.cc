@@ -270,7 +270,11 @@ void TableRow::setColumnsWidthConstraints(const std::vector<int>& columnWidths)
     if (columnWidths.size() < getVirtualChildCount()) {
         LOGE("columnWidths should be >= getVirtualChildCount()");
     }
-    mConstrainedColumnWidths = columnWidths;
+    if (mConstrainedColumnWidths != columnWidths) {
+        /*only rows whose columns changed are measured again*/
+        mConstrainedColumnWidths = columnWidths;
+        forceLayout();
+    }
 }
 
 TableRow::LayoutParams* TableRow::generateLayoutParams(const AttributeSet& attrs)const {
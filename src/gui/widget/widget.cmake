@@ -114,10 +114,10 @@ list(APPEND WIDGET_SOURCES
     widget/toolbar.cc
     widget/toast.cc
 
-    #widget/plotaxis.cc
-    #widget/plotobject.cc
-    #widget/plotpoint.cc
-    #widget/plotview.cc
+    widget/plotaxis.cc
+    widget/plotobject.cc
+    widget/plotpoint.cc
+    widget/plotview.cc
 )
 
 list(APPEND WIDGET_SOURCES
@@ -135,11 +135,13 @@ if(ENABLE_ACHART)
         widget/achart/model/categoryseries.h
         widget/achart/model/multiplecategoryseries.h
         widget/achart/model/rangecategoryseries.h
+        widget/achart/model/ringseries.h
         widget/achart/model/seriesselection.h
         widget/achart/model/timeseries.h
         widget/achart/model/xymultipleseriesdataset.h
         widget/achart/model/xyseries.h
         widget/achart/model/xyvalueseries.h
+        widget/achart/util/decimator.cc
 
         widget/achart/chart/scatterchart.cc
         widget/achart/chart/abstractchart.cc
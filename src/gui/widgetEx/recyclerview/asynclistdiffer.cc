@@ -0,0 +1,66 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <mutex>
+#include <thread>
+#include <core/handler.h>
+#include <utils/lockfreequeue.h>
+#include <widgetEx/recyclerview/asynclistdiffer.h>
+#include <porting/cdlog.h>
+namespace cdroid{
+
+Handler* AsyncListDifferBase::sMainHandler = nullptr;
+
+AsyncListDifferBase::AsyncListDifferBase(const Executor& backgroundExecutor)
+    :mState(std::make_shared<State>()),mBackgroundExecutor(backgroundExecutor){
+    if (mBackgroundExecutor == nullptr) {
+        mBackgroundExecutor = executeInBackground;
+    }
+    if (sMainHandler == nullptr) {
+        // created here, on the UI thread, workers only post to it
+        sMainHandler = new Handler();
+    }
+}
+
+AsyncListDifferBase::~AsyncListDifferBase() {
+    mState->alive = false;
+}
+
+void AsyncListDifferBase::executeInBackground(const std::function<void()>& task) {
+    static MPSCQueue<std::function<void()>*> sQueue(64);
+    static std::once_flag sInit;
+    std::call_once(sInit, []() {
+        std::thread diffThread([]() {
+            for (;;) {
+                std::function<void()>* diff = sQueue.take();
+                try {
+                    (*diff)();
+                } catch (std::exception& e) {
+                    LOGE("list diff failed: %s", e.what());
+                }
+                delete diff;
+            }
+        });
+        diffThread.detach();
+    });
+    sQueue.put(new std::function<void()>(task));
+}
+
+void AsyncListDifferBase::postToMainThread(const Runnable& r) {
+    sMainHandler->post(r);
+}
+}/*endof namespace*/
@@ -0,0 +1,138 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __ASYNC_LIST_DIFFER_H__
+#define __ASYNC_LIST_DIFFER_H__
+#include <memory>
+#include <functional>
+#include <widgetEx/recyclerview/diffutil.h>
+namespace cdroid{
+class Handler;
+class AsyncListDifferBase{
+public:
+    /*runs a task off the UI thread,the default one is a single shared worker thread*/
+    using Executor = std::function<void(const std::function<void()>&)>;
+protected:
+    /*shared with the diffs in flight,only touched on the UI thread*/
+    struct State{
+        bool alive = true;
+        int maxScheduledGeneration = 0;
+    };
+    std::shared_ptr<State> mState;
+    Executor mBackgroundExecutor;
+    static Handler* sMainHandler;
+    static void executeInBackground(const std::function<void()>& task);
+    static void postToMainThread(const Runnable& r);
+    AsyncListDifferBase(const Executor& backgroundExecutor);
+public:
+    virtual ~AsyncListDifferBase();
+};
+
+/*Keeps the current list of an adapter.A submitted list is diffed against the current one
+ *on a background thread,then the adapter gets the minimal notifyItemRangeXXX() calls on the
+ *UI thread.Only the latest submitted list is committed,older diffs still running are dropped.
+ *Lists are immutable once submitted,the ItemCallback is called on the background thread*/
+template<typename T>
+class AsyncListDiffer:public AsyncListDifferBase{
+public:
+    using List = std::vector<T>;
+private:
+    class ListCallback:public DiffUtil::Callback{
+    private:
+        std::shared_ptr<const List> mOldList;
+        std::shared_ptr<const List> mNewList;
+        std::shared_ptr<DiffUtil::ItemCallback<T>> mItemCallback;
+    public:
+        ListCallback(const std::shared_ptr<const List>& oldList,const std::shared_ptr<const List>& newList,
+                const std::shared_ptr<DiffUtil::ItemCallback<T>>& itemCallback)
+            :mOldList(oldList),mNewList(newList),mItemCallback(itemCallback){
+        }
+        int getOldListSize()override{
+            return int(mOldList->size());
+        }
+        int getNewListSize()override{
+            return int(mNewList->size());
+        }
+        bool areItemsTheSame(int oldItemPosition, int newItemPosition)override{
+            return mItemCallback->areItemsTheSame(mOldList->at(oldItemPosition), mNewList->at(newItemPosition));
+        }
+        bool areContentsTheSame(int oldItemPosition, int newItemPosition)override{
+            return mItemCallback->areContentsTheSame(mOldList->at(oldItemPosition), mNewList->at(newItemPosition));
+        }
+        Object* getChangePayload(int oldItemPosition, int newItemPosition)override{
+            return mItemCallback->getChangePayload(mOldList->at(oldItemPosition), mNewList->at(newItemPosition));
+        }
+    };
+    std::unique_ptr<ListUpdateCallback> mOwnedUpdateCallback;
+    ListUpdateCallback* mUpdateCallback;
+    std::shared_ptr<DiffUtil::ItemCallback<T>> mItemCallback;
+    std::shared_ptr<const List> mList;
+private:
+    void latchList(const std::shared_ptr<const List>& newList, DiffUtil::DiffResult& diffResult, Runnable commitCallback) {
+        mList = newList;
+        // notify last, after list is updated
+        diffResult.dispatchUpdatesTo(*mUpdateCallback);
+        if (commitCallback != nullptr) commitCallback();
+    }
+public:
+    AsyncListDiffer(ListUpdateCallback* updateCallback, const std::shared_ptr<DiffUtil::ItemCallback<T>>& itemCallback,
+            const Executor& backgroundExecutor = nullptr)
+        :AsyncListDifferBase(backgroundExecutor),mUpdateCallback(updateCallback),mItemCallback(itemCallback),
+        mList(std::make_shared<const List>()){
+    }
+
+    AsyncListDiffer(RecyclerView::Adapter* adapter, const std::shared_ptr<DiffUtil::ItemCallback<T>>& itemCallback)
+        :AsyncListDiffer(new AdapterListUpdateCallback(adapter), itemCallback){
+        mOwnedUpdateCallback.reset(mUpdateCallback);
+    }
+
+    /*what the adapter shows,getItemCount()/onBindViewHolder() read from it*/
+    const List& getCurrentList()const{
+        return *mList;
+    }
+
+    /*commitCallback runs on the UI thread once the list is committed,never if a newer list
+     *was submitted meanwhile*/
+    void submitList(List newList, Runnable commitCallback = nullptr) {
+        // incrementing generation means any currently-running diffs are discarded when they finish
+        const int runGeneration = ++mState->maxScheduledGeneration;
+        if (newList.empty() || mList->empty()) {
+            // nothing to diff, one range covers it all
+            const int countRemoved = int(mList->size());
+            mList = std::make_shared<const List>(std::move(newList));
+            if (countRemoved) mUpdateCallback->onRemoved(0, countRemoved);
+            if (mList->size()) mUpdateCallback->onInserted(0, int(mList->size()));
+            if (commitCallback != nullptr) commitCallback();
+            return;
+        }
+        std::shared_ptr<const List> oldList = mList;
+        std::shared_ptr<const List> submitted = std::make_shared<const List>(std::move(newList));
+        std::shared_ptr<State> state = mState;
+        std::shared_ptr<DiffUtil::ItemCallback<T>> itemCallback = mItemCallback;
+        mBackgroundExecutor([this, state, oldList, submitted, itemCallback, runGeneration, commitCallback]() {
+            std::shared_ptr<ListCallback> callback = std::make_shared<ListCallback>(oldList, submitted, itemCallback);
+            std::shared_ptr<DiffUtil::DiffResult> result = std::make_shared<DiffUtil::DiffResult>(DiffUtil::calculateDiff(*callback));
+            postToMainThread([this, state, callback, result, submitted, runGeneration, commitCallback]() {
+                if (state->alive && (state->maxScheduledGeneration == runGeneration)) {
+                    latchList(submitted, *result, commitCallback);
+                }
+            });
+        });
+    }
+};
+}/*endof namespace*/
+#endif/*__ASYNC_LIST_DIFFER_H__*/
@@ -0,0 +1,438 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <algorithm>
+#include <stdexcept>
+#include <widgetEx/recyclerview/diffutil.h>
+namespace cdroid{
+
+/*a snake is a diagonal run of matching items,possibly led by one insertion or removal*/
+struct DiffUtil::Snake {
+    int startX;
+    int startY;
+    int endX;
+    int endY;
+    bool reverse;
+    bool hasAdditionOrRemoval()const{
+        return endY - startY != endX - startX;
+    }
+    bool isAddition()const{
+        return endY - startY > endX - startX;
+    }
+    int diagonalSize()const{
+        return std::min(endX - startX, endY - startY);
+    }
+    Diagonal toDiagonal()const{
+        if (hasAdditionOrRemoval()) {
+            if (reverse) {
+                // snake edge it at the end
+                return Diagonal{startX, startY, diagonalSize()};
+            } else if (isAddition()) {
+                // snake edge it at the beginning
+                return Diagonal{startX, startY + 1, diagonalSize()};
+            } else {
+                return Diagonal{startX + 1, startY, diagonalSize()};
+            }
+        }
+        return Diagonal{startX, startY, endX - startX};
+    }
+};
+
+struct DiffUtil::Range {
+    int oldListStart;
+    int oldListEnd;
+    int newListStart;
+    int newListEnd;
+    int oldSize()const{ return oldListEnd - oldListStart; }
+    int newSize()const{ return newListEnd - newListStart; }
+};
+
+/*an array indexed from -size/2 to size/2,the k lines of the Myers graph*/
+class DiffUtil::CenteredArray {
+private:
+    std::vector<int> mData;
+    int mMid;
+public:
+    CenteredArray(int size):mData(size),mMid(size / 2){}
+    int get(int index)const{ return mData[index + mMid]; }
+    void set(int index, int value){ mData[index + mMid] = value; }
+};
+
+DiffUtil::DiffResult DiffUtil::calculateDiff(Callback& cb, bool detectMoves) {
+    const int oldSize = cb.getOldListSize();
+    const int newSize = cb.getNewListSize();
+    std::vector<Diagonal> diagonals;
+    // instead of a recursive implementation, we keep our own stack to avoid potential stack
+    // overflow exceptions
+    std::vector<Range> stack;
+    stack.push_back(Range{0, oldSize, 0, newSize});
+    const int max = (oldSize + newSize + 1) / 2;
+    // allocate forward and backward k-lines. K lines are diagonal lines in the matrix. (see the
+    // paper for details)
+    // These arrays lines keep the max reachable position for each k-line.
+    CenteredArray forward(max * 2 + 1);
+    CenteredArray backward(max * 2 + 1);
+    Snake snake;
+    while (!stack.empty()) {
+        const Range range = stack.back();
+        stack.pop_back();
+        if (midPoint(range, cb, forward, backward, snake)) {
+            // if it has a diagonal, save it
+            if (snake.diagonalSize() > 0) {
+                diagonals.push_back(snake.toDiagonal());
+            }
+            // add new ranges for left and right
+            stack.push_back(Range{range.oldListStart, snake.startX, range.newListStart, snake.startY});
+            stack.push_back(Range{snake.endX, range.oldListEnd, snake.endY, range.newListEnd});
+        }
+    }
+    // sort snakes
+    std::sort(diagonals.begin(), diagonals.end(), [](const Diagonal& a, const Diagonal& b) {
+        return a.x < b.x;
+    });
+    return DiffResult(&cb, diagonals, detectMoves);
+}
+
+/*Finds a middle snake in the given range.*/
+bool DiffUtil::midPoint(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, Snake& snake) {
+    if ((range.oldSize() < 1) || (range.newSize() < 1)) {
+        return false;
+    }
+    const int max = (range.oldSize() + range.newSize() + 1) / 2;
+    forward.set(1, range.oldListStart);
+    backward.set(1, range.oldListEnd);
+    for (int d = 0; d < max; d++) {
+        if (DiffUtil::forward(range, cb, forward, backward, d, snake)) {
+            return true;
+        }
+        if (DiffUtil::backward(range, cb, forward, backward, d, snake)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DiffUtil::forward(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, int d, Snake& snake) {
+    const bool checkForSnake = std::abs(range.oldSize() - range.newSize()) % 2 == 1;
+    const int delta = range.oldSize() - range.newSize();
+    for (int k = -d; k <= d; k += 2) {
+        // we either come from d-1, k-1 OR d-1. k+1
+        // as we move in steps of 2, array always holds both current and previous d values
+        // k = x - y and each array value holds the max X, y = x - k
+        int startX, startY, x, y;
+        if ((k == -d) || ((k != d) && (forward.get(k + 1) > forward.get(k - 1)))) {
+            // picking k + 1, incrementing Y (by simply not incrementing X)
+            x = startX = forward.get(k + 1);
+        } else {
+            // picking k - 1, incrementing X
+            startX = forward.get(k - 1);
+            x = startX + 1;
+        }
+        y = range.newListStart + (x - range.oldListStart) - k;
+        startY = ((d == 0) || (x != startX)) ? y : y - 1;
+        // now find snake size
+        while ((x < range.oldListEnd) && (y < range.newListEnd) && cb.areItemsTheSame(x, y)) {
+            x++;
+            y++;
+        }
+        // now we have furthest reaching x, record it
+        forward.set(k, x);
+        if (checkForSnake) {
+            // see if we did pass over a backwards array
+            // mapping function: delta - k
+            const int backwardsK = delta - k;
+            // if backwards K is calculated and it passed me, found match
+            if ((backwardsK >= -d + 1) && (backwardsK <= d - 1) && (backward.get(backwardsK) <= x)) {
+                // match
+                snake = Snake{startX, startY, x, y, false};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool DiffUtil::backward(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, int d, Snake& snake) {
+    const bool checkForSnake = (range.oldSize() - range.newSize()) % 2 == 0;
+    const int delta = range.oldSize() - range.newSize();
+    // same as forward but we go backwards from end of the lists to be beginning
+    // this also means we'll try to optimize for minimizing x instead of maximizing it
+    for (int k = -d; k <= d; k += 2) {
+        // we either come from d-1, k-1 OR d-1, k+1
+        // as we move in steps of 2, array always holds both current and previous d values
+        // k = x - y and each array value holds the MIN X, y = x - k
+        // when x's are equal, we prioritize deletion over insertion
+        int startX, startY, x, y;
+        if ((k == -d) || ((k != d) && (backward.get(k + 1) < backward.get(k - 1)))) {
+            // picking k + 1, decrementing Y (by simply not decrementing X)
+            x = startX = backward.get(k + 1);
+        } else {
+            // picking k - 1, decrementing X
+            startX = backward.get(k - 1);
+            x = startX - 1;
+        }
+        y = range.newListEnd - ((range.oldListEnd - x) - k);
+        startY = ((d == 0) || (x != startX)) ? y : y + 1;
+        // now find snake size
+        while ((x > range.oldListStart) && (y > range.newListStart) && cb.areItemsTheSame(x - 1, y - 1)) {
+            x--;
+            y--;
+        }
+        // now we have furthest point, record it (min X)
+        backward.set(k, x);
+        if (checkForSnake) {
+            // see if we did pass over a backwards array
+            // mapping function: delta - k
+            const int forwardsK = delta - k;
+            // if forwards K is calculated and it passed me, found match
+            if ((forwardsK >= -d) && (forwardsK <= d) && (forward.get(forwardsK) >= x)) {
+                // match
+                // assignment are reverse since we are a reverse snake
+                snake = Snake{x, y, startX, startY, true};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+DiffUtil::DiffResult::DiffResult(Callback* callback, std::vector<Diagonal>& diagonals, bool detectMoves) {
+    mDiagonals.swap(diagonals);
+    mCallback = callback;
+    mOldListSize = callback->getOldListSize();
+    mNewListSize = callback->getNewListSize();
+    mOldItemStatuses.assign(mOldListSize, 0);
+    mNewItemStatuses.assign(mNewListSize, 0);
+    mDetectMoves = detectMoves;
+    addEdgeDiagonals();
+    findMatchingItems();
+}
+
+/*Add edge diagonals so that we can iterate as long as there are diagonals w/o lots of
+ *null checks around*/
+void DiffUtil::DiffResult::addEdgeDiagonals() {
+    if (mDiagonals.empty() || (mDiagonals.front().x != 0) || (mDiagonals.front().y != 0)) {
+        mDiagonals.insert(mDiagonals.begin(), Diagonal{0, 0, 0});
+    }
+    mDiagonals.push_back(Diagonal{mOldListSize, mNewListSize, 0});
+}
+
+/*Find position mapping from old list to new list.
+ *If moves are requested, we'll also try to do an n^2 search between additions and
+ *removals to find moves.*/
+void DiffUtil::DiffResult::findMatchingItems() {
+    for (const Diagonal& diagonal : mDiagonals) {
+        for (int offset = 0; offset < diagonal.size; offset++) {
+            const int posX = diagonal.x + offset;
+            const int posY = diagonal.y + offset;
+            const bool theSame = mCallback->areContentsTheSame(posX, posY);
+            const int changeFlag = theSame ? FLAG_NOT_CHANGED : FLAG_CHANGED;
+            mOldItemStatuses[posX] = (posY << FLAG_OFFSET) | changeFlag;
+            mNewItemStatuses[posY] = (posX << FLAG_OFFSET) | changeFlag;
+        }
+    }
+    // now all matches are marked, lets look for moves
+    if (mDetectMoves) {
+        // traverse each addition / removal from the end of the list, find matching
+        // addition removal from before
+        findMoveMatches();
+    }
+}
+
+void DiffUtil::DiffResult::findMoveMatches() {
+    // for each removal, find matching addition
+    int posX = 0;
+    for (const Diagonal& diagonal : mDiagonals) {
+        while (posX < diagonal.x) {
+            if (mOldItemStatuses[posX] == 0) {
+                // there is a removal, find matching addition from the rest
+                findMatchingAddition(posX);
+            }
+            posX++;
+        }
+        // snap back for the next diagonal
+        posX = diagonal.endX();
+    }
+}
+
+/*Search the whole list to find the addition for the given removal of position posX*/
+void DiffUtil::DiffResult::findMatchingAddition(int posX) {
+    int posY = 0;
+    for (const Diagonal& diagonal : mDiagonals) {
+        while (posY < diagonal.y) {
+            // found some additions, evaluate
+            if ((mNewItemStatuses[posY] == 0) && mCallback->areItemsTheSame(posX, posY)) {
+                // yay found it, set values
+                const bool contentsMatching = mCallback->areContentsTheSame(posX, posY);
+                const int changeFlag = contentsMatching ? FLAG_MOVED_NOT_CHANGED : FLAG_MOVED_CHANGED;
+                // once we process one of these, it will mark the other one as ignored.
+                mOldItemStatuses[posX] = (posY << FLAG_OFFSET) | changeFlag;
+                mNewItemStatuses[posY] = (posX << FLAG_OFFSET) | changeFlag;
+                return;
+            }
+            posY++;
+        }
+        posY = diagonal.endY();
+    }
+}
+
+int DiffUtil::DiffResult::convertOldPositionToNew(int oldListPosition)const {
+    if ((oldListPosition < 0) || (oldListPosition >= mOldListSize)) {
+        throw std::out_of_range("Index out of bounds - passed position = "
+                + std::to_string(oldListPosition) + ", old list size = " + std::to_string(mOldListSize));
+    }
+    const int status = mOldItemStatuses[oldListPosition];
+    return (status & FLAG_MASK) == 0 ? NO_POSITION : status >> FLAG_OFFSET;
+}
+
+int DiffUtil::DiffResult::convertNewPositionToOld(int newListPosition)const {
+    if ((newListPosition < 0) || (newListPosition >= mNewListSize)) {
+        throw std::out_of_range("Index out of bounds - passed position = "
+                + std::to_string(newListPosition) + ", new list size = " + std::to_string(mNewListSize));
+    }
+    const int status = mNewItemStatuses[newListPosition];
+    return (status & FLAG_MASK) == 0 ? NO_POSITION : status >> FLAG_OFFSET;
+}
+
+void DiffUtil::DiffResult::dispatchUpdatesTo(RecyclerView::Adapter* adapter) {
+    AdapterListUpdateCallback callback(adapter);
+    dispatchUpdatesTo(callback);
+}
+
+/*Updates are dispatched from the end of the list to the start,so that the positions of
+ *items not processed yet stay valid.A move is only known once both its removal and its
+ *addition were seen,the first one is postponed until the second shows up*/
+void DiffUtil::DiffResult::dispatchUpdatesTo(ListUpdateCallback& updateCallback) {
+    BatchingListUpdateCallback* batching = dynamic_cast<BatchingListUpdateCallback*>(&updateCallback);
+    BatchingListUpdateCallback wrapper(&updateCallback);
+    BatchingListUpdateCallback& batchingCallback = batching ? *batching : wrapper;
+    // track up to date current list size for moves
+    // when a move is found, we record its position from the end of the list (which is
+    // less likely to change since we iterate in reverse).
+    // Later when we find the match of that move, we dispatch the update
+    int currentListSize = mOldListSize;
+    // list of postponed moves
+    std::vector<PostponedUpdate> postponedUpdates;
+    PostponedUpdate postponedUpdate;
+    // posX and posY are exclusive
+    int posX = mOldListSize;
+    int posY = mNewListSize;
+    // iterate from end of the list to the beginning.
+    // this just makes offsets easier since changes in the earlier indices has an effect
+    // on the later indices.
+    for (int diagonalIndex = int(mDiagonals.size()) - 1; diagonalIndex >= 0; diagonalIndex--) {
+        const Diagonal& diagonal = mDiagonals[diagonalIndex];
+        const int endX = diagonal.endX();
+        const int endY = diagonal.endY();
+        // dispatch removals and additions until we reach to that diagonal
+        // first remove then add so that it can go into its place and we don't need
+        // to offset values
+        while (posX > endX) {
+            posX--;
+            // REMOVAL
+            const int status = mOldItemStatuses[posX];
+            if ((status & FLAG_MOVED) != 0) {
+                const int newPos = status >> FLAG_OFFSET;
+                // get postponed addition
+                if (getPostponedUpdate(postponedUpdates, newPos, false, postponedUpdate)) {
+                    // this is an addition that was postponed. Now dispatch it.
+                    const int updatedNewPos = currentListSize - postponedUpdate.currentPos;
+                    batchingCallback.onMoved(posX, updatedNewPos - 1);
+                    if ((status & FLAG_MOVED_CHANGED) != 0) {
+                        Object* changePayload = mCallback->getChangePayload(posX, newPos);
+                        batchingCallback.onChanged(updatedNewPos - 1, 1, changePayload);
+                    }
+                } else {
+                    // first time we are seeing this, we'll see a matching addition
+                    postponedUpdates.push_back(PostponedUpdate{posX, currentListSize - posX - 1, true});
+                }
+            } else {
+                // simple removal
+                batchingCallback.onRemoved(posX, 1);
+                currentListSize--;
+            }
+        }
+        while (posY > endY) {
+            posY--;
+            // ADDITION
+            const int status = mNewItemStatuses[posY];
+            if ((status & FLAG_MOVED) != 0) {
+                // this is a move not an addition.
+                // see if this is postponed
+                const int oldPos = status >> FLAG_OFFSET;
+                // get postponed removal
+                if (!getPostponedUpdate(postponedUpdates, oldPos, true, postponedUpdate)) {
+                    // postpone it until we see the removal
+                    postponedUpdates.push_back(PostponedUpdate{posY, currentListSize - posX, false});
+                } else {
+                    // oldPosFromEnd = foundListSize - posX
+                    // we can find posX if we swap the list sizes
+                    // posX = listSize - oldPosFromEnd
+                    const int updatedOldPos = currentListSize - postponedUpdate.currentPos - 1;
+                    batchingCallback.onMoved(updatedOldPos, posX);
+                    if ((status & FLAG_MOVED_CHANGED) != 0) {
+                        Object* changePayload = mCallback->getChangePayload(oldPos, posY);
+                        batchingCallback.onChanged(posX, 1, changePayload);
+                    }
+                }
+            } else {
+                // simple addition
+                batchingCallback.onInserted(posX, 1);
+                currentListSize++;
+            }
+        }
+        // now dispatch updates for the diagonal
+        posX = diagonal.x;
+        posY = diagonal.y;
+        for (int i = 0; i < diagonal.size; i++) {
+            // dispatch changes
+            if ((mOldItemStatuses[posX] & FLAG_MASK) == FLAG_CHANGED) {
+                Object* changePayload = mCallback->getChangePayload(posX, posY);
+                batchingCallback.onChanged(posX, 1, changePayload);
+            }
+            posX++;
+            posY++;
+        }
+        // snap back for the next diagonal
+        posX = diagonal.x;
+        posY = diagonal.y;
+    }
+    batchingCallback.dispatchLastEvent();
+}
+
+bool DiffUtil::DiffResult::getPostponedUpdate(std::vector<PostponedUpdate>& postponedUpdates,
+        int posInList, bool removal, PostponedUpdate& out) {
+    auto it = postponedUpdates.begin();
+    for (; it != postponedUpdates.end(); it++) {
+        if ((it->posInOwnerList == posInList) && (it->removal == removal)) {
+            break;
+        }
+    }
+    if (it == postponedUpdates.end()) {
+        return false;
+    }
+    out = *it;
+    it = postponedUpdates.erase(it);
+    // re-offset all others
+    for (; it != postponedUpdates.end(); it++) {
+        it->currentPos += removal ? -1 : 1;
+    }
+    return true;
+}
+}/*endof namespace*/
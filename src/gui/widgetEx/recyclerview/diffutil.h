@@ -0,0 +1,118 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __DIFF_UTIL_H__
+#define __DIFF_UTIL_H__
+#include <vector>
+#include <widgetEx/recyclerview/listupdatecallback.h>
+namespace cdroid{
+/*Computes the shortest edit script between two lists with Myers' O(N+D^2) algorithm,
+ *plus an optional O(N^2) pass over the remaining items to find moves.
+ *The callbacks may run on a background thread,see AsyncListDiffer*/
+class DiffUtil{
+public:
+    class Callback {
+    public:
+        virtual ~Callback()=default;
+        virtual int getOldListSize()=0;
+        virtual int getNewListSize()=0;
+        /*whether the two positions hold the same item,e.g. same id*/
+        virtual bool areItemsTheSame(int oldItemPosition, int newItemPosition)=0;
+        /*only called for items that are the same,whether they display the same data*/
+        virtual bool areContentsTheSame(int oldItemPosition, int newItemPosition)=0;
+        /*optional partial bind payload for a changed item,passed to onChanged()*/
+        virtual Object* getChangePayload(int oldItemPosition, int newItemPosition){
+            return nullptr;
+        }
+    };
+
+    template<typename T>
+    class ItemCallback {
+    public:
+        virtual ~ItemCallback()=default;
+        virtual bool areItemsTheSame(const T& oldItem,const T& newItem)=0;
+        virtual bool areContentsTheSame(const T& oldItem,const T& newItem)=0;
+        virtual Object* getChangePayload(const T& oldItem,const T& newItem){
+            return nullptr;
+        }
+    };
+
+    class DiffResult;
+    static constexpr int NO_POSITION = -1;
+private:
+    struct Diagonal;
+    struct Snake;
+    struct Range;
+    class CenteredArray;
+    static bool midPoint(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, Snake& snake);
+    static bool forward(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, int d, Snake& snake);
+    static bool backward(const Range& range, Callback& cb, CenteredArray& forward, CenteredArray& backward, int d, Snake& snake);
+public:
+    /*the callback is only used until the returned result was dispatched*/
+    static DiffResult calculateDiff(Callback& cb, bool detectMoves = true);
+};
+
+struct DiffUtil::Diagonal {
+    int x;
+    int y;
+    int size;
+    int endX()const{ return x + size; }
+    int endY()const{ return y + size; }
+};
+
+class DiffUtil::DiffResult {
+private:
+    static constexpr int FLAG_NOT_CHANGED = 1;
+    static constexpr int FLAG_CHANGED = FLAG_NOT_CHANGED << 1;
+    static constexpr int FLAG_MOVED_CHANGED = FLAG_CHANGED << 1;
+    static constexpr int FLAG_MOVED_NOT_CHANGED = FLAG_MOVED_CHANGED << 1;
+    static constexpr int FLAG_MOVED = FLAG_MOVED_CHANGED | FLAG_MOVED_NOT_CHANGED;
+    static constexpr int FLAG_OFFSET = 4;
+    static constexpr int FLAG_MASK = (1 << FLAG_OFFSET) - 1;
+    struct PostponedUpdate {
+        int posInOwnerList;
+        int currentPos;
+        bool removal;
+    };
+    std::vector<Diagonal> mDiagonals;
+    /*matched position << FLAG_OFFSET | flags,0 for items without a match*/
+    std::vector<int> mOldItemStatuses;
+    std::vector<int> mNewItemStatuses;
+    Callback* mCallback;
+    int mOldListSize;
+    int mNewListSize;
+    bool mDetectMoves;
+    friend DiffUtil;
+private:
+    DiffResult(Callback* callback, std::vector<Diagonal>& diagonals, bool detectMoves);
+    void addEdgeDiagonals();
+    void findMatchingItems();
+    void findMoveMatches();
+    void findMatchingAddition(int posX);
+    static bool getPostponedUpdate(std::vector<PostponedUpdate>& postponedUpdates,
+            int posInList, bool removal, PostponedUpdate& out);
+public:
+    /*NO_POSITION if the item was removed*/
+    int convertOldPositionToNew(int oldListPosition)const;
+    /*NO_POSITION if the item was inserted*/
+    int convertNewPositionToOld(int newListPosition)const;
+    /*call it right after the adapter switched to the new list*/
+    void dispatchUpdatesTo(RecyclerView::Adapter* adapter);
+    void dispatchUpdatesTo(ListUpdateCallback& updateCallback);
+};
+}/*endof namespace*/
+#endif/*__DIFF_UTIL_H__*/
@@ -19,6 +19,8 @@
 #include <widgetEx/recyclerview/gapworker.h>
 #include <widgetEx/recyclerview/adapterhelper.h>
 #include <widgetEx/recyclerview/childhelper.h>
+#include <view/choreographer.h>
+#include <core/trace.h>
 namespace cdroid{
 
 GapWorker*GapWorker::sGapWorker = nullptr;
@@ -107,7 +109,6 @@ void GapWorker::LayoutPrefetchRegistryImpl::clearPrefetchPositions() {
 /////////////////////////////////////
 GapWorker::GapWorker(){
     mPostTimeNs = 0;
-    mFrameIntervalNs =0;
     mRunnable = [this](){run();};
 }
 
@@ -214,7 +215,9 @@ void GapWorker::buildTaskList() {
         }
     }
     // ... and priority sort
-    std::sort(mTasks.begin(),mTasks.end(), TaskComparator);
+    std::sort(mTasks.begin(),mTasks.end(),[](Task*lhs,Task*rhs){
+        return TaskComparator(lhs,rhs) < 0;
+    });
 }
 
 bool GapWorker::isPrefetchPositionAttached(RecyclerView* view, int position) {
@@ -242,9 +245,7 @@ void* GapWorker::prefetchPositionWithDeadline(RecyclerView* view,int position, i
 
     // FOREVER_NS is used as a deadline to force the work to occur now,
     // since it's needed next frame, even if it won't fit in gap
-    if (deadlineNs == RecyclerView::FOREVER_NS) {
-        LOGD("RV Prefetch forced - needed next frame");
-    }
+    ATRACE_NAME(deadlineNs == RecyclerView::FOREVER_NS ? "RV Prefetch forced - needed next frame" : "RV Prefetch");
     view->onEnterLayoutOrScroll();
     holder = recycler->tryGetViewHolderForPositionByDeadline(position, false, deadlineNs);
 
@@ -282,7 +283,7 @@ void GapWorker::prefetchInnerRecyclerViewWithDeadline(RecyclerView* innerView,in
     innerPrefetchRegistry->collectPrefetchPositionsFromView(innerView, true);
 
     if (innerPrefetchRegistry->mCount != 0) {
-        LOGD(deadlineNs == RecyclerView::FOREVER_NS ? "RV Nested Prefetch" : "RV Nested Prefetch forced - needed next frame");
+        ATRACE_NAME("RV Nested Prefetch");
         innerView->mState->prepareForNestedPrefetch(innerView->mAdapter);
         for (int i = 0; i < innerPrefetchRegistry->mCount * 2; i += 2) {
             // Note that we ignore immediate flag for inner items because
@@ -303,12 +304,18 @@ void GapWorker::flushTaskWithDeadline(Task* task, int64_t deadlineNs) {
 }
 
 void GapWorker::flushTasksWithDeadline(int64_t deadlineNs) {
+    bool outOfTime = false;
     for (int i = 0; i < mTasks.size(); i++) {
         Task* task = mTasks.at(i);
         if (task->view == nullptr) {
             break; // done with populated tasks
         }
-        flushTaskWithDeadline(task, deadlineNs);
+        // Tasks are sorted, once the gap is used up only optional work is left. Drop it,
+        // the next traversal collects the positions again.
+        outOfTime = outOfTime || (!task->neededNextFrame && (task->view->getNanoTime() >= deadlineNs));
+        if (!outOfTime) {
+            flushTaskWithDeadline(task, deadlineNs);
+        }
         task->clear();
     }
 }
@@ -319,9 +326,10 @@ void GapWorker::prefetch(int64_t deadlineNs) {
 }
 
 void GapWorker::run() {
+    // Cleared first, so that a later traversal can post again even if nothing was drawn yet
+    mPostTimeNs = 0;
 
-    // Query most recent vsync so we can predict next one. Note that drawing time not yet
-    // valid in animation/input callbacks, so query it here to be safe.
+    // Only prefetch for views that were drawn at least once
     const size_t size = mRecyclerViews.size();
     int64_t latestFrameVsyncMs = 0;
     for (int i = 0; i < size; i++) {
@@ -332,10 +340,11 @@ void GapWorker::run() {
     }
 
     if (latestFrameVsyncMs > 0) {
-        const int64_t nextFrameNs = latestFrameVsyncMs*1000000LL + mFrameIntervalNs;
+        // The frame clock knows when the next animation/scroll frame starts,
+        // the gap until then is all the time prefetch gets.
+        const int64_t nextFrameNs = Choreographer::getInstance().getNextFrameTimeNanos();
+        ATRACE_NAME("RV Gap Worker");
         prefetch(nextFrameNs);
-        // TODO: consider rescheduling self, if there's more work to do
-        mPostTimeNs = 0;
     }
 }
 
@@ -57,7 +57,6 @@ protected:
     static GapWorker* sGapWorker;// = new ThreadLocal<>();
     std::vector<RecyclerView*> mRecyclerViews;
     int64_t mPostTimeNs;
-    int64_t mFrameIntervalNs;
 
     static bool isPrefetchPositionAttached(RecyclerView* view, int position);
     /**
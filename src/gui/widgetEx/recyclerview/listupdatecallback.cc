@@ -0,0 +1,116 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#include <algorithm>
+#include <widgetEx/recyclerview/listupdatecallback.h>
+namespace cdroid{
+
+AdapterListUpdateCallback::AdapterListUpdateCallback(RecyclerView::Adapter* adapter)
+    :mAdapter(adapter){
+}
+
+void AdapterListUpdateCallback::onInserted(int position, int count) {
+    mAdapter->notifyItemRangeInserted(position, count);
+}
+
+void AdapterListUpdateCallback::onRemoved(int position, int count) {
+    mAdapter->notifyItemRangeRemoved(position, count);
+}
+
+void AdapterListUpdateCallback::onMoved(int fromPosition, int toPosition) {
+    mAdapter->notifyItemMoved(fromPosition, toPosition);
+}
+
+void AdapterListUpdateCallback::onChanged(int position, int count, Object* payload) {
+    mAdapter->notifyItemRangeChanged(position, count, payload);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
+BatchingListUpdateCallback::BatchingListUpdateCallback(ListUpdateCallback* callback)
+    :mWrapped(callback){
+    mLastEventType = TYPE_NONE;
+    mLastEventPosition = -1;
+    mLastEventCount = -1;
+    mLastEventPayload = nullptr;
+}
+
+void BatchingListUpdateCallback::dispatchLastEvent() {
+    switch (mLastEventType) {
+    case TYPE_NONE:
+        return;
+    case TYPE_ADD:
+        mWrapped->onInserted(mLastEventPosition, mLastEventCount);
+        break;
+    case TYPE_REMOVE:
+        mWrapped->onRemoved(mLastEventPosition, mLastEventCount);
+        break;
+    case TYPE_CHANGE:
+        mWrapped->onChanged(mLastEventPosition, mLastEventCount, mLastEventPayload);
+        break;
+    }
+    mLastEventPayload = nullptr;
+    mLastEventType = TYPE_NONE;
+}
+
+void BatchingListUpdateCallback::onInserted(int position, int count) {
+    if ((mLastEventType == TYPE_ADD) && (position >= mLastEventPosition)
+            && (position <= mLastEventPosition + mLastEventCount)) {
+        mLastEventCount += count;
+        mLastEventPosition = std::min(position, mLastEventPosition);
+        return;
+    }
+    dispatchLastEvent();
+    mLastEventPosition = position;
+    mLastEventCount = count;
+    mLastEventType = TYPE_ADD;
+}
+
+void BatchingListUpdateCallback::onRemoved(int position, int count) {
+    if ((mLastEventType == TYPE_REMOVE) && (mLastEventPosition >= position)
+            && (mLastEventPosition <= position + count)) {
+        mLastEventCount += count;
+        mLastEventPosition = position;
+        return;
+    }
+    dispatchLastEvent();
+    mLastEventPosition = position;
+    mLastEventCount = count;
+    mLastEventType = TYPE_REMOVE;
+}
+
+void BatchingListUpdateCallback::onMoved(int fromPosition, int toPosition) {
+    dispatchLastEvent(); // moves are not merged
+    mWrapped->onMoved(fromPosition, toPosition);
+}
+
+void BatchingListUpdateCallback::onChanged(int position, int count, Object* payload) {
+    if ((mLastEventType == TYPE_CHANGE) && !(position > mLastEventPosition + mLastEventCount
+            || position + count < mLastEventPosition || mLastEventPayload != payload)) {
+        // take potential overlap into account
+        const int previousEnd = mLastEventPosition + mLastEventCount;
+        mLastEventPosition = std::min(position, mLastEventPosition);
+        mLastEventCount = std::max(previousEnd, position + count) - mLastEventPosition;
+        return;
+    }
+    dispatchLastEvent();
+    mLastEventPosition = position;
+    mLastEventCount = count;
+    mLastEventPayload = payload;
+    mLastEventType = TYPE_CHANGE;
+}
+}/*endof namespace*/
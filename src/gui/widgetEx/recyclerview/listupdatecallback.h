@@ -0,0 +1,66 @@
+/*********************************************************************************
+ * Copyright (C) [2019] [houzh@msn.com]
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *********************************************************************************/
+#ifndef __LIST_UPDATE_CALLBACK_H__
+#define __LIST_UPDATE_CALLBACK_H__
+#include <widgetEx/recyclerview/recyclerview.h>
+namespace cdroid{
+/*Receives the changes DiffUtil::DiffResult::dispatchUpdatesTo() found between two lists*/
+class ListUpdateCallback{
+public:
+    virtual ~ListUpdateCallback()=default;
+    virtual void onInserted(int position, int count)=0;
+    virtual void onRemoved(int position, int count)=0;
+    virtual void onMoved(int fromPosition, int toPosition)=0;
+    virtual void onChanged(int position, int count, Object* payload)=0;
+};
+
+/*Forwards the changes to the notifyItemXXX() methods of a RecyclerView adapter*/
+class AdapterListUpdateCallback:public ListUpdateCallback{
+private:
+    RecyclerView::Adapter* mAdapter;
+public:
+    AdapterListUpdateCallback(RecyclerView::Adapter* adapter);
+    void onInserted(int position, int count)override;
+    void onRemoved(int position, int count)override;
+    void onMoved(int fromPosition, int toPosition)override;
+    void onChanged(int position, int count, Object* payload)override;
+};
+
+/*Merges consecutive events of the same kind into one range before passing them on.
+ *dispatchLastEvent() must be called once all the events are in*/
+class BatchingListUpdateCallback:public ListUpdateCallback{
+private:
+    static constexpr int TYPE_NONE = 0;
+    static constexpr int TYPE_ADD = 1;
+    static constexpr int TYPE_REMOVE = 2;
+    static constexpr int TYPE_CHANGE = 3;
+    ListUpdateCallback* mWrapped;
+    int mLastEventType;
+    int mLastEventPosition;
+    int mLastEventCount;
+    Object* mLastEventPayload;
+public:
+    BatchingListUpdateCallback(ListUpdateCallback* callback);
+    void dispatchLastEvent();
+    void onInserted(int position, int count)override;
+    void onRemoved(int position, int count)override;
+    void onMoved(int fromPosition, int toPosition)override;
+    void onChanged(int position, int count, Object* payload)override;
+};
+}/*endof namespace*/
+#endif/*__LIST_UPDATE_CALLBACK_H__*/
@@ -26,6 +26,7 @@
 #include <widgetEx/recyclerview/staggeredgridlayoutmanager.h>
 #include <widgetEx/recyclerview/recyclerviewaccessibilitydelegate.h>
 #include <widgetEx/recyclerview/fastscroller.h>
+#include <view/asyncinflater.h>
 #include <view/focusfinder.h>
 #include <utils/mathutils.h>
 #include <core/build.h>
@@ -746,6 +747,11 @@ RecyclerView::RecycledViewPool& RecyclerView::getRecycledViewPool() {
 }
 
 void RecyclerView::setRecycledViewPool(RecycledViewPool* pool) {
+    LOGD("This function is deprecated,USE setRecycledViewPool(std::shared_ptr<RecycledViewPool>).");
+    setRecycledViewPool(std::shared_ptr<RecycledViewPool>(pool));
+}
+
+void RecyclerView::setRecycledViewPool(std::shared_ptr<RecycledViewPool> pool) {
     mRecycler->setRecycledViewPool(pool);
 }
 
@@ -1923,19 +1929,8 @@ void RecyclerView::onAttachedToWindow() {
         // Register with gap worker
         mGapWorker = GapWorker::sGapWorker;//.get();
         if (mGapWorker == nullptr) {
+            // The frame deadline comes from Choreographer on every pass, no refresh rate to query
             mGapWorker = new GapWorker();
-
-            // break 60 fps assumption if data from display appears valid
-            // NOTE: we only do this query once, statically, because it's very expensive (> 1ms)
-            float refreshRate = 60.0f;
-            /*Display display = ViewCompat.getDisplay(this);
-            if (!isInEditMode() && display != null) {
-                float displayRefreshRate = display.getRefreshRate();
-                if (displayRefreshRate >= 30.0f) {
-                    refreshRate = displayRefreshRate;
-                }
-            }*/
-            mGapWorker->mFrameIntervalNs = (1000000000 / refreshRate);
             GapWorker::sGapWorker = mGapWorker;//.set(mGapWorker);
         }
         mGapWorker->add(this);
@@ -4057,9 +4052,11 @@ EdgeEffect* RecyclerView::EdgeEffectFactory::createEdgeEffect(RecyclerView& view
 /////////////RecycledViewPool///////////////////
 
 RecyclerView::RecycledViewPool::RecycledViewPool(){
+    mAlive = std::make_shared<bool>(true);
 }
 
 RecyclerView::RecycledViewPool::~RecycledViewPool(){
+    *mAlive = false;
     clear();
     for (int i = 0; i < mScrap.size(); i++) {
         ScrapData* data = mScrap.valueAt(i);
@@ -4083,6 +4080,7 @@ void RecyclerView::RecycledViewPool::setMaxRecycledViews(int viewType, int max)
     while (scrapHeap.size() > max) {
         ViewHolder*holder =  scrapHeap.back();
         scrapHeap.pop_back();
+        scrapData->mStats.evictions++;
         delete holder;
     }
 }
@@ -4092,23 +4090,17 @@ int RecyclerView::RecycledViewPool::getRecycledViewCount(int viewType) {
 }
 
 RecyclerView::ViewHolder* RecyclerView::RecycledViewPool::getRecycledView(int viewType) {
-    ScrapData* scrapData = mScrap.get(viewType);
-    if ( (scrapData != nullptr) && !scrapData->mScrapHeap.empty()) {
-        std::vector<ViewHolder*>& scrapHeap = scrapData->mScrapHeap;
-#if 1
-        for (int i = scrapHeap.size() - 1; i >= 0; i--) {
-            if (!scrapHeap.at(i)->isAttachedToTransitionOverlay()) {
-                ViewHolder*ret =scrapHeap.at(i);
-                scrapHeap.erase(scrapHeap.begin()+i);//remove(i);
-                return ret;
-            }
+    ScrapData* scrapData = getScrapDataForType(viewType);
+    std::vector<ViewHolder*>& scrapHeap = scrapData->mScrapHeap;
+    for (int i = scrapHeap.size() - 1; i >= 0; i--) {
+        if (!scrapHeap.at(i)->isAttachedToTransitionOverlay()) {
+            ViewHolder*ret =scrapHeap.at(i);
+            scrapHeap.erase(scrapHeap.begin()+i);//remove(i);
+            scrapData->mStats.hits++;
+            return ret;
         }
-#else
-        ViewHolder*ret = scrapHeap.back();
-        scrapHeap.pop_back();
-        return ret;
-#endif
     }
+    scrapData->mStats.misses++;
     return nullptr;
 }
 
@@ -4123,8 +4115,10 @@ int RecyclerView::RecycledViewPool::size() const{
 
 void RecyclerView::RecycledViewPool::putRecycledView(ViewHolder* scrap) {
     const int viewType = scrap->getItemViewType();
-    std::vector<ViewHolder*>& scrapHeap = getScrapDataForType(viewType)->mScrapHeap;
-    if (mScrap.get(viewType)->mMaxScrap <= scrapHeap.size()) {
+    ScrapData* scrapData = getScrapDataForType(viewType);
+    std::vector<ViewHolder*>& scrapHeap = scrapData->mScrapHeap;
+    if (scrapData->mMaxScrap <= scrapHeap.size()) {
+        scrapData->mStats.evictions++;
         delete scrap;//chenyang:)
         return;
     }
@@ -4147,6 +4141,7 @@ void RecyclerView::RecycledViewPool::factorInCreateTime(int viewType, int64_t cr
     ScrapData* scrapData = getScrapDataForType(viewType);
     scrapData->mCreateRunningAverageNs = runningAverage(
         scrapData->mCreateRunningAverageNs, createTimeNs);
+    scrapData->mStats.creations++;
 }
 
 void RecyclerView::RecycledViewPool::factorInBindTime(int viewType, int64_t bindTimeNs) {
@@ -4156,8 +4151,10 @@ void RecyclerView::RecycledViewPool::factorInBindTime(int viewType, int64_t bind
 }
 
 bool RecyclerView::RecycledViewPool::willCreateInTime(int viewType, int64_t approxCurrentNs, int64_t deadlineNs) {
-    const int64_t expectedDurationNs = getScrapDataForType(viewType)->mCreateRunningAverageNs;
-    return (expectedDurationNs == 0) || (approxCurrentNs + expectedDurationNs < deadlineNs);
+    // A holder created now only pays off in this pass if it can be bound too
+    const ScrapData* scrapData = getScrapDataForType(viewType);
+    const int64_t expectedDurationNs = scrapData->mCreateRunningAverageNs + scrapData->mBindRunningAverageNs;
+    return (scrapData->mCreateRunningAverageNs == 0) || (approxCurrentNs + expectedDurationNs < deadlineNs);
 }
 
 bool RecyclerView::RecycledViewPool::willBindInTime(int viewType, int64_t approxCurrentNs, int64_t deadlineNs) {
@@ -4213,6 +4210,53 @@ RecyclerView::RecycledViewPool::ScrapData* RecyclerView::RecycledViewPool::getSc
     return scrapData;
 }
 
+RecyclerView::RecycledViewPool::Stats RecyclerView::RecycledViewPool::getStats(int viewType)const{
+    const ScrapData* scrapData = mScrap.get(viewType);
+    return scrapData ? scrapData->mStats : Stats();
+}
+
+RecyclerView::RecycledViewPool::Stats RecyclerView::RecycledViewPool::getStats()const{
+    Stats total;
+    for (int i = 0; i < mScrap.size(); i++) {
+        const Stats& stats = mScrap.valueAt(i)->mStats;
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.creations += stats.creations;
+        total.evictions += stats.evictions;
+    }
+    return total;
+}
+
+void RecyclerView::RecycledViewPool::resetStats() {
+    for (int i = 0; i < mScrap.size(); i++) {
+        mScrap.valueAt(i)->mStats = Stats();
+    }
+}
+
+void RecyclerView::RecycledViewPool::prefill(AsyncLayoutInflater& inflater,const std::string& resource,
+        ViewGroup* parent,int viewType,int count,const HolderFactory& factory) {
+    std::shared_ptr<bool> alive = mAlive;
+    for (int i = 0; i < count; i++) {
+        inflater.inflate(resource, parent, [this,alive,viewType,factory](View*view,const std::string&,ViewGroup*) {
+            ScrapData* scrapData = *alive ? getScrapDataForType(viewType) : nullptr;
+            if ((scrapData == nullptr) || (scrapData->mScrapHeap.size() >= scrapData->mMaxScrap)) {
+                delete view;
+                return;
+            }
+            ViewHolder* holder = factory(view);
+            holder->mItemViewType = viewType;
+            scrapData->mStats.creations++;
+            putRecycledView(holder);
+        });
+    }
+}
+
+std::shared_ptr<RecyclerView::RecycledViewPool> RecyclerView::RecycledViewPool::getSharedPool() {
+    // never deleted, its holders may outlive any RecyclerView
+    static std::shared_ptr<RecycledViewPool> sSharedPool(new RecycledViewPool(),[](RecycledViewPool*){});
+    return sSharedPool;
+}
+
 //////////////*endofRecycledViewPool*//////////////////
 RecyclerView* RecyclerView::findNestedRecyclerView(View* view) {
     if (dynamic_cast<ViewGroup*>(view)==nullptr){// instanceof ViewGroup)) {
@@ -4268,11 +4312,14 @@ RecyclerView::Recycler::Recycler(RecyclerView*rv){
     mRV = rv;
     mViewCacheMax = DEFAULT_CACHE_SIZE;
     mChangedScrap = nullptr;
-    mRecyclerPool = nullptr;
 }
 
 RecyclerView::Recycler::~Recycler(){
-    delete mRecyclerPool;
+    if (mRecyclerPool && (mRV->mAdapter != nullptr)) {
+        // a shared pool outlives us,it must forget our adapter
+        poolingContainerDetach(mRV->mAdapter);
+        mRecyclerPool->detach();
+    }
     delete mChangedScrap;
 }
 
@@ -5026,7 +5073,7 @@ void RecyclerView::Recycler::setViewCacheExtension(const ViewCacheExtension& ext
     mViewCacheExtension = extension;
 }
 
-void RecyclerView::Recycler::setRecycledViewPool(RecycledViewPool* pool) {
+void RecyclerView::Recycler::setRecycledViewPool(std::shared_ptr<RecycledViewPool> pool) {
     poolingContainerDetach(mRV->mAdapter);
     if (mRecyclerPool != nullptr) {
         mRecyclerPool->detach();
@@ -5069,7 +5116,7 @@ void RecyclerView::Recycler::onDetachedFromWindow() {
 
 RecyclerView::RecycledViewPool& RecyclerView::Recycler::getRecycledViewPool() {
     if (mRecyclerPool == nullptr) {
-        mRecyclerPool = new RecycledViewPool();
+        mRecyclerPool = std::make_shared<RecycledViewPool>();
         maybeSendPoolingContainerAttach();
     }
     return *mRecyclerPool;
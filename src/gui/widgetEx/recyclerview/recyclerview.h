@@ -31,6 +31,7 @@ class ViewInfoStore;
 class GapWorker;
 class GridLayoutManager;
 class RecyclerViewAccessibilityDelegate;
+class AsyncLayoutInflater;
 
 class RecyclerView:public ViewGroup{
 private:
@@ -454,6 +455,9 @@ public:
     void setOnFlingListener(const OnFlingListener& onFlingListener);
     OnFlingListener getOnFlingListener();
     RecycledViewPool& getRecycledViewPool();
+    /*a pool may be given to several RecyclerViews,the last one holding it deletes it*/
+    void setRecycledViewPool(std::shared_ptr<RecycledViewPool> pool);
+    [[deprecated("This function is deprecated,USE std::shared_ptr version.")]]
     void setRecycledViewPool(RecycledViewPool* pool);
     void setViewCacheExtension(const ViewCacheExtension& extension);
     void setItemViewCacheSize(int size);
@@ -899,7 +903,19 @@ protected:
     virtual EdgeEffect* createEdgeEffect(RecyclerView& view,int direction);
 };
 
+/*A pool may be shared by several RecyclerViews (nested or sibling lists using the same
+ *item layouts),their adapters must then agree on what each view type means.
+ *getSharedPool() is a process wide instance meant for that,used on the UI thread only*/
 class RecyclerView::RecycledViewPool{
+public:
+    /*hits/misses count getRecycledView() results,evictions the holders dropped over capacity*/
+    struct Stats{
+        int hits = 0;
+        int misses = 0;
+        int creations = 0;
+        int evictions = 0;
+    };
+    using HolderFactory = std::function<ViewHolder*(View*)>;
 private:
     friend RecyclerView::Recycler;
 protected:
@@ -909,10 +925,12 @@ protected:
         int mMaxScrap = DEFAULT_MAX_SCRAP;
         int64_t mCreateRunningAverageNs = 0;
         int64_t mBindRunningAverageNs = 0;
+        Stats mStats;
     };
     SparseArray<ScrapData*> mScrap;
     int mAttachCountForClearing = 0;
     std::set<Adapter*> mAttachedAdaptersForPoolingContainer;
+    std::shared_ptr<bool> mAlive;/*checked by the pending prefill() callbacks*/
 
     int size()const;
     int64_t runningAverage(int64_t oldAverage, int64_t newValue);
@@ -935,6 +953,14 @@ public:
     int getRecycledViewCount(int viewType);
     ViewHolder* getRecycledView(int viewType);
     void putRecycledView(ViewHolder* scrap);
+    Stats getStats(int viewType)const;
+    Stats getStats()const;/*summed over all view types*/
+    void resetStats();
+    /*inflates count item views of viewType on the inflater's background thread,factory wraps
+     *each of them into a ViewHolder on the UI thread.Stops once the type's capacity is reached*/
+    void prefill(AsyncLayoutInflater& inflater,const std::string& resource,ViewGroup* parent,
+            int viewType,int count,const HolderFactory& factory);
+    static std::shared_ptr<RecycledViewPool> getSharedPool();
 };
 
 class RecyclerView::Recycler{
@@ -957,7 +983,7 @@ protected:
     std::vector<ViewHolder*> mAttachedScrap;
     std::vector<ViewHolder*>* mChangedScrap;
     std::vector<ViewHolder*> mCachedViews;
-    RecycledViewPool* mRecyclerPool;
+    std::shared_ptr<RecycledViewPool> mRecyclerPool;
     void updateViewCacheSize();
     bool validateViewHolderForOffsetPosition(ViewHolder* holder);
     View* getViewForPosition(int position, bool dryRun);
@@ -982,7 +1008,7 @@ protected:
     void offsetPositionRecordsForInsert(int insertedAt, int count);
     void offsetPositionRecordsForRemove(int removedFrom, int count, bool applyToPreLayout);
     void setViewCacheExtension(const ViewCacheExtension& extension);
-    void setRecycledViewPool(RecycledViewPool* pool);
+    void setRecycledViewPool(std::shared_ptr<RecycledViewPool> pool);
     RecycledViewPool& getRecycledViewPool();
     void viewRangeUpdate(int positionStart, int itemCount);
     void markKnownViewsInvalid();
@@ -1012,6 +1038,7 @@ private:
     friend GapWorker;
     friend RecyclerView;
     friend RecyclerView::ItemAnimator;
+    friend RecyclerView::RecycledViewPool;
     int mFlags;
     int mIsRecyclableCount = 0;
     int mWasImportantForAccessibilityBeforeHidden=View::IMPORTANT_FOR_ACCESSIBILITY_AUTO;
@@ -1159,7 +1159,7 @@ int StaggeredGridLayoutManager::fill(RecyclerView::Recycler& recycler, LayoutSta
 
     updateAllRemainingSpans(layoutState.mLayoutDirection, targetLine);
     LOGD_IF(_Debug,"FILLING targetLine: %d,remaining spans:%p, state:%p",
-            targetLine,mRemainingSpans,layoutState);
+            targetLine,mRemainingSpans,&layoutState);
 
     // the default coordinate to add new view.
     const int defaultNewViewLine = mShouldReverseLayout
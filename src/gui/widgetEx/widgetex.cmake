@@ -24,6 +24,9 @@ SET(WIDGETEX_SOURCES
     widgetEx/recyclerview/gapworker.cc
     #widgetEx/recyclerview/carousellayoutmanager.cc
     widgetEx/recyclerview/adapterhelper.cc
+    widgetEx/recyclerview/diffutil.cc
+    widgetEx/recyclerview/listupdatecallback.cc
+    widgetEx/recyclerview/asynclistdiffer.cc
     widgetEx/viewgrouputils.cc
 )
 endif()
@@ -108,4 +108,12 @@ INT InputInjectEvents(const INPUTEVENT*events,UINT count,DWORD timeout){
     return count;
 }
 
+INT InputGetDeviceFds(int*fds,UINT maxfds){
+    return 0;/*only polled by InputGetEvents*/
+}
+
+INT InputReadEvents(int fd,INPUTEVENT*outevents,UINT max){
+    return E_ERROR;
+}
+
 
@@ -184,3 +184,11 @@ INT InputGetEvents(INPUTEVENT*outevents,UINT max,DWORD timeout){
     return e-outevents;
 }
 
+
+INT InputGetDeviceFds(int*fds,UINT maxfds){
+    return 0;/*only polled by InputGetEvents*/
+}
+
+INT InputReadEvents(int fd,INPUTEVENT*outevents,UINT max){
+    return E_ERROR;
+}
@@ -1,10 +1,11 @@
 #include <cdlog.h>
+#include <cdlogformat.h>
 #include <cstdio>
 #include <string.h>
 #include <time.h>
 #include <string>
 #include <map>
-#include <shared_queue.h>
+#include <mutex>
 #include <iomanip>
 #include <android/log.h>
 #if defined(__Linux__)||defined(__unix__)
@@ -35,9 +36,8 @@ static std::string splitFileName(const std::string& str) {
 }
 
 static std::map<const std::string,int>sModules;
-static shared_queue<std::string>dbgMessages;
+static std::mutex sModulesLock;
 static constexpr int kMaxMessageSize=2048;
-static char msgBoddy[kMaxMessageSize];
 static int cdlog2a(int level){
     switch(level){
     /** Verbose logging. Should typically be disabled for a release apk. */
@@ -52,27 +52,65 @@ static int cdlog2a(int level){
     return ANDROID_LOG_UNKNOWN;
 }
 
-static void LogInit() {
+static int LogModuleLevel(const char*file){
+    const char*tag;
+    const int tagLen = cdlog::LogGetTag(file,&tag);
+    std::lock_guard<std::mutex>lock(sModulesLock);
+    auto it = sModules.find(std::string(tag,tagLen));
+    return (it==sModules.end())?sLogLevel:it->second;
 }
 
-void LogPrintf(int level,const char*file,const char*func,int line,const char*format,...) {
-    va_list args;
-    const std::string tag=splitFileName(file);
-    auto it = sModules.find(tag);
-    const int module_loglevel=(it==sModules.end())?sLogLevel:it->second;
-    if(level<module_loglevel||level<0||level>LOG_FATAL)
-        return;
-    LogInit();
+/*logd is asynchronous already,messages are formatted right away*/
+static void LogOutput(int level,const char*file,const char*func,int line,const char*text){
     const char*colors[]= {"\033[0m","\033[1m","\033[0;32m","\033[0;36m","\033[1;31m","\033[5;31m"};
+    const char*tag;
+    const int tagLen = cdlog::LogGetTag(file,&tag);
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC,&ts);
-    int len1=snprintf(msgBoddy,kMaxMessageSize,"%010ld.%06ld \033[0;32m[%s]\033[0;34m \%s:%d %s",
-                      ts.tv_sec,ts.tv_nsec/1000, tag.c_str(),func,line, colors[level]);
+    __android_log_print(cdlog2a(level),file,"%010ld.%06ld \033[0;32m[%.*s]\033[0;34m %s:%d %s%s\033[0m\r\n",
+                      ts.tv_sec,ts.tv_nsec/1000,tagLen,tag,func,line,colors[level],text);
+}
+
+namespace cdlog{
+std::atomic<int>sLogSerial(1);
+
+LogArgs&threadLogArgs(){
+    thread_local LogArgs args;
+    return args;
+}
+
+void resolveLogSite(LogSite&site){
+    const int serial = sLogSerial.load(std::memory_order_acquire);
+    site.level.store(LogModuleLevel(site.file),std::memory_order_relaxed);
+    site.serial.store(serial,std::memory_order_release);
+}
+
+void LogCommit(const LogSite&site,int level,const char*format,const LogArgs&args){
+    char msg[kMaxMessageSize];
+    if((level<0)||(level>LOG_FATAL))return;
+    msg[0] = 0;
+    if(format==nullptr){/*the format was copied in front of the arguments*/
+        LogArgReader reader(args);
+        if(reader.next())LogFormatArgs(msg,kMaxMessageSize,reader.str,reader);
+    }else
+        LogFormatArgs(msg,kMaxMessageSize,format,args);
+    LogOutput(level,site.file,site.func,site.line,msg);
+}
+}/*endof namespace cdlog*/
+
+unsigned int LogFlush(){
+    return 0;
+}
+
+void LogPrintf(int level,const char*file,const char*func,int line,const char*format,...) {
+    va_list args;
+    char msg[kMaxMessageSize];
+    if(level<LogModuleLevel(file)||level<0||level>LOG_FATAL)
+        return;
     va_start(args, format);
-    len1+=vsnprintf(msgBoddy+len1,kMaxMessageSize-len1,format, args);
+    vsnprintf(msg,kMaxMessageSize,format, args);
     va_end(args);
-    strcat(msgBoddy+len1,"\033[0m\r\n");
-    __android_log_print(cdlog2a(level),file,"%s",msgBoddy);
+    LogOutput(level,file,func,line,msg);
 }
 
 void LogDump(int level,const char*tag,const char*func,int line,const char*label,const unsigned char*data,int len) {
@@ -89,6 +127,7 @@ void LogDump(int level,const char*tag,const char*func,int line,const char*label,
 }
 
 void LogSetModuleLevel(const char*module,int level) {
+    std::lock_guard<std::mutex>lock(sModulesLock);
     if(module==NULL) {
         sLogLevel=(LogLevel)level;
         for(auto it=sModules.begin(); it!=sModules.end(); it++) {
@@ -98,6 +137,7 @@ void LogSetModuleLevel(const char*module,int level) {
         std::string tag=splitFileName(module);
         sModules[tag]=level;
     }
+    cdlog::sLogSerial.fetch_add(1,std::memory_order_acq_rel);
 }
 
 void LogParseModule(const char*log) {
@@ -143,32 +183,19 @@ void LogParseModules(int argc,const char*argv[]) {
 
 namespace cdlog {
 static const std::string kTruncatedWarningText = "[...truncated...]";
-LogMessage::LogMessage(const std::string& file, const int line, const std::string& function,int level)
-    : file_(splitFileName(file)),function_(function), line_(line),level_message(level) {
+LogMessage::LogMessage(const char*file, const int line, const char*function,int level)
+    : file_(file),line_(line),function_(function),level_message(level) {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC,&ts);
     timestamp_ = ts.tv_sec;
     timeusec_ = ts.tv_nsec/1000 ;
-    LogInit();
-    const std::string tag=splitFileName(file);
-    auto it = sModules.find(tag);
-    level_module=(it==sModules.end())?sLogLevel:it->second;
+    level_module = LogModuleLevel(file);
 }
 
 LogMessage::~LogMessage() {
-    std::ostringstream oss;
-    static const char*colors[]= {"\033[0m","\033[1m","\033[0;32m","\033[0;36m","\033[1;31m","\033[0;31m"};
-
     if(level_message>=level_module) {
-        oss << std::setw(10) <<std::setfill('0')<< (timestamp_) << "." << std::setw(6) << (timeusec_);
-        oss << " \033[0;32m[" << file_<<"]\033[0;34m ";
-        oss << function_<<":" << line_ <<" "<<colors[level_message];
-
-        const std::string str(stream_.str());
-        if (!str.empty()) oss << str ;
-        log_entry_ += oss.str();
-        log_entry_ +="\033[0m\n";
-        __android_log_print(cdlog2a(level_message),file_.c_str(),"%s",log_entry_.c_str());
+        log_entry_ = stream_.str();
+        LogOutput(level_message,file_,function_,line_,log_entry_.c_str());
     }
 }
 
@@ -188,7 +215,7 @@ void LogMessage::messageSave(const char* format, ...) {
         }
     }
 }
-FatalMessage::FatalMessage(const std::string& file, const int line, const std::string& function,int signal)
+FatalMessage::FatalMessage(const char*file, const int line, const char*function,int signal)
     :LogMessage(file,line,function,LOG_FATAL),signal_(signal) {
     const size_t max_dump_size = 50;
     void* dump[max_dump_size];
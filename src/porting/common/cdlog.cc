@@ -1,10 +1,15 @@
 #include <cdlog.h>
+#include <cdlogformat.h>
 #include <cstdio>
 #include <string.h>
 #include <time.h>
 #include <string>
 #include <map>
-#include <shared_queue.h>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
 #include <iomanip>
 #if HAVE_SYS_PRCTL_H
 #include <sys/prctl.h>
@@ -24,11 +29,6 @@
 #ifdef HAVE_EXECINFO_H
 #include <execinfo.h>
 #endif
-#if !defined(NDEBUG)
-#define ASYNC_LOG 0
-#else
-#define ASYNC_LOG 1
-#endif
 static LogLevel sLogLevel=LOG_DEBUG;
 #if defined(_WIN32)||defined(_WIN64)||defined(_MSVC_VER)
 #include <Windows.h>
@@ -56,12 +56,115 @@ static std::string splitFileName(const std::string& str) {
 }
 
 static std::map<const std::string,int>sModules;
-static shared_queue<std::string>dbgMessages;
+static std::mutex sModulesLock;
 static constexpr int kMaxMessageSize=2048;
-static char msgBoddy[kMaxMessageSize];
+
+/*Messages are queued in a bounded lock free MPSC ring(Vyukov's sequence scheme)
+ *and formatted by the log thread.A full ring drops the message and counts it,
+ *the caller never blocks nor allocates*/
+namespace{
+struct LogRecord{
+    const char*file;
+    const char*func;
+    const char*format;
+    long sec;
+    long usec;
+    int line;
+    int level;
+    cdlog::LogArgs args;
+};
+struct LogSlot{
+    std::atomic<size_t>seq;/*stored relative to the slot index so zero means free in lap 0*/
+    LogRecord record;
+};
+constexpr size_t kRingSize = 512;/*must be a power of 2*/
+LogSlot sRing[kRingSize];
+std::atomic<size_t>sEnqueuePos(0);
+size_t sDequeuePos = 0;
+std::mutex sConsumerLock;/*the log thread and LogFlush take turns as the single consumer*/
+std::atomic<unsigned int>sDropped(0);
+unsigned int sDroppedReported = 0;
+std::atomic<bool>sConsumerSleeping(false);
+std::mutex sWakeLock;
+std::condition_variable sWakeCond;
+thread_local LogRecord tRecord;/*per thread staging buffer*/
+}
+
+namespace cdlog{
+std::atomic<int>sLogSerial(1);
+}
+
+static size_t slotSeq(size_t index){
+    return sRing[index].seq.load(std::memory_order_acquire)+index;
+}
+
+static bool LogEnqueue(const LogRecord&r){
+    size_t pos = sEnqueuePos.load(std::memory_order_relaxed);
+    for(;;){
+        const size_t index = pos&(kRingSize-1);
+        const intptr_t diff = intptr_t(slotSeq(index))-intptr_t(pos);
+        if(diff==0){
+            if(sEnqueuePos.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed))
+                break;
+        }else if(diff<0){
+            sDropped.fetch_add(1,std::memory_order_relaxed);
+            return false;
+        }else{
+            pos = sEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    const size_t index = pos&(kRingSize-1);
+    LogRecord&dst = sRing[index].record;
+    memcpy(&dst,&r,offsetof(LogRecord,args)+offsetof(cdlog::LogArgs,data)+r.args.size);
+    sRing[index].seq.store(pos+1-index,std::memory_order_release);
+    if(sConsumerSleeping.exchange(false,std::memory_order_acq_rel))
+        sWakeCond.notify_one();
+    return true;
+}
+
+static void LogOutput(const LogRecord&r){
+    static const char*colors[]= {"\033[0m","\033[1m","\033[0;32m","\033[0;36m","\033[1;31m","\033[5;31m"};
+    char msg[kMaxMessageSize];
+    const char*tag;
+    const int tagLen = cdlog::LogGetTag(r.file,&tag);
+    int len = snprintf(msg,kMaxMessageSize,"%010ld.%06ld \033[0;32m[%.*s]\033[0;34m %s:%d %s",
+                      r.sec,r.usec,tagLen,tag,r.func,r.line,colors[r.level]);
+    if(r.format==nullptr){/*the format was copied in front of the arguments*/
+        cdlog::LogArgReader reader(r.args);
+        if(reader.next())len += cdlog::LogFormatArgs(msg+len,kMaxMessageSize-len-8,reader.str,reader);
+    }else
+        len += cdlog::LogFormatArgs(msg+len,kMaxMessageSize-len-8,r.format,r.args);
+    if(r.args.truncated)len += snprintf(msg+len,kMaxMessageSize-len,"...");
+    snprintf(msg+len,kMaxMessageSize-len,"\033[0m\n");
+    fputs(msg,stdout);
+}
+
+/*caller holds sConsumerLock*/
+static bool LogEmpty(){
+    const size_t index = sDequeuePos&(kRingSize-1);
+    return intptr_t(slotSeq(index))-intptr_t(sDequeuePos+1)<0;
+}
+
+/*caller holds sConsumerLock*/
+static int LogDrain(){
+    int count = 0;
+    while(!LogEmpty()){
+        const size_t index = sDequeuePos&(kRingSize-1);
+        LogOutput(sRing[index].record);
+        sRing[index].seq.store(sDequeuePos+kRingSize-index,std::memory_order_release);
+        sDequeuePos++;
+        count++;
+    }
+    const unsigned int dropped = sDropped.load(std::memory_order_relaxed);
+    if(dropped!=sDroppedReported){
+        printf("\033[1;31m[%u log messages dropped]\033[0m\n",dropped-sDroppedReported);
+        sDroppedReported = dropped;
+    }
+    if(count)fflush(stdout);
+    return count;
+}
 
 static void LogInit() {
-#if defined(ASYNC_LOG)&&ASYNC_LOG
     static std::once_flag sInit;
     std::call_once(sInit,[&]() {
         std::thread th([]() {
@@ -71,39 +174,112 @@ static void LogInit() {
             pthread_setname_np(pthread_self(), "LogThread");
 #endif
             while(1) {
-                std::string msg;
-                if(dbgMessages.size()==0)dbgMessages.wait_and_pop(msg,INT_MAX);
-                else dbgMessages.try_and_pop(msg);
-                std::cout<<msg;
+                bool empty;
+                {
+                    std::lock_guard<std::mutex>lock(sConsumerLock);
+                    LogDrain();
+                }
+                /*producers only notify when we are about to sleep,the timeout covers a missed wakeup*/
+                std::unique_lock<std::mutex>lock(sWakeLock);
+                sConsumerSleeping.store(true,std::memory_order_seq_cst);
+                {
+                    std::lock_guard<std::mutex>lock(sConsumerLock);
+                    empty = LogEmpty();
+                }
+                if(empty)
+                    sWakeCond.wait_for(lock,std::chrono::milliseconds(50));
+                sConsumerSleeping.store(false,std::memory_order_relaxed);
             }
         });
         th.detach();
+        atexit([](){LogFlush();});
     });
-#endif
+}
+
+static void LogCommitText(const char*file,const char*func,int line,int level,const char*text,size_t len){
+    /*long texts are split over several records*/
+    const size_t chunk = cdlog::LogArgs::kCapacity-sizeof(void*)-2;
+    LogInit();
+    do{
+        LogRecord&r = tRecord;
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC,&ts);
+        r.file = file;
+        r.func = func;
+        r.line = line;
+        r.level= level;
+        r.sec  = ts.tv_sec;
+        r.usec = ts.tv_nsec/1000;
+        r.format = "%s";
+        r.args.clear();
+        const size_t n = len<chunk?len:chunk;
+        r.args.putString(text,n);
+        LogEnqueue(r);
+        text += n;
+        len -= n;
+    }while(len);
+}
+
+namespace cdlog{
+LogArgs&threadLogArgs(){
+    return tRecord.args;
+}
+
+void resolveLogSite(LogSite&site){
+    const int serial = sLogSerial.load(std::memory_order_acquire);
+    const char*tag;
+    const int tagLen = LogGetTag(site.file,&tag);
+    int level = sLogLevel;
+    {
+        std::lock_guard<std::mutex>lock(sModulesLock);
+        auto it = sModules.find(std::string(tag,tagLen));
+        if(it!=sModules.end())level = it->second;
+    }
+    site.level.store(level,std::memory_order_relaxed);
+    site.serial.store(serial,std::memory_order_release);
+}
+
+void LogCommit(const LogSite&site,int level,const char*format,const LogArgs&args){
+    if((level<0)||(level>LOG_FATAL))return;
+    LogInit();
+    LogRecord&r = tRecord;/*args were captured into tRecord.args by LogDeferred*/
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    r.file = site.file;
+    r.func = site.func;
+    r.line = site.line;
+    r.level= level;
+    r.sec  = ts.tv_sec;
+    r.usec = ts.tv_nsec/1000;
+    r.format = format;
+    if(&args!=&r.args)r.args = args;
+    LogEnqueue(r);
+}
+}/*endof namespace cdlog*/
+
+unsigned int LogFlush(){
+    std::lock_guard<std::mutex>lock(sConsumerLock);
+    LogDrain();
+    return sDropped.load(std::memory_order_relaxed);
 }
 
 void LogPrintf(int level,const char*file,const char*func,int line,const char*format,...) {
     va_list args;
-    const std::string tag=splitFileName(file);
-    auto it = sModules.find(tag);
-    const int module_loglevel=(it==sModules.end())?sLogLevel:it->second;
+    int module_loglevel = sLogLevel;
+    {
+        const char*tag;
+        const int tagLen = cdlog::LogGetTag(file,&tag);
+        std::lock_guard<std::mutex>lock(sModulesLock);
+        auto it = sModules.find(std::string(tag,tagLen));
+        if(it!=sModules.end())module_loglevel = it->second;
+    }
     if(level<module_loglevel||level<0||level>LOG_FATAL)
         return;
-    LogInit();
-    const char*colors[]= {"\033[0m","\033[1m","\033[0;32m","\033[0;36m","\033[1;31m","\033[5;31m"};
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC,&ts);
-    int len1=snprintf(msgBoddy,kMaxMessageSize,"%010ld.%06ld \033[0;32m[%s]\033[0;34m \%s:%d %s",
-                      ts.tv_sec,ts.tv_nsec/1000, tag.c_str(),func,line, colors[level]);
+    char msg[kMaxMessageSize];/*C callers can't defer their va_list,format here*/
     va_start(args, format);
-    len1+=vsnprintf(msgBoddy+len1,kMaxMessageSize-len1,format, args);
+    vsnprintf(msg,kMaxMessageSize,format, args);
     va_end(args);
-    strcat(msgBoddy+len1,"\033[0m\r\n");
-#if defined(ASYNC_LOG )&&ASYNC_LOG
-    dbgMessages.push(msgBoddy);
-#else
-    printf("%s",msgBoddy);
-#endif
+    LogCommitText(file,func,line,level,msg,strlen(msg));
 }
 
 void LogDump(int level,const char*tag,const char*func,int line,const char*label,const unsigned char*data,int len) {
@@ -120,6 +296,7 @@ void LogDump(int level,const char*tag,const char*func,int line,const char*label,
 }
 
 void LogSetModuleLevel(const char*module,int level) {
+    std::lock_guard<std::mutex>lock(sModulesLock);
     if(module==NULL) {
         sLogLevel=(LogLevel)level;
         for(auto it=sModules.begin(); it!=sModules.end(); it++) {
@@ -129,6 +306,7 @@ void LogSetModuleLevel(const char*module,int level) {
         std::string tag=splitFileName(module);
         sModules[tag]=level;
     }
+    cdlog::sLogSerial.fetch_add(1,std::memory_order_acq_rel);/*call sites resolve their level again*/
 }
 
 void LogParseModule(const char*log) {
@@ -174,36 +352,23 @@ void LogParseModules(int argc,const char*argv[]) {
 
 namespace cdlog {
 static const std::string kTruncatedWarningText = "[...truncated...]";
-LogMessage::LogMessage(const std::string& file, const int line, const std::string& function,int level)
-    : file_(splitFileName(file)),function_(function), line_(line),level_message(level) {
+LogMessage::LogMessage(const char*file, const int line, const char*function,int level)
+    : file_(file),line_(line),function_(function),level_message(level) {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC,&ts);
     timestamp_ = ts.tv_sec;
     timeusec_ = ts.tv_nsec/1000 ;
-    LogInit();
-    const std::string tag=splitFileName(file);
-    auto it = sModules.find(tag);
-    level_module=(it==sModules.end())?sLogLevel:it->second;
+    LogSite site(file,function,line);
+    resolveLogSite(site);
+    level_module = site.level;
 }
 
 LogMessage::~LogMessage() {
-    std::ostringstream oss;
-    static const char*colors[]= {"\033[0m","\033[1m","\033[0;32m","\033[0;36m","\033[1;31m","\033[0;31m"};
-
     if(level_message>=level_module) {
-        oss << std::setw(10) <<std::setfill('0')<< (timestamp_) << "." << std::setw(6) << (timeusec_);
-        oss << " \033[0;32m[" << file_<<"]\033[0;34m ";
-        oss << function_<<":" << line_ <<" "<<colors[level_message];
-
-        const std::string str(stream_.str());
-        if (!str.empty()) oss << str ;
-        log_entry_ += oss.str();
-        log_entry_ +="\033[0m\n";
-#if defined(ASYNC_LOG)&&ASYNC_LOG
-        dbgMessages.push(log_entry_);
-#else
-	printf("%s",log_entry_.c_str());
-#endif
+        log_entry_ = stream_.str();
+        LogCommitText(file_,function_,line_,level_message,log_entry_.c_str(),log_entry_.size());
+        if(level_message==LOG_FATAL)
+            LogFlush();
     }
 }
 
@@ -223,7 +388,7 @@ void LogMessage::messageSave(const char* format, ...) {
         }
     }
 }
-FatalMessage::FatalMessage(const std::string& file, const int line, const std::string& function,int signal)
+FatalMessage::FatalMessage(const char*file, const int line, const char*function,int signal)
     :LogMessage(file,line,function,LOG_FATAL),signal_(signal) {
     const size_t max_dump_size = 50;
     void* dump[max_dump_size];
@@ -0,0 +1,176 @@
+#ifndef __CDLOG_FORMAT_H__
+#define __CDLOG_FORMAT_H__
+#include <cdlog.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+/*Formats the arguments captured by cdlog::LogArgs against their printf format.
+ *Every conversion is rebuilt with a length modifier matching the stored value,
+ *so arguments can be formatted later on another thread*/
+namespace cdlog{
+
+class LogArgReader{
+private:
+    const char*mPos;
+    const char*mEnd;
+public:
+    char type;
+    uint8_t size;
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void*ptr;
+    const char*str;
+    LogArgReader(const LogArgs&args):mPos(args.data),mEnd(args.data+args.size),
+        type(0),size(0),i(0),u(0),d(0),ptr(nullptr),str(nullptr){}
+    bool next(){
+        if(mPos>=mEnd)return false;
+        type = *mPos++;
+        switch(type){
+        case LogArgs::ARG_INT:
+        case LogArgs::ARG_UINT:
+            size = uint8_t(*mPos++);
+            memcpy(&u,mPos,sizeof(u));
+            i = int64_t(u);
+            mPos += sizeof(u);
+            break;
+        case LogArgs::ARG_DOUBLE:
+            memcpy(&d,mPos,sizeof(d));
+            mPos += sizeof(d);
+            break;
+        case LogArgs::ARG_POINTER:
+            memcpy(&ptr,mPos,sizeof(ptr));
+            mPos += sizeof(ptr);
+            break;
+        case LogArgs::ARG_STRING:
+            memcpy(&ptr,mPos,sizeof(ptr));
+            mPos += sizeof(ptr);
+            str = mPos;
+            mPos += strlen(str)+1;
+            break;
+        default:return false;
+        }
+        return true;
+    }
+    /*value of an integer argument as the callee would have seen it*/
+    uint64_t asUnsigned()const{
+        switch(type){
+        case LogArgs::ARG_INT:
+        case LogArgs::ARG_UINT:return size>=8?u:(u&((uint64_t(1)<<(size*8))-1));
+        case LogArgs::ARG_DOUBLE:return uint64_t(d);
+        default:return uint64_t(uintptr_t(ptr));
+        }
+    }
+    int64_t asSigned()const{
+        switch(type){
+        case LogArgs::ARG_INT:return i;
+        case LogArgs::ARG_UINT:return int64_t(asUnsigned());
+        case LogArgs::ARG_DOUBLE:return int64_t(d);
+        default:return int64_t(uintptr_t(ptr));
+        }
+    }
+};
+
+/*formats the arguments left in reader*/
+static inline int LogFormatArgs(char*out,int capacity,const char*format,LogArgReader&reader){
+    char spec[32];
+    int len = 0;
+    auto append=[&](int n){
+        if(n>0)len = (len+n<capacity)?len+n:capacity-1;
+    };
+    const char*p = format;
+    while(*p && len<capacity-1){
+        if(*p!='%'){
+            out[len++] = *p++;
+            continue;
+        }
+        if(p[1]=='%'){
+            out[len++] = '%';
+            p += 2;
+            continue;
+        }
+        int s = 0;
+        spec[s++] = *p++;
+        while(strchr("-+ #0'",*p) && s<16)spec[s++] = *p++;
+        for(int part = 0;part<2;part++){
+            if(part==1){
+                if(*p!='.')break;
+                spec[s++] = *p++;
+            }
+            if(*p=='*'){
+                p++;
+                const int v = reader.next()?int(reader.asSigned()):0;
+                s += snprintf(spec+s,12,"%d",v);
+            }else{
+                while((*p>='0')&&(*p<='9')&&(s<24))spec[s++] = *p++;
+            }
+        }
+        while(*p && strchr("hljztLq",*p))p++;/*the stored value decides the length*/
+        const char conv = *p;
+        if(conv==0)break;
+        p++;
+        if(conv=='n'){
+            reader.next();
+            continue;
+        }
+        if(!reader.next()){
+            append(snprintf(out+len,capacity-len,"<?>"));
+            continue;
+        }
+        switch(conv){
+        case 'd':
+        case 'i':
+            spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,(long long)reader.asSigned()));
+            break;
+        case 'u':case 'o':case 'x':case 'X':
+            spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,(unsigned long long)reader.asUnsigned()));
+            break;
+        case 'c':
+            spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,int(reader.asSigned())));
+            break;
+        case 'f':case 'F':case 'e':case 'E':case 'g':case 'G':case 'a':case 'A':
+            spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,
+                (reader.type==LogArgs::ARG_DOUBLE)?reader.d:double(reader.asSigned())));
+            break;
+        case 's':
+            spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,(reader.type==LogArgs::ARG_STRING)?reader.str:"<?>"));
+            break;
+        case 'p':
+            spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,spec,
+                ((reader.type==LogArgs::ARG_POINTER)||(reader.type==LogArgs::ARG_STRING))?reader.ptr:(const void*)uintptr_t(reader.asUnsigned())));
+            break;
+        default:
+            spec[s++] = conv; spec[s] = 0;
+            append(snprintf(out+len,capacity-len,"%s",spec));
+            break;
+        }
+    }
+    out[len] = 0;
+    return len;
+}
+
+static inline int LogFormatArgs(char*out,int capacity,const char*format,const LogArgs&args){
+    LogArgReader reader(args);
+    return LogFormatArgs(out,capacity,format,reader);
+}
+
+/*file name without directory and extension,the module name used by LogSetModuleLevel*/
+static inline int LogGetTag(const char*file,const char**tag){
+    const char*start = file;
+    for(const char*q = file;*q;q++){
+        if((*q=='/')||(*q=='\\')||(*q=='('))start = q+1;
+    }
+    const char*dot = strrchr(start,'.');
+    *tag = start;
+    return dot?int(dot-start):int(strlen(start));
+}
+
+}/*endof namespace cdlog*/
+#endif/*__CDLOG_FORMAT_H__*/
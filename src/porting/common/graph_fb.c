@@ -34,6 +34,41 @@ typedef struct {
 } FBSURFACE;
 
 static FBDEVICE devs[2]= {-1};
+
+static int getBytesPerPixel(int format){
+    switch(format){
+    case GPF_ARGB4444:
+    case GPF_ARGB1555:
+    case GPF_RGB565: return 2;
+    default: return 4;
+    }
+}
+
+/*only RGB565 <-> 32bit lines are converted,other pairs of different formats are rejected by GFXBlit*/
+static int canConvert(int dfmt,int sfmt){
+    return ((sfmt==GPF_RGB565)&&(getBytesPerPixel(dfmt)==4))||((dfmt==GPF_RGB565)&&(getBytesPerPixel(sfmt)==4));
+}
+
+static void convertPixels(uint8_t*pd,int dfmt,const uint8_t*ps,int sfmt,int count){
+    int i;
+    if(sfmt==GPF_RGB565){
+        const uint16_t*s16 = (const uint16_t*)ps;
+        uint32_t*d32 = (uint32_t*)pd;
+        for(i=0;i<count;i++){
+            const uint16_t p = s16[i];
+            const uint32_t r = (p>>11)&0x1F, g = (p>>5)&0x3F, b = p&0x1F;
+            d32[i] = 0xFF000000|(((r<<3)|(r>>2))<<16)|(((g<<2)|(g>>4))<<8)|((b<<3)|(b>>2));
+        }
+    }else{
+        const uint32_t*s32 = (const uint32_t*)ps;
+        uint16_t*d16 = (uint16_t*)pd;
+        for(i=0;i<count;i++){
+            const uint32_t p = s32[i];
+            d16[i] = ((p>>8)&0xF800)|((p>>5)&0x07E0)|((p>>3)&0x001F);
+        }
+    }
+}
+
 static GFXRect screenMargin= {0};
 static FBSURFACE devSurfaces[16];
 int32_t GFXInit() {
@@ -153,6 +188,15 @@ int32_t GFXFillRect(GFXHANDLE surface,const GFXRect*rect,uint32_t color) {
     rec.h=ngs->height;
     if(rect)rec=*rect;
     LOGV("FillRect %p %d,%d-%d,%d color=0x%x pitch=%d",ngs,rec.x,rec.y,rec.w,rec.h,color,ngs->pitch);
+    if(getBytesPerPixel(ngs->format)!=4){
+        const int bpp = getBytesPerPixel(ngs->format);
+        const uint16_t c16 = ((color>>8)&0xF800)|((color>>5)&0x07E0)|((color>>3)&0x001F);
+        for(y=0; y<rec.h; y++) {
+            uint16_t*line = (uint16_t*)(ngs->buffer+ngs->pitch*(rec.y+y)+rec.x*bpp);
+            for(x=0; x<rec.w; x++)line[x] = c16;
+        }
+        return E_OK;
+    }
     uint32_t*fb=(uint32_t*)(ngs->buffer+ngs->pitch*rec.y+rec.x*4);
     uint32_t*fbtop=fb;
     for(x=0; x<rec.w; x++)fb[x]=color;
@@ -235,7 +279,8 @@ int32_t GFXCreateSurface(int dispid,GFXHANDLE*surface,uint32_t width,uint32_t he
     surf->height=hwsurface?dev->var.yres:height;
     surf->format=format;
     surf->ishw=hwsurface;
-    surf->pitch=width*4;
+    /*cairo requires the stride to be 4 bytes aligned*/
+    surf->pitch=hwsurface?width*4:((width*getBytesPerPixel(format)+3)&~3);
     size_t buffer_size=surf->height*surf->pitch;
     if(hwsurface) {
         setfbinfo(surf);
@@ -287,17 +332,28 @@ int32_t GFXBlit(GFXHANDLE dstsurface,int dx,int dy,GFXHANDLE srcsurface,const GF
 
     LOGV("Blit %p %d,%d-%d,%d -> %p %d,%d buffer=%p->%p",nsrc,rs.x,rs.y,rs.w,rs.h,ndst,dx,dy,pbs,pbd);
 #ifndef USE_PIXMAN
-    pbs+=rs.y*nsrc->pitch+rs.x*4;
-    if(ndst->ishw==0)pbd+=dy*ndst->pitch+dx*4;
-    else pbd+=(dy+screenMargin.y)*ndst->pitch+(dx+screenMargin.x)*4;
-    const int cpw=rs.w*4;
+    const int sbpp = getBytesPerPixel(nsrc->format);
+    const int dfmt = ndst->ishw?GPF_ARGB:ndst->format;
+    const int dbpp = getBytesPerPixel(dfmt);
+    /*lines are copied as they are only when both surfaces share the pixel layout*/
+    const int samefmt = (nsrc->format==dfmt)||((sbpp==4)&&(dbpp==4));
+    if(!samefmt && !canConvert(dfmt,nsrc->format)){
+        LOGE("Blit from format %d to %d is not supported",nsrc->format,dfmt);
+        return E_INVALID_PARA;
+    }
+    pbs+=rs.y*nsrc->pitch+rs.x*sbpp;
+    if(ndst->ishw==0)pbd+=dy*ndst->pitch+dx*dbpp;
+    else pbd+=(dy+screenMargin.y)*ndst->pitch+(dx+screenMargin.x)*dbpp;
+    const int cpw=rs.w*sbpp;
     for(y=0; y<rs.h; y++) {
-        memcpy(pbd,pbs,cpw);
+        if(samefmt)memcpy(pbd,pbs,cpw);
+        else convertPixels(pbd,dfmt,pbs,nsrc->format,rs.w);
         pbs+=nsrc->pitch;
         pbd+=ndst->pitch;
     }
 #else
-    pixman_image_t *src_image = pixman_image_create_bits(PIXMAN_a8r8g8b8, nsrc->width, nsrc->height, (uint32_t*)nsrc->buffer, nsrc->pitch);
+    const pixman_format_code_t srcFormat = (nsrc->format==GPF_RGB565)?PIXMAN_r5g6b5:PIXMAN_a8r8g8b8;
+    pixman_image_t *src_image = pixman_image_create_bits(srcFormat, nsrc->width, nsrc->height, (uint32_t*)nsrc->buffer, nsrc->pitch);
     pixman_image_t *dst_image = pixman_image_create_bits(PIXMAN_a8r8g8b8, ndst->width, ndst->height, (uint32_t*)ndst->buffer, ndst->pitch);
     pixman_image_composite(PIXMAN_OP_SRC, src_image,NULL/*mask*/, dst_image,
                        rs.x, rs.y, 0, 0, dx, dy, rs.w, rs.h);
@@ -36,6 +36,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <sys/inotify.h>
+#include <errno.h>
 typedef struct DeviceNode{
     int fd;
     std::string name;
@@ -80,7 +81,7 @@ int32_t InputInit() {
         if(ent->d_type != DT_DIR) {
             const int clock = CLOCK_MONOTONIC;
             /*if your kernel's CONFIG_INPUT_PROC_CLOCK is realtime and no RTC,the clock must be setted as CLOCK_MONOTONIC*/
-            fd = open(fname,O_RDWR);
+            fd = open(fname,O_RDWR|O_NONBLOCK);
             ioctl(fd,EVIOCSCLOCKID,&clock);
             if(fd > 0) {
                 dev.maxfd=std::max(dev.maxfd,fd);
@@ -186,14 +187,83 @@ int32_t InputInjectEvents(const INPUTEVENT*es,uint32_t count,uint32_t timeout) {
     return count;
 }
 
-int32_t InputGetEvents(INPUTEVENT*outevents,uint32_t max,uint32_t timeout) {
-    int rc,count = 0,event_pos = 0;
-    struct timeval tv;
-    struct input_event events[64];
+int32_t InputGetDeviceFds(int*fds,uint32_t maxfds) {
+    uint32_t count = 0;
+    for(auto it = dev.fds.begin(); (it != dev.fds.end()) && (count < maxfds); it++)
+        fds[count++] = it->fd;
+    return count;
+}
+
+static int readHotplugEvents(INPUTEVENT*outevents,uint32_t max) {
     char inotifyBuffer[512];
     INPUTEVENT*e = outevents;
-    fd_set rfds;
+    const int total = read(dev.inotify,inotifyBuffer,sizeof(inotifyBuffer));
+    LOGI("read(dev.inotify=%d/%d)",total,sizeof(struct inotify_event));
+    for(int pos = 0; (pos + (int)sizeof(struct inotify_event) <= total) && (e - outevents < max);) {
+        struct inotify_event*ievent = (struct inotify_event*)(inotifyBuffer+pos);
+        std::string path = WATCHED_PATH;
+        path.append("/").append(ievent->name);
+        pos += sizeof(struct inotify_event)+ievent->len;
+        if(ievent->mask & IN_DELETE) {
+            auto it = dev.findByPath(path);
+            LOGI("..device %s:%d deleted found=%d",path.c_str(),ievent->wd,(it!=dev.fds.end()));
+            if(it == dev.fds.end())continue;
+            e->device = it->fd;
+            e->type = EV_REMOVE;
+            close(it->fd);
+            dev.fds.erase(it);
+            e++;
+        } else if(ievent->mask & IN_CREATE) {
+            const int clock = CLOCK_MONOTONIC;
+            const int fd = open(path.c_str(),O_RDWR|O_NONBLOCK);
+            LOGI("device %s:%d created",path.c_str(),fd);
+            if(fd < 0)continue;
+            ioctl(fd,EVIOCSCLOCKID,&clock);
+            e->device = fd;
+            e->type = EV_ADD;
+            dev.fds.push_back({fd,path});
+            dev.maxfd = std::max(dev.maxfd,fd);
+            e++;
+        } else {
+            LOGI("device %s:%d event=%x",path.c_str(),ievent->wd,ievent->mask);
+        }
+    }
+    return e - outevents;
+}
+
+int32_t InputReadEvents(int fd,INPUTEVENT*outevents,uint32_t max) {
     static const char*type2name[]= {"SYN","KEY","REL","ABS","MSC","SW"};
+    struct input_event events[64];
+    int rc;
+    if(fd == dev.pipe[0]) {
+        rc = read(fd,outevents,max*sizeof(INPUTEVENT));
+        return (rc > 0) ? rc/sizeof(INPUTEVENT) : 0;
+    } else if(fd == dev.inotify) {
+        return readHotplugEvents(outevents,max);
+    }
+    /*input devices,read as many events as the caller can take in one syscall*/
+    rc = read(fd,events,std::min<size_t>(max,sizeof(events)/sizeof(struct input_event))*sizeof(struct input_event));
+    if(rc < 0)
+        return ((errno == EAGAIN) || (errno == EINTR)) ? 0 : E_ERROR;
+    const int count = rc/sizeof(struct input_event);
+    for(int j = 0; j < count; j++) {
+        INPUTEVENT*e = outevents + j;
+        e->tv_sec = events[j].time.tv_sec;
+        e->tv_usec= events[j].time.tv_usec;
+        e->type = events[j].type;
+        e->code = events[j].code;
+        e->value= events[j].value;
+        e->device = fd;
+        LOGV_IF(e->type<EV_SW,"fd:%d [%s]%02x,%02x,%02x time=%ld.%06ld",fd,
+                type2name[e->type],e->type,e->code,e->value,e->tv_sec,e->tv_usec);
+    }
+    return count;
+}
+
+int32_t InputGetEvents(INPUTEVENT*outevents,uint32_t max,uint32_t timeout) {
+    int rc,count = 0;
+    struct timeval tv;
+    fd_set rfds;
     tv.tv_usec= (timeout%1000)*1000;//1000L*timeout;
     tv.tv_sec = timeout/1000;
     FD_ZERO(&rfds);
@@ -204,64 +274,12 @@ int32_t InputGetEvents(INPUTEVENT*outevents,uint32_t max,uint32_t timeout) {
         LOGD("select error");
         return E_ERROR;
     }
+    /*hotplug may modify dev.fds*/
     std::vector<DEVICENODE> FDS = dev.fds;
-    for(int i=0; i < FDS.size(); i++) {
+    for(int i=0; (i < FDS.size()) && (count < max); i++) {
         if(!FD_ISSET(FDS[i].fd,&rfds))continue;
-        if(FDS[i].fd == dev.pipe[0]) { //for pipe
-            rc = read(FDS[i].fd,e, (max-count)*sizeof(INPUTEVENT));
-            e += rc/sizeof(INPUTEVENT);
-            count += rc/sizeof(INPUTEVENT);
-        } else if(FDS[i].fd == dev.inotify) {
-            int elen=0;
-            struct inotify_event*ievent=(struct inotify_event*)inotifyBuffer;
-            const int total = read(dev.inotify,inotifyBuffer,sizeof(inotifyBuffer));
-            LOGI("read(dev.inotify=%d/%d)",total,sizeof(struct inotify_event));
-            if(total<sizeof(struct inotify_event))
-                continue;
-            while(elen<total) {
-                ievent = (struct inotify_event*)(inotifyBuffer+event_pos);
-                std::string path = WATCHED_PATH;
-                path.append("/").append(ievent->name);
-                const int eventsize = sizeof(struct inotify_event)+ievent->len;
-                rc -= eventsize;
-                event_pos += eventsize;
-                if(ievent->mask & IN_DELETE) {
-                    auto it = dev.findByPath(path);
-                    e->device = it->fd;
-                    e->type = EV_REMOVE;
-                    LOGI("..device %s:%d/%d deleted found=%d",path.c_str(),ievent->wd,it->fd,(it!=dev.fds.end()));
-                    if(it!=dev.fds.end()) {
-                        FD_CLR(it->fd,&rfds);
-                        close(it->fd);
-                        dev.fds.erase(it);
-                    }
-                    e++;
-                } else if(ievent->mask & IN_CREATE) {
-                    e->device = open(path.c_str(),O_RDWR);
-                    e->type = EV_ADD;
-                    dev.fds.push_back({e->device,path});
-                    dev.maxfd=std::max(dev.maxfd,e->device);
-                    LOGI("device %s:%d created",path.c_str(),e->device);
-                    e++;
-                } else {
-                    LOGI("device %s:%d event=%x rc=%d",path.c_str(),ievent->wd,ievent->mask,IN_CREATE,IN_DELETE,rc);
-                }
-                elen+=(sizeof(struct inotify_event)+ievent->len);
-            }
-        } else {/*for input devices*/
-            rc = read(FDS[i].fd,events, sizeof(events)/sizeof(struct input_event));
-            for(int j=0; (rc>0)&&j<rc/sizeof(struct input_event)&&(count<max); j++,e++,count++) {
-                e->tv_sec = events[j].time.tv_sec;
-                e->tv_usec= events[j].time.tv_usec;
-                e->type = events[j].type;
-                e->code = events[j].code;
-                e->value= events[j].value;
-                e->device = FDS[i].fd;
-                LOGV_IF(e->type<EV_SW,"fd:%d [%s]%02x,%02x,%02x time=%ld.%06ld",FDS[i].fd,
-                        type2name[e->type],e->type,e->code,e->value,e->tv_sec,e->tv_usec);
-            }
-        }
+        rc = InputReadEvents(FDS[i].fd,outevents+count,max-count);
+        if(rc > 0)count += rc;
     }
-    return e-outevents;
+    return count;
 }
-
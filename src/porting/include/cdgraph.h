@@ -89,6 +89,8 @@ int32_t GFXGetDisplaySize(int dispid, uint32_t* width, uint32_t* height);
     @param [in]width                         The value give the surface width in pixels.
     @param [in]height                        The value give the surface height in pixels.
     @param [in]format                        surface format @ref NGLPIXELFORMAT
+                                             drivers that cannot create the requested format fall back to GPF_ARGB,
+                                             GFXGetSurfaceInfo and the pitch returned by GFXLockSurface tell which one was used
     @param [in]hwsurface
     @retval E_OK
     @retval E_ERROR
@@ -121,6 +123,7 @@ int32_t GFXSurfaceSetOpacity(GFXHANDLE surface, uint8_t alpha);
 int32_t GFXFillRect(GFXHANDLE dstsurface, const GFXRect* rect, uint32_t color);
 
 /**This function Blit source surface to dest surface .
+    source and dest surface may have different format,pixels are converted while blitting
     @param [in]dstsurface                     The dest surface which used to blit to.
     @param [in]dx                             The position x which source surface blit to
     @param [in]dy                             The position y which source surface blit to
@@ -54,6 +54,12 @@ int32_t InputInit();
 int32_t InputGetEvents(INPUTEVENT*events,uint32_t maxevent,uint32_t timeout);
 int32_t InputInjectEvents(const INPUTEVENT*events,uint32_t count,uint32_t timeout);
 int32_t InputGetDeviceInfo(int device,INPUTDEVICEINFO*);
+/*fds(devices,inject pipe and hotplug watch) to be polled by the caller instead of InputGetEvents,
+ *returns the fd count,0 if the platform can only be read by InputGetEvents*/
+int32_t InputGetDeviceFds(int*fds,uint32_t maxfds);
+/*non-blocking batched read of the events pending on fd,EV_ADD/EV_REMOVE events report
+ *the device fds to start/stop polling*/
+int32_t InputReadEvents(int fd,INPUTEVENT*events,uint32_t maxevent);
 
 END_DECLS
 
@@ -19,6 +19,8 @@ void LogDump  (int level,const char*tag,const char*func,int line,const char*labe
 void LogSetModuleLevel(const char*module,int level);
 void LogParseModule(const char*module);
 void LogParseModules(int argc,const char*argv[]);
+/*writes out all queued messages,returns the number of messages dropped so far because the queue was full*/
+unsigned int LogFlush();
 #ifdef __cplusplus
 }
 #endif 
@@ -28,12 +30,136 @@ void LogParseModules(int argc,const char*argv[]);
 #include <sstream>
 #include <iostream>
 #include <cstdarg>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
 namespace cdlog{
+/*state of one LOGx call site,the module level is resolved once and cached
+ *until LogSetModuleLevel changes sLogSerial*/
+struct LogSite{
+    const char*file;
+    const char*func;
+    int line;
+    std::atomic<int>level;
+    std::atomic<int>serial;
+    LogSite(const char*f,const char*fn,int l):file(f),func(fn),line(l),level(0),serial(0){}
+};
+extern std::atomic<int>sLogSerial;
+void resolveLogSite(LogSite&site);
+inline bool isLoggable(LogSite&site,int level){
+    if(site.serial.load(std::memory_order_acquire)!=sLogSerial.load(std::memory_order_relaxed))
+        resolveLogSite(site);
+    return level>=site.level.load(std::memory_order_relaxed);
+}
+
+/*arguments of a deferred message,formatted later by the log thread.
+ *strings are copied,everything else is stored by value*/
+struct LogArgs{
+    enum{ARG_INT='i',ARG_UINT='u',ARG_DOUBLE='f',ARG_STRING='s',ARG_POINTER='p'};
+    static constexpr int kCapacity = 432;
+    uint16_t size;
+    bool truncated;
+    char data[kCapacity];
+    void clear(){size = 0;truncated = false;}
+    bool reserve(int n){
+        if(size+n<=kCapacity)return true;
+        truncated = true;
+        return false;
+    }
+    void putInteger(char type,uint8_t bytes,uint64_t v){
+        if(!reserve(2+sizeof(v)))return;
+        data[size++] = type;
+        data[size++] = char(bytes);
+        memcpy(data+size,&v,sizeof(v));
+        size += sizeof(v);
+    }
+    void putDouble(double v){
+        if(!reserve(1+sizeof(v)))return;
+        data[size++] = ARG_DOUBLE;
+        memcpy(data+size,&v,sizeof(v));
+        size += sizeof(v);
+    }
+    void putPointer(const void*v){
+        if(!reserve(1+sizeof(v)))return;
+        data[size++] = ARG_POINTER;
+        memcpy(data+size,&v,sizeof(v));
+        size += sizeof(v);
+    }
+    void putString(const char*s){
+        putString(s,s?strlen(s):6);
+    }
+    void putString(const char*s,size_t len){
+        const char*str = s?s:"(null)";
+        if(!reserve(1+sizeof(s)+1))return;
+        data[size++] = ARG_STRING;
+        memcpy(data+size,&s,sizeof(s));
+        size += sizeof(s);
+        if(len>=size_t(kCapacity-size)){
+            len = kCapacity-size-1;
+            truncated = true;
+        }
+        memcpy(data+size,str,len);
+        size += uint16_t(len);
+        data[size++] = 0;
+    }
+};
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value||std::is_enum<T>::value>::type logArg(LogArgs&a,T v){
+    typedef typename std::conditional<std::is_enum<T>::value,int,T>::type I;
+    if(std::is_signed<I>::value)a.putInteger(LogArgs::ARG_INT,sizeof(T),uint64_t(int64_t(v)));
+    else a.putInteger(LogArgs::ARG_UINT,sizeof(T),uint64_t(v));
+}
+template<typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type logArg(LogArgs&a,T v){ a.putDouble(double(v)); }
+inline void logArg(LogArgs&a,const char*v){ a.putString(v); }
+inline void logArg(LogArgs&a,char*v){ a.putString(v); }
+inline void logArg(LogArgs&a,const unsigned char*v){ a.putString((const char*)v); }
+inline void logArg(LogArgs&a,unsigned char*v){ a.putString((const char*)v); }
+inline void logArg(LogArgs&a,std::nullptr_t){ a.putPointer(nullptr); }
+template<typename T>
+inline void logArg(LogArgs&a,const T*v){ a.putPointer((const void*)v); }
+inline void logArg(LogArgs&a,const std::string&v){ a.putString(v.data(),v.size()); }
+template<typename T>
+inline typename std::enable_if<std::is_class<T>::value||std::is_union<T>::value>::type logArg(LogArgs&,const T&){
+    static_assert(sizeof(T)==0,"LOGx only takes arithmetic,enum,pointer and std::string arguments");
+}
+inline void logArgs(LogArgs&){}
+template<typename T,typename...Rest>
+inline void logArgs(LogArgs&a,T v,Rest...rest){
+    logArg(a,v);
+    logArgs(a,rest...);
+}
+
+LogArgs&threadLogArgs();
+/*a null format means the format was copied as the first string of args*/
+void LogCommit(const LogSite&site,int level,const char*format,const LogArgs&args);
+inline void LogDeferred(const LogSite&site,int level,const char*text){
+    LogArgs&a = threadLogArgs();/*the text may be a temporary,keep a copy*/
+    a.clear();
+    a.putString(text);
+    LogCommit(site,level,nullptr,a);
+}
+/*only a string literal is known to outlive the log thread,any other format is copied*/
+template<typename F>
+struct isLiteralFormat:std::integral_constant<bool,std::is_array<typename std::remove_reference<F>::type>::value
+        &&std::is_const<typename std::remove_reference<F>::type>::value>{};
+template<typename F,typename...Args>
+inline typename std::enable_if<(sizeof...(Args)>0)>::type LogDeferred(const LogSite&site,int level,F&&format,Args...args){
+    LogArgs&a = threadLogArgs();
+    const bool literal = isLiteralFormat<F>::value;
+    a.clear();
+    if(!literal)a.putString(format);
+    logArgs(a,args...);
+    LogCommit(site,level,literal?format:nullptr,a);
+}
+
 class LogMessage {
 protected:
-    const std::string file_;
+    const char*file_;
     const int line_;
-    const std::string function_;
+    const char*function_;
     int level_message;
     int level_module;
     std::ostringstream stream_;
@@ -41,7 +167,7 @@ protected:
     long timestamp_; //second part
     long timeusec_;  //usecond part
 public:
-    LogMessage(const std::string& file, const int line, const std::string& function,int level);
+    LogMessage(const char*file, const int line, const char*function,int level);
     virtual ~LogMessage(); // at destruction will flush the message
     std::ostringstream& messageStream() {return stream_;}
     void messageSave(const char* format, ...);
@@ -50,7 +176,7 @@ class FatalMessage:public LogMessage{
 protected:
     int signal_;
 public:
-    FatalMessage(const std::string& file, const int line, const std::string& function,int signal);
+    FatalMessage(const char*file, const int line, const char*function,int signal);
     virtual ~FatalMessage();
 };
 }//namespace cdlog
@@ -60,7 +186,10 @@ public:
 #endif /*endof __cplusplus*/
 
 #ifdef __cplusplus
-    #define LOG_PRINTF(level,...) cdlog::LogMessage(__FILE__,__LINE__,__FUNCTION__,level).messageSave(__VA_ARGS__)
+    #define LOG_PRINTF(level,...) do{\
+        static cdlog::LogSite _logSite_(__FILE__,__FUNCTION__,__LINE__);\
+        if(cdlog::isLoggable(_logSite_,level))cdlog::LogDeferred(_logSite_,level,__VA_ARGS__);\
+    }while(0)
 #else
     #define LOG_PRINTF(level,...) LogPrintf(level,__FILE__,__FUNCTION__,__LINE__,__VA_ARGS__)
 #endif
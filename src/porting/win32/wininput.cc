@@ -123,3 +123,11 @@ int32_t InputGetEvents(INPUTEVENT*outevents, uint32_t max, uint32_t timeout) {
     LOGV_IF(readedBytes>0,"read %d bytes %d events", readedBytes, readedBytes / sizeof(INPUTEVENT));
     return readedBytes/sizeof(INPUTEVENT);
 }
+
+int32_t InputGetDeviceFds(int*fds, uint32_t maxfds) {
+    return 0;/*anonymous pipes can't be polled,only InputGetEvents is supported*/
+}
+
+int32_t InputReadEvents(int fd, INPUTEVENT*outevents, uint32_t max) {
+    return E_ERROR;
+}
@@ -170,3 +170,26 @@ TEST_F(ANIMATOR,scale){
     app.exec();
 }
 
+
+TEST_F(ANIMATOR,keyframes){
+    View*v = new View(100,100);
+    ObjectAnimator*anim = ObjectAnimator::ofFloat(v,"translationX",{0,100,50});
+    anim->setInterpolator(LinearInterpolator::Instance);
+    ASSERT_EQ(anim->getValues(0)->getProperty(),View::TRANSLATION_X);
+    const float expected[] = {0,50,100,75,50};
+    for(int i=0;i<=4;i++){
+        anim->setCurrentFraction((float)i/4.f);
+        ASSERT_FLOAT_EQ(v->getTranslationX(),expected[i]);
+    }
+    delete anim;
+    delete v;
+}
+
+TEST_F(ANIMATOR,intToFloatProperty){
+    View*v = new View(100,100);
+    ObjectAnimator*anim = ObjectAnimator::ofInt(v,"alpha",{0,1});
+    anim->setCurrentFraction(1.f);
+    ASSERT_FLOAT_EQ(v->getAlpha(),1.f);
+    delete anim;
+    delete v;
+}
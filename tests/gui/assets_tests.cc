@@ -37,6 +37,19 @@ TEST_F(ASSETS,array2){
    printf("size=%lu\r\n",array.size());
    ASSERT_TRUE(array.size()>0);
 }
+TEST_F(ASSETS,lazy){
+    const char*args[]={"assets_tests","--lazy",nullptr};
+    App app(2,args);
+    ASSERT_TRUE(app.isLazyLoading());
+    std::vector<std::string>array;
+    app.getArray("cdroid:array/resolver_target_actions_unpin",array);
+    ASSERT_TRUE(array.size()>0);
+    ASSERT_EQ((uint32_t)app.getColor("cdroid:color/black"),(uint32_t)0xFF000000);
+    ASSERT_NE(app.getString("cdroid:string/number_picker_decrement_button"),"cdroid:string/number_picker_decrement_button");
+    /*dimens kept in colors_material.xml*/
+    ASSERT_FLOAT_EQ(app.getFloat("cdroid:dimen/hint_alpha_material_dark",0.f),0.5f);
+}
+
 TEST_F(ASSETS,color){
     App app(0,NULL);
     auto cl = app.getColorStateList("cdroid:attr/editTextColor");
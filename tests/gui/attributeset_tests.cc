@@ -53,3 +53,21 @@ TEST_F(ATTS,inherit2){
     ASSERT_EQ(att2.getString("color2"),"cdroid:attr/textColor");
     ASSERT_EQ(att2.getString("color3"),"cdroid:attr/textColor");
 }
+
+TEST_F(ATTS,sharedCopyOnWrite){
+    AttributeSet att1(nullptr,"cdroid");
+    att1.add("textColor","#ff0000");
+    AttributeSet att2(att1,true);
+    ASSERT_EQ(att2.getString("textColor"),"#ff0000");
+    att2.add("textColor","#00ff00");
+    att2.add("textSize","12sp");
+    ASSERT_EQ(att1.getString("textColor"),"#ff0000");
+    ASSERT_FALSE(att1.hasAttribute("textSize"));
+    ASSERT_EQ(att2.getString("textColor"),"#00ff00");
+
+    /*the source of a sharing copies too*/
+    AttributeSet att3(att1,true);
+    att1.add("textColor","#0000ff");
+    ASSERT_EQ(att3.getString("textColor"),"#ff0000");
+    ASSERT_EQ(att1.getString("textColor"),"#0000ff");
+}
@@ -2,6 +2,10 @@
 #include <cdroid.h>
 #include <core/systemclock.h>
 #include <image-decoders/imagedecoder.h>
+#include <utils/lockfreequeue.h>
+#include <utils/arrayblockingqueue.h>
+#include <shared_queue.h>
+#include <thread>
 using namespace Cairo;
 using namespace cdroid;
 class BENCHMARK:public testing::Test{
@@ -62,3 +66,44 @@ TEST_F(BENCHMARK,Jpeg){
    printf("jpeg decoe time:%f \r\n",(t2-t1)/100.f);
 }
 #endif
+
+template<typename Q>
+static float queueSpeed(Q&q,int producers,int count){
+    std::vector<std::thread>threads;
+    const int64_t t1 = SystemClock::uptimeMicros();
+    for(int p = 0;p < producers;p++){
+        threads.emplace_back([&q,count](){
+            for(int i = 0;i < count;i++)q.put(i);
+        });
+    }
+    int64_t sum = 0;
+    for(int i = 0;i < count*producers;i++)sum += q.take();
+    for(auto&t:threads)t.join();
+    const int64_t t2 = SystemClock::uptimeMicros();
+    EXPECT_EQ(sum,int64_t(count-1)*count/2*producers);
+    return float(t2-t1)*1000.f/(count*producers);
+}
+
+TEST_F(BENCHMARK,Queues){
+    const int count = 1000000;
+    SPSCQueue<int>spsc(1024);
+    MPSCQueue<int>mpsc1(1024),mpsc4(1024);
+    ArrayBlockingQueue<int>abq1(1024),abq4(1024);
+    printf("SPSCQueue          1 producer : %.1fns/item\r\n",queueSpeed(spsc,1,count));
+    printf("MPSCQueue          1 producer : %.1fns/item\r\n",queueSpeed(mpsc1,1,count));
+    printf("MPSCQueue          4 producers: %.1fns/item\r\n",queueSpeed(mpsc4,4,count/4));
+    printf("ArrayBlockingQueue 1 producer : %.1fns/item\r\n",queueSpeed(abq1,1,count));
+    printf("ArrayBlockingQueue 4 producers: %.1fns/item\r\n",queueSpeed(abq4,4,count/4));
+
+    shared_queue<int>sq;
+    const int64_t t1 = SystemClock::uptimeMicros();
+    std::thread producer([&sq,count](){
+        for(int i = 0;i < count;i++)sq.push(i);
+    });
+    int item,taken = 0;
+    while(taken < count)
+        if(sq.wait_and_pop(item,10))taken++;
+    producer.join();
+    const int64_t t2 = SystemClock::uptimeMicros();
+    printf("shared_queue       1 producer : %.1fns/item\r\n",float(t2-t1)*1000.f/count);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <widget/achart/model/xyseries.h>
+#include <random>
+#include <algorithm>
+
+using namespace cdroid;
+
+class DECIMATOR:public testing::Test{
+public:
+    using Points = std::vector<std::pair<double,double>>;
+    static constexpr int COUNT  = 100000;
+    static constexpr int COLUMNS= 300;
+    std::map<double,double>mXY;
+    void SetUp()override{
+        std::mt19937 random(1234);
+        double y = 0;
+        for(int i=0;i<COUNT;i++){
+            y += double(int(random()%201)-100)/10.0;
+            mXY[i*0.5] = y;
+        }
+    }
+    static bool contains(const Points&points,double x,double y){
+        return std::find(points.begin(),points.end(),std::make_pair(x,y))!=points.end();
+    }
+};
+
+TEST_F(DECIMATOR,minMax){
+    Decimator d;
+    d.build(mXY);
+    Points out;
+    const double minX = 1000.0,maxX = 40000.0;
+    d.decimate(d.lowerBound(minX),d.lowerBound(maxX),minX,maxX,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_LE(out.size(),size_t(COLUMNS*4));
+    ASSERT_TRUE(std::is_sorted(out.begin(),out.end()));
+    /*every column keeps its extremes*/
+    const double step = (maxX-minX)/COLUMNS;
+    for(int c=0;c<COLUMNS;c++){
+        auto first = mXY.lower_bound(minX+step*c);
+        auto last  = mXY.lower_bound(c==COLUMNS-1?maxX:minX+step*(c+1));
+        auto ymin = first,ymax = first;
+        for(auto it=first;it!=last;it++){
+            if(it->second<ymin->second)ymin = it;
+            if(it->second>ymax->second)ymax = it;
+        }
+        ASSERT_TRUE(contains(out,ymin->first,ymin->second))<<"column "<<c;
+        ASSERT_TRUE(contains(out,ymax->first,ymax->second))<<"column "<<c;
+    }
+}
+
+TEST_F(DECIMATOR,append){
+    Decimator built,appended;
+    built.build(mXY);
+    appended.build(std::map<double,double>(mXY.begin(),mXY.lower_bound(COUNT/8)));
+    for(auto it = mXY.lower_bound(COUNT/8);it!=mXY.end();it++)
+        appended.append(it->first,it->second);
+    Points a,b;
+    built.decimate(0,built.size(),0,COUNT/2,COLUMNS,Decimator::MIN_MAX,a);
+    appended.decimate(0,appended.size(),0,COUNT/2,COLUMNS,Decimator::MIN_MAX,b);
+    ASSERT_EQ(a,b);
+}
+
+TEST_F(DECIMATOR,lttb){
+    Decimator d;
+    d.build(mXY);
+    Points out;
+    d.decimate(0,d.size(),0,COUNT/2,COLUMNS,Decimator::LTTB,out);
+    ASSERT_EQ(out.size(),size_t(COLUMNS*2));
+    ASSERT_TRUE(std::is_sorted(out.begin(),out.end()));
+    ASSERT_EQ(out.front().first,mXY.begin()->first);
+    ASSERT_EQ(out.back().first,mXY.rbegin()->first);
+}
+
+TEST_F(DECIMATOR,fewPoints){
+    Decimator d;
+    d.build(std::map<double,double>(mXY.begin(),mXY.lower_bound(100)));
+    Points out;
+    d.decimate(0,d.size(),0,100,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_EQ(out.size(),d.size());
+}
+
+TEST_F(DECIMATOR,series){
+    XYSeries series("test");
+    for(int i=0;i<1000;i++)
+        series.add(i,i%7);
+    Points out;
+    series.getRange(100,200,false,COLUMNS,Decimator::NONE,out);
+    ASSERT_EQ(out.size(),size_t(100));
+    ASSERT_EQ(out.front().first,100);
+
+    /*the bounding points on both sides*/
+    out.clear();
+    series.getRange(100.5,199.5,true,COLUMNS,Decimator::NONE,out);
+    ASSERT_EQ(out.front().first,100);
+    ASSERT_EQ(out.back().first,200);
+
+    /*fewer points than COLUMNS*4 come back whole from the decimator too*/
+    out.clear();
+    series.getRange(0,2000,false,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_EQ(out.size(),size_t(1000));
+
+    series.add(1000,3);
+    out.clear();
+    series.getRange(0,2000,false,COLUMNS,Decimator::NONE,out);
+    ASSERT_EQ(out.size(),size_t(1001));
+    out.clear();
+    series.getRange(0,2000,false,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_EQ(out.size(),size_t(1001));
+
+    series.remove(0);
+    out.clear();
+    series.getRange(0,2000,false,COLUMNS,Decimator::NONE,out);
+    ASSERT_EQ(out.size(),size_t(1000));
+    ASSERT_EQ(out.front().first,1);
+    out.clear();
+    series.getRange(0,2000,false,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_EQ(out.size(),size_t(1000));
+    ASSERT_EQ(out.front().first,1);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <core/looper.h>
+#include <core/systemclock.h>
+#include <cdlog.h>
+#include <widgetEx/recyclerview/diffutil.h>
+#include <widgetEx/recyclerview/asynclistdiffer.h>
+#include <random>
+
+using namespace cdroid;
+
+class DIFFUTIL:public testing::Test{
+public:
+    struct Item{
+        int id;
+        int content;
+    };
+    class ItemDiff:public DiffUtil::ItemCallback<Item>{
+    public:
+        bool areItemsTheSame(const Item& a,const Item& b)override{
+            return a.id==b.id;
+        }
+        bool areContentsTheSame(const Item& a,const Item& b)override{
+            return a.content==b.content;
+        }
+    };
+    class ListDiff:public DiffUtil::Callback{
+    public:
+        const std::vector<Item>&mOld;
+        const std::vector<Item>&mNew;
+        ListDiff(const std::vector<Item>&o,const std::vector<Item>&n):mOld(o),mNew(n){}
+        int getOldListSize()override{return mOld.size();}
+        int getNewListSize()override{return mNew.size();}
+        bool areItemsTheSame(int o,int n)override{return mOld[o].id==mNew[n].id;}
+        bool areContentsTheSame(int o,int n)override{return mOld[o].content==mNew[n].content;}
+    };
+    /*replays the updates on a copy of the old list,inserted and changed items are marked stale*/
+    class Replay:public ListUpdateCallback{
+    public:
+        struct Entry{
+            Item item;
+            bool stale;
+        };
+        std::vector<Entry>list;
+        int events = 0;
+        Replay(const std::vector<Item>&items){
+            for(auto&i:items)list.push_back({i,false});
+        }
+        void onInserted(int position,int count)override{
+            events++;
+            list.insert(list.begin()+position,count,Entry{{-1,-1},true});
+        }
+        void onRemoved(int position,int count)override{
+            events++;
+            list.erase(list.begin()+position,list.begin()+position+count);
+        }
+        void onMoved(int from,int to)override{
+            events++;
+            Entry e = list[from];
+            list.erase(list.begin()+from);
+            list.insert(list.begin()+to,e);
+        }
+        void onChanged(int position,int count,Object*)override{
+            events++;
+            for(int i=0;i<count;i++)list[position+i].stale = true;
+        }
+        bool matches(const std::vector<Item>&items)const{
+            if(list.size()!=items.size())return false;
+            for(size_t i=0;i<items.size();i++){
+                if(list[i].stale)continue;
+                if((list[i].item.id!=items[i].id)||(list[i].item.content!=items[i].content))return false;
+            }
+            return true;
+        }
+    };
+    static void SetUpTestCase(){
+        Looper::prepare(false);
+        if(Looper::getMainLooper()==nullptr)Looper::prepareMainLooper();
+    }
+};
+
+TEST_F(DIFFUTIL,simple){
+    std::vector<Item>o={{1,0},{2,0},{3,0},{4,0},{5,0}};
+    std::vector<Item>n={{1,0},{3,1},{4,0},{6,0},{5,0}};
+    ListDiff cb(o,n);
+    DiffUtil::DiffResult result = DiffUtil::calculateDiff(cb);
+    Replay replay(o);
+    result.dispatchUpdatesTo(replay);
+    ASSERT_TRUE(replay.matches(n));
+    ASSERT_EQ(replay.events,3);/*remove 2,change 3,insert 6*/
+    ASSERT_EQ(result.convertOldPositionToNew(1),DiffUtil::NO_POSITION);
+    ASSERT_EQ(result.convertOldPositionToNew(2),1);
+    ASSERT_EQ(result.convertNewPositionToOld(3),DiffUtil::NO_POSITION);
+}
+
+TEST_F(DIFFUTIL,random){
+    std::mt19937 rng(42);
+    for(int iter=0;iter<2000;iter++){
+        std::vector<Item>o;
+        int nextId = 0;
+        const int size = rng()%40;
+        for(int i=0;i<size;i++)o.push_back({nextId++,int(rng()%3)});
+        std::vector<Item>n = o;
+        const int edits = rng()%8;
+        for(int e=0;e<edits;e++){
+            const int kind = rng()%4;
+            if(kind==0){
+                n.insert(n.begin()+rng()%(n.size()+1),Item{nextId++,0});
+            }else if((kind==1)&&n.size()){
+                n.erase(n.begin()+rng()%n.size());
+            }else if((kind==2)&&(n.size()>1)){
+                const Item it = n[rng()%n.size()];
+                n.erase(std::find_if(n.begin(),n.end(),[&it](const Item&i){return i.id==it.id;}));
+                n.insert(n.begin()+rng()%(n.size()+1),it);
+            }else if(n.size()){
+                n[rng()%n.size()].content = rng()%3;
+            }
+        }
+        for(int detectMoves=0;detectMoves<2;detectMoves++){
+            ListDiff cb(o,n);
+            DiffUtil::DiffResult result = DiffUtil::calculateDiff(cb,detectMoves);
+            Replay replay(o);
+            result.dispatchUpdatesTo(replay);
+            ASSERT_TRUE(replay.matches(n))<<"iteration "<<iter;
+        }
+    }
+}
+
+TEST_F(DIFFUTIL,largeListFewChanges){
+    std::vector<Item>o;
+    for(int i=0;i<100000;i++)o.push_back({i,0});
+    std::vector<Item>n = o;
+    n.erase(n.begin()+500);
+    n.insert(n.begin()+70000,Item{-2,0});
+    n[30000].content = 1;
+    ListDiff cb(o,n);
+    const int64_t start = SystemClock::uptimeMillis();
+    DiffUtil::DiffResult result = DiffUtil::calculateDiff(cb);
+    Replay replay(o);
+    result.dispatchUpdatesTo(replay);
+    LOGI("diffed 100000 items in %dms",int(SystemClock::uptimeMillis()-start));
+    ASSERT_TRUE(replay.matches(n));
+    ASSERT_EQ(replay.events,3);
+}
+
+TEST_F(DIFFUTIL,asyncListDiffer){
+    Looper*looper = Looper::getMainLooper();
+    std::vector<Item>o={{1,0},{2,0},{3,0}};
+    std::vector<Item>n={{3,0},{1,1},{4,0}};
+    Replay replay({});
+    AsyncListDiffer<Item>differ(&replay,std::make_shared<ItemDiff>());
+    differ.submitList(o);
+    ASSERT_EQ(differ.getCurrentList().size(),3u);/*nothing to diff,committed at once*/
+    ASSERT_TRUE(replay.matches(o));
+
+    bool supersededCommitted = false;
+    bool committed = false;
+    differ.submitList({{5,0}},[&supersededCommitted](){supersededCommitted = true;});/*superseded before it finishes*/
+    differ.submitList(n,[&committed](){committed = true;});
+    int64_t start = SystemClock::uptimeMillis();
+    while(!committed && (SystemClock::uptimeMillis()-start<2000))
+        looper->pollOnce(10);
+    ASSERT_TRUE(committed);
+    /*give the superseded diff time to come back,it must be dropped*/
+    start = SystemClock::uptimeMillis();
+    while(SystemClock::uptimeMillis()-start<200)
+        looper->pollOnce(10);
+    ASSERT_FALSE(supersededCommitted);
+    ASSERT_EQ(differ.getCurrentList().size(),3u);
+    ASSERT_EQ(differ.getCurrentList()[0].id,3);
+    ASSERT_TRUE(replay.matches(n));
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <view/choreographer.h>
+#include <widgetEx/recyclerview/recyclerview.h>
+
+using namespace cdroid;
+
+/*prefetch deadlines are computed against a fake clock,all times in nanoseconds*/
+class FRAMEDEADLINE:public testing::Test{
+public:
+    static constexpr int64_t MS = 1000000;
+    static constexpr int64_t INTERVAL = 16*MS;
+    class TestPool:public RecyclerView::RecycledViewPool{
+    public:
+        using RecycledViewPool::factorInCreateTime;
+        using RecycledViewPool::factorInBindTime;
+        using RecycledViewPool::willCreateInTime;
+        using RecycledViewPool::willBindInTime;
+    };
+};
+
+TEST_F(FRAMEDEADLINE,nextFrameTime){
+    const int64_t last = 1000*MS;
+    /*within the current interval the next frame starts one interval after the last*/
+    ASSERT_EQ(Choreographer::getNextFrameTimeNanos(last,INTERVAL,last+2*MS),last+INTERVAL);
+    ASSERT_EQ(Choreographer::getNextFrameTimeNanos(last,INTERVAL,last+INTERVAL-1),last+INTERVAL);
+    /*idle for a while,a frame posted now gets a whole interval*/
+    ASSERT_EQ(Choreographer::getNextFrameTimeNanos(last,INTERVAL,last+INTERVAL),last+2*INTERVAL);
+    ASSERT_EQ(Choreographer::getNextFrameTimeNanos(last,INTERVAL,last+100*MS),last+100*MS+INTERVAL);
+    ASSERT_EQ(Choreographer::getNextFrameTimeNanos(0,INTERVAL,5*MS),int64_t(INTERVAL));
+}
+
+TEST_F(FRAMEDEADLINE,unknownCost){
+    TestPool pool;
+    const int64_t now = 1000*MS;
+    /*nothing measured yet,always try*/
+    ASSERT_TRUE(pool.willCreateInTime(0,now,now+1));
+    ASSERT_TRUE(pool.willBindInTime(0,now,now+1));
+}
+
+TEST_F(FRAMEDEADLINE,createIncludesBind){
+    TestPool pool;
+    pool.factorInCreateTime(0,4*MS);
+    pool.factorInBindTime(0,4*MS);
+    const int64_t now = 1000*MS;
+    const int64_t deadline = Choreographer::getNextFrameTimeNanos(now-10*MS,INTERVAL,now);/*6ms left*/
+    ASSERT_EQ(deadline,now+6*MS);
+    ASSERT_TRUE(pool.willBindInTime(0,now,deadline));
+    /*creating alone fits,but the holder couldn't be bound in this pass*/
+    ASSERT_FALSE(pool.willCreateInTime(0,now,deadline));
+    ASSERT_TRUE(pool.willCreateInTime(0,now-3*MS,deadline));
+    /*other view types keep their own costs*/
+    ASSERT_TRUE(pool.willCreateInTime(1,now,deadline));
+}
+
+TEST_F(FRAMEDEADLINE,pastDeadline){
+    TestPool pool;
+    pool.factorInCreateTime(0,1*MS);
+    pool.factorInBindTime(0,1*MS);
+    const int64_t deadline = 1000*MS;
+    ASSERT_FALSE(pool.willBindInTime(0,deadline,deadline));
+    ASSERT_FALSE(pool.willCreateInTime(0,deadline+MS,deadline));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <view/viewgroup.h>
+#include <view/hittestindex.h>
+#include <random>
+#include <algorithm>
+
+using namespace cdroid;
+
+class HITTEST:public testing::Test{
+public:
+    class TestGroup:public ViewGroup{
+    public:
+        TestGroup(int w,int h):ViewGroup(w,h){}
+        /*the linear scan done without the index*/
+        int linearHitTest(int x,int y){
+            std::vector<View*>list = buildOrderedChildList();
+            if(list.empty())list = mChildren;
+            for(int i=int(list.size())-1;i>=0;i--){
+                if(isTransformedTouchPointInView(x,y,*list[i],nullptr))
+                    return list[i]->getId();
+            }
+            return 0;
+        }
+    };
+    static constexpr int WIDTH = 800;
+    static constexpr int HEIGHT= 480;
+    TestGroup*mGroup;
+    int mHitId;
+    std::mt19937 mRandom;
+    void SetUp()override{
+        mGroup = new TestGroup(WIDTH,HEIGHT);
+        mRandom.seed(1234);
+        for(int i=0;i<300;i++){
+            View*v = new View(10,10);
+            v->setId(i+1);
+            v->setOnTouchListener([this](View&v,MotionEvent&e){
+                mHitId = v.getId();
+                return true;
+            });
+            mGroup->addView(v);
+            v->layout(mRandom()%WIDTH,mRandom()%HEIGHT,10+mRandom()%80,10+mRandom()%60);
+        }
+    }
+    void TearDown()override{
+        delete mGroup;
+    }
+    int hitTest(int x,int y){
+        mHitId = 0;
+        MotionEvent*e = MotionEvent::obtain(0,0,MotionEvent::ACTION_DOWN,x,y,0);
+        mGroup->dispatchTouchEvent(*e);
+        e->setAction(MotionEvent::ACTION_UP);
+        mGroup->dispatchTouchEvent(*e);
+        e->recycle();
+        return mHitId;
+    }
+    /*the indexed dispatch must pick the same child as the linear scan*/
+    void compare(int count){
+        for(int i=0;i<count;i++){
+            const int x = mRandom()%WIDTH;
+            const int y = mRandom()%HEIGHT;
+            ASSERT_EQ(hitTest(x,y),mGroup->linearHitTest(x,y))<<"at "<<x<<","<<y;
+        }
+    }
+};
+
+TEST_F(HITTEST,index){
+    std::vector<View*>children;
+    for(int i=0;i<mGroup->getChildCount();i++)
+        children.push_back(mGroup->getChildAt(i));
+    HitTestIndex index;
+    index.build(children);
+    std::vector<View*>candidates;
+    for(int i=0;i<1000;i++){
+        const int x = mRandom()%WIDTH;
+        const int y = mRandom()%HEIGHT;
+        index.query(x,y,candidates);
+        std::vector<View*>expected;
+        for(View*v:children){
+            if(Rect::Make(v->getLeft(),v->getTop(),v->getWidth(),v->getHeight()).contains(x,y))
+                expected.push_back(v);
+        }
+        /*every child under the point is a candidate,in child order*/
+        auto it = candidates.begin();
+        for(View*v:expected){
+            it = std::find(it,candidates.end(),v);
+            ASSERT_NE(it,candidates.end());
+        }
+    }
+}
+
+TEST_F(HITTEST,dispatch){
+    compare(500);
+    mGroup->setHitTestIndexEnabled(true);
+    compare(2000);
+}
+
+TEST_F(HITTEST,moveChildren){
+    mGroup->setHitTestIndexEnabled(true);
+    hitTest(0,0);
+    for(int i=0;i<mGroup->getChildCount();i+=3){
+        View*v = mGroup->getChildAt(i);
+        v->offsetLeftAndRight(int(mRandom()%40)-20);
+        v->setTranslationY(float(mRandom()%30));
+        v->setRotation(float(mRandom()%90));
+    }
+    compare(1000);
+    mGroup->offsetChildrenTopAndBottom(-25);
+    compare(1000);
+    View*removed = mGroup->getChildAt(10);
+    mGroup->removeViewAt(10);
+    delete removed;
+    mGroup->addView(new View(WIDTH,HEIGHT),0);
+    compare(1000);
+}
+
+TEST_F(HITTEST,zOrder){
+    mGroup->setHitTestIndexEnabled(true);
+    hitTest(0,0);
+    for(int i=0;i<mGroup->getChildCount();i+=7)
+        mGroup->getChildAt(i)->setZ(float(mRandom()%8));
+    compare(1000);
+}
@@ -7,6 +7,10 @@
 #include <sys/stat.h>
 #include <dirent.h>
 #include <image-decoders/imagedecoder.h>
+#include <drawable/drawable.h>
+#include <drawable/imageatlas.h>
+#include <drawable/ninepatchrenderer.h>
+#include <sstream>
 #ifdef ENABLE_CAIROSVG
 #include <curl/curl.h>
 #endif
@@ -183,6 +187,129 @@ TEST_F(IMAGE,ninepatch2){
     //img->get_ninepatch(horz,vert);
     //ctx->draw_ninepatch(img,rect,horz,vert);
 }
+TEST_F(IMAGE,applyConfig){
+    auto img = ImageSurface::create(Surface::Format::ARGB32,64,32);
+    auto cr = Cairo::Context::create(img);
+    cr->set_source_rgb(1,0,0);
+    cr->paint();
+    img->flush();
+    ImageDecoder::setTransparency(img,PixelFormat::OPAQUE);
+    auto img565 = ImageDecoder::applyConfig(img,ImageDecoder::RGB_565);
+    ASSERT_EQ(img565->get_format(),Surface::Format::RGB16_565);
+    ASSERT_EQ(*(uint16_t*)img565->get_data(),0xF800);
+    ASSERT_EQ(ImageDecoder::getTransparency(img565),PixelFormat::OPAQUE);
+
+    ImageDecoder::setTransparency(img,PixelFormat::TRANSLUCENT);
+    ASSERT_EQ(ImageDecoder::applyConfig(img,ImageDecoder::RGB_565).get(),img.get());
+}
+
+TEST_F(IMAGE,applyConfigUntagged){
+    /*decoders that don't tag the transparency(gif) have it computed from the pixels*/
+    auto img = ImageSurface::create(Surface::Format::ARGB32,64,32);
+    auto cr = Cairo::Context::create(img);
+    cr->set_source_rgba(1,0,0,0.5);
+    cr->paint();
+    img->flush();
+    ASSERT_EQ(ImageDecoder::applyConfig(img,ImageDecoder::RGB_565).get(),img.get());
+
+    cr->set_operator(Cairo::Context::Operator::SOURCE);
+    cr->set_source_rgb(0,0,1);
+    cr->paint();
+    img->flush();
+    auto img565 = ImageDecoder::applyConfig(img,ImageDecoder::RGB_565);
+    ASSERT_EQ(img565->get_format(),Surface::Format::RGB16_565);
+    ASSERT_EQ(*(uint16_t*)img565->get_data(),0x001F);
+}
+
+static cairo_status_t appendPng(void*closure,const unsigned char*data,unsigned int length){
+    ((std::string*)closure)->append((const char*)data,length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static void appendBE32(std::string&out,uint32_t v){
+    for(int i=3;i>=0;i--)out.push_back(char(v>>(i*8)));
+}
+
+static uint32_t pngCrc(const std::string&data){
+    uint32_t crc = 0xFFFFFFFF;
+    for(unsigned char c:data){
+        crc ^= c;
+        for(int k=0;k<8;k++)crc = (crc>>1)^(0xEDB88320&(0-(crc&1)));
+    }
+    return crc^0xFFFFFFFF;
+}
+
+TEST_F(IMAGE,ninepatch565){
+    /*an opaque precompiled ninepatch,npTc goes right after IHDR as ninepatch_compile.py does*/
+    auto img = ImageSurface::create(Surface::Format::ARGB32,40,30);
+    auto cr = Cairo::Context::create(img);
+    cr->set_source_rgb(0,0,1);
+    cr->paint();
+    img->flush();
+    std::string png;
+    cairo_surface_write_to_png_stream(img->cobj(),appendPng,&png);
+
+    std::string chunk("npTc");
+    const int32_t divs[] = {10,30,8,22};
+    chunk.append(std::string("\x00\x02\x02\x09",4));
+    appendBE32(chunk,0);
+    appendBE32(chunk,0);
+    for(int32_t padding:{4,5,6,7})appendBE32(chunk,padding);
+    appendBE32(chunk,0);
+    for(int32_t div:divs)appendBE32(chunk,div);
+    for(int i=0;i<9;i++)appendBE32(chunk,1);
+    std::string npTc;
+    appendBE32(npTc,chunk.size()-4);
+    npTc += chunk;
+    appendBE32(npTc,pngCrc(chunk));
+    png.insert(8+25,npTc);
+
+    const int config = ImageDecoder::getPreferredConfig();
+    ImageDecoder::setPreferredConfig(ImageDecoder::RGB_565);
+    std::istringstream stream(png);
+    auto bmp = ImageDecoder::loadImage(stream);
+    ImageDecoder::setPreferredConfig(config);
+    ASSERT_NE(bmp.get(),nullptr);
+    ASSERT_EQ(bmp->get_format(),Surface::Format::ARGB32);
+    size_t len;
+    ASSERT_NE(ImageDecoder::getChunk(bmp,"npTc",len),nullptr);
+
+    NinePatchRenderer np(bmp);
+    const Rect padding = np.getPadding();
+    ASSERT_EQ(padding.left,4);
+    ASSERT_EQ(padding.width,5);
+    ASSERT_EQ(padding.top,6);
+    ASSERT_EQ(padding.height,7);
+}
+
+TEST_F(IMAGE,atlas){
+    ImageAtlas atlas(128,32);
+    auto img = ImageSurface::create(Surface::Format::ARGB32,30,20);
+    auto cr = Cairo::Context::create(img);
+    cr->set_source_rgb(0,1,0);
+    cr->paint();
+    img->flush();
+    ASSERT_TRUE(atlas.isCandidate("cdroid:mipmap/icon",30,20));
+    ASSERT_FALSE(atlas.isCandidate("cdroid:mipmap/icon",33,20));
+    auto r1 = atlas.add("cdroid:mipmap/icon.png",img);
+    ASSERT_NE(r1,nullptr);
+    ASSERT_EQ(atlas.get("@cdroid:mipmap/icon.png"),r1);
+    /*same name with another extension is another image*/
+    ASSERT_EQ(atlas.get("cdroid:mipmap/icon.jpg"),nullptr);
+    auto r2 = atlas.add("cdroid:mipmap/icon2",img);
+    ASSERT_EQ(r1->getSurface().get(),r2->getSurface().get());
+    Rect rc = r1->getRect();
+    ASSERT_FALSE(rc.intersect(r2->getRect()));
+    ASSERT_EQ(atlas.getPageCount(),1);
+
+    auto copy = r2->extract();
+    ASSERT_EQ(copy->get_width(),30);
+    ASSERT_EQ(((uint32_t*)copy->get_data())[0],0xFF00FF00);
+    r1 = nullptr;
+    r2 = nullptr;
+    ASSERT_EQ(atlas.getPageCount(),0);
+}
+
 #ifdef ENABLE_CAIROSVG
 TEST_F(IMAGE,SVG){
      svg_cairo_t *svg;
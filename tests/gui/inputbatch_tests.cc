@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cdroid.h>
+#include <core/inputeventsource.h>
+
+using namespace cdroid;
+
+class INPUTBATCH:public testing::Test{
+public:
+    static void SetUpTestCase(){
+        /*Choreographer and ~InputEventSource both use the main Looper*/
+        Looper::prepare(false);
+        if(Looper::getMainLooper()==nullptr)Looper::prepareMainLooper();
+    }
+    class TestSource:public InputEventSource{
+    public:
+        struct Dispatched{
+            int action;
+            int deviceId;
+            size_t historySize;
+            nsecs_t eventTime;
+            float x;
+        };
+        std::vector<Dispatched>mDispatched;
+        using InputEventSource::batchMotion;
+        using InputEventSource::consumeBatchedInput;
+        using InputEventSource::resampleMotion;
+    protected:
+        void dispatchEvent(InputEvent&e)override{
+            MotionEvent&m = (MotionEvent&)e;
+            mDispatched.push_back({m.getActionMasked(),m.getDeviceId(),m.getHistorySize(),m.getEventTime(),m.getX()});
+        }
+    };
+    static MotionEvent*obtain(int action,nsecs_t time,float x,int deviceId=0,int pointerCount=1){
+        PointerCoords coords[2];
+        PointerProperties props[2];
+        for(int i=0;i<pointerCount;i++){
+            props[i].id = i;
+            coords[i].setAxisValue(MotionEvent::AXIS_X,x+i*50);
+            coords[i].setAxisValue(MotionEvent::AXIS_Y,200);
+        }
+        return MotionEvent::obtain(0,time,action,pointerCount,props,coords,0/*metaState*/,0,
+                0,0/*x/yPrecision*/,deviceId,0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*flags*/,0/*classification*/);
+    }
+};
+
+TEST_F(INPUTBATCH,batchPerFrame){
+    TestSource src;
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,100,100));
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,104,110));
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,108,120));
+    /*nothing goes out before the frame*/
+    ASSERT_TRUE(src.mDispatched.empty());
+    src.consumeBatchedInput();
+    ASSERT_EQ(src.mDispatched.size(),size_t(1));
+    ASSERT_EQ(src.mDispatched[0].historySize,size_t(2));
+    ASSERT_EQ(src.mDispatched[0].eventTime,108);
+    ASSERT_EQ(src.mDispatched[0].x,120);
+}
+
+TEST_F(INPUTBATCH,unbatchable){
+    TestSource src;
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,100,100));
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,102,100,1));
+    /*devices are batched apart*/
+    ASSERT_TRUE(src.mDispatched.empty());
+    /*a new pointer count can't be appended,the pending move goes first*/
+    src.batchMotion(obtain(MotionEvent::ACTION_MOVE,104,110,0,2));
+    ASSERT_EQ(src.mDispatched.size(),size_t(1));
+    ASSERT_EQ(src.mDispatched[0].eventTime,100);
+    src.consumeBatchedInput();
+    ASSERT_EQ(src.mDispatched.size(),size_t(3));
+    ASSERT_EQ(src.mDispatched[1].deviceId,0);
+    ASSERT_EQ(src.mDispatched[1].eventTime,104);
+    ASSERT_EQ(src.mDispatched[2].deviceId,1);
+}
+
+TEST_F(INPUTBATCH,resample){
+    MotionEvent*m = INPUTBATCH::obtain(MotionEvent::ACTION_MOVE,100,100);
+    MotionEvent*m2= INPUTBATCH::obtain(MotionEvent::ACTION_MOVE,108,116);
+    ASSERT_TRUE(m->addBatch(*m2));
+    /*extrapolated to the frame time along the two newest samples*/
+    TestSource::resampleMotion(*m,111);
+    ASSERT_EQ(m->getHistorySize(),size_t(2));
+    ASSERT_EQ(m->getEventTime(),111);
+    ASSERT_FLOAT_EQ(m->getX(),122);
+    m->recycle();
+
+    /*the prediction is limited to half of the sample interval*/
+    m = INPUTBATCH::obtain(MotionEvent::ACTION_MOVE,100,100);
+    ASSERT_TRUE(m->addBatch(*m2));
+    TestSource::resampleMotion(*m,130);
+    ASSERT_EQ(m->getEventTime(),112);
+    ASSERT_FLOAT_EQ(m->getX(),124);
+    m->recycle();
+
+    /*samples too close are left alone*/
+    m = INPUTBATCH::obtain(MotionEvent::ACTION_MOVE,107,100);
+    ASSERT_TRUE(m->addBatch(*m2));
+    TestSource::resampleMotion(*m,112);
+    ASSERT_EQ(m->getHistorySize(),size_t(1));
+    ASSERT_EQ(m->getEventTime(),108);
+    m->recycle();
+    m2->recycle();
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <cdroid.h>
 #include <porting/cdinput.h>
+#include <core/inputlatencytracker.h>
 #if defined(__linux__)||defined(__unix__) 
 #include <sys/time.h>
 #include <linux/input.h>
@@ -1318,3 +1319,37 @@ TEST_F(INPUTDEVICE, MTB6) {
    ASSERT_EQ(OutEvents[8]->getY(0), mts[23].value);   // 触点1 Y: 600
 
 }
+
+TEST(INPUTLATENCY,stages){
+   InputLatencyTracker&t = InputLatencyTracker::getInstance();
+   t.setEnabled(true);
+   t.reset();
+   const nsecs_t ms = SystemClock::NANOS_PER_MS;
+   KeyEvent*k = KeyEvent::obtain(0,0,KeyEvent::ACTION_DOWN,KEY_ENTER,0,0,0,KEY_ENTER,0,0,0);
+   k->setHardwareTimeNanos(100*ms);
+   t.onEventDispatched(*k,103*ms);
+   KeyEvent*c = KeyEvent::obtain(*k);
+   ASSERT_EQ(c->getHardwareTimeNanos(),100*ms);
+   t.onEventDispatched(*c,104*ms);
+   const uint32_t frame = t.getFrameNumber()+1;
+   t.onFrameDrawn(120*ms);
+   t.onFrameFlipped(125*ms);
+   ASSERT_EQ(t.getCount(InputLatencyTracker::INPUT_TO_DISPATCH),2);
+   ASSERT_EQ(t.getCount(InputLatencyTracker::INPUT_TO_FLIP),2);
+   ASSERT_EQ(t.getPercentile(InputLatencyTracker::INPUT_TO_DISPATCH,50),4.f);
+   ASSERT_EQ(t.getPercentile(InputLatencyTracker::DISPATCH_TO_DRAW,100),17.f);
+   ASSERT_EQ(t.getPercentile(InputLatencyTracker::DRAW_TO_FLIP,100),5.f);
+   auto records = t.getRecentRecords();
+   ASSERT_EQ(records.size(),2);
+   ASSERT_EQ(records[0].frame,frame);
+   ASSERT_EQ(records[1].frame,frame);
+   /*events that did not cause a frame are not charged to a later one*/
+   t.onEventDispatched(*k,200*ms);
+   t.onFrameDrawn(800*ms);
+   t.onFrameFlipped(801*ms);
+   ASSERT_EQ(t.getCount(InputLatencyTracker::DISPATCH_TO_DRAW),2);
+   k->recycle();
+   c->recycle();
+   t.reset();
+   t.setEnabled(false);
+}
@@ -7,6 +7,8 @@
 #include <thread>
 #include <core/uieventsource.h>
 #include <core/handler.h>
+#include <core/trace.h>
+#include <sstream>
 #if defined(__linux__)||defined(__unix__)
 #include <sys/time.h>
 #include <sys/timerfd.h>
@@ -87,6 +89,33 @@ TEST_F(LOOPER,removeMessage){
    }
    ASSERT_EQ(ft.getCount(),1);
 }
+class OrderHandler:public MessageHandler{
+public:
+   std::vector<int>whats;
+   void handleMessage(Message&msg)override{
+       whats.push_back(msg.what);
+   }
+};
+
+TEST_F(LOOPER,messageOrder){
+   OrderHandler ft;
+   for(int i = 0;i < 10;i++){
+       Message msg(i);
+       mLooper->sendMessageDelayed(20-(i%3)*5,&ft,msg);
+   }
+   mLooper->removeMessages(&ft,4);
+   ASSERT_TRUE(mLooper->hasMessages(&ft,3,nullptr));
+   ASSERT_FALSE(mLooper->hasMessages(&ft,4,nullptr));
+   const int64_t t1 = SystemClock::uptimeMillis();
+   while(SystemClock::uptimeMillis()-t1<100){
+       mLooper->pollOnce(10);
+   }
+   /*ordered by uptime,messages with same uptime are FIFO*/
+   const std::vector<int>expected = {2,5,8,1,7,0,3,6,9};
+   ASSERT_EQ(ft.whats,expected);
+   mLooper->removeMessages(&ft);
+}
+
 class SelfDestroyHandler:public MessageHandler{
 private:
     Looper*mLooper;
@@ -159,6 +188,47 @@ TEST_F(LOOPER,removeHandler){
     printf("#### END ####\r\n\r\n");
 }
 
+class ReadyEventHandler:public EventHandler{
+public:
+    int checkCount=0;
+    int handleCount=0;
+    ReadyEventHandler(){
+        setReadinessDriven(true);
+    }
+    int checkEvents()override{checkCount++;return 1;}
+    int handleEvents()override{handleCount++;return 0;}
+};
+TEST_F(LOOPER,readinessDriven){
+    ReadyEventHandler hdl;
+    mLooper->addEventHandler(&hdl);
+    mLooper->pollOnce(0);
+    EXPECT_EQ(hdl.handleCount,1);/*ready once it is added*/
+    for(int i=0;i<5;i++)mLooper->pollOnce(0);
+    EXPECT_EQ(hdl.checkCount,1);/*not polled until signaled*/
+
+    hdl.signalReady();
+    mLooper->pollOnce(0);
+    EXPECT_EQ(hdl.handleCount,2);
+
+    nsecs_t t0 = SystemClock::uptimeMillis();
+    hdl.signalReadyAt(t0+20);
+    mLooper->pollOnce(1000);/*poll timeout is shortened to the ready time*/
+    EXPECT_EQ(hdl.handleCount,3);
+    EXPECT_LT(SystemClock::uptimeMillis()-t0,500);
+
+    std::thread th([&hdl](){
+        usleep(20000);
+        hdl.signalReady();
+    });
+    t0 = SystemClock::uptimeMillis();
+    mLooper->pollOnce(1000);/*signals from other threads wake the looper*/
+    th.join();
+    EXPECT_EQ(hdl.handleCount,4);
+    EXPECT_LT(SystemClock::uptimeMillis()-t0,500);
+    mLooper->removeEventHandler(&hdl);
+    mLooper->pollOnce(0);
+}
+
 class TestRunner:public Runnable{
 private:
    int mCount;
@@ -194,6 +264,27 @@ TEST_F(LOOPER,eventhandler){
     ASSERT_FALSE(rc);
 }
 
+TEST_F(LOOPER,eventhandler_storm){
+    UIEventSource*handler=new UIEventSource(nullptr,nullptr);
+    std::vector<Runnable>runs(10);
+    for(int i=0;i<100000;i++){
+        Runnable&r = runs[i%runs.size()];
+        handler->postDelayed(r,500);
+        if(i%10!=3)ASSERT_EQ(handler->removeCallbacks(r),1);
+    }
+    for(int i=0;i<runs.size();i++)
+        ASSERT_EQ(handler->hasCallbacks(runs[i]),i==3);
+    ASSERT_EQ(handler->removeCallbacks(runs[3]),10000);
+    ASSERT_FALSE(handler->hasCallbacks(runs[3]));
+
+    handler->postDelayed(runs[0],10);
+    handler->removeCallbacks(runs[0]);
+    handler->postDelayed(runs[0],10);/*a removed runnable can be posted again*/
+    ASSERT_TRUE(handler->hasCallbacks(runs[0]));
+    ASSERT_EQ(handler->removeCallbacks(runs[0]),1);
+    delete handler;
+}
+
 class MyHandler:public Handler{
 public:
     int count=0;
@@ -288,3 +379,34 @@ TEST_F(LOOPER,atexit){
     AtExit::registerCallback([](){std::cout<<"__2"<<std::endl;});
     AtExit::registerCallback([](){std::cout<<"__3"<<std::endl;});
 }
+
+TEST_F(LOOPER,trace){
+    Trace::clear();
+    ATRACE_NAME("untraced");/*tracing is disabled*/
+    ASSERT_EQ(Trace::getEventCount(),0);
+    Trace::setEnabled(true);
+    {
+        ATRACE_NAME("outer");
+        ATRACE_INT("counter",42);
+        ATRACE_ASYNC_BEGIN("async",7);
+        mLooper->pollOnce(1);
+    }
+    std::thread th([](){
+        Trace::setThreadName("worker");
+        ATRACE_ASYNC_END("async",7);
+    });
+    th.join();
+    Trace::setEnabled(false);
+    ASSERT_GE(Trace::getEventCount(),8);/*B,C,b,B,B,E,E,E and e on the worker*/
+    std::ostringstream oss;
+    Trace::dump(oss);
+    const std::string json = oss.str();
+    ASSERT_NE(json.find("\"name\":\"outer\""),std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"Looper::pollInner\""),std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"value\":42}"),std::string::npos);
+    ASSERT_NE(json.find("\"ph\":\"e\""),std::string::npos);
+    ASSERT_NE(json.find("\"worker\""),std::string::npos);
+    ASSERT_EQ(json.find("untraced"),std::string::npos);
+    Trace::clear();
+    ASSERT_EQ(Trace::getEventCount(),0);
+}
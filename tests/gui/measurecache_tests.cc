@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <widget/tablelayout.h>
+#include <widget/tablerow.h>
+#include <widget/relativelayout.h>
+#include <widget/gridlayout.h>
+#include <widget/framelayout.h>
+
+using namespace cdroid;
+
+namespace cdroid{
+class GridLayoutTestAccessor{
+public:
+    /*moves the solved columns,a re-solve puts them back*/
+    static void shiftLocations(GridLayout&grid,int dx){
+        for(int&x:grid.mHorizontalAxis->mLocations)x+=dx;
+    }
+};
+}
+
+class MEASURECACHE:public testing::Test{
+public:
+    class CountingView:public View{
+    public:
+        int mMeasureCount;
+        CountingView(int w,int h):View(w,h),mMeasureCount(0){}
+    protected:
+        void onMeasure(int widthMeasureSpec,int heightMeasureSpec)override{
+            mMeasureCount++;
+            View::onMeasure(widthMeasureSpec,heightMeasureSpec);
+        }
+    };
+    class CountingRow:public TableRow{
+    public:
+        int mMeasureCount;
+        CountingRow(int w,int h):TableRow(w,h),mMeasureCount(0){}
+    protected:
+        void onMeasure(int widthMeasureSpec,int heightMeasureSpec)override{
+            mMeasureCount++;
+            TableRow::onMeasure(widthMeasureSpec,heightMeasureSpec);
+        }
+    };
+    static void fillGrid(GridLayout&grid,CountingView**cells,FrameLayout**frames,int count){
+        grid.setColumnCount(2);
+        for(int i=0;i<count;i++){
+            frames[i]= new FrameLayout(60+i*10,40);
+            cells[i] = new CountingView(60+i*10,40);
+            frames[i]->addView(cells[i],new FrameLayout::LayoutParams(60+i*10,40));
+            grid.addView(frames[i],new GridLayout::LayoutParams());
+        }
+    }
+    static void assertSameBounds(View*a,View*b){
+        ASSERT_EQ(a->getLeft(),b->getLeft());
+        ASSERT_EQ(a->getTop(),b->getTop());
+        ASSERT_EQ(a->getWidth(),b->getWidth());
+        ASSERT_EQ(a->getHeight(),b->getHeight());
+    }
+    static int exactly(int size){
+        return MeasureSpec::makeMeasureSpec(size,MeasureSpec::EXACTLY);
+    }
+    static int atMost(int size){
+        return MeasureSpec::makeMeasureSpec(size,MeasureSpec::AT_MOST);
+    }
+    static void measureAndLayout(View*v,int w,int h){
+        v->measure(exactly(w),exactly(h));
+        v->layout(0,0,v->getMeasuredWidth(),v->getMeasuredHeight());
+    }
+};
+
+TEST_F(MEASURECACHE,sameSpec){
+    CountingView v(100,100);
+    v.requestLayout();
+    v.measure(exactly(100),atMost(50));
+    v.measure(exactly(100),atMost(50));
+    ASSERT_EQ(v.mMeasureCount,1);
+    v.layout(0,0,100,50);
+    v.measure(exactly(100),atMost(50));
+    ASSERT_EQ(v.mMeasureCount,1);
+    v.requestLayout();
+    v.measure(exactly(100),atMost(50));
+    ASSERT_EQ(v.mMeasureCount,2);
+}
+
+TEST_F(MEASURECACHE,specKey){
+    /*AT_MOST heights must not overwrite the width part of the cache key*/
+    View v(100,100);
+    v.measure(exactly(100),atMost(50));
+    v.layout(0,0,100,50);
+    v.measure(exactly(200),atMost(50));
+    ASSERT_EQ(v.getMeasuredWidth(),200);
+}
+
+TEST_F(MEASURECACHE,relative){
+    RelativeLayout rl(400,300);
+    View*a = new View(100,40);
+    View*b = new View(100,40);
+    a->setId(1);
+    b->setId(2);
+    RelativeLayout::LayoutParams*lp = new RelativeLayout::LayoutParams(100,40);
+    lp->addRule(RelativeLayout::BELOW,1);
+    rl.addView(a,new RelativeLayout::LayoutParams(100,40));
+    rl.addView(b,lp);
+    measureAndLayout(&rl,400,300);
+    ASSERT_EQ(b->getTop(),a->getBottom());
+
+    /*the sorted graph survives requests that don't touch the rules*/
+    a->requestLayout();
+    measureAndLayout(&rl,400,300);
+    ASSERT_EQ(b->getTop(),a->getBottom());
+
+    /*changed rules sort the children again*/
+    lp = new RelativeLayout::LayoutParams(100,40);
+    lp->addRule(RelativeLayout::BELOW,2);
+    a->setLayoutParams(lp);
+    b->setLayoutParams(new RelativeLayout::LayoutParams(100,40));
+    measureAndLayout(&rl,400,300);
+    ASSERT_EQ(a->getTop(),b->getBottom());
+}
+
+TEST_F(MEASURECACHE,tableRows){
+    TableLayout table(400,300);
+    CountingRow*rows[2];
+    View*cells[2];
+    for(int i=0;i<2;i++){
+        rows[i] = new CountingRow(400,40);
+        cells[i]= new View(80,40);
+        rows[i]->addView(cells[i],new TableRow::LayoutParams(80,40));
+        table.addView(rows[i]);
+    }
+    measureAndLayout(&table,400,300);
+    rows[0]->mMeasureCount = rows[1]->mMeasureCount = 0;
+    /*a cell keeping its size only re-measures its own row*/
+    cells[0]->requestLayout();
+    measureAndLayout(&table,400,300);
+    ASSERT_EQ(rows[0]->mMeasureCount,1);
+    ASSERT_EQ(rows[1]->mMeasureCount,0);
+
+    /*a wider column re-measures every row*/
+    cells[0]->setLayoutParams(new TableRow::LayoutParams(120,40));
+    measureAndLayout(&table,400,300);
+    ASSERT_EQ(rows[1]->mMeasureCount,1);
+    ASSERT_EQ(cells[1]->getWidth(),120);
+}
+
+TEST_F(MEASURECACHE,gridLayout){
+    GridLayout grid(400,300);
+    CountingView*cells[4];
+    FrameLayout*frames[4];
+    fillGrid(grid,cells,frames,4);
+    measureAndLayout(&grid,400,300);
+    const int left = frames[1]->getLeft();
+    const int measureCount = cells[1]->mMeasureCount;
+
+    /*a request inside a cell that keeps its size reuses the solved locations*/
+    GridLayoutTestAccessor::shiftLocations(grid,7);
+    cells[1]->requestLayout();
+    measureAndLayout(&grid,400,300);
+    ASSERT_GT(cells[1]->mMeasureCount,measureCount);
+    ASSERT_EQ(frames[1]->getLeft(),left+7);
+
+    /*a resized cell solves again and matches a grid that never cached*/
+    cells[0]->setLayoutParams(new FrameLayout::LayoutParams(90,50));
+    measureAndLayout(&grid,400,300);
+
+    GridLayout fresh(400,300);
+    CountingView*freshCells[4];
+    FrameLayout*freshFrames[4];
+    fillGrid(fresh,freshCells,freshFrames,4);
+    freshCells[0]->setLayoutParams(new FrameLayout::LayoutParams(90,50));
+    measureAndLayout(&fresh,400,300);
+    for(int i=0;i<4;i++){
+        assertSameBounds(frames[i],freshFrames[i]);
+        assertSameBounds(cells[i],freshCells[i]);
+    }
+}
+
+TEST_F(MEASURECACHE,gridLayoutAtMost){
+    /*AT_MOST bounds the grid like layout does,it is not stretched to the parent size*/
+    GridLayout grid(400,300);
+    CountingView*cells[4];
+    FrameLayout*frames[4];
+    fillGrid(grid,cells,frames,4);
+    grid.measure(atMost(400),atMost(300));
+    const int width = grid.getMeasuredWidth();
+    const int height= grid.getMeasuredHeight();
+    ASSERT_LT(width,400);
+    ASSERT_LT(height,300);
+    grid.layout(0,0,width,height);
+    ASSERT_EQ(frames[3]->getRight(),width);
+    ASSERT_EQ(frames[3]->getBottom(),height);
+
+    /*measuring again with the same bounds gives the same solution*/
+    cells[1]->requestLayout();
+    grid.measure(atMost(400),atMost(300));
+    ASSERT_EQ(grid.getMeasuredWidth(),width);
+    ASSERT_EQ(grid.getMeasuredHeight(),height);
+    grid.layout(0,0,width,height);
+
+    GridLayout fresh(400,300);
+    CountingView*freshCells[4];
+    FrameLayout*freshFrames[4];
+    fillGrid(fresh,freshCells,freshFrames,4);
+    measureAndLayout(&fresh,width,height);
+    for(int i=0;i<4;i++){
+        assertSameBounds(frames[i],freshFrames[i]);
+        assertSameBounds(cells[i],freshCells[i]);
+    }
+}
@@ -17,6 +17,8 @@ extern void gettimeofday(struct timeval* t1, struct timezone* zone);
 #undef ABSOLUTE
 #endif
 #include <cdroid.h>
+#include <core/inputrecorder.h>
+#include <sstream>
 
 struct MTEvent{int type,code,value;};
 class MOTIONEVENT:public testing::Test{
@@ -85,6 +87,128 @@ TEST_F(MOTIONEVENT,offset){
     ASSERT_EQ(e->getY(),200);
 }
 
+TEST_F(MOTIONEVENT,addBatch){
+    PointerCoords coords[2];
+    PointerProperties props[2];
+    coords[0].setAxisValue(MotionEvent::AXIS_X,100);
+    coords[0].setAxisValue(MotionEvent::AXIS_Y,200);
+    MotionEvent*e = MotionEvent::obtain(0,100,MotionEvent::ACTION_MOVE,1,props,coords, 0/*metaState*/,0,
+            0,0/*x/yPrecision*/,0/*deviceId*/, 0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*flags*/,0/*classification*/);
+    coords[0].setAxisValue(MotionEvent::AXIS_X,110);
+    MotionEvent*e2 = MotionEvent::obtain(0,104,MotionEvent::ACTION_MOVE,1,props,coords, 0/*metaState*/,0,
+            0,0/*x/yPrecision*/,0/*deviceId*/, 0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*flags*/,0/*classification*/);
+    ASSERT_TRUE(e->addBatch(*e2));
+    ASSERT_EQ(e->getHistorySize(),1);
+    ASSERT_EQ(e->getHistoricalEventTime(0),100);
+    ASSERT_EQ(e->getEventTime(),104);/*sample times stay in ms*/
+    ASSERT_EQ(e->getHistoricalX(0,0),100);
+    ASSERT_EQ(e->getX(),110);
+    e2->setAction(MotionEvent::ACTION_UP);
+    ASSERT_FALSE(e->addBatch(*e2));
+    e->recycle();
+    e2->recycle();
+}
+
+TEST_F(MOTIONEVENT,recordReplay){
+    PointerCoords coords[2];
+    PointerProperties props[2];
+    props[1].id = 1;
+    coords[0].setAxisValue(MotionEvent::AXIS_X,100);
+    coords[0].setAxisValue(MotionEvent::AXIS_Y,200);
+    coords[1].setAxisValue(MotionEvent::AXIS_X,300);
+    coords[1].setAxisValue(MotionEvent::AXIS_PRESSURE,.5f);
+    MotionEvent*e = MotionEvent::obtain(90,100,MotionEvent::ACTION_MOVE,2,props,coords, 0/*metaState*/,0,
+            0,0/*x/yPrecision*/,3/*deviceId*/, 0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*flags*/,0/*classification*/);
+    coords[0].setAxisValue(MotionEvent::AXIS_X,110);
+    e->addSample(104,coords);
+    e->setHardwareTimeNanos(99000000LL);
+    KeyEvent*k = KeyEvent::obtain(200,210,KeyEvent::ACTION_UP,KeyEvent::KEYCODE_ENTER,2/*repeat*/,0/*metaState*/,
+            3/*deviceId*/,28/*scancode*/,0/*flags*/,InputDevice::SOURCE_KEYBOARD,0/*displayId*/);
+    std::stringstream ss;
+    InputEventRecorder::writeHeader(ss);
+    InputEventRecorder::writeEvent(ss,*e);
+    InputEventRecorder::writeEvent(ss,*k);
+    ASSERT_TRUE(InputEventRecorder::readHeader(ss));
+    ASSERT_EQ(InputEventRecorder::peekEventTime(ss),104);
+    MotionEvent*m = (MotionEvent*)InputEventRecorder::readEvent(ss,1000);
+    ASSERT_NE(m,nullptr);
+    ASSERT_EQ(m->getType(),InputEvent::INPUT_EVENT_TYPE_MOTION);
+    ASSERT_EQ(m->getDeviceId(),3);
+    ASSERT_EQ(m->getPointerCount(),2);
+    ASSERT_EQ(m->getHistorySize(),1);
+    ASSERT_EQ(m->getDownTime(),1090);
+    ASSERT_EQ(m->getHistoricalEventTime(0),1100);
+    ASSERT_EQ(m->getEventTime(),1104);
+    ASSERT_EQ(m->getHardwareTimeNanos(),1099000000LL);
+    ASSERT_EQ(m->getHistoricalX(0,0),100);
+    ASSERT_EQ(m->getX(0),110);
+    ASSERT_EQ(m->getX(1),300);
+    ASSERT_EQ(m->getPointerId(1),1);
+    ASSERT_FLOAT_EQ(m->getPressure(1),.5f);
+    KeyEvent*k2 = (KeyEvent*)InputEventRecorder::readEvent(ss,1000);
+    ASSERT_NE(k2,nullptr);
+    ASSERT_EQ(k2->getKeyCode(),KeyEvent::KEYCODE_ENTER);
+    ASSERT_EQ(k2->getScanCode(),28);
+    ASSERT_EQ(k2->getRepeatCount(),2);
+    ASSERT_EQ(k2->getEventTime(),1210);
+    ASSERT_EQ(InputEventRecorder::peekEventTime(ss),-1);
+    ASSERT_EQ(InputEventRecorder::readEvent(ss),nullptr);
+    e->recycle();
+    m->recycle();
+    k->recycle();
+    k2->recycle();
+}
+
+TEST_F(MOTIONEVENT,recordReplayKeys){
+    /*keys and motions share the ms time base,so a mixed recording replays in order and on time*/
+    Looper::prepare(false);
+    if(Looper::getMainLooper()==nullptr)Looper::prepareMainLooper();
+    PointerCoords coords[1];
+    PointerProperties props[1];
+    coords[0].setAxisValue(MotionEvent::AXIS_X,100);
+    const std::string path = "/tmp/recordReplayKeys.cdir";
+    InputEventRecorder recorder;
+    ASSERT_TRUE(recorder.open(path));
+    KeyEvent*k = KeyEvent::obtain(1000,1000,KeyEvent::ACTION_DOWN,KeyEvent::KEYCODE_ENTER,0/*repeat*/,0/*metaState*/,
+            3/*deviceId*/,28/*scancode*/,0/*flags*/,InputDevice::SOURCE_KEYBOARD,0/*displayId*/);
+    recorder.write(*k);
+    k->recycle();
+    for(int i=0;i<2;i++){
+        MotionEvent*e = MotionEvent::obtain(1010,1010+i*10,i?MotionEvent::ACTION_UP:MotionEvent::ACTION_DOWN,1,props,coords,0/*metaState*/,0,
+                0,0/*x/yPrecision*/,4/*deviceId*/,0/*edgeFlags*/,InputDevice::SOURCE_TOUCHSCREEN,0/*flags*/,0/*classification*/);
+        recorder.write(*e);
+        e->recycle();
+    }
+    k = KeyEvent::obtain(1000,1030,KeyEvent::ACTION_UP,KeyEvent::KEYCODE_ENTER,0/*repeat*/,0/*metaState*/,
+            3/*deviceId*/,28/*scancode*/,0/*flags*/,InputDevice::SOURCE_KEYBOARD,0/*displayId*/);
+    recorder.write(*k);
+    k->recycle();
+    recorder.close();
+    ASSERT_EQ(recorder.getEventCount(),4u);
+
+    std::vector<std::pair<int,int>>played;/*type,action*/
+    std::vector<nsecs_t>times;
+    InputEventPlayer player([&](InputEvent&e){
+        const int action = (e.getType()==InputEvent::INPUT_EVENT_TYPE_KEY)?((KeyEvent&)e).getAction():((MotionEvent&)e).getActionMasked();
+        played.push_back({e.getType(),action});
+        times.push_back(e.getEventTime());
+    });
+    ASSERT_TRUE(player.load(path));
+    const nsecs_t start = SystemClock::uptimeMillis();
+    player.start(1.f);
+    while(player.isPlaying() && (SystemClock::uptimeMillis() - start < 2000))
+        Looper::getMainLooper()->pollOnce(5);
+    ASSERT_FALSE(player.isPlaying());
+    ASSERT_LT(SystemClock::uptimeMillis() - start,500);
+    ASSERT_EQ(played.size(),size_t(4));
+    ASSERT_EQ(played[0],std::make_pair(int(InputEvent::INPUT_EVENT_TYPE_KEY),int(KeyEvent::ACTION_DOWN)));
+    ASSERT_EQ(played[1],std::make_pair(int(InputEvent::INPUT_EVENT_TYPE_MOTION),int(MotionEvent::ACTION_DOWN)));
+    ASSERT_EQ(played[2],std::make_pair(int(InputEvent::INPUT_EVENT_TYPE_MOTION),int(MotionEvent::ACTION_UP)));
+    ASSERT_EQ(played[3],std::make_pair(int(InputEvent::INPUT_EVENT_TYPE_KEY),int(KeyEvent::ACTION_UP)));
+    ASSERT_GE(times[3]-times[0],30);
+    std::remove(path.c_str());
+}
+
 TEST_F(MOTIONEVENT,Rotation) {
     // The un-rotated frame size.
     constexpr int width = 600;
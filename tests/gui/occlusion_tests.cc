@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <view/viewgroup.h>
+#include <drawable/colordrawable.h>
+#include <drawable/shapedrawable.h>
+
+using namespace cdroid;
+
+class OCCLUSION:public testing::Test{
+public:
+    class CountingView:public View{
+    public:
+        int mDrawCount;
+        CountingView(int w,int h):View(w,h),mDrawCount(0){}
+    protected:
+        void onDraw(Canvas&canvas)override{
+            mDrawCount++;
+        }
+    };
+    class TestGroup:public ViewGroup{
+    public:
+        TestGroup(int w,int h):ViewGroup(w,h){}
+        bool backgroundOccluded(Canvas&canvas){
+            return isBackgroundOccluded(canvas);
+        }
+    protected:
+        void onLayout(bool changed,int l,int t,int w,int h)override{}
+    };
+    static constexpr int WIDTH = 400;
+    static constexpr int HEIGHT= 300;
+    TestGroup*mGroup;
+    CountingView*mBottom;
+    CountingView*mTop;
+    Canvas*mCanvas;
+    void SetUp()override{
+        mCanvas = new Canvas(Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32,WIDTH,HEIGHT));
+        mGroup = new TestGroup(WIDTH,HEIGHT);
+        mGroup->setOcclusionCullingEnabled(true);
+        mGroup->layout(0,0,WIDTH,HEIGHT);
+        mBottom= new CountingView(100,100);
+        mTop   = new CountingView(200,200);
+        mTop->setBackground(new ColorDrawable(0xFF00FF00));
+        mGroup->addView(mBottom);
+        mGroup->addView(mTop);
+        mBottom->layout(50,50,100,100);
+        mTop->layout(20,20,200,200);
+    }
+    void TearDown()override{
+        delete mGroup;
+        delete mCanvas;
+    }
+    void draw(){
+        mBottom->mDrawCount = mTop->mDrawCount = 0;
+        mGroup->draw(*mCanvas);
+    }
+};
+
+TEST_F(OCCLUSION,offByDefault){
+    TestGroup group(WIDTH,HEIGHT);
+    ASSERT_FALSE(group.isOcclusionCullingEnabled());
+}
+
+TEST_F(OCCLUSION,cullChild){
+    draw();
+    ASSERT_EQ(mTop->mDrawCount,1);
+    ASSERT_EQ(mBottom->mDrawCount,0);
+
+    mGroup->setOcclusionCullingEnabled(false);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+}
+
+TEST_F(OCCLUSION,partiallyCovered){
+    mBottom->offsetLeftAndRight(150);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+    /*only the covered part of it is dirty*/
+    mCanvas->save();
+    mCanvas->rectangle(190,60,20,20);
+    mCanvas->clip();
+    draw();
+    mCanvas->restore();
+    ASSERT_EQ(mBottom->mDrawCount,0);
+}
+
+TEST_F(OCCLUSION,notOpaque){
+    mTop->setAlpha(0.5f);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+    mTop->setAlpha(1.f);
+    mTop->setRotation(30.f);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+    mTop->setRotation(0.f);
+    mTop->setScaleX(0.2f);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+    mTop->setScaleX(1.f);
+    mTop->setVisibility(View::INVISIBLE);
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+}
+
+TEST_F(OCCLUSION,background){
+    mGroup->setBackground(new ColorDrawable(0xFFFF0000));
+    ASSERT_FALSE(mGroup->backgroundOccluded(*mCanvas));
+    mCanvas->save();
+    mCanvas->rectangle(30,30,100,100);
+    mCanvas->clip();
+    ASSERT_TRUE(mGroup->backgroundOccluded(*mCanvas));
+    mGroup->setOcclusionCullingEnabled(false);
+    ASSERT_FALSE(mGroup->backgroundOccluded(*mCanvas));
+    mCanvas->restore();
+}
+
+TEST_F(OCCLUSION,shapeBackground){
+    /*the corners of an oval don't cover what lies under them*/
+    ShapeDrawable*sd = new ShapeDrawable();
+    sd->setShape(new OvalShape());
+    mTop->setBackground(sd);
+    ASSERT_EQ(sd->getOpacity(),int(PixelFormat::TRANSLUCENT));
+    draw();
+    ASSERT_EQ(mBottom->mDrawCount,1);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <widget/plotobject.h>
+#include <widget/plotview.h>
+
+using namespace cdroid;
+
+class PLOTOBJECT:public testing::Test{
+public:
+    static constexpr int CAPACITY = 100;
+    /*milliseconds since the epoch,a float can't tell neighbouring samples apart*/
+    static constexpr double TIME = 1.7e12;
+};
+
+TEST_F(PLOTOBJECT,ring){
+    PlotObject obj(0xFFFFFFFF,PlotObject::Lines);
+    obj.addSample(0,0);
+    ASSERT_EQ(obj.sampleCount(),0);
+
+    obj.setCapacity(CAPACITY);
+    for(int i=0;i<CAPACITY*2+5;i++)
+        obj.addSample(i,i%7);
+    ASSERT_EQ(obj.sampleCount(),int(CAPACITY));
+    ASSERT_EQ(obj.sample(0).first,CAPACITY+5);
+    ASSERT_EQ(obj.sample(CAPACITY-1).first,CAPACITY*2+4);
+
+    /*older samples are ignored*/
+    obj.addSample(0,100);
+    ASSERT_EQ(obj.sample(CAPACITY-1).first,CAPACITY*2+4);
+
+    obj.clearSamples();
+    ASSERT_EQ(obj.sampleCount(),0);
+    ASSERT_EQ(obj.capacity(),int(CAPACITY));
+}
+
+TEST_F(PLOTOBJECT,precision){
+    PlotObject obj(0xFFFFFFFF,PlotObject::Lines);
+    obj.setCapacity(CAPACITY);
+    for(int i=0;i<CAPACITY;i++)
+        obj.addSample(TIME+i,i);
+    for(int i=0;i<CAPACITY;i++){
+        ASSERT_EQ(obj.sample(i).first,TIME+i);
+        ASSERT_EQ(obj.sample(i).second,i);
+    }
+
+    PlotView view(200,100);
+    view.setLimits(TIME,TIME+CAPACITY,0,CAPACITY);
+    const Rect pr = view.pixRect();
+    const PointF first = view.mapToWidget(obj.sample(0).first,obj.sample(0).second);
+    const PointF last = view.mapToWidget(obj.sample(CAPACITY-1).first,obj.sample(CAPACITY-1).second);
+    ASSERT_NEAR(first.x,pr.left,0.01f);
+    ASSERT_NEAR(last.x,pr.left+pr.width*(CAPACITY-1)/double(CAPACITY),0.01f);
+    ASSERT_LT(view.mapToWidget(TIME,0).x,view.mapToWidget(TIME+1,0).x);
+}
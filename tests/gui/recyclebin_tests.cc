@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <widget/listview.h>
+#include <widget/recyclebin.h>
+
+using namespace cdroid;
+
+class RECYCLEBIN:public testing::Test{
+public:
+    class ItemAdapter:public Adapter{
+    public:
+        int mBindCount;
+        std::vector<int>mTypes;
+        ItemAdapter():mBindCount(0),mTypes(20,0){}
+        int getCount()const override{ return int(mTypes.size()); }
+        void*getItem(int position)const override{ return nullptr; }
+        int getViewTypeCount()const override{ return 2; }
+        int getItemViewType(int position)const override{ return mTypes[position]; }
+        View*getView(int position,View*convertView,ViewGroup*parent)override{
+            mBindCount++;
+            if(convertView)return convertView;
+            View*v = new View(100,20);
+            v->setLayoutParams(new AbsListView::LayoutParams(LayoutParams::MATCH_PARENT,20));
+            return v;
+        }
+    };
+    class TestList:public ListView{
+    public:
+        TestList(int w,int h):ListView(w,h){}
+        RecycleBin*recycler(){ return mRecycler; }
+        View*obtain(int position,bool&recycled){
+            bool metadata[1];
+            View*v = obtainView(position,metadata);
+            recycled = metadata[0];
+            return v;
+        }
+        /*binds an item off screen the way prefetchItems() does*/
+        View*prefetch(int position){
+            View*scrapView = mRecycler->getScrapView(position);
+            View*v = mAdapter->getView(position,scrapView,this);
+            v->setLayoutParams(new AbsListView::LayoutParams(LayoutParams::MATCH_PARENT,
+                    20,mAdapter->getItemViewType(position)));
+            mRecycler->addPrefetchedView(v,position);
+            return v;
+        }
+    };
+    ItemAdapter*mAdapter;
+    TestList*mList;
+    void SetUp()override{
+        mAdapter = new ItemAdapter();
+        mList = new TestList(100,60);
+        mList->setAdapter(mAdapter);
+        mList->measure(MeasureSpec::makeMeasureSpec(100,MeasureSpec::EXACTLY),
+                MeasureSpec::makeMeasureSpec(60,MeasureSpec::EXACTLY));
+        mList->layout(0,0,100,60);
+        mAdapter->mBindCount = 0;
+    }
+    void TearDown()override{
+        mList->recycler()->clear();
+        delete mList;
+        delete mAdapter;
+    }
+};
+
+TEST_F(RECYCLEBIN,prefetchedReuse){
+    bool recycled;
+    View*v = mList->prefetch(5);
+    ASSERT_EQ(mList->recycler()->getPrefetchedViewCount(),size_t(1));
+    ASSERT_EQ(mList->obtain(5,recycled),v);
+    ASSERT_FALSE(recycled);/*never attached,setupChild must add it*/
+    ASSERT_EQ(mAdapter->mBindCount,1);/*obtainView didn't bind it again*/
+    ASSERT_EQ(mList->recycler()->getPrefetchedViewCount(),size_t(0));
+    delete v;
+}
+
+TEST_F(RECYCLEBIN,prefetchedAttach){
+    /*items 0..2 fill the list,scrolling one item brings the prefetched 3 in*/
+    View*v = mList->prefetch(3);
+    mList->scrollListBy(20);
+    ASSERT_EQ(mAdapter->mBindCount,1);
+    ASSERT_EQ(v->getParent(),mList);
+    ASSERT_EQ(mList->getChildAt(mList->getChildCount()-1),v);
+    ASSERT_FALSE(v->isTemporarilyDetached());
+    ASSERT_EQ(v->isAttachedToWindow(),mList->isAttachedToWindow());
+}
+
+TEST_F(RECYCLEBIN,prefetchedDiscard){
+    mList->prefetch(3);
+    mList->prefetch(4);
+    mList->prefetch(5);
+    mList->recycler()->scrapPrefetchedViews(4,5);
+    ASSERT_EQ(mList->recycler()->getPrefetchedViewCount(),size_t(2));
+    ASSERT_FALSE(mList->recycler()->hasPrefetchedView(3));
+    /*a view that was never attached doesn't go to the scrap heap*/
+    ASSERT_EQ(mList->recycler()->getScrapView(3),nullptr);
+}
+
+TEST_F(RECYCLEBIN,prefetchedFromScrap){
+    /*item 0 scrolls out into the scrap heap,prefetching rebinds it*/
+    mList->scrollListBy(21);
+    View*v = mList->prefetch(6);
+    ASSERT_TRUE(v->isTemporarilyDetached());
+    bool recycled;
+    ASSERT_EQ(mList->obtain(6,recycled),v);
+    ASSERT_TRUE(recycled);
+    ASSERT_FALSE(v->isTemporarilyDetached());
+    mList->recycler()->addScrapView(v,6);
+
+    /*dropped,it goes back to the heap it came from*/
+    ASSERT_EQ(mList->prefetch(6),v);
+    mList->recycler()->scrapPrefetchedViews();
+    ASSERT_EQ(mList->recycler()->getScrapView(6),v);
+    mList->recycler()->addScrapView(v,6);
+}
+
+TEST_F(RECYCLEBIN,prefetchedViewTypeChanged){
+    mList->prefetch(7);
+    mAdapter->mTypes[7] = 1;
+    ASSERT_EQ(mList->recycler()->getPrefetchedView(7),nullptr);
+    ASSERT_EQ(mList->recycler()->getPrefetchedViewCount(),size_t(0));
+    ASSERT_EQ(mList->recycler()->getScrapView(7),nullptr);
+    ASSERT_EQ(mList->recycler()->getScrapView(8),nullptr);
+}
+
+TEST_F(RECYCLEBIN,prefetchedTransientState){
+    mList->scrollListBy(21);
+    View*v = mList->prefetch(6);/*rebound from the scrap heap*/
+    ASSERT_TRUE(v->isTemporarilyDetached());
+    v->setHasTransientState(true);
+    mList->recycler()->scrapPrefetchedViews();
+    ASSERT_EQ(mList->recycler()->getScrapView(6),nullptr);
+    ASSERT_EQ(mList->recycler()->getTransientStateView(6),v);
+    v->setHasTransientState(false);
+    mList->recycler()->addScrapView(v,6);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cdlog.h>
+#include <cdroid.h>
+#include <view/asyncinflater.h>
+#include <widgetEx/recyclerview/recyclerview.h>
+
+using namespace cdroid;
+
+class RECYCLEDVIEWPOOL:public testing::Test{
+public:
+    using Pool = RecyclerView::RecycledViewPool;
+    /*holders built outside an adapter keep INVALID_TYPE as their view type*/
+    static constexpr int TYPE = RecyclerView::INVALID_TYPE;
+    static constexpr int ITEM_TYPE = 1;
+    static RecyclerView::ViewHolder*newHolder(){
+        return new RecyclerView::ViewHolder(new View(100,40));
+    }
+    static void pollFor(int ms,const std::function<bool()>&done){
+        const int64_t start = SystemClock::uptimeMillis();
+        while(!done() && (SystemClock::uptimeMillis()-start < ms))
+            Looper::getMainLooper()->pollOnce(10);
+    }
+};
+
+TEST_F(RECYCLEDVIEWPOOL,stats){
+    Pool pool;
+    pool.setMaxRecycledViews(TYPE,2);
+    for(int i=0;i<3;i++)
+        pool.putRecycledView(newHolder());
+    ASSERT_EQ(pool.getRecycledViewCount(TYPE),2);
+    ASSERT_EQ(pool.getStats(TYPE).evictions,1);
+
+    for(int i=0;i<3;i++)
+        delete pool.getRecycledView(TYPE);
+    Pool::Stats stats = pool.getStats(TYPE);
+    ASSERT_EQ(stats.hits,2);
+    ASSERT_EQ(stats.misses,1);
+
+    pool.setMaxRecycledViews(TYPE,0);
+    pool.putRecycledView(newHolder());
+    ASSERT_EQ(pool.getStats().evictions,2);
+
+    pool.resetStats();
+    stats = pool.getStats();
+    ASSERT_EQ(stats.hits+stats.misses+stats.creations+stats.evictions,0);
+}
+
+TEST_F(RECYCLEDVIEWPOOL,sharedPool){
+    std::shared_ptr<Pool> shared = Pool::getSharedPool();
+    ASSERT_EQ(shared,Pool::getSharedPool());
+    shared->putRecycledView(newHolder());
+    ASSERT_EQ(shared->getRecycledViewCount(TYPE),1);
+    shared->clear();
+    shared->resetStats();
+}
+
+TEST_F(RECYCLEDVIEWPOOL,poolOwnership){
+    std::shared_ptr<Pool> pool = std::make_shared<Pool>();
+    {
+        RecyclerView rv1(100,100);
+        RecyclerView rv2(100,100);
+        rv1.setRecycledViewPool(pool);
+        rv2.setRecycledViewPool(pool);
+        ASSERT_EQ(&rv1.getRecycledViewPool(),pool.get());
+        ASSERT_EQ(&rv2.getRecycledViewPool(),pool.get());
+        ASSERT_EQ(pool.use_count(),3);
+    }
+    /*the views let go of the pool without deleting it*/
+    ASSERT_EQ(pool.use_count(),1);
+    pool->putRecycledView(newHolder());
+    ASSERT_EQ(pool->getRecycledViewCount(TYPE),1);
+}
+
+TEST_F(RECYCLEDVIEWPOOL,statsLookup){
+    class TypeCountingPool:public Pool{
+    public:
+        int getTypeCount()const{ return mScrap.size(); }
+    };
+    TypeCountingPool pool;
+    const Pool::Stats stats = pool.getStats(42);
+    ASSERT_EQ(stats.hits+stats.misses+stats.creations+stats.evictions,0);
+    ASSERT_EQ(pool.getTypeCount(),0);/*reading the stats of an unknown type adds nothing*/
+}
+
+TEST_F(RECYCLEDVIEWPOOL,prefill){
+    App app(0,nullptr);
+    AsyncLayoutInflater inflater(&app);
+    int created = 0;
+    auto factory = [&created](View*view){
+        created++;
+        return new RecyclerView::ViewHolder(view);
+    };
+    Pool pool;
+    pool.setMaxRecycledViews(ITEM_TYPE,2);
+    pool.prefill(inflater,"cdroid:layout/simple_list_item_1",nullptr,ITEM_TYPE,3,factory);
+    pollFor(2000,[&pool](){return pool.getRecycledViewCount(ITEM_TYPE)==2;});
+    pollFor(200,[](){return false;});/*the third view comes back after the type is full*/
+    ASSERT_EQ(pool.getRecycledViewCount(ITEM_TYPE),2);
+    ASSERT_EQ(pool.getRecycledViewCount(TYPE),0);
+    ASSERT_EQ(pool.getStats(ITEM_TYPE).creations,2);
+    ASSERT_EQ(created,2);
+    RecyclerView::ViewHolder*holder = pool.getRecycledView(ITEM_TYPE);
+    ASSERT_NE(holder,nullptr);
+    ASSERT_EQ(holder->getItemViewType(),ITEM_TYPE);
+    delete holder;
+
+    /*views inflated for a pool that is gone are dropped without building holders*/
+    created = 0;
+    Pool*gone = new Pool();
+    gone->prefill(inflater,"cdroid:layout/simple_list_item_1",nullptr,ITEM_TYPE,2,factory);
+    delete gone;
+    pollFor(500,[](){return false;});
+    ASSERT_EQ(created,0);
+}
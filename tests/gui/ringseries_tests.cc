@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <widget/achart/model/ringseries.h>
+#include <random>
+#include <algorithm>
+
+using namespace cdroid;
+
+class RINGSERIES:public testing::Test{
+public:
+    using Points = std::vector<std::pair<double,double>>;
+    static constexpr int CAPACITY= 1000;
+    static constexpr int COLUMNS = 100;
+};
+
+TEST_F(RINGSERIES,evict){
+    RingSeries series("test",CAPACITY);
+    for(int i=0;i<CAPACITY*3+10;i++)
+        series.add(i,i%7);
+    ASSERT_EQ(series.getItemCount(),int(CAPACITY));
+    ASSERT_EQ(series.getX(0),CAPACITY*2+10);
+    ASSERT_EQ(series.getX(CAPACITY-1),CAPACITY*3+9);
+    ASSERT_EQ(series.getMinX(),CAPACITY*2+10);
+    ASSERT_EQ(series.getMaxX(),CAPACITY*3+9);
+    ASSERT_THROW(series.getY(CAPACITY),std::out_of_range);
+
+    /*older samples are ignored*/
+    series.add(0,100);
+    ASSERT_EQ(series.getMaxY(),6);
+
+    series.clear();
+    ASSERT_EQ(series.getItemCount(),0);
+    series.add(5,1);
+    ASSERT_EQ(series.getX(0),5);
+}
+
+TEST_F(RINGSERIES,minMax){
+    RingSeries series("test",CAPACITY);
+    std::mt19937 random(1234);
+    std::vector<double>ys;
+    for(int i=0;i<CAPACITY*5;i++){
+        ys.push_back(double(random()%10000));
+        series.add(i,ys.back());
+        const size_t first = ys.size()>CAPACITY?ys.size()-CAPACITY:0;
+        if(i%97==0){
+            ASSERT_EQ(series.getMinY(),*std::min_element(ys.begin()+first,ys.end()))<<"at "<<i;
+            ASSERT_EQ(series.getMaxY(),*std::max_element(ys.begin()+first,ys.end()))<<"at "<<i;
+        }
+    }
+    /*removing from the middle keeps the extremes right*/
+    const size_t first = ys.size()-CAPACITY;
+    const int index = int(std::max_element(ys.begin()+first,ys.end())-ys.begin()-first);
+    ys.erase(ys.begin()+first+index);
+    series.remove(index);
+    ASSERT_EQ(series.getMaxY(),*std::max_element(ys.begin()+first,ys.end()));
+    series.remove(0);
+    ASSERT_EQ(series.getItemCount(),CAPACITY-2);
+}
+
+TEST_F(RINGSERIES,indexForKey){
+    RingSeries series("test",CAPACITY);
+    for(int i=0;i<CAPACITY+50;i++)
+        series.add(i*2,i);
+    ASSERT_EQ(series.getIndexForKey(100),0);
+    ASSERT_EQ(series.getIndexForKey(110),5);
+    ASSERT_EQ(series.getIndexForKey(111),-7);
+    ASSERT_EQ(series.getIndexForKey(0),-1);
+}
+
+TEST_F(RINGSERIES,range){
+    RingSeries series("test",CAPACITY);
+    for(int i=0;i<CAPACITY+500;i++)
+        series.add(i,i%7);
+    Points out;
+    series.getRange(600.5,700.5,true,COLUMNS,Decimator::NONE,out);
+    ASSERT_EQ(out.front().first,600);
+    ASSERT_EQ(out.back().first,701);
+    ASSERT_EQ(series.getRange(0,700.5,false).size(),size_t(201));
+
+    /*the bounding points stay while columns keep their extremes*/
+    out.clear();
+    series.getRange(600.5,1400.5,true,COLUMNS,Decimator::MIN_MAX,out);
+    ASSERT_LE(out.size(),size_t(COLUMNS*4+2));
+    ASSERT_TRUE(std::is_sorted(out.begin(),out.end()));
+    ASSERT_EQ(out.front().first,600);
+    ASSERT_EQ(out.back().first,1401);
+    const double step = 800.0/COLUMNS;
+    for(int c=0;c<COLUMNS;c++){
+        bool hasMin = false,hasMax = false;
+        for(auto&p:out){
+            if((p.first>=600.5+step*c)&&(p.first<600.5+step*(c+1))){
+                hasMin |= (p.second==0);
+                hasMax |= (p.second==6);
+            }
+        }
+        ASSERT_TRUE(hasMin&&hasMax)<<"column "<<c;
+    }
+
+    out.clear();
+    series.getRange(600.5,1400.5,false,COLUMNS,Decimator::LTTB,out);
+    ASSERT_EQ(out.size(),size_t(COLUMNS*2));
+    ASSERT_TRUE(std::is_sorted(out.begin(),out.end()));
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <gtest/gtest.h>
+#include <porting/cdlog.h>
+#include <cdlogformat.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LOG:public testing::Test{
+public:
+    static std::string format(const char*fmt,const cdlog::LogArgs&args){
+        char out[1024];
+        cdlog::LogFormatArgs(out,sizeof(out),fmt,args);
+        return std::string(out);
+    }
+};
+
+TEST_F(LOG,format){
+    cdlog::LogArgs args;
+    args.clear();
+    const std::string name("cdroid");
+    cdlog::logArgs(args,name,-3,42u,1.5,'x');
+    ASSERT_EQ(format("%s %d %u %.2f %c",args),"cdroid -3 42 1.50 x");
+    ASSERT_FALSE(args.truncated);
+    args.clear();
+    cdlog::logArgs(args,int8_t(-1),uint16_t(0xFFFF),(long long)1<<40);
+    ASSERT_EQ(format("%d %x %lld",args),"-1 ffff 1099511627776");
+    args.clear();
+    cdlog::logArgs(args,7);
+    ASSERT_EQ(format("%d %s",args),"7 <?>");/*missing arguments don't crash*/
+}
+
+TEST_F(LOG,truncation){
+    cdlog::LogArgs args;
+    args.clear();
+    const std::string longText(1000,'a');
+    cdlog::logArgs(args,longText,5);
+    ASSERT_TRUE(args.truncated);
+    ASSERT_LE(int(args.size),int(cdlog::LogArgs::kCapacity));
+    const std::string out = format("%s",args);
+    ASSERT_GT(out.size(),size_t(cdlog::LogArgs::kCapacity/2));
+    ASSERT_EQ(out,std::string(out.size(),'a'));
+}
+
+TEST_F(LOG,copiedFormat){
+    LogFlush();
+    testing::internal::CaptureStdout();
+    {
+        std::string fmt("copied %s %d");
+        LOGI(fmt.c_str(),"format",12);
+        fmt.assign(fmt.size(),'#');/*the log thread must not see the caller's buffer*/
+    }
+    LogFlush();
+    const std::string out = testing::internal::GetCapturedStdout();
+    ASSERT_NE(out.find("copied format 12"),std::string::npos);
+}
+
+TEST_F(LOG,ordering){
+    constexpr int kThreads = 4;
+    constexpr int kCount = 400;
+    LogFlush();
+    testing::internal::CaptureStdout();
+    const unsigned int dropped = LogFlush();
+    std::vector<std::thread>threads;
+    for(int t = 0;t<kThreads;t++){
+        threads.emplace_back([t](){
+            for(int n = 0;n<kCount;n++)LOGI("ordering t%d n%d",t,n);
+        });
+    }
+    for(auto&th:threads)th.join();
+    const unsigned int newDropped = LogFlush()-dropped;
+    const std::string out = testing::internal::GetCapturedStdout();
+    int last[kThreads];
+    int printed = 0;
+    for(int t = 0;t<kThreads;t++)last[t] = -1;
+    for(size_t pos = out.find("ordering t");pos!=std::string::npos;pos = out.find("ordering t",pos+1)){
+        int t,n;
+        ASSERT_EQ(sscanf(out.c_str()+pos,"ordering t%d n%d",&t,&n),2);
+        ASSERT_LT(n,kCount);
+        ASSERT_GT(n,last[t]);/*messages of one thread keep their order*/
+        last[t] = n;
+        printed++;
+    }
+    ASSERT_EQ(printed+newDropped,unsigned(kThreads*kCount));
+    if(newDropped)ASSERT_NE(out.find("log messages dropped"),std::string::npos);
+}